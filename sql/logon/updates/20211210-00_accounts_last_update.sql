@@ -0,0 +1,9 @@
+/*
+Time of the last change of an account, AccountMgr only loads the changed accounts.
+*/
+
+ALTER TABLE `accounts`
+ADD COLUMN `last_update` TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP AFTER `joindate`,
+ADD INDEX `last_update` (`last_update`);
+
+UPDATE `logon_db_version` SET LastUpdate = '20211210-00_accounts_last_update';
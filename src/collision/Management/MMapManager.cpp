@@ -67,7 +67,10 @@ namespace MMAP
         else
         {
             if (thread_safe_environment)
+            {
+                std::unique_lock<std::shared_mutex> lock(tileLock);
                 itr = loadedMMaps.insert(MMapDataSet::value_type(mapId, nullptr)).first;
+            }
             else
             {
                 sLogger.failure("Invalid mapId %u passed to MMapManager after startup in thread unsafe environment", mapId);
@@ -117,6 +120,7 @@ namespace MMAP
         MMapData* mmap_data = new MMapData(mesh);
         mmap_data->mmapLoadedTiles.clear();
 
+        std::unique_lock<std::shared_mutex> lock(tileLock);
         itr->second = mmap_data;
         return true;
     }
@@ -189,6 +193,8 @@ namespace MMAP
         dtMeshHeader* header = (dtMeshHeader*)data;
         dtTileRef tileRef = 0;
 
+        std::unique_lock<std::shared_mutex> lock(tileLock);
+
         // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
         if (dtStatusSucceed(mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef)))
         {
@@ -229,6 +235,8 @@ namespace MMAP
 
         dtTileRef tileRef = mmap->mmapLoadedTiles[packedGridPos];
 
+        std::unique_lock<std::shared_mutex> lock(tileLock);
+
         // unload, and mark as non loaded
         if (dtStatusFailed(mmap->navMesh->removeTile(tileRef, nullptr, nullptr)))
         {
@@ -258,6 +266,8 @@ namespace MMAP
             return false;
         }
 
+        std::unique_lock<std::shared_mutex> lock(tileLock);
+
         // unload all tiles from given map
         MMapData* mmap = itr->second;
         for (MMapTileSet::iterator i = mmap->mmapLoadedTiles.begin(); i != mmap->mmapLoadedTiles.end(); ++i)
@@ -24,6 +24,7 @@
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
 
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -77,6 +78,10 @@ namespace MMAP
 
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return uint32(loadedMMaps.size()); }
+
+            // held exclusively while navmeshes and tiles are added or removed,
+            // threads other than the map threads hold it shared while they use a navmesh
+            std::shared_mutex& getTileLock() { return tileLock; }
         private:
             bool loadMapData(uint32 mapId);
             uint32 packTileID(int32 x, int32 y);
@@ -85,6 +90,7 @@ namespace MMAP
             MMapDataSet loadedMMaps;
             uint32 loadedTiles;
             bool thread_safe_environment;
+            std::shared_mutex tileLock;
     };
 }
 
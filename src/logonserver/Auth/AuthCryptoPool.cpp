@@ -0,0 +1,149 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#include "AuthCryptoPool.hpp"
+#include "AuthSocket.h"
+#include "Logging/Logger.hpp"
+
+#include <chrono>
+
+using AscEmu::Threading::AEThread;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+AuthCryptoPool& AuthCryptoPool::getInstance()
+{
+    static AuthCryptoPool mInstance;
+    return mInstance;
+}
+
+void AuthCryptoPool::initialize(uint32_t workerCount, uint32_t maxQueuedJobs)
+{
+    m_maxQueuedJobs = maxQueuedJobs;
+
+    if (workerCount == 0)
+    {
+        sLogger.info("AuthCryptoPool : Disabled, logon calculations run on the network threads");
+        return;
+    }
+
+    for (uint32_t i = 0; i < workerCount; ++i)
+    {
+        m_workers.push_back(std::make_unique<AEThread>("AuthCryptoWorker" + std::to_string(i),
+            [this](AEThread& thread) { this->workerRunner(thread); }, milliseconds(0)));
+    }
+
+    sLogger.info("AuthCryptoPool : Started %u crypto workers", workerCount);
+}
+
+void AuthCryptoPool::finalize()
+{
+    if (!isEnabled())
+        return;
+
+    for (auto& worker : m_workers)
+        worker->requestKill();
+
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers)
+        worker->join();
+
+    m_workers.clear();
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_jobs.clear();
+    }
+
+    sLogger.info("AuthCryptoPool : Stopped after %llu jobs (%llu cancelled, %llu rejected), %llu us average, %u us max",
+        static_cast<unsigned long long>(m_calculatedJobCount.load()), static_cast<unsigned long long>(m_cancelledJobCount.load()),
+        static_cast<unsigned long long>(m_rejectedJobCount.load()), static_cast<unsigned long long>(getAverageJobTime()), m_maxJobTime.load());
+}
+
+bool AuthCryptoPool::queueJob(std::shared_ptr<AuthCryptoJob> const& job)
+{
+    if (!isEnabled())
+    {
+        runJob(*job);
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (m_maxQueuedJobs != 0 && m_jobs.size() >= m_maxQueuedJobs)
+        {
+            ++m_rejectedJobCount;
+            return false;
+        }
+
+        m_jobs.push_back(job);
+    }
+
+    m_condition.notify_one();
+    return true;
+}
+
+uint32_t AuthCryptoPool::getQueuedJobCount()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return static_cast<uint32_t>(m_jobs.size());
+}
+
+uint64_t AuthCryptoPool::getAverageJobTime() const
+{
+    const uint64_t jobCount = m_calculatedJobCount;
+    return jobCount ? m_totalJobTime / jobCount : 0;
+}
+
+void AuthCryptoPool::workerRunner(AEThread& thread)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (thread.isKilled())
+        return;
+
+    if (m_jobs.empty())
+    {
+        m_condition.wait_for(lock, milliseconds(100));
+        return;
+    }
+
+    const std::shared_ptr<AuthCryptoJob> job = std::move(m_jobs.front());
+    m_jobs.pop_front();
+    lock.unlock();
+
+    runJob(*job);
+}
+
+void AuthCryptoPool::runJob(AuthCryptoJob& job)
+{
+    if (job.cancelled)
+    {
+        ++m_cancelledJobCount;
+        job.finished.store(true, std::memory_order_release);
+        return;
+    }
+
+    const auto startTime = steady_clock::now();
+
+    AuthSocket::calculateCryptoJob(job);
+
+    const auto jobTime = static_cast<uint32_t>(duration_cast<microseconds>(steady_clock::now() - startTime).count());
+    m_totalJobTime += jobTime;
+    ++m_calculatedJobCount;
+
+    uint32_t maxJobTime = m_maxJobTime;
+    while (jobTime > maxJobTime && !m_maxJobTime.compare_exchange_weak(maxJobTime, jobTime));
+
+    // the socket takes the results under the same lock, it sees them only after the answer was sent
+    std::lock_guard<std::mutex> guard(job.socketMutex);
+    job.finished.store(true, std::memory_order_release);
+
+    if (job.socket != nullptr && !job.cancelled)
+        job.socket->sendCryptoJobResult(job);
+}
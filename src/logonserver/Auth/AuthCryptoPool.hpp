@@ -0,0 +1,120 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include "Auth/BigNumber.h"
+#include "Auth/Sha1.h"
+#include "Server/AccountMgr.h"
+#include "Threading/AEThread.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class AuthSocket;
+
+enum class AuthCryptoStep : uint8_t
+{
+    Challenge,
+    Proof
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// The SRP6 calculations of one logon step, queued by AuthSocket.
+// The worker fills in the results and answers the client through the socket, the socket
+// takes the results over when it handles its next packet.
+struct AuthCryptoJob
+{
+    AuthCryptoJob(AuthSocket* socket, AuthCryptoStep step) : socket(socket), step(step) {}
+
+    // cleared by the socket when it is deleted, guarded by socketMutex
+    std::mutex socketMutex;
+    AuthSocket* socket;
+
+    const AuthCryptoStep step;
+
+    // set when the client disconnected, the worker skips the job
+    std::atomic<bool> cancelled = false;
+    std::atomic<bool> finished = false;
+
+    std::shared_ptr<Account> account;
+
+    // challenge: N and g are set by the socket, s, v, b and B are calculated
+    // proof: all of them and A, M1 are set by the socket
+    BigNumber N;
+    BigNumber g;
+    BigNumber s;
+    BigNumber v;
+    BigNumber b;
+    BigNumber B;
+    BigNumber A;
+    uint8_t M1[20] = {};
+
+    // proof results
+    bool isProofValid = false;
+    BigNumber sessionKey;
+    Sha1Hash proofHash;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Runs the SRP6 calculations (modular exponentiations) of the logon on a fixed number of
+// worker threads, so the network threads keep serving the other connections when many
+// clients log in at once (e.g. after a world server restart).
+// The queue is bounded, clients are asked to try again later when it is full.
+// When the pool is disabled (0 workers) the jobs run on the network thread.
+class AuthCryptoPool
+{
+private:
+    AuthCryptoPool() = default;
+    ~AuthCryptoPool() = default;
+
+public:
+    static AuthCryptoPool& getInstance();
+    void initialize(uint32_t workerCount, uint32_t maxQueuedJobs);
+    void finalize();
+
+    AuthCryptoPool(AuthCryptoPool&&) = delete;
+    AuthCryptoPool(AuthCryptoPool const&) = delete;
+    AuthCryptoPool& operator=(AuthCryptoPool&&) = delete;
+    AuthCryptoPool& operator=(AuthCryptoPool const&) = delete;
+
+    // returns false when the queue is full
+    bool queueJob(std::shared_ptr<AuthCryptoJob> const& job);
+
+    bool isEnabled() const { return !m_workers.empty(); }
+    uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+    uint32_t getQueuedJobCount();
+
+    uint64_t getCalculatedJobCount() const { return m_calculatedJobCount; }
+    uint64_t getCancelledJobCount() const { return m_cancelledJobCount; }
+    uint64_t getRejectedJobCount() const { return m_rejectedJobCount; }
+    // microseconds
+    uint64_t getAverageJobTime() const;
+    uint32_t getMaxJobTime() const { return m_maxJobTime; }
+
+private:
+    void workerRunner(AscEmu::Threading::AEThread& thread);
+    void runJob(AuthCryptoJob& job);
+
+    std::vector<std::unique_ptr<AscEmu::Threading::AEThread>> m_workers;
+    uint32_t m_maxQueuedJobs = 0;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::shared_ptr<AuthCryptoJob>> m_jobs;
+
+    std::atomic<uint64_t> m_calculatedJobCount = 0;
+    std::atomic<uint64_t> m_cancelledJobCount = 0;
+    std::atomic<uint64_t> m_rejectedJobCount = 0;
+    std::atomic<uint64_t> m_totalJobTime = 0;
+    std::atomic<uint32_t> m_maxJobTime = 0;
+};
+
+#define sAuthCryptoPool AuthCryptoPool::getInstance()
@@ -23,6 +23,7 @@
 #include <Logging/Logger.hpp>
 #include "Server/IpBanMgr.h"
 #include <Auth/AutoPatcher.h>
+#include "Auth/AuthCryptoPool.hpp"
 #include "Server/Master.hpp"
 #include <Realm/RealmManager.hpp>
 
@@ -69,6 +70,13 @@ AuthSocket::AuthSocket(SOCKET fd) : Socket(fd, 32768, 4096)
 AuthSocket::~AuthSocket()
 {
     ASSERT(!m_patchJob);
+
+    // a crypto worker might still want to answer through this socket
+    if (m_cryptoJob)
+    {
+        std::lock_guard<std::mutex> guard(m_cryptoJob->socketMutex);
+        m_cryptoJob->socket = nullptr;
+    }
 }
 
 void AuthSocket::OnDisconnect()
@@ -85,6 +93,9 @@ void AuthSocket::OnDisconnect()
         PatchMgr::getInstance().AbortPatchJob(m_patchJob);
         m_patchJob = nullptr;
     }
+
+    if (m_cryptoJob)
+        m_cryptoJob->cancelled = true;
 }
 
 void AuthSocket::HandleChallenge()
@@ -250,62 +261,14 @@ void AuthSocket::HandleChallenge()
         //m_account->forcedLanguage = temp;
     }
 
-    // SRP6 //////////////////////////////////////////////////////////////////////////////////////////////////////
-    // Challenge
-    //
-    // First we will generate the Verifier value using the following formulas
-    //
-    // x = SHA1(s | SHA1(I | ":" | P))
-    // v = g^x % N
-    //
-    // The SHA1(I | ":" | P) part for x we have in the account database, this is the encrypted password, reversed
-    // N is a safe prime
-    // g is the generator
-    // | means concatenation in this contect
-    //
-    //
+    // the SRP6 values are calculated by the crypto workers, see calculateCryptoJob
+    auto job = std::make_shared<AuthCryptoJob>(this, AuthCryptoStep::Challenge);
+    job->account = m_account;
+    job->N = N;
+    job->g = g;
 
-    Sha1Hash sha;
-    sha.UpdateData(s.AsByteArray(), 32);
-    sha.UpdateData(m_account->SrpHash, 20);
-    sha.Finalize();
-
-    BigNumber x;
-    x.SetBinary(sha.GetDigest(), sha.GetLength());
-    v = g.ModExp(x, N);
-
-    // Next we generate b, and B which are the public and private values of the server
-    //
-    // b = random()
-    // B = k*v + g^b % N
-    //
-    // in our case the multiplier parameters, k = 3
-
-    b.SetRand(152);
-    uint8 k = 3;
-
-    BigNumber gmod = g.ModExp(b, N);
-    B = ((v * k) + gmod) % N;
-    ASSERT(gmod.GetNumBytes() <= 32);
-
-    BigNumber unk;
-    unk.SetRand(128);
-
-    // Now we send B, g, N and s to the client as a challenge, asking the client for the proof
-    sAuthLogonChallenge_S challenge;
-    challenge.cmd = 0;
-    challenge.error = 0;
-    challenge.unk2 = CE_SUCCESS;
-    memcpy(challenge.B, B.AsByteArray(), 32);
-    challenge.g_len = 1;
-    challenge.g = (g.AsByteArray())[0];
-    challenge.N_len = 32;
-    memcpy(challenge.N, N.AsByteArray(), 32);
-    memcpy(challenge.s, s.AsByteArray(), 32);
-    memcpy(challenge.unk3, unk.AsByteArray(), 16);
-    challenge.unk4 = 0;
-
-    Send(reinterpret_cast<uint8*>(&challenge), sizeof(sAuthLogonChallenge_S));
+    if (!startCryptoJob(job))
+        SendChallengeError(CE_SERVER_FULL);
 }
 
 void AuthSocket::HandleProof()
@@ -337,6 +300,59 @@ void AuthSocket::HandleProof()
     //Read(sizeof(sAuthLogonProof_C), (uint8*)&lp);
     readBuffer.Read(&lp, sizeof(sAuthLogonProof_C));
 
+    auto job = std::make_shared<AuthCryptoJob>(this, AuthCryptoStep::Proof);
+    job->account = m_account;
+    job->N = N;
+    job->g = g;
+    job->s = s;
+    job->v = v;
+    job->b = b;
+    job->B = B;
+    job->A.SetBinary(lp.A, 32);
+    memcpy(job->M1, lp.M1, 20);
+
+    if (!startCryptoJob(job))
+        SendChallengeError(CE_SERVER_FULL);
+}
+
+void AuthSocket::calculateCryptoJob(AuthCryptoJob& job)
+{
+    if (job.step == AuthCryptoStep::Challenge)
+    {
+        // SRP6 //////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Challenge
+        //
+        // First we need the Verifier value, it is generated using the following formulas
+        //
+        // x = SHA1(s | SHA1(I | ":" | P))
+        // v = g^x % N
+        //
+        // The SHA1(I | ":" | P) part for x we have in the account database, this is the encrypted password, reversed
+        // N is a safe prime
+        // g is the generator
+        // | means concatenation in this contect
+        //
+        // The salt and the verifier only depend on the password, AccountMgr calculates them once per account
+        //
+
+        sAccountMgr.getSrpVerifier(*job.account, job.g, job.N, job.s, job.v);
+
+        // Next we generate b, and B which are the public and private values of the server
+        //
+        // b = random()
+        // B = k*v + g^b % N
+        //
+        // in our case the multiplier parameters, k = 3
+
+        job.b.SetRand(152);
+        uint8 k = 3;
+
+        BigNumber gmod = job.g.ModExp(job.b, job.N);
+        job.B = ((job.v * k) + gmod) % job.N;
+        ASSERT(gmod.GetNumBytes() <= 32);
+        return;
+    }
+
     // SRP6 //////////////////////////////////////////////////////////////////////////////////////////////////////
     // 
     // Now comes the famous secret Xi Chi fraternity handshake ( http://www.youtube.com/watch?v=jJSYBoI2si0 ),
@@ -347,18 +363,15 @@ void AuthSocket::HandleProof()
     //
     //
 
-    BigNumber A;
-    A.SetBinary(lp.A, 32);
-
     Sha1Hash sha;
-    sha.UpdateBigNumbers(&A, &B, 0);
+    sha.UpdateBigNumbers(&job.A, &job.B, 0);
     sha.Finalize();
 
     BigNumber u;
     u.SetBinary(sha.GetDigest(), 20);
 
     // S session key key, S = ( A * v^u ) ^ b
-    BigNumber S = (A * (v.ModExp(u, N))).ModExp(b, N);
+    BigNumber S = (job.A * (job.v.ModExp(u, job.N))).ModExp(job.b, job.N);
 
     // Generate M
     // M = H(H(N) xor H(g), H(I), s, A, B, K) according to http://srp.stanford.edu/design.html
@@ -388,16 +401,16 @@ void AuthSocket::HandleProof()
     {
         vK[i * 2 + 1] = sha.GetDigest()[i];
     }
-    m_sessionkey.SetBinary(vK, 40);
+    job.sessionKey.SetBinary(vK, 40);
 
     uint8 hash[20];
 
     sha.Initialize();
-    sha.UpdateBigNumbers(&N, NULL);
+    sha.UpdateBigNumbers(&job.N, NULL);
     sha.Finalize();
     memcpy(hash, sha.GetDigest(), 20);
     sha.Initialize();
-    sha.UpdateBigNumbers(&g, NULL);
+    sha.UpdateBigNumbers(&job.g, NULL);
     sha.Finalize();
     for (int i = 0; i < 20; i++)
     {
@@ -407,14 +420,14 @@ void AuthSocket::HandleProof()
     t3.SetBinary(hash, 20);
 
     sha.Initialize();
-    sha.UpdateData((const uint8*)m_account->UsernamePtr->c_str(), (int)m_account->UsernamePtr->size());
+    sha.UpdateData((const uint8*)job.account->Username.c_str(), (int)job.account->Username.size());
     sha.Finalize();
 
     BigNumber t4;
     t4.SetBinary(sha.GetDigest(), 20);
 
     sha.Initialize();
-    sha.UpdateBigNumbers(&t3, &t4, &s, &A, &B, &m_sessionkey, NULL);
+    sha.UpdateBigNumbers(&t3, &t4, &job.s, &job.A, &job.B, &job.sessionKey, NULL);
     sha.Finalize();
 
     BigNumber M;
@@ -422,7 +435,42 @@ void AuthSocket::HandleProof()
 
     // Compare the M value the client sent us to the one we generated, this proves we both have the same values
     // which proves we have the same username-password pairs
-    if (memcmp(lp.M1, M.AsByteArray(), 20) != 0)
+    job.isProofValid = memcmp(job.M1, M.AsByteArray(), 20) == 0;
+    if (!job.isProofValid)
+        return;
+
+    // the hash we send to let the client know
+    job.proofHash.Initialize();
+    job.proofHash.UpdateBigNumbers(&job.A, &M, &job.sessionKey, 0);
+    job.proofHash.Finalize();
+}
+
+void AuthSocket::sendCryptoJobResult(AuthCryptoJob& job)
+{
+    if (job.step == AuthCryptoStep::Challenge)
+    {
+        BigNumber unk;
+        unk.SetRand(128);
+
+        // Now we send B, g, N and s to the client as a challenge, asking the client for the proof
+        sAuthLogonChallenge_S challenge;
+        challenge.cmd = 0;
+        challenge.error = 0;
+        challenge.unk2 = CE_SUCCESS;
+        memcpy(challenge.B, job.B.AsByteArray(), 32);
+        challenge.g_len = 1;
+        challenge.g = (job.g.AsByteArray())[0];
+        challenge.N_len = 32;
+        memcpy(challenge.N, job.N.AsByteArray(), 32);
+        memcpy(challenge.s, job.s.AsByteArray(), 32);
+        memcpy(challenge.unk3, unk.AsByteArray(), 16);
+        challenge.unk4 = 0;
+
+        Send(reinterpret_cast<uint8*>(&challenge), sizeof(sAuthLogonChallenge_S));
+        return;
+    }
+
+    if (!job.isProofValid)
     {
         // Authentication failed.
         //SendProofError(4, 0);
@@ -432,24 +480,63 @@ void AuthSocket::HandleProof()
     }
 
     // Store sessionkey
-    m_account->SetSessionKey(m_sessionkey.AsByteArray());
-
-    // let the client know
-    sha.Initialize();
-    sha.UpdateBigNumbers(&A, &M, &m_sessionkey, 0);
-    sha.Finalize();
+    job.account->SetSessionKey(job.sessionKey.AsByteArray());
 
     //SendProofError(0, sha.GetDigest());
-    sendAuthProof(sha);
+    sendAuthProof(job.proofHash);
     sLogger.debug("[AuthLogonProof] Authentication Success.");
 
-    // we're authenticated now :)
-    m_authenticated = true;
-
     // Don't update when IP banned, but update anyway if it's an account ban
-    sLogonSQL->Execute("UPDATE accounts SET lastlogin=NOW(), lastip='%s' WHERE id = %u;", GetRemoteIP().c_str(), m_account->AccountId);
+    // last_update is kept, AccountMgr does not need to sync the account for a logon
+    sLogonSQL->Execute("UPDATE accounts SET lastlogin=NOW(), lastip='%s', last_update=last_update WHERE id = %u;", GetRemoteIP().c_str(), job.account->AccountId);
 }
 
+bool AuthSocket::startCryptoJob(std::shared_ptr<AuthCryptoJob> const& job)
+{
+    // set before queueing, without workers the job is finished right away
+    m_cryptoJob = job;
+
+    if (sAuthCryptoPool.queueJob(job))
+        return true;
+
+    sLogger.debug("[AuthSocket] Crypto queue is full, client %s has to try again later", GetRemoteIP().c_str());
+    m_cryptoJob = nullptr;
+    return false;
+}
+
+bool AuthSocket::takeCryptoJobResult()
+{
+    if (!m_cryptoJob)
+        return true;
+
+    if (!m_cryptoJob->finished.load(std::memory_order_acquire))
+        return false;
+
+    {
+        // the worker holds the lock until the answer is sent
+        std::lock_guard<std::mutex> guard(m_cryptoJob->socketMutex);
+
+        if (m_cryptoJob->step == AuthCryptoStep::Challenge)
+        {
+            s = m_cryptoJob->s;
+            v = m_cryptoJob->v;
+            b = m_cryptoJob->b;
+            B = m_cryptoJob->B;
+        }
+        else if (m_cryptoJob->isProofValid)
+        {
+            m_sessionkey = m_cryptoJob->sessionKey;
+
+            // we're authenticated now :)
+            m_authenticated = true;
+        }
+
+        m_cryptoJob->socket = nullptr;
+    }
+
+    m_cryptoJob = nullptr;
+    return true;
+}
 void AuthSocket::SendChallengeError(uint8 Error)
 {
     uint8 buffer[3];
@@ -559,6 +646,13 @@ void AuthSocket::OnRead()
         return;
     }
 
+    // the client has to wait for the answer to its last packet, keep the new one until then
+    if (!takeCryptoJobResult())
+    {
+        sLogger.debug("Crypto job of the last packet is not finished! Skipped!");
+        return;
+    }
+
     uint8 Command = *(uint8*)readBuffer.GetBufferStart();
     last_recv = UNIXTIME;
     if (Command < MAX_AUTH_CMD && Handlers[Command] != NULL)
@@ -713,7 +807,7 @@ void AuthSocket::HandleReconnectProof()
         return;
 
     // Don't update when IP banned, but update anyway if it's an account ban
-    sLogonSQL->Execute("UPDATE accounts SET lastlogin = NOW(), lastip = '%s' WHERE id = %u;", GetRemoteIP().c_str(), m_account->AccountId);
+    sLogonSQL->Execute("UPDATE accounts SET lastlogin = NOW(), lastip = '%s', last_update = last_update WHERE id = %u;", GetRemoteIP().c_str(), m_account->AccountId);
     //RemoveReadBufferBytes(GetReadBufferSize(), true);
     readBuffer.Remove(readBuffer.GetSize());
 
@@ -30,6 +30,7 @@
 
 struct Patch;
 class PatchJob;
+struct AuthCryptoJob;
 
 class AuthSocket : public Socket
 {
@@ -56,6 +57,11 @@ class AuthSocket : public Socket
         void HandleTransferResume();
         void HandleTransferCancel();
 
+        // SRP6 calculations of HandleChallenge and HandleProof, run by AuthCryptoPool
+        static void calculateCryptoJob(AuthCryptoJob& job);
+        // Called by AuthCryptoPool when the job is calculated, may run on a crypto worker
+        void sendCryptoJobResult(AuthCryptoJob& job);
+
         // Server Packet Builders
         void SendChallengeError(uint8 Error);
         void SendProofError(uint8 Error, uint8* M2);
@@ -85,6 +91,12 @@ class AuthSocket : public Socket
         BigNumber m_sessionkey;
         time_t last_recv;
 
+        // SRP6 calculations of the last logon step
+        std::shared_ptr<AuthCryptoJob> m_cryptoJob;
+        bool startCryptoJob(std::shared_ptr<AuthCryptoJob> const& job);
+        // returns false while the job is not finished
+        bool takeCryptoJobResult();
+
     public:
 
         // Patching stuff
@@ -23,6 +23,7 @@
 #include <Server/Master.hpp>
 #include <iostream>
 #include <Server/AccountMgr.h>
+#include <Auth/AuthCryptoPool.hpp>
 #include <Server/IpBanMgr.h>
 #include <Network/Network.h>
 #include <LogonConf.h>
@@ -249,6 +250,8 @@ void LogonConsole::Info(char* /*str*/)
     std::cout << "-----------------------" << std::endl;
     std::cout << "CPU Usage: " << sLogon.getCPUUsage() << " %" << std::endl;
     std::cout << "RAM Usage: " << sLogon.getRAMUsage() << " MB" << std::endl;
+    std::cout << "Crypto Workers: " << sAuthCryptoPool.getWorkerCount() << " (" << sAuthCryptoPool.getQueuedJobCount() << " queued, "
+        << sAuthCryptoPool.getRejectedJobCount() << " rejected, " << sAuthCryptoPool.getAverageJobTime() << " us average)" << std::endl;
 }
 
 void LogonConsole::AccountCreate(char* str)
@@ -285,7 +288,7 @@ void LogonConsole::AccountCreate(char* str)
         return;
     }
 
-    sAccountMgr.reloadAccounts(true);
+    sAccountMgr.syncAccounts(true);
 
     std::cout << "Account created." << std::endl;
 }
@@ -314,7 +317,7 @@ void LogonConsole::AccountDelete(char* str)
         return;
     }
 
-    sAccountMgr.reloadAccounts(true);
+    sAccountMgr.removeAccount(name);
 
     std::cout << "Account deleted." << std::endl;
 }
@@ -350,7 +353,7 @@ void LogonConsole::AccountSetPassword(char* str)
         return;
     }
 
-    sAccountMgr.reloadAccounts(true);
+    sAccountMgr.syncAccounts(true);
 
     std::cout << "Account password updated." << std::endl;
 }
@@ -408,7 +411,7 @@ void LogonConsole::AccountChangePassword(char* str)
 
     }
 
-    sAccountMgr.reloadAccounts(true);
+    sAccountMgr.syncAccounts(true);
 
     std::cout << "Account password changed." << std::endl;
 }
@@ -30,8 +30,10 @@
 #include <Util/Strings.hpp>
 #include <Server/IpBanMgr.h>
 
+// accounts per snapshot part and delta packet
+static const uint32 accountSyncPartSize = 2048;
 
-LogonCommServerSocket::LogonCommServerSocket(SOCKET fd) : Socket(fd, 65536, 524288)
+LogonCommServerSocket::LogonCommServerSocket(SOCKET fd) : Socket(fd, 262144, 524288)
 {
     // do nothing
     last_ping = (uint32)UNIXTIME;
@@ -42,6 +44,10 @@ LogonCommServerSocket::LogonCommServerSocket(SOCKET fd) : Socket(fd, 65536, 5242
     authenticated = 0;
     seed = 0;
 
+    accountSyncActive = false;
+    accountSyncEpoch = 0;
+    accountSyncVersion = 0;
+
     sLogger.info("Created LogonCommServerSocket %u", m_fd);
 }
 
@@ -161,6 +167,10 @@ void LogonCommServerSocket::HandlePacket(WorldPacket & recvData)
         NULL,                                               // LRSMSG_ACCOUNT_RESULT
         &LogonCommServerSocket::HandleRequestAllAccounts,   // LRCMSG_ALL_ACCOUNT_REQUEST
         NULL,                                               // LRSMSG_ALL_ACCOUNT_RESULT
+        &LogonCommServerSocket::HandleAccountSyncRequest,   // LRCMSG_ACCOUNT_SYNC_REQUEST
+        NULL,                                               // LRSMSG_ACCOUNT_SYNC_SNAPSHOT
+        &LogonCommServerSocket::HandleAccountSnapshotAck,   // LRCMSG_ACCOUNT_SYNC_SNAPSHOT_ACK
+        NULL,                                               // LRSMSG_ACCOUNT_SYNC_DELTA
     };
 
     if (recvData.GetOpcode() >= LRMSG_MAX_OPCODES || Handlers[recvData.GetOpcode()] == 0)
@@ -244,7 +254,7 @@ void LogonCommServerSocket::HandleSessionRequest(WorldPacket & recvData)
     {
         // Append account information.
         data << acct->AccountId;
-        data << acct->UsernamePtr->c_str();
+        data << acct->Username.c_str();
         if (!acct->GMFlags)
             data << uint8(0);
         else
@@ -611,7 +621,7 @@ void LogonCommServerSocket::HandleDatabaseModify(WorldPacket & recvData)
                 SendPacket(&data);
                 //}
 
-                sAccountMgr.reloadAccounts(false);
+                sAccountMgr.syncAccounts(false);
             }
 
         }
@@ -656,6 +666,9 @@ void LogonCommServerSocket::HandleDatabaseModify(WorldPacket & recvData)
 
                 sLogonSQL->Query("INSERT INTO `accounts`(`acc_name`,`encrypted_password`,`banned`,`email`,`flags`,`banreason`) VALUES ('%s', SHA(UPPER('%s')),'0','','24','')", name_save.c_str(), pass.c_str());
 
+                // the name might be remembered as missing by the check above
+                sAccountMgr.syncAccounts(true);
+
                 result = Result_Account_Finished;
 
                 data << uint32(method);     // method_id
@@ -665,7 +678,7 @@ void LogonCommServerSocket::HandleDatabaseModify(WorldPacket & recvData)
                 SendPacket(&data);
             }
 
-            sAccountMgr.reloadAccounts(false);
+            sAccountMgr.syncAccounts(false);
         }
         break;
     }
@@ -756,31 +769,172 @@ void LogonCommServerSocket::HandleRequestCheckAccount(WorldPacket & recvData)
     SendPacket(&data);
 }
 
+// used by realms without account sync
 void LogonCommServerSocket::HandleRequestAllAccounts(WorldPacket& /*recvData*/)
 {
     std::string accountsArray;
-    auto accountMap = sAccountMgr.getAccountMap();
-
-    for (auto const map_itr :  accountMap)
-    {
-        std::string gm_flags;
 
-        if (map_itr.second->GMFlags)
-            gm_flags = map_itr.second->GMFlags;
-        else
-            gm_flags = "0";
+    std::vector<AccountSyncEntry> accounts;
+    uint32 epoch;
+    sAccountMgr.getAccountSnapshot(accounts, epoch);
 
-        accountsArray += std::to_string(map_itr.second->AccountId) + "," + map_itr.first + "," + (gm_flags.empty() ? "0" : gm_flags) + ";";
-    }
+    for (auto const& account : accounts)
+        accountsArray += std::to_string(account.accountId) + "," + account.name + "," + (account.gmFlags.empty() ? "0" : account.gmFlags) + ";";
 
     // remove last ; from string
-    accountsArray.pop_back();
+    if (!accountsArray.empty())
+        accountsArray.pop_back();
 
     WorldPacket data(LRSMSG_ALL_ACCOUNT_RESULT, 3000);
     data << accountsArray;
     SendPacket(&data);
 }
 
+// Writes the uncompressed size and the compressed accounts [begin, end) to data
+static bool appendCompressedAccounts(WorldPacket& data, std::vector<AccountSyncEntry> const& accounts, size_t begin, size_t end)
+{
+    ByteBuffer buffer((end - begin) * 24 + 4);
+    buffer << uint32(end - begin);
+
+    for (size_t i = begin; i < end; ++i)
+        buffer << uint8(accounts[i].type) << accounts[i].accountId << accounts[i].name << accounts[i].gmFlags;
+
+    const size_t offset = data.size();
+    uLongf compressedSize = compressBound((uLong)buffer.size());
+
+    data << uint32(buffer.size());
+    data.resize(offset + 4 + compressedSize);
+
+    if (compress2(data.contents() + offset + 4, &compressedSize, buffer.contents(), (uLong)buffer.size(), 1) != Z_OK)
+    {
+        sLogger.failure("Compress of account sync packet failed.");
+        return false;
+    }
+
+    data.resize(offset + 4 + compressedSize);
+    return true;
+}
+
+void LogonCommServerSocket::HandleAccountSyncRequest(WorldPacket& recvData)
+{
+    uint32 protocolVersion;
+    uint32 epoch;
+    uint64 version;
+    recvData >> protocolVersion >> epoch >> version;
+
+    if (protocolVersion != ACCOUNT_SYNC_PROTOCOL_VERSION)
+    {
+        sLogger.failure("Realm at %s requested account sync protocol %u, logonserver uses %u.", GetRemoteIP().c_str(), protocolVersion, ACCOUNT_SYNC_PROTOCOL_VERSION);
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(accountSyncLock);
+
+    accountSyncEpoch = epoch;
+    accountSyncVersion = version;
+    accountSyncActive = true;
+
+    // epoch 0 = the realm knows no accounts yet
+    if (epoch == 0 || !sendAccountChanges())
+        sendAccountSnapshot();
+    else
+        sLogger.info("Realm at %s resumed account sync at version %llu.", GetRemoteIP().c_str(), static_cast<unsigned long long>(version));
+}
+
+void LogonCommServerSocket::HandleAccountSnapshotAck(WorldPacket& recvData)
+{
+    uint32 epoch;
+    uint64 version;
+    uint32 nextPart;
+    recvData >> epoch >> version >> nextPart;
+
+    std::lock_guard<std::mutex> guard(accountSyncLock);
+
+    // acknowledges an older snapshot
+    if (accountSyncActive || epoch != accountSyncEpoch || version != accountSyncVersion)
+        return;
+
+    if (nextPart * accountSyncPartSize < accountSnapshot.size())
+    {
+        sendAccountSnapshotPart(nextPart);
+        return;
+    }
+
+    sLogger.info("Realm at %s received %u accounts.", GetRemoteIP().c_str(), static_cast<uint32>(accountSnapshot.size()));
+
+    accountSnapshot.clear();
+    accountSnapshot.shrink_to_fit();
+    accountSyncActive = true;
+
+    // changes made while the snapshot was sent
+    if (!sendAccountChanges())
+        sendAccountSnapshot();
+}
+
+void LogonCommServerSocket::PushAccountChanges()
+{
+    std::lock_guard<std::mutex> guard(accountSyncLock);
+
+    if (accountSyncActive && !sendAccountChanges())
+        sendAccountSnapshot();
+}
+
+bool LogonCommServerSocket::sendAccountChanges()
+{
+    std::vector<AccountSyncEntry> changes;
+    uint64 toVersion;
+    if (!sAccountMgr.getChangesSince(accountSyncEpoch, accountSyncVersion, changes, toVersion))
+        return false;
+
+    if (changes.empty())
+        return true;
+
+    // the rest is sent with the next push
+    const size_t count = std::min<size_t>(changes.size(), accountSyncPartSize);
+    toVersion = accountSyncVersion + count;
+
+    WorldPacket data(LRSMSG_ACCOUNT_SYNC_DELTA, count * 12 + 28);
+    data << accountSyncEpoch;
+    data << accountSyncVersion;
+    data << toVersion;
+    if (!appendCompressedAccounts(data, changes, 0, count))
+        return true;
+
+    SendPacket(&data);
+    accountSyncVersion = toVersion;
+    return true;
+}
+
+void LogonCommServerSocket::sendAccountSnapshot()
+{
+    accountSnapshot.clear();
+    accountSyncVersion = sAccountMgr.getAccountSnapshot(accountSnapshot, accountSyncEpoch);
+
+    // changes are pushed after the last part is acknowledged
+    accountSyncActive = false;
+
+    sLogger.info("Sending %u accounts to realm at %s.", static_cast<uint32>(accountSnapshot.size()), GetRemoteIP().c_str());
+
+    sendAccountSnapshotPart(0);
+}
+
+void LogonCommServerSocket::sendAccountSnapshotPart(uint32 part)
+{
+    const uint32 partCount = std::max<uint32>(1, static_cast<uint32>((accountSnapshot.size() + accountSyncPartSize - 1) / accountSyncPartSize));
+    const size_t begin = std::min<size_t>(size_t(part) * accountSyncPartSize, accountSnapshot.size());
+    const size_t end = std::min<size_t>(begin + accountSyncPartSize, accountSnapshot.size());
+
+    WorldPacket data(LRSMSG_ACCOUNT_SYNC_SNAPSHOT, (end - begin) * 12 + 28);
+    data << accountSyncEpoch;
+    data << accountSyncVersion;
+    data << part;
+    data << partCount;
+    if (!appendCompressedAccounts(data, accountSnapshot, begin, end))
+        return;
+
+    SendPacket(&data);
+}
+
 void LogonCommServerSocket::HandlePopulationRespond(WorldPacket & recvData)
 {
     float population;
@@ -23,8 +23,12 @@
 #include <RC4Engine.h>
 #include "CommonTypes.hpp"
 #include "Network/Socket.h"
+#include "Server/AccountMgr.h"
 #include "zlib.h"
 
+#include <mutex>
+#include <vector>
+
 class LogonCommServerSocket : public Socket
 {
     uint32 remaining;
@@ -33,6 +37,17 @@ class LogonCommServerSocket : public Socket
     RC4Engine sendCrypto;
     RC4Engine recvCrypto;
 
+    // account sync, guarded by accountSyncLock
+    std::mutex accountSyncLock;
+    bool accountSyncActive;                             // the realm knows all accounts, changes are pushed
+    uint32 accountSyncEpoch;
+    uint64 accountSyncVersion;                          // last version known by the realm
+    std::vector<AccountSyncEntry> accountSnapshot;      // all accounts until the realm acknowledged the last part
+
+    bool sendAccountChanges();
+    void sendAccountSnapshot();
+    void sendAccountSnapshotPart(uint32 part);
+
     public:
 
         uint32 authenticated;
@@ -60,8 +75,12 @@ class LogonCommServerSocket : public Socket
         void HandlePopulationRespond(WorldPacket& recvData);
         void HandleRequestCheckAccount(WorldPacket& recvData);
         void HandleRequestAllAccounts(WorldPacket& recvData);
+        void HandleAccountSyncRequest(WorldPacket& recvData);
+        void HandleAccountSnapshotAck(WorldPacket& recvData);
 
         void RefreshRealmsPop();
+        // sends the accounts changed since the last push, called by RealmManager
+        void PushAccountChanges();
 
         std::atomic<unsigned long> last_ping;
         bool removed;
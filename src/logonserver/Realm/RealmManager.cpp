@@ -279,6 +279,16 @@ namespace AscEmu::Realm
         this->serverSocketLock.Release();
     }
 
+    void RealmManager::pushAccountChanges()
+    {
+        this->serverSocketLock.Acquire();
+
+        for (auto commServerSocket : this->serverSockets)
+            commServerSocket->PushAccountChanges();
+
+        this->serverSocketLock.Release();
+    }
+
     void RealmManager::setRealmOffline(uint32_t realm_id)
     {
         this->realmLock.Acquire();
@@ -66,6 +66,8 @@ namespace AscEmu::Realm
 
         void timeoutSockets();
         void checkServers();
+        // sends the account changes to the realms, see LogonCommServerSocket::PushAccountChanges
+        void pushAccountChanges();
 
         void setRealmOffline(uint32_t realm_id);
         void setRealmPopulation(uint32_t realm_id, float population);
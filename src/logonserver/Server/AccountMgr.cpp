@@ -7,27 +7,54 @@ This file is released under the MIT license. See README-MIT for more information
 #include <Logging/Logger.hpp>
 #include <Log.hpp>
 #include <Auth/BigNumber.h>
+#include <Auth/Sha1.h>
 #include <Util/Strings.hpp>
 #include <Database/Database.h>
 #include "Master.hpp"
 
+// the last field is the time of the last change, used by syncAccounts
+static const char* accountQuery = "SELECT id, acc_name, encrypted_password, flags, banned, forceLanguage, muted, UNIX_TIMESTAMP(last_update) FROM accounts";
+
+// older changes are dropped, world servers missing them request all accounts again
+static const size_t maxChangeLogSize = 4096;
+
+// unknown names are not queried again for this many seconds, logons with wrong names must not hammer the database
+static const time_t missingAccountTime = 10;
+static const size_t maxMissingAccounts = 4096;
+
 AccountMgr& AccountMgr::getInstance()
 {
     static AccountMgr mInstance;
     return mInstance;
 }
 
-void AccountMgr::initialize(uint32_t reloadTime)
+void AccountMgr::initialize(uint32_t reloadTime, uint32_t fullReloadTime, bool preloadAccounts)
 {
-    sLogger.info("AccountMgr : Started precaching accounts...");
     m_reloadThread = nullptr;
     m_reloadTime = reloadTime;
+    m_fullReloadTime = fullReloadTime;
+    m_preloadAccounts = preloadAccounts;
+
+    if (m_preloadAccounts)
+    {
+        sLogger.info("AccountMgr : Started precaching accounts...");
+
+        reloadAccounts(true);
+
+        accountMgrMutex.Acquire();
+        _resetChangeLog();
+        accountMgrMutex.Release();
 
-    reloadAccounts(true);
+        sLogger.info("AccountMgr : loaded %u accounts.", static_cast<uint32_t>(getCount()));
+    }
+    else
+    {
+        reloadAccounts(true);
 
-    sLogger.info("AccountMgr : loaded %u accounts.", static_cast<uint32_t>(getCount()));
+        sLogger.info("AccountMgr : Accounts are loaded on first use");
+    }
 
-    m_reloadThread = std::make_unique<AscEmu::Threading::AEThread>("ReloadAccounts", [this](AscEmu::Threading::AEThread& /*thread*/) { this->reloadAccounts(false); }, std::chrono::seconds(m_reloadTime));
+    m_reloadThread = std::make_unique<AscEmu::Threading::AEThread>("ReloadAccounts", [this](AscEmu::Threading::AEThread& /*thread*/) { this->updateAccounts(); }, std::chrono::seconds(m_reloadTime));
 }
 
 void AccountMgr::finalize()
@@ -37,7 +64,7 @@ void AccountMgr::finalize()
     m_reloadThread->killAndJoin();
 }
 
-void AccountMgr::addAccount(Field* field)
+std::shared_ptr<Account> AccountMgr::addAccount(Field* field)
 {
     auto account = std::make_shared<Account>();
 
@@ -96,7 +123,10 @@ void AccountMgr::addAccount(Field* field)
 
     AscEmu::Util::Strings::toUpperCase(accountName);
 
-    _accountMap[accountName] = account;
+    account->Username = accountName;
+    _accountMap.insert_or_assign(accountName, account);
+
+    return account;
 }
 
 std::shared_ptr<Account> AccountMgr::getAccountByName(std::string& Name)
@@ -106,6 +136,10 @@ std::shared_ptr<Account> AccountMgr::getAccountByName(std::string& Name)
     auto pAccount = _getAccountByNameLockFree(Name);
 
     accountMgrMutex.Release();
+
+    if (pAccount == nullptr && !m_preloadAccounts)
+        pAccount = _loadAccount(Name);
+
     return pAccount;
 }
 
@@ -146,80 +180,238 @@ void AccountMgr::updateAccount(std::shared_ptr<Account> account, Field* field)
         sLogonSQL->Execute("UPDATE accounts SET muted = 0 WHERE id = %u", account->AccountId);
     }
 
+    uint8_t srpHash[20];
     if (encryptedPassword.size() == 40)
     {
         BigNumber bn;
         bn.SetHexStr(encryptedPassword.c_str());
         if (bn.GetNumBytes() < 20)
         {
-            memcpy(account->SrpHash, bn.AsByteArray(), bn.GetNumBytes());
+            memcpy(srpHash, bn.AsByteArray(), bn.GetNumBytes());
             for (auto n = bn.GetNumBytes(); n <= 19; n++)
-                account->SrpHash[n] = static_cast<uint8_t>(0);
+                srpHash[n] = static_cast<uint8_t>(0);
 
-            std::reverse(std::begin(account->SrpHash), std::end(account->SrpHash));
+            std::reverse(std::begin(srpHash), std::end(srpHash));
         }
         else
         {
-            memcpy(account->SrpHash, bn.AsByteArray(), 20);
-            std::reverse(std::begin(account->SrpHash), std::end(account->SrpHash));
+            memcpy(srpHash, bn.AsByteArray(), 20);
+            std::reverse(std::begin(srpHash), std::end(srpHash));
         }
     }
     else
     {
         sLogger.failure("Account `%s` has incorrect number of bytes in encrypted password! Disabling.", accountName.c_str());
-        memset(account->SrpHash, 0, 20);
+        memset(srpHash, 0, 20);
+    }
+
+    // the crypto workers read the hash while the accounts are reloaded
+    std::lock_guard<std::mutex> guard(m_srpMutex);
+    if (memcmp(account->SrpHash, srpHash, 20) != 0)
+    {
+        memcpy(account->SrpHash, srpHash, 20);
+        account->hasSrpVerifier = false;
     }
 }
 
-void AccountMgr::reloadAccounts(bool silent)
+void AccountMgr::getSrpVerifier(Account& account, BigNumber& g, BigNumber const& N, BigNumber& salt, BigNumber& verifier)
 {
-    accountMgrMutex.Acquire();
+    uint8_t srpHash[20];
+    {
+        std::lock_guard<std::mutex> guard(m_srpMutex);
+        if (account.hasSrpVerifier)
+        {
+            salt = account.SrpSalt;
+            verifier = account.SrpVerifier;
+            return;
+        }
+
+        memcpy(srpHash, account.SrpHash, 20);
+    }
+
+    // x = SHA1(s | SHA1(I | ":" | P)), v = g^x % N
+    // calculated without holding the lock, another worker might do the same for this account
+    salt.SetRand(256);
+
+    Sha1Hash sha;
+    sha.UpdateData(salt.AsByteArray(), 32);
+    sha.UpdateData(srpHash, 20);
+    sha.Finalize();
+
+    BigNumber x;
+    x.SetBinary(sha.GetDigest(), sha.GetLength());
+    verifier = g.ModExp(x, N);
+
+    std::lock_guard<std::mutex> guard(m_srpMutex);
+    if (account.hasSrpVerifier)
+    {
+        salt = account.SrpSalt;
+        verifier = account.SrpVerifier;
+    }
+    else if (memcmp(account.SrpHash, srpHash, 20) == 0)
+    {
+        account.SrpSalt = salt;
+        account.SrpVerifier = verifier;
+        account.hasSrpVerifier = true;
+    }
+}
 
+void AccountMgr::reloadAccounts(bool silent)
+{
     if (!silent)
         sLogger.info("[AccountMgr] Reloading Accounts...");
 
-    std::set<std::string> account_list;
+    if (!m_preloadAccounts)
+    {
+        // accounts are loaded again when they are used
+        const uint32_t lastChange = _getLastChangeTime();
+
+        accountMgrMutex.Acquire();
+
+        _accountMap.clear();
+        m_missingAccounts.clear();
+        m_lastChangeTime = lastChange;
+        m_lastChangeIds.clear();
+        m_lastFullReload = UNIXTIME;
+
+        // accounts deleted since the last reload are unknown, world servers have to request all accounts again
+        _resetChangeLog();
+
+        accountMgrMutex.Release();
+        return;
+    }
+
+    // the query runs without the lock, logons only wait for the accounts being updated
+    QueryResult* result = sLogonSQL->Query("%s", accountQuery);
+
+    accountMgrMutex.Acquire();
+
+    const uint32_t generation = ++m_reloadGeneration;
+    uint32_t lastChange = 0;
 
-    QueryResult* result = sLogonSQL->Query("SELECT id, acc_name, encrypted_password, flags, banned, forceLanguage, muted FROM accounts");
     if (result)
     {
         do
         {
             Field* field = result->Fetch();
-            std::string accountName = field[1].GetString();
-
-            AscEmu::Util::Strings::toUpperCase(accountName);
-
-            const auto account = _getAccountByNameLockFree(accountName);
-            if (account == nullptr)
-                addAccount(field);
-            else
-                updateAccount(account, field);
 
-            account_list.insert(accountName);
+            _syncAccount(field)->reloadGeneration = generation;
+            lastChange = std::max(lastChange, field[7].GetUInt32());
 
         } while (result->NextRow());
 
         delete result;
     }
 
+    // accounts not found in the table were deleted
     for (auto accounts = _accountMap.begin(); accounts != _accountMap.end();)
     {
-        auto accountsCopy = accounts;
-        ++accounts;
-
-        if (account_list.find(accountsCopy->first) == account_list.end())
-            _accountMap.erase(accountsCopy);
+        if (accounts->second->reloadGeneration != generation)
+        {
+            _recordChange(AccountSync_Removed, accounts->second->AccountId, accounts->first, nullptr);
+            accounts = _accountMap.erase(accounts);
+        }
         else
-            accountsCopy->second->UsernamePtr = const_cast<std::string*>(&accountsCopy->first);
+        {
+            ++accounts;
+        }
     }
 
+    m_lastChangeTime = lastChange;
+    m_lastChangeIds.clear();
+    m_lastFullReload = UNIXTIME;
+
     if (!silent)
         sLogger.info("[AccountMgr] Found %u accounts.", static_cast<uint32_t>(_accountMap.size()));
 
     accountMgrMutex.Release();
 }
 
+void AccountMgr::syncAccounts(bool silent)
+{
+    accountMgrMutex.Acquire();
+    const uint32_t lastChange = m_lastChangeTime;
+    accountMgrMutex.Release();
+
+    // rows changed in the same second as the last synced one are loaded again
+    QueryResult* result = sLogonSQL->Query("%s WHERE last_update >= FROM_UNIXTIME(%u)", accountQuery, lastChange);
+    if (result == nullptr)
+        return;
+
+    uint32_t count = 0;
+
+    accountMgrMutex.Acquire();
+
+    do
+    {
+        Field* field = result->Fetch();
+
+        const uint32_t accountId = field[0].GetUInt32();
+        const uint32_t changeTime = field[7].GetUInt32();
+
+        // loaded by the last sync already, the world servers know it
+        const bool isSynced = changeTime == m_lastChangeTime && m_lastChangeIds.count(accountId) != 0;
+
+        if (changeTime > m_lastChangeTime)
+        {
+            m_lastChangeTime = changeTime;
+            m_lastChangeIds.clear();
+        }
+
+        if (changeTime == m_lastChangeTime)
+            m_lastChangeIds.insert(accountId);
+
+        if (m_preloadAccounts)
+        {
+            _syncAccount(field);
+            ++count;
+            continue;
+        }
+
+        // accounts that are not cached yet are loaded when they are used
+        std::string accountName = field[1].GetString();
+        AscEmu::Util::Strings::toUpperCase(accountName);
+
+        // a new account is not missing anymore
+        m_missingAccounts.erase(accountName);
+
+        if (const auto account = _getAccountByNameLockFree(accountName))
+        {
+            updateAccount(account, field);
+            ++count;
+        }
+        else if (!isSynced)
+        {
+            // might be a new account, world servers replace the ones they know
+            _recordChange(AccountSync_Set, accountId, accountName, nullptr);
+        }
+
+    } while (result->NextRow());
+
+    accountMgrMutex.Release();
+
+    delete result;
+
+    if (!silent && count != 0)
+        sLogger.info("[AccountMgr] Synced %u changed accounts.", count);
+}
+
+void AccountMgr::removeAccount(std::string Name)
+{
+    AscEmu::Util::Strings::toUpperCase(Name);
+
+    accountMgrMutex.Acquire();
+
+    const auto itr = _accountMap.find(Name);
+    if (itr != _accountMap.end())
+    {
+        _recordChange(AccountSync_Removed, itr->second->AccountId, itr->first, nullptr);
+        _accountMap.erase(itr);
+    }
+
+    accountMgrMutex.Release();
+}
+
 size_t AccountMgr::getCount() const
 {
     return _accountMap.size();
@@ -230,6 +422,84 @@ std::map<std::string, std::shared_ptr<Account>> AccountMgr::getAccountMap() cons
     return _accountMap;
 }
 
+uint32_t AccountMgr::getSyncEpoch()
+{
+    accountMgrMutex.Acquire();
+    const uint32_t epoch = m_syncEpoch;
+    accountMgrMutex.Release();
+
+    return epoch;
+}
+
+uint64_t AccountMgr::getSyncVersion()
+{
+    accountMgrMutex.Acquire();
+    const uint64_t version = m_syncVersion;
+    accountMgrMutex.Release();
+
+    return version;
+}
+
+uint64_t AccountMgr::getAccountSnapshot(std::vector<AccountSyncEntry>& accounts, uint32_t& epoch)
+{
+    accountMgrMutex.Acquire();
+
+    epoch = m_syncEpoch;
+    const uint64_t version = m_syncVersion;
+
+    if (m_preloadAccounts)
+    {
+        accounts.reserve(_accountMap.size());
+        for (const auto& account : _accountMap)
+            accounts.push_back({ AccountSync_Set, account.second->AccountId, account.first, account.second->GMFlags ? account.second->GMFlags : "" });
+
+        accountMgrMutex.Release();
+        return version;
+    }
+
+    accountMgrMutex.Release();
+
+    // only the table knows all accounts, changes made meanwhile are part of the next delta
+    if (QueryResult* result = sLogonSQL->Query("SELECT id, acc_name FROM accounts"))
+    {
+        accounts.reserve(result->GetRowCount());
+
+        do
+        {
+            Field* field = result->Fetch();
+
+            std::string accountName = field[1].GetString();
+            AscEmu::Util::Strings::toUpperCase(accountName);
+
+            accounts.push_back({ AccountSync_Set, field[0].GetUInt32(), accountName, "" });
+
+        } while (result->NextRow());
+
+        delete result;
+    }
+
+    return version;
+}
+
+bool AccountMgr::getChangesSince(uint32_t epoch, uint64_t version, std::vector<AccountSyncEntry>& changes, uint64_t& toVersion)
+{
+    accountMgrMutex.Acquire();
+
+    // version of the oldest change in the log
+    const uint64_t firstVersion = m_syncVersion - m_changeLog.size() + 1;
+
+    const bool isInLog = epoch == m_syncEpoch && version <= m_syncVersion && version + 1 >= firstVersion;
+    if (isInLog)
+    {
+        changes.assign(m_changeLog.begin() + static_cast<std::ptrdiff_t>(version + 1 - firstVersion), m_changeLog.end());
+        toVersion = m_syncVersion;
+    }
+
+    accountMgrMutex.Release();
+
+    return isInLog;
+}
+
 std::shared_ptr<Account> AccountMgr::_getAccountByNameLockFree(std::string& Name)
 {
     const auto itr = _accountMap.find(Name);
@@ -238,3 +508,114 @@ std::shared_ptr<Account> AccountMgr::_getAccountByNameLockFree(std::string& Name
 
     return itr->second;
 }
+
+std::shared_ptr<Account> AccountMgr::_loadAccount(std::string& Name)
+{
+    std::string accountName = Name;
+    AscEmu::Util::Strings::toUpperCase(accountName);
+
+    accountMgrMutex.Acquire();
+    const auto missing = m_missingAccounts.find(accountName);
+    const bool isMissing = missing != m_missingAccounts.end() && missing->second > UNIXTIME;
+    accountMgrMutex.Release();
+
+    if (isMissing)
+        return nullptr;
+
+    QueryResult* result = sLogonSQL->Query("%s WHERE acc_name = '%s'", accountQuery, sLogonSQL->EscapeString(Name).c_str());
+    if (result == nullptr)
+    {
+        accountMgrMutex.Acquire();
+        _addMissingAccount(accountName);
+        accountMgrMutex.Release();
+
+        return nullptr;
+    }
+
+    accountMgrMutex.Acquire();
+    auto account = _syncAccount(result->Fetch());
+    accountMgrMutex.Release();
+
+    delete result;
+    return account;
+}
+
+std::shared_ptr<Account> AccountMgr::_syncAccount(Field* field)
+{
+    std::string accountName = field[1].GetString();
+    AscEmu::Util::Strings::toUpperCase(accountName);
+
+    auto account = _getAccountByNameLockFree(accountName);
+    if (account == nullptr)
+    {
+        // without preloading the account was only not cached yet
+        if (m_preloadAccounts)
+            _recordChange(AccountSync_Set, field[0].GetUInt32(), accountName, nullptr);
+
+        return addAccount(field);
+    }
+
+    updateAccount(account, field);
+    return account;
+}
+
+uint32_t AccountMgr::_getLastChangeTime()
+{
+    uint32_t lastChange = 0;
+
+    if (QueryResult* result = sLogonSQL->Query("SELECT UNIX_TIMESTAMP(MAX(last_update)) FROM accounts"))
+    {
+        lastChange = result->Fetch()[0].GetUInt32();
+        delete result;
+    }
+
+    return lastChange;
+}
+
+void AccountMgr::_addMissingAccount(std::string const& name)
+{
+    if (m_missingAccounts.size() >= maxMissingAccounts)
+    {
+        for (auto itr = m_missingAccounts.begin(); itr != m_missingAccounts.end();)
+        {
+            if (itr->second <= UNIXTIME)
+                itr = m_missingAccounts.erase(itr);
+            else
+                ++itr;
+        }
+
+        // flooded with names, they are queried again
+        if (m_missingAccounts.size() >= maxMissingAccounts)
+            m_missingAccounts.clear();
+    }
+
+    m_missingAccounts[name] = UNIXTIME + missingAccountTime;
+}
+
+void AccountMgr::_recordChange(AccountSyncChange type, uint32_t accountId, std::string const& name, char const* gmFlags)
+{
+    // the accounts are loaded for the first time
+    if (m_syncEpoch == 0)
+        return;
+
+    m_changeLog.push_back({ type, accountId, name, gmFlags ? gmFlags : "" });
+    ++m_syncVersion;
+
+    if (m_changeLog.size() > maxChangeLogSize)
+        m_changeLog.pop_front();
+}
+
+void AccountMgr::_resetChangeLog()
+{
+    // also a new epoch when the logonserver was restarted
+    m_syncEpoch = std::max(static_cast<uint32_t>(UNIXTIME), m_syncEpoch + 1);
+    m_changeLog.clear();
+}
+
+void AccountMgr::updateAccounts()
+{
+    if (m_fullReloadTime != 0 && UNIXTIME >= m_lastFullReload + static_cast<time_t>(m_fullReloadTime))
+        reloadAccounts(false);
+    else
+        syncAccounts(false);
+}
@@ -4,8 +4,15 @@ This file is released under the MIT license. See README-MIT for more information
 */
 
 #pragma once
+#include <Auth/BigNumber.h>
 #include <Database/Field.hpp>
 #include <Threading/AEThread.h>
+#include "LogonCommDefines.h"
+
+#include <deque>
+#include <mutex>
+#include <set>
+#include <vector>
 
 struct Account
 {
@@ -15,10 +22,18 @@ struct Account
     uint32_t Banned;
     uint8_t SrpHash[20]; // the encrypted password field, reversed
     uint8_t* SessionKey;
-    std::string* UsernamePtr;
+    std::string Username; // upper case, kept by value since the account outlives its entry in AccountMgr
     std::string forcedLanguage;
     uint32_t Muted;
 
+    // SRP6 salt and verifier (v = g^x % N), guarded by AccountMgr, see AccountMgr::getSrpVerifier
+    BigNumber SrpSalt;
+    BigNumber SrpVerifier;
+    bool hasSrpVerifier;
+
+    // set by AccountMgr::reloadAccounts to find the deleted accounts
+    uint32_t reloadGeneration;
+
     Account()
     {
         GMFlags = NULL;
@@ -28,7 +43,8 @@ struct Account
         Banned = 0;
         Muted = 0;
         forcedLocale = false;
-        UsernamePtr = nullptr;
+        hasSrpVerifier = false;
+        reloadGeneration = 0;
     }
 
     ~Account()
@@ -65,6 +81,15 @@ struct Account
 
 };
 
+// An account as the world servers know it, see LogonCommServerSocket::HandleAccountSyncRequest
+struct AccountSyncEntry
+{
+    AccountSyncChange type;
+    uint32_t accountId;
+    std::string name;
+    std::string gmFlags;
+};
+
 class AccountMgr
 {
 private:
@@ -73,7 +98,7 @@ private:
 
 public:
     static AccountMgr& getInstance();
-    void initialize(uint32_t reloadTime);
+    void initialize(uint32_t reloadTime, uint32_t fullReloadTime, bool preloadAccounts);
     void finalize();
 
     AccountMgr(AccountMgr&&) = delete;
@@ -81,25 +106,79 @@ public:
     AccountMgr& operator=(AccountMgr&&) = delete;
     AccountMgr& operator=(AccountMgr const&) = delete;
 
-    void addAccount(Field* field);
+    std::shared_ptr<Account> addAccount(Field* field);
 
+    // Loads the account from the database when it is not cached and accounts are not preloaded
     std::shared_ptr<Account> getAccountByName(std::string& Name);
 
     void updateAccount(std::shared_ptr<Account> account, Field* field);
+
+    // Copies the salt and verifier of the account, they are calculated once and kept until the password changes.
+    // Called by the crypto workers, generator g and safe prime N are the ones of the challenge.
+    void getSrpVerifier(Account& account, BigNumber& g, BigNumber const& N, BigNumber& salt, BigNumber& verifier);
+
+    // Loads the whole table again and drops deleted accounts.
+    // Without preloading the cached accounts are dropped, they are loaded again when they are used.
     void reloadAccounts(bool silent);
+    // Loads the accounts changed since the last sync or reload (accounts.last_update)
+    void syncAccounts(bool silent);
+    // Drops an account deleted from the database
+    void removeAccount(std::string Name);
 
     size_t getCount() const;
 
     std::map<std::string, std::shared_ptr<Account>> getAccountMap() const;
 
+    // Account sync with the world servers.
+    // Added, changed and deleted accounts are kept in a change log, every change increases the version.
+    // The log starts again with a new epoch when it misses changes (full reload without preloading),
+    // the world servers have to request all accounts then.
+    uint32_t getSyncEpoch();
+    uint64_t getSyncVersion();
+    // Copies all accounts, returns the version they belong to
+    uint64_t getAccountSnapshot(std::vector<AccountSyncEntry>& accounts, uint32_t& epoch);
+    // Copies the changes after version, returns false when they are not in the log anymore
+    bool getChangesSince(uint32_t epoch, uint64_t version, std::vector<AccountSyncEntry>& changes, uint64_t& toVersion);
+
 private:
 
     std::shared_ptr<Account> _getAccountByNameLockFree(std::string& Name);
+    std::shared_ptr<Account> _loadAccount(std::string& Name);
+    // adds or updates the account of the row, needs the lock
+    std::shared_ptr<Account> _syncAccount(Field* field);
+    uint32_t _getLastChangeTime();
+    // remembers a name not found in the table, needs the lock
+    void _addMissingAccount(std::string const& name);
+    // needs the lock
+    void _recordChange(AccountSyncChange type, uint32_t accountId, std::string const& name, char const* gmFlags);
+    void _resetChangeLog();
+
+    // called by m_reloadThread
+    void updateAccounts();
 
     std::map<std::string, std::shared_ptr<Account>> _accountMap;
 
     std::unique_ptr<AscEmu::Threading::AEThread> m_reloadThread;
     uint32_t m_reloadTime;
+    uint32_t m_fullReloadTime = 0;
+    bool m_preloadAccounts = true;
+
+    time_t m_lastFullReload = 0;
+    // unix time of the newest change seen by reloadAccounts and syncAccounts
+    uint32_t m_lastChangeTime = 0;
+    uint32_t m_reloadGeneration = 0;
+    // ids of the accounts changed in the second of m_lastChangeTime, syncAccounts loads them again
+    std::set<uint32_t> m_lastChangeIds;
+    // names not found by _loadAccount and the time until they are not queried again
+    std::map<std::string, time_t> m_missingAccounts;
+
+    // change log, the last change has version m_syncVersion
+    uint32_t m_syncEpoch = 0;
+    uint64_t m_syncVersion = 0;
+    std::deque<AccountSyncEntry> m_changeLog;
+
+    // guards SrpHash, SrpSalt, SrpVerifier and hasSrpVerifier of all accounts
+    std::mutex m_srpMutex;
 
 protected:
 
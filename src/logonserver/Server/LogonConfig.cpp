@@ -15,12 +15,19 @@ LogonConfig::LogonConfig()
 
     // logon.conf - Listen
     listen.port = 8093;
+    listen.networkThreads = 1;
+    listen.cryptoThreads = 2;
+    listen.cryptoQueueSize = 2000;
 
     // logon.conf - Logger
     logger.minimumMessageType = 2;
 
     // logon.conf - Rates
     rates.accountRefreshTime = 600;
+    rates.accountFullRefreshTime = 86400;
+
+    // logon.conf - AccountCache
+    accountCache.preload = true;
 }
 
 void LogonConfig::loadConfigValues(bool reload /*false*/)
@@ -51,12 +58,19 @@ void LogonConfig::loadConfigValues(bool reload /*false*/)
     Config.MainConfig.tryGetString("Listen", "ISHost", &listen.interServerHost);
     Config.MainConfig.tryGetInt("Listen", "RealmListPort", &listen.realmListPort);
     Config.MainConfig.tryGetInt("Listen", "ServerPort", &listen.port);
+    Config.MainConfig.tryGetInt("Listen", "NetworkThreads", &listen.networkThreads);
+    Config.MainConfig.tryGetInt("Listen", "CryptoThreads", &listen.cryptoThreads);
+    Config.MainConfig.tryGetInt("Listen", "CryptoQueueSize", &listen.cryptoQueueSize);
 
     // logon.conf - Logger Settings
     Config.MainConfig.tryGetInt("Logger", "MinimumMessageType", &logger.minimumMessageType);
 
     // logon.conf - Rates
     Config.MainConfig.tryGetInt("Rates", "AccountRefresh", &rates.accountRefreshTime);
+    Config.MainConfig.tryGetInt("Rates", "AccountFullRefresh", &rates.accountFullRefreshTime);
+
+    // logon.conf - AccountCache
+    Config.MainConfig.tryGetBool("AccountCache", "Preload", &accountCache.preload);
 
     // logon.conf - LogonServer
     Config.MainConfig.tryGetBool("LogonServer", "DisablePings", &logonServer.disablePings);
@@ -35,6 +35,9 @@ public:
         std::string interServerHost;
         uint32_t realmListPort;
         uint32_t port;
+        uint32_t networkThreads;
+        uint32_t cryptoThreads;
+        uint32_t cryptoQueueSize;
     } listen;
 
     // logon.conf - Logger Settings
@@ -47,8 +50,15 @@ public:
     struct Rates
     {
         uint32_t accountRefreshTime;
+        uint32_t accountFullRefreshTime;
     } rates;
 
+    // logon.conf - AccountCache
+    struct AccountCache
+    {
+        bool preload;
+    } accountCache;
+
     // logon.conf - LogonServer
     struct LogonServer
     {
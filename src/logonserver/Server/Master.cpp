@@ -10,6 +10,7 @@ This file is released under the MIT license. See README-MIT for more information
 #include "IpBanMgr.h"
 #include "Realm/RealmManager.hpp"
 #include "Auth/AuthSocket.h"
+#include "Auth/AuthCryptoPool.hpp"
 #include "Server/LogonServerDefines.hpp"
 #include "Server/Master.hpp"
 #include <Logging/Logger.hpp>
@@ -29,7 +30,7 @@ std::set<AuthSocket*> _authSockets;
 
 ConfigMgr Config;
 
-static const char* REQUIRED_LOGON_DB_VERSION = "20200221-00_utf8mb4_unicode_ci";
+static const char* REQUIRED_LOGON_DB_VERSION = "20211210-00_accounts_last_update";
 
 MasterLogon& MasterLogon::getInstance()
 {
@@ -84,18 +85,23 @@ void MasterLogon::Run(int /*argc*/, char** /*argv*/)
 
     sIpBanMgr.initialize();
 
-    sAccountMgr.initialize(logonConfig.rates.accountRefreshTime); // time in seconds
+    sAccountMgr.initialize(logonConfig.rates.accountRefreshTime, logonConfig.rates.accountFullRefreshTime, logonConfig.accountCache.preload); // time in seconds
 
     PatchMgr::getInstance().initialize();
 
     sRealmManager.initialize(300); // time in seconds
 
+    sAuthCryptoPool.initialize(logonConfig.listen.cryptoThreads, logonConfig.listen.cryptoQueueSize);
+
     // Load conf settings..
     clientMinBuild = 5875;
     clientMaxBuild = 15595;
 
     ThreadPool.ExecuteTask(new LogonConsoleThread);
 
+#ifdef CONFIG_USE_EPOLL
+    sSocketMgr.setWorkerThreadCount(logonConfig.listen.networkThreads);
+#endif
     sSocketMgr.initialize();
 
     auto realmlistSocket = new ListenSocket<AuthSocket>(logonConfig.listen.host.c_str(), logonConfig.listen.realmListPort);
@@ -137,6 +143,7 @@ void MasterLogon::Run(int /*argc*/, char** /*argv*/)
                 g_localTime = *localtime(&UNIXTIME);
             }
 
+            sRealmManager.pushAccountChanges();
             PatchMgr::getInstance().UpdateJobs();
             Arcemu::Sleep(1000);
         }
@@ -157,6 +164,7 @@ void MasterLogon::Run(int /*argc*/, char** /*argv*/)
     sSocketMgr.ShutdownThreads();
 #endif
     sLogonConsole.Kill();
+    sAuthCryptoPool.finalize();
     sAccountMgr.finalize();
     sRealmManager.finalize();
 
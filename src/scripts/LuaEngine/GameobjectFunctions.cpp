@@ -32,13 +32,13 @@ int LuaGameObject::GossipCreateMenu(lua_State* L, GameObject* ptr)
     if (!target || !ptr)
         return 0;
 
-    if (LuaGlobal::instance()->m_menu != NULL)
-        delete LuaGlobal::instance()->m_menu;
+    if (LuaGlobal::instance()->luaEngine()->m_menu != NULL)
+        delete LuaGlobal::instance()->luaEngine()->m_menu;
 
-    LuaGlobal::instance()->m_menu = new GossipMenu(ptr->getGuid(), text_id);
+    LuaGlobal::instance()->luaEngine()->m_menu = new GossipMenu(ptr->getGuid(), text_id);
 
     if (autosend)
-        LuaGlobal::instance()->m_menu->sendGossipPacket(target);
+        LuaGlobal::instance()->luaEngine()->m_menu->sendGossipPacket(target);
 
     return 0;
 }
@@ -52,13 +52,13 @@ int LuaGameObject::GossipMenuAddItem(lua_State* L, GameObject* /*ptr*/)
     const char* boxmessage = luaL_optstring(L, 5, "");
     uint32_t boxmoney = static_cast<uint32_t>(luaL_optinteger(L, 6, 0));
 
-    if (LuaGlobal::instance()->m_menu == NULL)
+    if (LuaGlobal::instance()->luaEngine()->m_menu == NULL)
     {
         DLLLogDetail("There is no menu to add items to!");
         return 0;
     }
 
-    LuaGlobal::instance()->m_menu->addItem(icon, 0, IntId, menu_text, boxmoney, boxmessage, coded);
+    LuaGlobal::instance()->luaEngine()->m_menu->addItem(icon, 0, IntId, menu_text, boxmoney, boxmessage, coded);
     return 0;
 }
 
@@ -68,13 +68,13 @@ int LuaGameObject::GossipSendMenu(lua_State* L, GameObject* /*ptr*/)
     if (!target)
         return 0;
 
-    if (LuaGlobal::instance()->m_menu == NULL)
+    if (LuaGlobal::instance()->luaEngine()->m_menu == NULL)
     {
         DLLLogDetail("There is no menu to send!");
         return 0;
     }
 
-    LuaGlobal::instance()->m_menu->sendGossipPacket(target);
+    LuaGlobal::instance()->luaEngine()->m_menu->sendGossipPacket(target);
 
     return 0;
 }
@@ -85,13 +85,13 @@ int LuaGameObject::GossipComplete(lua_State* L, GameObject* /*ptr*/)
     if (!target)
         return 0;
 
-    if (LuaGlobal::instance()->m_menu == NULL)
+    if (LuaGlobal::instance()->luaEngine()->m_menu == NULL)
     {
         DLLLogDetail("There is no menu to complete!");
         return 0;
     }
 
-    LuaGlobal::instance()->m_menu->senGossipComplete(target);
+    LuaGlobal::instance()->luaEngine()->m_menu->senGossipComplete(target);
 
     return 0;
 }
@@ -1122,7 +1122,7 @@ int LuaGameObject::RegisterEvent(lua_State* L, GameObject* ptr)
         functionRef = LuaHelpers::ExtractfRefFromCString(L, luaL_checkstring(L, 1));
     if (functionRef)
     {
-        TimedEvent* ev = TimedEvent::Allocate(ptr, new CallbackP1<LuaEngine, int>(LuaGlobal::instance()->luaEngine().get(), &LuaEngine::CallFunctionByReference, functionRef), EVENT_LUA_GAMEOBJ_EVENTS, delay, repeats);
+        TimedEvent* ev = TimedEvent::Allocate(ptr, new CallbackP1<LuaEngine, int>(LuaGlobal::instance()->luaEngine(), &LuaEngine::CallFunctionByReference, functionRef), EVENT_LUA_GAMEOBJ_EVENTS, delay, repeats);
         ptr->event_AddEvent(ev);
         std::map<uint64_t, std::set<int>>& objRefs = LuaGlobal::instance()->luaEngine()->getObjectFunctionRefs();
         std::map<uint64_t, std::set<int>>::iterator itr = objRefs.find(ptr->getGuid());
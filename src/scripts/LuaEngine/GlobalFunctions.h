@@ -713,6 +713,64 @@ namespace luaGlobalFunctions
         lua_pushnumber(L, guild ? guild->getId() : -1);
         return 1;
     }
+
+    // Lua globals belong to the state of one map, these values are seen by all of them
+    int SetSharedValue(lua_State* L)
+    {
+        const char* key = luaL_checkstring(L, 1);
+
+        LuaSharedValue value;
+        switch (lua_type(L, 2))
+        {
+            case LUA_TNONE:
+            case LUA_TNIL:
+                break;
+            case LUA_TBOOLEAN:
+                value.type = LuaSharedValue::Boolean;
+                value.number = lua_toboolean(L, 2) ? 1.0 : 0.0;
+                break;
+            case LUA_TNUMBER:
+                value.type = LuaSharedValue::Number;
+                value.number = lua_tonumber(L, 2);
+                break;
+            case LUA_TSTRING:
+                value.type = LuaSharedValue::String;
+                value.string = lua_tostring(L, 2);
+                break;
+            default:
+                return luaL_error(L, "SetSharedValue: only booleans, numbers and strings can be shared, got %s", luaL_typename(L, 2));
+        }
+
+        LuaGlobal::instance()->setSharedValue(key, value);
+        return 0;
+    }
+
+    int GetSharedValue(lua_State* L)
+    {
+        const char* key = luaL_checkstring(L, 1);
+
+        const LuaSharedValue value = LuaGlobal::instance()->getSharedValue(key);
+        switch (value.type)
+        {
+            case LuaSharedValue::Boolean:
+                RET_BOOL(value.number != 0.0)
+            case LuaSharedValue::Number:
+                RET_NUMBER(value.number)
+            case LuaSharedValue::String:
+                RET_STRING(value.string.c_str())
+            default:
+                RET_NIL()
+        }
+    }
+
+    // adds to a shared number in one step, so counters do not lose updates of other maps
+    int AddSharedValue(lua_State* L)
+    {
+        const char* key = luaL_checkstring(L, 1);
+        const double value = luaL_optnumber(L, 2, 1.0);
+
+        RET_NUMBER(LuaGlobal::instance()->addSharedValue(key, value))
+    }
 }
 
 void RegisterGlobalFunctions(lua_State* L)
@@ -766,6 +824,9 @@ void RegisterGlobalFunctions(lua_State* L)
     lua_register(L, "GetPlayersInInstance", &luaGlobalFunctions::GetPlayersInInstance);
     lua_register(L, "GetGuildByName", &luaGlobalFunctions::GetGuildByName);
     lua_register(L, "GetGuildByLeaderGuid", &luaGlobalFunctions::GetGuildByLeaderGuid);
+    lua_register(L, "SetSharedValue", &luaGlobalFunctions::SetSharedValue);
+    lua_register(L, "GetSharedValue", &luaGlobalFunctions::GetSharedValue);
+    lua_register(L, "AddSharedValue", &luaGlobalFunctions::AddSharedValue);
 }
 
 #endif      // GLOBALFUNCTIONS_H
@@ -15,6 +15,9 @@ This file is released under the MIT license. See README-MIT for more information
 #include "Map/MapMgr.h"
 #include "Server/Script/ScriptSetup.h"
 #include <WorldConf.h>
+#include <functional>
+#include <tuple>
+#include <type_traits>
 
 #ifndef _WIN32
 #include <dirent.h>
@@ -43,7 +46,7 @@ extern "C" SCRIPT_DECL uint32_t _exp_get_script_type()
 extern "C" SCRIPT_DECL void _exp_script_register(ScriptMgr* mgr)
 {
     m_scriptMgr = mgr;
-    LuaGlobal::instance()->luaEngine()->Startup();
+    LuaGlobal::instance()->getMainEngine()->Startup();
 }
 
 extern "C" SCRIPT_DECL void _exp_engine_unload()
@@ -53,7 +56,33 @@ extern "C" SCRIPT_DECL void _exp_engine_unload()
 
 extern "C" SCRIPT_DECL void _export_engine_reload()
 {
-    LuaGlobal::instance()->luaEngine()->Restart();
+    LuaGlobal::instance()->getMainEngine()->Restart();
+
+    for (auto& mapEngine : LuaGlobal::instance()->getMapEngines())
+        mapEngine->Restart();
+}
+
+extern "C" SCRIPT_DECL void _export_engine_profile(std::ostream& out, uint32_t count)
+{
+    if (!worldConfig.luaEngine.profileCalls)
+        out << "Lua call profiling is disabled, enable it with LuaEngine.ProfileCalls.\n";
+
+    std::vector<LuaFunctionProfile> profiles = LuaGlobal::instance()->getMainEngine()->getProfiles();
+    for (auto& mapEngine : LuaGlobal::instance()->getMapEngines())
+    {
+        const auto mapProfiles = mapEngine->getProfiles();
+        profiles.insert(profiles.end(), mapProfiles.begin(), mapProfiles.end());
+    }
+
+    LuaProfiler::writeReport(out, profiles, count);
+}
+
+extern "C" SCRIPT_DECL void _export_engine_profile_reset()
+{
+    LuaGlobal::instance()->getMainEngine()->resetProfiles();
+
+    for (auto& mapEngine : LuaGlobal::instance()->getMapEngines())
+        mapEngine->resetProfiles();
 }
 
 void report(lua_State* L)
@@ -69,7 +98,7 @@ void report(lua_State* L)
     }
 }
 
-LuaEngine::LuaEngine() : lu(nullptr) {}
+LuaEngine::LuaEngine() : lu(nullptr), m_callType(LUA_CALL_OTHER), m_callEntry(0), m_instructionBudgetExceeded(false), m_callDepth(0), m_instructionCount(0), m_menu(nullptr) {}
 
 void LuaEngine::ScriptLoadDir(const std::string Dirname, LUALoadScripts* pak)
 {
@@ -131,10 +160,13 @@ void LuaEngine::LoadScripts()
 //////////////////////////////////////////////////////////////////////////////////////////
 // FUNCTION CALL METHODS
 
-void LuaEngine::BeginCall(uint16_t fReference)
+void LuaEngine::BeginCall(uint16_t fReference, LuaCallType type, uint32_t entry)
 {
     lua_settop(lu, 0); //stack should be empty
     lua_rawgeti(lu, LUA_REGISTRYINDEX, fReference);
+
+    m_callType = type;
+    m_callEntry = entry;
 }
 
 bool LuaEngine::ExecuteCall(uint8_t params, uint8_t res)
@@ -154,7 +186,7 @@ bool LuaEngine::ExecuteCall(uint8_t params, uint8_t res)
     }
     else
     {
-        if (lua_pcall(lu, params, res, 0))
+        if (ProtectedCall(params, res, m_callType, m_callEntry))
         {
             report(lu);
             ret = false;
@@ -169,6 +201,95 @@ void LuaEngine::EndCall(uint8_t res)
             lua_remove(lu, res);
 }
 
+// instructions run between two calls of the hook
+static const uint32_t instructionBudgetStep = 1000;
+
+// aborts the running script, the error is raised in the script like any other.
+// Once the budget is used up every later step fails too, until the outermost call returned.
+static void InstructionBudgetHook(lua_State* L, lua_Debug* /*ar*/)
+{
+    if (LuaGlobal::instance()->luaEngine()->countInstructions(lua_gethookcount(L)))
+        luaL_error(L, "script exceeded the instruction budget of %u", worldConfig.luaEngine.instructionBudget);
+}
+
+// The hook stays set between the calls: setting it again restarts the count of the thread,
+// a nested call would give a running outer call a new budget.
+static void SetInstructionBudget(lua_State* L)
+{
+    const uint32_t budget = worldConfig.luaEngine.instructionBudget;
+    if (budget != 0)
+    {
+        const int step = static_cast<int>(std::min(budget, instructionBudgetStep));
+        if (lua_gethook(L) != &InstructionBudgetHook || lua_gethookcount(L) != step)
+            lua_sethook(L, &InstructionBudgetHook, LUA_MASKCOUNT, step);
+    }
+    else if (lua_gethook(L) != nullptr)
+    {
+        lua_sethook(L, nullptr, 0, 0);
+    }
+}
+
+bool LuaEngine::countInstructions(int count)
+{
+    m_instructionCount += static_cast<uint64_t>(count);
+    if (m_instructionCount < worldConfig.luaEngine.instructionBudget)
+        return false;
+
+    m_instructionBudgetExceeded = true;
+    return true;
+}
+
+int LuaEngine::ProtectedCall(int params, int results, LuaCallType type, uint32_t entry)
+{
+    LuaFunctionProfile* profile = nullptr;
+    if (worldConfig.luaEngine.profileCalls)
+    {
+        lua_Debug ar;
+        lua_pushvalue(lu, -(params + 1));
+        if (lua_isfunction(lu, -1) && lua_getinfo(lu, ">S", &ar))
+            profile = &m_profiler.getProfile(type, entry, ar.source, ar.short_src, ar.linedefined);
+        else
+            lua_pop(lu, 1);
+    }
+
+    // calls made by the script count against the budget of the outermost call
+    if (m_callDepth++ == 0)
+        m_instructionCount = 0;
+
+    const bool outerBudgetExceeded = m_instructionBudgetExceeded;
+    m_instructionBudgetExceeded = false;
+    SetInstructionBudget(lu);
+
+    const auto startTime = LuaProfiler::now();
+    const int result = lua_pcall(lu, params, results, 0);
+    --m_callDepth;
+
+    if (profile != nullptr)
+        m_profiler.record(*profile, startTime, result != 0, m_instructionBudgetExceeded);
+
+    m_instructionBudgetExceeded = outerBudgetExceeded;
+    return result;
+}
+
+std::vector<LuaFunctionProfile> LuaEngine::getProfiles()
+{
+    // only called from the console, which is inside no state
+    if (!LuaGlobal::instance()->enterEngine(this))
+        return {};
+
+    std::vector<LuaFunctionProfile> profiles = m_profiler.getProfiles();
+    RELEASE_LOCK
+
+    return profiles;
+}
+
+void LuaEngine::resetProfiles()
+{
+    GET_ENGINE_LOCK(this)
+    m_profiler.reset();
+    RELEASE_LOCK
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // PUSH METHODS
 
@@ -270,7 +391,12 @@ END PUSH METHODS
 
 void LuaEngine::HyperCallFunction(const char* FuncName, int ref)  //hyper as in hypersniper :3
 {
-    GET_LOCK
+    if (!LuaGlobal::instance()->enterEngine(this))
+    {
+        postCall(new CallbackP2<LuaEngine, const char*, int>(this, &LuaEngine::HyperCallFunction, FuncName, ref));
+        return;
+    }
+
     std::string sFuncName = std::string(FuncName);
     char* copy = strdup(FuncName);
     char* token = strtok(copy, ".:");
@@ -336,8 +462,8 @@ void LuaEngine::HyperCallFunction(const char* FuncName, int ref)  //hyper as in
         {
             free((void*)FuncName);
             luaL_unref(lu, LUA_REGISTRYINDEX, ref);
-            const auto itr = LuaGlobal::instance()->luaEngine()->m_registeredTimedEvents.find(ref);
-            LuaGlobal::instance()->luaEngine()->m_registeredTimedEvents.erase(itr);
+            const auto itr = m_registeredTimedEvents.find(ref);
+            m_registeredTimedEvents.erase(itr);
         }
         else
         {
@@ -347,7 +473,7 @@ void LuaEngine::HyperCallFunction(const char* FuncName, int ref)  //hyper as in
         }
     }
     lua_remove(lu, thread); //now we can remove the thread object
-    int r = lua_pcall(lu, nargs + (colon ? 1 : 0), 0, 0);
+    int r = ProtectedCall(nargs + (colon ? 1 : 0), 0, LUA_CALL_EVENT, 0);
     if (r)
         report(lu);
 
@@ -368,9 +494,10 @@ static int CreateLuaEvent(lua_State* L)
     {
         lua_settop(L, 1);
         int functionRef = luaL_ref(L, LUA_REGISTRYINDEX);
-        TimedEvent* ev = TimedEvent::Allocate(&sWorld, new CallbackP1<LuaEngine, int>(LuaGlobal::instance()->luaEngine().get(), &LuaEngine::CallFunctionByReference, functionRef), 0, delay, repeats);
+        // held by the event manager of the state, the references of the other states use the same numbers
+        TimedEvent* ev = TimedEvent::Allocate(&sLuaEventMgr, new CallbackP1<LuaEngine, int>(LuaGlobal::instance()->luaEngine(), &LuaEngine::CallFunctionByReference, functionRef), 0, delay, repeats);
         ev->eventType = LUA_EVENTS_END + functionRef; //Create custom reference by adding the ref number to the max lua event type to get a unique reference for every function.
-        sWorld.event_AddEvent(ev);
+        sLuaEventMgr.event_AddEvent(ev);
         LuaGlobal::instance()->luaEngine()->getFunctionRefs().insert(functionRef);
         lua_pushinteger(L, functionRef);
     }
@@ -385,10 +512,14 @@ static int CreateLuaEvent(lua_State* L)
 
 void LuaEngine::CallFunctionByReference(int ref)
 {
-    GET_LOCK
+    if (!LuaGlobal::instance()->enterEngine(this))
+    {
+        postCall(new CallbackP1<LuaEngine, int>(this, &LuaEngine::CallFunctionByReference, ref));
+        return;
+    }
 
     lua_rawgeti(lu, LUA_REGISTRYINDEX, ref);
-    if (lua_pcall(lu, 0, 0, 0))
+    if (ProtectedCall(0, 0, LUA_CALL_EVENT, 0))
         report(lu);
 
     RELEASE_LOCK
@@ -396,12 +527,12 @@ void LuaEngine::CallFunctionByReference(int ref)
 
 void LuaEngine::DestroyAllLuaEvents()
 {
-    GET_LOCK
+    GET_ENGINE_LOCK(this)
 
     //Clean up for all events.
     for (auto itr = m_functionRefs.begin(); itr != m_functionRefs.end(); ++itr)
     {
-        sEventMgr.RemoveEvents(&sWorld, (*itr) + LUA_EVENTS_END);
+        sEventMgr.RemoveEvents(&LuaEventMgr, (*itr) + LUA_EVENTS_END);
         luaL_unref(lu, LUA_REGISTRYINDEX, (*itr));
     }
     m_functionRefs.clear();
@@ -409,6 +540,12 @@ void LuaEngine::DestroyAllLuaEvents()
     RELEASE_LOCK
 }
 
+void LuaEngine::postCall(CallbackBase* callback)
+{
+    // the holder runs its events outside of every state, so the state is entered there
+    LuaEventMgr.event_AddEvent(TimedEvent::Allocate(&LuaEventMgr, callback, EVENT_LUA_POSTED_CALL, 1, 1));
+}
+
 static int ModifyLuaEventInterval(lua_State* L)
 {
     GET_LOCK
@@ -417,7 +554,7 @@ static int ModifyLuaEventInterval(lua_State* L)
     int newinterval = static_cast<int>(luaL_checkinteger(L, 2));
     ref += LUA_EVENTS_END;
     //Easy interval modification.
-    sEventMgr.ModifyEventTime(&sWorld, ref, newinterval);
+    sEventMgr.ModifyEventTime(&sLuaEventMgr, ref, newinterval);
 
     RELEASE_LOCK
 
@@ -432,7 +569,7 @@ static int DestroyLuaEvent(lua_State* L)
     int ref = static_cast<int>(luaL_checkinteger(L, 1));
     luaL_unref(L, LUA_REGISTRYINDEX, ref);
     LuaGlobal::instance()->luaEngine()->getFunctionRefs().erase(ref);
-    sEventMgr.RemoveEvents(&sWorld, ref + LUA_EVENTS_END);
+    sEventMgr.RemoveEvents(&sLuaEventMgr, ref + LUA_EVENTS_END);
 
     RELEASE_LOCK
 
@@ -517,7 +654,7 @@ static int RegisterDummySpell(lua_State* L)
     if (!entry || typeName == nullptr)
         return 0;
 
-    if (LuaGlobal::instance()->m_luaDummySpells.find(entry) != LuaGlobal::instance()->m_luaDummySpells.end())
+    if (LuaGlobal::instance()->luaEngine()->m_luaDummySpells.find(entry) != LuaGlobal::instance()->luaEngine()->m_luaDummySpells.end())
         luaL_error(L, "LuaEngineMgr : RegisterDummySpell failed! Spell %d already has a registered Lua function!", entry);
     if (!strcmp(typeName, "function"))
         functionRef = static_cast<uint16_t>(luaL_ref(L, LUA_REGISTRYINDEX));
@@ -714,7 +851,7 @@ static int SuspendLuaThread(lua_State* L)
     if (ref == LUA_REFNIL || ref == LUA_NOREF)
         return luaL_error(L, "Error in SuspendLuaThread! Failed to create a valid reference.");
 
-    TimedEvent* evt = TimedEvent::Allocate(thread, new CallbackP1<LuaEngine, int>(LuaGlobal::instance()->luaEngine().get(), &LuaEngine::ResumeLuaThread, ref), 0, waitime, 1);
+    TimedEvent* evt = TimedEvent::Allocate(thread, new CallbackP1<LuaEngine, int>(LuaGlobal::instance()->luaEngine(), &LuaEngine::ResumeLuaThread, ref), 0, waitime, 1);
     sWorld.event_AddEvent(evt);
     lua_remove(L, 1); // remove thread object
     lua_remove(L, 1); // remove timer.
@@ -750,7 +887,7 @@ static int RegisterTimedEvent(lua_State* L)  //in this case, L == lu
         return luaL_error(L, "Error in RegisterTimedEvent! Failed to create a valid reference.");
     }
    
-    TimedEvent* te = TimedEvent::Allocate(LuaGlobal::instance()->luaEngine().get(), new CallbackP2<LuaEngine, const char*, int>(LuaGlobal::instance()->luaEngine().get(), &LuaEngine::HyperCallFunction, funcName, ref), EVENT_LUA_TIMED, delay, repeats);
+    TimedEvent* te = TimedEvent::Allocate(LuaGlobal::instance()->luaEngine(), new CallbackP2<LuaEngine, const char*, int>(LuaGlobal::instance()->luaEngine(), &LuaEngine::HyperCallFunction, funcName, ref), EVENT_LUA_TIMED, delay, repeats);
     EventInfoHolder* ek = new EventInfoHolder;
     ek->funcName = funcName;
     ek->te = te;
@@ -775,9 +912,9 @@ bool LuaHookOnNewCharacter(uint32_t Race, uint32_t Class, WorldSession* /*Sessio
     GET_LOCK
 
     bool result = true;
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_NEW_CHARACTER])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_NEW_CHARACTER])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_NEW_CHARACTER);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_NEW_CHARACTER);
         LuaGlobal::instance()->luaEngine()->PUSH_STRING(Name);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(Race);
@@ -800,9 +937,9 @@ void LuaHookOnKillPlayer(Player* pPlayer, Player* pVictim)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_KILL_PLAYER])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_KILL_PLAYER])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_KILL_PLAYER);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_KILL_PLAYER);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PushUnit(pVictim);
@@ -816,9 +953,9 @@ void LuaHookOnFirstEnterWorld(Player* pPlayer)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_FIRST_ENTER_WORLD])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_FIRST_ENTER_WORLD])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_FIRST_ENTER_WORLD);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_FIRST_ENTER_WORLD);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -831,9 +968,9 @@ void LuaHookOnEnterWorld(Player* pPlayer)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_ENTER_WORLD])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_ENTER_WORLD])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_ENTER_WORLD);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_ENTER_WORLD);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -846,9 +983,9 @@ void LuaHookOnGuildJoin(Player* pPlayer, Guild* pGuild)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_GUILD_JOIN])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_GUILD_JOIN])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_GUILD_JOIN);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_GUILD_JOIN);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PUSH_STRING(pGuild->getNameChar());
@@ -862,9 +999,9 @@ void LuaHookOnDeath(Player* pPlayer)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_DEATH])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_DEATH])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_DEATH);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_DEATH);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -878,9 +1015,9 @@ bool LuaHookOnRepop(Player* pPlayer)
     GET_LOCK
 
     bool result = true;
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_REPOP])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_REPOP])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_REPOP);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_REPOP);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         if (LuaGlobal::instance()->luaEngine()->ExecuteCall(2, 1))
@@ -901,9 +1038,9 @@ void LuaHookOnEmote(Player* pPlayer, uint32_t Emote, Unit* pUnit)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_EMOTE])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_EMOTE])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_EMOTE);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_EMOTE);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PushUnit(pUnit);
@@ -918,9 +1055,9 @@ void LuaHookOnEnterCombat(Player* pPlayer, Unit* pTarget)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_ENTER_COMBAT])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_ENTER_COMBAT])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_ENTER_COMBAT);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_ENTER_COMBAT);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PushUnit(pTarget);
@@ -935,9 +1072,9 @@ bool LuaHookOnCastSpell(Player* pPlayer, SpellInfo const* pSpell, Spell* spell)
     GET_LOCK
 
     bool result = true;
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_CAST_SPELL])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_CAST_SPELL])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_CAST_SPELL);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_CAST_SPELL);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(pSpell->getId());
@@ -961,9 +1098,9 @@ void LuaHookOnTick()
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_TICK])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_TICK])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_TICK);
         LuaGlobal::instance()->luaEngine()->ExecuteCall();
     }
 
@@ -975,9 +1112,9 @@ bool LuaHookOnLogoutRequest(Player* pPlayer)
     GET_LOCK
 
     bool result = true;
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_LOGOUT_REQUEST])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_LOGOUT_REQUEST])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_LOGOUT_REQUEST);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_LOGOUT_REQUEST);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         if (LuaGlobal::instance()->luaEngine()->ExecuteCall(2, 1))
@@ -999,9 +1136,9 @@ void LuaHookOnLogout(Player* pPlayer)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_LOGOUT])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_LOGOUT])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_LOGOUT);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_LOGOUT);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -1014,9 +1151,9 @@ void LuaHookOnQuestAccept(Player* pPlayer, QuestProperties* pQuest, Object* pQue
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_QUEST_ACCEPT])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_QUEST_ACCEPT])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_QUEST_ACCEPT);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_QUEST_ACCEPT);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(pQuest->id);
@@ -1042,9 +1179,9 @@ void LuaHookOnZone(Player* pPlayer, uint32_t Zone, uint32_t oldZone)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_ZONE])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_ZONE])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_ZONE);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_ZONE);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(Zone);
@@ -1060,9 +1197,9 @@ bool LuaHookOnChat(Player* pPlayer, uint32_t Type, uint32_t Lang, const char* Me
     GET_LOCK
 
     bool result = true;
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_CHAT])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_CHAT])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_CHAT);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_CHAT);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PUSH_STRING(Message);
@@ -1088,9 +1225,9 @@ void LuaHookOnLoot(Player* pPlayer, Unit* pTarget, uint32_t Money, uint32_t Item
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_LOOT])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_LOOT])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_LOOT);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_LOOT);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PushUnit(pTarget);
@@ -1106,9 +1243,9 @@ void LuaHookOnGuildCreate(Player* pLeader, Guild* pGuild)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_GUILD_CREATE])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_GUILD_CREATE])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_GUILD_CREATE);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_GUILD_CREATE);
         LuaGlobal::instance()->luaEngine()->PushUnit(pLeader);
         LuaGlobal::instance()->luaEngine()->PUSH_STRING(pGuild->getNameChar());
@@ -1122,9 +1259,9 @@ void LuaHookOnEnterWorld2(Player* pPlayer)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_FULL_LOGIN])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_FULL_LOGIN])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_FULL_LOGIN);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_FULL_LOGIN);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -1137,9 +1274,9 @@ void LuaHookOnCharacterCreate(Player* pPlayer)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_CHARACTER_CREATE])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_CHARACTER_CREATE])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_CHARACTER_CREATE);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_CHARACTER_CREATE);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -1152,9 +1289,9 @@ void LuaHookOnQuestCancelled(Player* pPlayer, QuestProperties* pQuest)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_QUEST_CANCELLED])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_QUEST_CANCELLED])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_QUEST_CANCELLED);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_QUEST_CANCELLED);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(pQuest->id);
@@ -1168,9 +1305,9 @@ void LuaHookOnQuestFinished(Player* pPlayer, QuestProperties* pQuest, Object* pQ
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_QUEST_FINISHED])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_QUEST_FINISHED])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_QUEST_FINISHED);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_QUEST_FINISHED);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(pQuest->id);
@@ -1196,9 +1333,9 @@ void LuaHookOnHonorableKill(Player* pPlayer, Player* pKilled)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_HONORABLE_KILL])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_HONORABLE_KILL])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_HONORABLE_KILL);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_HONORABLE_KILL);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PushUnit(pKilled);
@@ -1212,9 +1349,9 @@ void LuaHookOnArenaFinish(Player* pPlayer, ArenaTeam* pTeam, bool victory, bool
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_ARENA_FINISH])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_ARENA_FINISH])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_ARENA_FINISH);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_ARENA_FINISH);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PUSH_STRING(pTeam->m_name.c_str());
@@ -1230,9 +1367,9 @@ void LuaHookOnObjectLoot(Player* pPlayer, Object* pTarget, uint32_t Money, uint3
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_OBJECTLOOT])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_OBJECTLOOT])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_OBJECTLOOT);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_OBJECTLOOT);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PushUnit(pTarget);
@@ -1248,9 +1385,9 @@ void LuaHookOnAreaTrigger(Player* pPlayer, uint32_t areaTrigger)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_AREATRIGGER])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_AREATRIGGER])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_AREATRIGGER);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_AREATRIGGER);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(areaTrigger);
@@ -1264,9 +1401,9 @@ void LuaHookOnPostLevelUp(Player* pPlayer)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_POST_LEVELUP])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_POST_LEVELUP])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_POST_LEVELUP);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_POST_LEVELUP);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -1280,9 +1417,9 @@ bool LuaHookOnPreUnitDie(Unit* Killer, Unit* Victim)
     GET_LOCK
 
     bool result = true;
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_PRE_DIE])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_PRE_DIE])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_PRE_DIE);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_PRE_DIE);
         LuaGlobal::instance()->luaEngine()->PushUnit(Killer);
         LuaGlobal::instance()->luaEngine()->PushUnit(Victim);
@@ -1305,9 +1442,9 @@ void LuaHookOnAdvanceSkillLine(Player* pPlayer, uint32_t SkillLine, uint32_t Cur
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_ADVANCE_SKILLLINE])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_ADVANCE_SKILLLINE])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_ADVANCE_SKILLLINE);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_ADVANCE_SKILLLINE);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(SkillLine);
@@ -1322,9 +1459,9 @@ void LuaHookOnDuelFinished(Player* pWinner, Player* pLoser)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_DUEL_FINISHED])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_DUEL_FINISHED])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_DUEL_FINISHED);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_DUEL_FINISHED);
         LuaGlobal::instance()->luaEngine()->PushUnit(pWinner);
         LuaGlobal::instance()->luaEngine()->PushUnit(pLoser);
@@ -1338,9 +1475,9 @@ void LuaHookOnAuraRemove(Aura* aura)
 {
     GET_LOCK
 
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_AURA_REMOVE])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_AURA_REMOVE])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_AURA_REMOVE);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_AURA_REMOVE);
         LuaGlobal::instance()->luaEngine()->PushAura(aura);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -1354,9 +1491,9 @@ bool LuaHookOnResurrect(Player* pPlayer)
     GET_LOCK
 
     bool result = true;
-    for (auto itr : LuaGlobal::instance()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_RESURRECT])
+    for (auto itr : LuaGlobal::instance()->luaEngine()->EventAsToFuncName[SERVER_HOOK_EVENT_ON_RESURRECT])
     {
-        LuaGlobal::instance()->luaEngine()->BeginCall(itr);
+        LuaGlobal::instance()->luaEngine()->BeginCall(itr, LUA_CALL_HOOK, SERVER_HOOK_EVENT_ON_RESURRECT);
         LuaGlobal::instance()->luaEngine()->PUSH_INT(SERVER_HOOK_EVENT_ON_RESURRECT);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         if (LuaGlobal::instance()->luaEngine()->ExecuteCall(2, 1))
@@ -1378,7 +1515,7 @@ bool LuaOnDummySpell(uint8_t effectIndex, Spell* pSpell)
 {
     GET_LOCK
 
-    LuaGlobal::instance()->luaEngine()->BeginCall(LuaGlobal::instance()->m_luaDummySpells[pSpell->getSpellInfo()->getId()]);
+    LuaGlobal::instance()->luaEngine()->BeginCall(LuaGlobal::instance()->luaEngine()->m_luaDummySpells[pSpell->getSpellInfo()->getId()], LUA_CALL_DUMMY_SPELL, pSpell->getSpellInfo()->getId());
     LuaGlobal::instance()->luaEngine()->PUSH_UINT(effectIndex);
     LuaGlobal::instance()->luaEngine()->PushSpell(pSpell);
     LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -1388,18 +1525,68 @@ bool LuaOnDummySpell(uint8_t effectIndex, Spell* pSpell)
     return true;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Hooks of creature, gameobject and instance scripts that find the state of the script busy
+// (see LuaGlobal) are posted as an event to the object of the script. Its event holder calls
+// them from the thread of its map outside of every state, so the state is entered there.
+// Objects passed to the hook are looked up again by guid on that map, they are nil in the
+// call when they left the map in between.
+
+class LuaPostedCall : public CallbackBase
+{
+    std::function<void()> m_call;
+
+public:
+    explicit LuaPostedCall(std::function<void()> call) : m_call(std::move(call)) {}
+    void execute() override { m_call(); }
+};
+
+template <typename T, bool isObject = std::is_base_of<Object, typename std::remove_pointer<T>::type>::value>
+struct LuaPostedArg
+{
+    explicit LuaPostedArg(T value) : m_value(value) {}
+    T get(MapMgr* /*mapMgr*/) const { return m_value; }
+
+    T m_value;
+};
+
+template <typename T>
+struct LuaPostedArg<T, true>
+{
+    explicit LuaPostedArg(T object) : m_guid(object != nullptr ? object->getGuid() : 0) {}
+    T get(MapMgr* mapMgr) const { return mapMgr != nullptr && m_guid != 0 ? static_cast<T>(mapMgr->_GetObject(m_guid)) : nullptr; }
+
+    uint64_t m_guid;
+};
+
+template <typename Script, typename... Params, typename... Args>
+void postScriptCall(Script* script, void (Script::*hook)(Params...), Args... args)
+{
+    auto call = [script, hook, postedArgs = std::make_tuple(LuaPostedArg<Params>(args)...)]()
+    {
+        MapMgr* mapMgr = script->getPostedCallMap();
+        std::apply([&](auto const&... arg) { (script->*hook)(arg.get(mapMgr)...); }, postedArgs);
+    };
+
+    EventableObject* owner = script->getPostedCallOwner();
+    owner->event_AddEvent(TimedEvent::Allocate(owner, new LuaPostedCall(std::move(call)), EVENT_LUA_POSTED_CALL, 1, 1));
+}
+
 class LuaCreature : public CreatureAIScript
 {
 public:
-    LuaCreature(Creature* creature) : CreatureAIScript(creature), m_binding(nullptr) {}
+    LuaCreature(Creature* creature) : CreatureAIScript(creature), m_binding(nullptr), m_engine(nullptr) {}
     ~LuaCreature()
     {}
 
+    EventableObject* getPostedCallOwner() { return getCreature(); }
+    MapMgr* getPostedCallMap() { return getCreature()->GetMapMgr(); }
+
     void OnCombatStart(Unit* mTarget)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnCombatStart, mTarget)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_ENTER_COMBAT]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_ENTER_COMBAT], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_ENTER_COMBAT);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
@@ -1410,9 +1597,9 @@ public:
 
     void OnCombatStop(Unit* mTarget)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnCombatStop, mTarget)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_LEAVE_COMBAT]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_LEAVE_COMBAT], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_LEAVE_COMBAT);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
@@ -1423,9 +1610,9 @@ public:
 
     void OnTargetDied(Unit* mTarget)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnTargetDied, mTarget)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_TARGET_DIED]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_TARGET_DIED], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_TARGET_DIED);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
@@ -1436,9 +1623,9 @@ public:
 
     void OnDied(Unit* mKiller)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnDied, mKiller)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_DIED]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_DIED], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_DIED);
         LuaGlobal::instance()->luaEngine()->PushUnit(mKiller);
@@ -1449,9 +1636,9 @@ public:
 
     void OnTargetParried(Unit* mTarget)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnTargetParried, mTarget)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_TARGET_PARRIED]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_TARGET_PARRIED], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_TARGET_PARRIED);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
@@ -1462,9 +1649,9 @@ public:
 
     void OnTargetDodged(Unit* mTarget)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnTargetDodged, mTarget)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_TARGET_DODGED]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_TARGET_DODGED], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_TARGET_DODGED);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
@@ -1475,9 +1662,9 @@ public:
 
     void OnTargetBlocked(Unit* mTarget, int32_t iAmount)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnTargetBlocked, mTarget, iAmount)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_TARGET_BLOCKED]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_TARGET_BLOCKED], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_TARGET_BLOCKED);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
@@ -1489,9 +1676,9 @@ public:
 
     void OnTargetCritHit(Unit* mTarget, int32_t fAmount)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnTargetCritHit, mTarget, fAmount)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_TARGET_CRIT_HIT]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_TARGET_CRIT_HIT], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_TARGET_CRIT_HIT);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
@@ -1503,9 +1690,9 @@ public:
 
     void OnParried(Unit* mTarget)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnParried, mTarget)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_PARRY]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_PARRY], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_PARRY);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
@@ -1516,9 +1703,9 @@ public:
 
     void OnDodged(Unit* mTarget)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnDodged, mTarget)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_DODGED]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_DODGED], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_DODGED);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
@@ -1529,9 +1716,9 @@ public:
 
     void OnBlocked(Unit* mTarget, int32_t iAmount)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnBlocked, mTarget, iAmount)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_BLOCKED]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_BLOCKED], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_BLOCKED);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
@@ -1543,9 +1730,9 @@ public:
 
     void OnCritHit(Unit* mTarget, int32_t fAmount)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnCritHit, mTarget, fAmount)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_CRIT_HIT]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_CRIT_HIT], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_CRIT_HIT);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
@@ -1557,9 +1744,9 @@ public:
 
     void OnHit(Unit* mTarget, float fAmount)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnHit, mTarget, fAmount)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_HIT]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_HIT], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_HIT);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
@@ -1571,9 +1758,9 @@ public:
 
     void OnAssistTargetDied(Unit* mAssistTarget)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnAssistTargetDied, mAssistTarget)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_ASSIST_TARGET_DIED]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_ASSIST_TARGET_DIED], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_ASSIST_TARGET_DIED);
         LuaGlobal::instance()->luaEngine()->PushUnit(mAssistTarget);
@@ -1584,9 +1771,9 @@ public:
 
     void OnFear(Unit* mFeared, uint32_t iSpellId)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnFear, mFeared, iSpellId)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_FEAR]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_FEAR], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_FEAR);
         LuaGlobal::instance()->luaEngine()->PushUnit(mFeared);
@@ -1598,9 +1785,9 @@ public:
 
     void OnFlee(Unit* mFlee)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnFlee, mFlee)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_FLEE]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_FLEE], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_FLEE);
         LuaGlobal::instance()->luaEngine()->PushUnit(mFlee);
@@ -1611,9 +1798,9 @@ public:
 
     void OnCallForHelp()
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnCallForHelp)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_CALL_FOR_HELP]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_CALL_FOR_HELP], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_CALL_FOR_HELP);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -1623,14 +1810,13 @@ public:
 
     void OnLoad()
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnLoad)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_LOAD]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_LOAD], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_LOAD);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
 
-        RELEASE_LOCK
         uint32_t iid = getCreature()->GetInstanceID();
         if (getCreature()->GetMapMgr() == nullptr || getCreature()->GetMapMgr()->GetMapInfo()->isNonInstanceMap())
             iid = 0;
@@ -1638,16 +1824,18 @@ public:
         WoWGuid wowGuid;
         wowGuid.Init(getCreature()->getGuid());
 
-        LuaGlobal::instance()->m_onLoadInfo.push_back(getCreature()->GetMapId());
-        LuaGlobal::instance()->m_onLoadInfo.push_back(iid);
-        LuaGlobal::instance()->m_onLoadInfo.push_back(wowGuid.getGuidLowPart());
+        m_engine->m_onLoadInfo.push_back(getCreature()->GetMapId());
+        m_engine->m_onLoadInfo.push_back(iid);
+        m_engine->m_onLoadInfo.push_back(wowGuid.getGuidLowPart());
+
+        RELEASE_LOCK
     }
 
     void OnReachWP(uint32_t iWaypointId, bool bForwards)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnReachWP, iWaypointId, bForwards)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_REACH_WP]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_REACH_WP], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_REACH_WP);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(iWaypointId);
@@ -1659,9 +1847,9 @@ public:
 
     void OnLootTaken(Player* pPlayer, ItemProperties const* pItemPrototype)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnLootTaken, pPlayer, pItemPrototype)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_LOOT_TAKEN]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_LOOT_TAKEN], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_LOOT_TAKEN);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
@@ -1673,9 +1861,9 @@ public:
 
     void AIUpdate()
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::AIUpdate)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_AIUPDATE]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_AIUPDATE], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_AIUPDATE);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -1685,9 +1873,9 @@ public:
 
     void OnEmote(Player* pPlayer, EmoteType Emote)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnEmote, pPlayer, Emote)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_EMOTE]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_EMOTE], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_EMOTE);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
@@ -1699,9 +1887,9 @@ public:
 
     void OnDamageTaken(Unit* mAttacker, uint32_t fAmount)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnDamageTaken, mAttacker, fAmount)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_DAMAGE_TAKEN]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_DAMAGE_TAKEN], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PUSH_INT(CREATURE_EVENT_ON_DAMAGE_TAKEN);
         LuaGlobal::instance()->luaEngine()->PushUnit(mAttacker);
@@ -1713,9 +1901,9 @@ public:
 
     void OnEnterVehicle()
     {
-        CHECK_BINDING_ACQUIRELOCK;
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnEnterVehicle)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_ENTER_VEHICLE]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_ENTER_VEHICLE], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->ExecuteCall(1);
 
@@ -1724,9 +1912,9 @@ public:
 
     void OnExitVehicle()
     {
-        CHECK_BINDING_ACQUIRELOCK;
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnExitVehicle)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_EXIT_VEHICLE]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_EXIT_VEHICLE], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->ExecuteCall(1);
 
@@ -1735,9 +1923,9 @@ public:
 
     void OnFirstPassengerEntered(Unit* passenger)
     {
-        CHECK_BINDING_ACQUIRELOCK;
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnFirstPassengerEntered, passenger)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_FIRST_PASSENGER_ENTERED]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_FIRST_PASSENGER_ENTERED], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PushUnit(passenger);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -1747,9 +1935,9 @@ public:
 
     void OnVehicleFull()
     {
-        CHECK_BINDING_ACQUIRELOCK;
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnVehicleFull)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_VEHICLE_FULL]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_VEHICLE_FULL], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->ExecuteCall(1);
 
@@ -1758,9 +1946,9 @@ public:
 
     void OnLastPassengerLeft(Unit* passenger)
     {
-        CHECK_BINDING_ACQUIRELOCK;
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::OnLastPassengerLeft, passenger)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_LAST_PASSENGER_LEFT]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[CREATURE_EVENT_ON_LAST_PASSENGER_LEFT], LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->PushUnit(passenger);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -1770,9 +1958,9 @@ public:
 
     void StringFunctionCall(int fRef)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaCreature::StringFunctionCall, fRef)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(static_cast<uint16_t>(fRef));
+        LuaGlobal::instance()->luaEngine()->BeginCall(static_cast<uint16_t>(fRef), LUA_CALL_CREATURE, getCreature()->getEntry());
         LuaGlobal::instance()->luaEngine()->PushUnit(getCreature());
         LuaGlobal::instance()->luaEngine()->ExecuteCall(1);
 
@@ -1783,7 +1971,7 @@ public:
     {
         {
             typedef std::multimap<uint32_t, LuaCreature*> CMAP;
-            CMAP& cMap = LuaGlobal::instance()->luaEngine()->getLuCreatureMap();
+            CMAP& cMap = m_engine->getLuCreatureMap();
             auto itr = cMap.find(getCreature()->getEntry());
             auto itend = cMap.upper_bound(getCreature()->getEntry());
             CMAP::iterator it;
@@ -1797,14 +1985,14 @@ public:
 
         {
             //Function Ref clean up
-            std::map< uint64_t, std::set<int> >& objRefs = LuaGlobal::instance()->luaEngine()->getObjectFunctionRefs();
+            std::map< uint64_t, std::set<int> >& objRefs = m_engine->getObjectFunctionRefs();
             auto itr = objRefs.find(getCreature()->getGuid());
             if (itr != objRefs.end())
             {
                 std::set<int>& refs = itr->second;
                 for (auto it = refs.begin(); it != refs.end(); ++it)
                 {
-                    luaL_unref(LuaGlobal::instance()->luaEngine()->getluState(), LUA_REGISTRYINDEX, (*it));
+                    luaL_unref(m_engine->getluState(), LUA_REGISTRYINDEX, (*it));
                     sEventMgr.RemoveEvents(getCreature(), (*it) + EVENT_LUA_CREATURE_EVENTS);
                 }
                 refs.clear();
@@ -1813,12 +2001,14 @@ public:
         delete this;
     }
     LuaObjectBinding* m_binding;
+    // the state the script was created in
+    LuaEngine* m_engine;
 };
 
 class LuaGameObjectScript : public GameObjectAIScript
 {
 public:
-    explicit LuaGameObjectScript(GameObject* go) : GameObjectAIScript(go), m_binding(nullptr) {}
+    explicit LuaGameObjectScript(GameObject* go) : GameObjectAIScript(go), m_binding(nullptr), m_engine(nullptr) {}
     ~LuaGameObjectScript() {}
 
     GameObject* getGO()
@@ -1826,11 +2016,14 @@ public:
         return _gameobject;
     }
 
+    EventableObject* getPostedCallOwner() { return _gameobject; }
+    MapMgr* getPostedCallMap() { return _gameobject->GetMapMgr(); }
+
     void OnCreate()
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaGameObjectScript::OnCreate)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[GAMEOBJECT_EVENT_ON_CREATE]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[GAMEOBJECT_EVENT_ON_CREATE], LUA_CALL_GAMEOBJECT, _gameobject->getEntry());
         LuaGlobal::instance()->luaEngine()->PushGo(_gameobject);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(1);
 
@@ -1839,9 +2032,9 @@ public:
 
     void OnSpawn()
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaGameObjectScript::OnSpawn)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[GAMEOBJECT_EVENT_ON_SPAWN]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[GAMEOBJECT_EVENT_ON_SPAWN], LUA_CALL_GAMEOBJECT, _gameobject->getEntry());
         LuaGlobal::instance()->luaEngine()->PushGo(_gameobject);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(1);
 
@@ -1850,9 +2043,9 @@ public:
 
     void OnDespawn()
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaGameObjectScript::OnDespawn)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[GAMEOBJECT_EVENT_ON_DESPAWN]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[GAMEOBJECT_EVENT_ON_DESPAWN], LUA_CALL_GAMEOBJECT, _gameobject->getEntry());
         LuaGlobal::instance()->luaEngine()->PushGo(_gameobject);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(1);
 
@@ -1861,9 +2054,9 @@ public:
 
     void OnLootTaken(Player* pLooter, ItemProperties const* pItemInfo)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaGameObjectScript::OnLootTaken, pLooter, pItemInfo)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[GAMEOBJECT_EVENT_ON_LOOT_TAKEN]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[GAMEOBJECT_EVENT_ON_LOOT_TAKEN], LUA_CALL_GAMEOBJECT, _gameobject->getEntry());
         LuaGlobal::instance()->luaEngine()->PushGo(_gameobject);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(GAMEOBJECT_EVENT_ON_LOOT_TAKEN);
         LuaGlobal::instance()->luaEngine()->PushUnit(pLooter);
@@ -1875,9 +2068,9 @@ public:
 
     void OnActivate(Player* pPlayer)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaGameObjectScript::OnActivate, pPlayer)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[GAMEOBJECT_EVENT_ON_USE]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[GAMEOBJECT_EVENT_ON_USE], LUA_CALL_GAMEOBJECT, _gameobject->getEntry());
         LuaGlobal::instance()->luaEngine()->PushGo(_gameobject);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(GAMEOBJECT_EVENT_ON_USE);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
@@ -1888,9 +2081,9 @@ public:
 
     void AIUpdate()
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaGameObjectScript::AIUpdate)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[GAMEOBJECT_EVENT_AIUPDATE]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[GAMEOBJECT_EVENT_AIUPDATE], LUA_CALL_GAMEOBJECT, _gameobject->getEntry());
         LuaGlobal::instance()->luaEngine()->PushGo(_gameobject);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(1);
 
@@ -1899,9 +2092,9 @@ public:
 
     void OnDamaged(uint32_t damage)
     {
-        CHECK_BINDING_ACQUIRELOCK;
+        CHECK_BINDING_ACQUIRELOCK(&LuaGameObjectScript::OnDamaged, damage)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[GAMEOBJECT_EVENT_ON_DAMAGED]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[GAMEOBJECT_EVENT_ON_DAMAGED], LUA_CALL_GAMEOBJECT, _gameobject->getEntry());
         LuaGlobal::instance()->luaEngine()->PushGo(_gameobject);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(damage);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -1911,9 +2104,9 @@ public:
 
     void OnDestroyed()
     {
-        CHECK_BINDING_ACQUIRELOCK;
+        CHECK_BINDING_ACQUIRELOCK(&LuaGameObjectScript::OnDestroyed)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[GAMEOBJECT_EVENT_ON_DESTROYED]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[GAMEOBJECT_EVENT_ON_DESTROYED], LUA_CALL_GAMEOBJECT, _gameobject->getEntry());
         LuaGlobal::instance()->luaEngine()->PushGo(_gameobject);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(1);
 
@@ -1923,7 +2116,7 @@ public:
     void Destroy()
     {
         typedef std::multimap<uint32_t, LuaGameObjectScript*> GMAP;
-        GMAP& gMap = LuaGlobal::instance()->luaEngine()->getLuGameObjectMap();
+        GMAP& gMap = m_engine->getLuGameObjectMap();
         auto itr = gMap.find(_gameobject->getEntry());
         auto itend = gMap.upper_bound(_gameobject->getEntry());
         GMAP::iterator it;
@@ -1936,19 +2129,20 @@ public:
                 gMap.erase(it);
         }
 
-        std::map< uint64_t, std::set<int> >& objRefs = LuaGlobal::instance()->luaEngine()->getObjectFunctionRefs();
+        std::map< uint64_t, std::set<int> >& objRefs = m_engine->getObjectFunctionRefs();
         auto itr2 = objRefs.find(_gameobject->getGuid());
         if (itr2 != objRefs.end())
         {
             std::set<int>& refs = itr2->second;
             for (std::set<int>::iterator it2 = refs.begin(); it2 != refs.end(); ++it2)
-                luaL_unref(LuaGlobal::instance()->luaEngine()->getluState(), LUA_REGISTRYINDEX, (*it2));
+                luaL_unref(m_engine->getluState(), LUA_REGISTRYINDEX, (*it2));
 
             refs.clear();
         }
         delete this;
     }
     LuaObjectBinding* m_binding;
+    LuaEngine* m_engine;
 };
 
 class LuaGossip : public GossipScript
@@ -2001,15 +2195,17 @@ public:
     {
         GET_LOCK
 
+        LuaObjectBinding* binding = getBinding(pObject);
+
         if (pObject->isCreature())
         {
-            if (m_unit_gossip_binding == nullptr)
+            if (binding == nullptr)
             {
                 RELEASE_LOCK;
                 return;
             }
 
-            LuaGlobal::instance()->luaEngine()->BeginCall(m_unit_gossip_binding->m_functionReferences[GOSSIP_EVENT_ON_TALK]);
+            LuaGlobal::instance()->luaEngine()->BeginCall(binding->m_functionReferences[GOSSIP_EVENT_ON_TALK], LUA_CALL_GOSSIP, pObject->getEntry());
             LuaGlobal::instance()->luaEngine()->PushUnit(pObject);
             LuaGlobal::instance()->luaEngine()->PUSH_UINT(GOSSIP_EVENT_ON_TALK);
             LuaGlobal::instance()->luaEngine()->PushUnit(plr);
@@ -2017,13 +2213,13 @@ public:
         }
         else if (pObject->isItem())
         {
-            if (m_item_gossip_binding == nullptr)
+            if (binding == nullptr)
             {
                 RELEASE_LOCK;
                 return;
             }
 
-            LuaGlobal::instance()->luaEngine()->BeginCall(m_item_gossip_binding->m_functionReferences[GOSSIP_EVENT_ON_TALK]);
+            LuaGlobal::instance()->luaEngine()->BeginCall(binding->m_functionReferences[GOSSIP_EVENT_ON_TALK], LUA_CALL_GOSSIP, pObject->getEntry());
             LuaGlobal::instance()->luaEngine()->PushItem(pObject);
             LuaGlobal::instance()->luaEngine()->PUSH_UINT(GOSSIP_EVENT_ON_TALK);
             LuaGlobal::instance()->luaEngine()->PushUnit(plr);
@@ -2031,13 +2227,13 @@ public:
         }
         else if (pObject->isGameObject())
         {
-            if (m_go_gossip_binding == nullptr)
+            if (binding == nullptr)
             {
                 RELEASE_LOCK;
                 return;
             }
 
-            LuaGlobal::instance()->luaEngine()->BeginCall(m_go_gossip_binding->m_functionReferences[GOSSIP_EVENT_ON_TALK]);
+            LuaGlobal::instance()->luaEngine()->BeginCall(binding->m_functionReferences[GOSSIP_EVENT_ON_TALK], LUA_CALL_GOSSIP, pObject->getEntry());
             LuaGlobal::instance()->luaEngine()->PushGo(pObject);
             LuaGlobal::instance()->luaEngine()->PUSH_UINT(GOSSIP_EVENT_ON_TALK);
             LuaGlobal::instance()->luaEngine()->PushUnit(plr);
@@ -2051,15 +2247,17 @@ public:
     {
         GET_LOCK
 
+        LuaObjectBinding* binding = getBinding(pObject);
+
         if (pObject->isCreature())
         {
-            if (m_unit_gossip_binding == nullptr)
+            if (binding == nullptr)
             {
                 RELEASE_LOCK;
                 return;
             }
 
-            LuaGlobal::instance()->luaEngine()->BeginCall(m_unit_gossip_binding->m_functionReferences[GOSSIP_EVENT_ON_SELECT_OPTION]);
+            LuaGlobal::instance()->luaEngine()->BeginCall(binding->m_functionReferences[GOSSIP_EVENT_ON_SELECT_OPTION], LUA_CALL_GOSSIP, pObject->getEntry());
             LuaGlobal::instance()->luaEngine()->PushUnit(pObject);
             LuaGlobal::instance()->luaEngine()->PUSH_UINT(GOSSIP_EVENT_ON_SELECT_OPTION);
             LuaGlobal::instance()->luaEngine()->PushUnit(Plr);
@@ -2070,12 +2268,12 @@ public:
         }
         else if (pObject->isItem())
         {
-            if (m_item_gossip_binding == nullptr)
+            if (binding == nullptr)
             {
                 RELEASE_LOCK;
                 return;
             }
-            LuaGlobal::instance()->luaEngine()->BeginCall(m_item_gossip_binding->m_functionReferences[GOSSIP_EVENT_ON_SELECT_OPTION]);
+            LuaGlobal::instance()->luaEngine()->BeginCall(binding->m_functionReferences[GOSSIP_EVENT_ON_SELECT_OPTION], LUA_CALL_GOSSIP, pObject->getEntry());
             LuaGlobal::instance()->luaEngine()->PushItem(pObject);
             LuaGlobal::instance()->luaEngine()->PUSH_UINT(GOSSIP_EVENT_ON_SELECT_OPTION);
             LuaGlobal::instance()->luaEngine()->PushUnit(Plr);
@@ -2086,12 +2284,12 @@ public:
         }
         else if (pObject->isGameObject())
         {
-            if (m_go_gossip_binding == nullptr)
+            if (binding == nullptr)
             {
                 RELEASE_LOCK;
                 return;
             }
-            LuaGlobal::instance()->luaEngine()->BeginCall(m_go_gossip_binding->m_functionReferences[GOSSIP_EVENT_ON_SELECT_OPTION]);
+            LuaGlobal::instance()->luaEngine()->BeginCall(binding->m_functionReferences[GOSSIP_EVENT_ON_SELECT_OPTION], LUA_CALL_GOSSIP, pObject->getEntry());
             LuaGlobal::instance()->luaEngine()->PushGo(pObject);
             LuaGlobal::instance()->luaEngine()->PUSH_UINT(GOSSIP_EVENT_ON_SELECT_OPTION);
             LuaGlobal::instance()->luaEngine()->PushUnit(Plr);
@@ -2108,14 +2306,16 @@ public:
     {
         GET_LOCK
 
+        LuaObjectBinding* binding = getBinding(pObject);
+
         if (pObject->isCreature())
         {
-            if (m_unit_gossip_binding == nullptr)
+            if (binding == nullptr)
             {
                 RELEASE_LOCK;
                 return;
             }
-            LuaGlobal::instance()->luaEngine()->BeginCall(m_unit_gossip_binding->m_functionReferences[GOSSIP_EVENT_ON_END]);
+            LuaGlobal::instance()->luaEngine()->BeginCall(binding->m_functionReferences[GOSSIP_EVENT_ON_END], LUA_CALL_GOSSIP, pObject->getEntry());
             LuaGlobal::instance()->luaEngine()->PushUnit(pObject);
             LuaGlobal::instance()->luaEngine()->PUSH_UINT(GOSSIP_EVENT_ON_END);
             LuaGlobal::instance()->luaEngine()->PushUnit(Plr);
@@ -2123,12 +2323,12 @@ public:
         }
         else if (pObject->isItem())
         {
-            if (m_item_gossip_binding == nullptr)
+            if (binding == nullptr)
             {
                 RELEASE_LOCK;
                 return;
             }
-            LuaGlobal::instance()->luaEngine()->BeginCall(m_item_gossip_binding->m_functionReferences[GOSSIP_EVENT_ON_END]);
+            LuaGlobal::instance()->luaEngine()->BeginCall(binding->m_functionReferences[GOSSIP_EVENT_ON_END], LUA_CALL_GOSSIP, pObject->getEntry());
             LuaGlobal::instance()->luaEngine()->PushItem(pObject);
             LuaGlobal::instance()->luaEngine()->PUSH_UINT(GOSSIP_EVENT_ON_END);
             LuaGlobal::instance()->luaEngine()->PushUnit(Plr);
@@ -2136,12 +2336,12 @@ public:
         }
         else if (pObject->isGameObject())
         {
-            if (m_go_gossip_binding == nullptr)
+            if (binding == nullptr)
             {
                 RELEASE_LOCK;
                 return;
             }
-            LuaGlobal::instance()->luaEngine()->BeginCall(m_go_gossip_binding->m_functionReferences[GOSSIP_EVENT_ON_END]);
+            LuaGlobal::instance()->luaEngine()->BeginCall(binding->m_functionReferences[GOSSIP_EVENT_ON_END], LUA_CALL_GOSSIP, pObject->getEntry());
             LuaGlobal::instance()->luaEngine()->PushGo(pObject);
             LuaGlobal::instance()->luaEngine()->PUSH_UINT(GOSSIP_EVENT_ON_END);
             LuaGlobal::instance()->luaEngine()->PushUnit(Plr);
@@ -2151,6 +2351,21 @@ public:
         RELEASE_LOCK
     }
 
+    // gossip scripts are shared by all maps, the binding is taken from the state of the caller
+    LuaObjectBinding* getBinding(Object* pObject)
+    {
+        if (pObject->isCreature() && m_unit_gossip_binding != nullptr)
+            return LuaGlobal::instance()->luaEngine()->getLuaUnitGossipBinding(pObject->getEntry());
+
+        if (pObject->isItem() && m_item_gossip_binding != nullptr)
+            return LuaGlobal::instance()->luaEngine()->getLuaItemGossipBinding(pObject->getEntry());
+
+        if (pObject->isGameObject() && m_go_gossip_binding != nullptr)
+            return LuaGlobal::instance()->luaEngine()->getLuaGOGossipBinding(pObject->getEntry());
+
+        return nullptr;
+    }
+
     LuaObjectBinding* m_unit_gossip_binding;
     LuaObjectBinding* m_item_gossip_binding;
     LuaObjectBinding* m_go_gossip_binding;
@@ -2159,10 +2374,7 @@ public:
 class LuaQuest : public QuestScript
 {
 public:
-    LuaQuest() : QuestScript()
-    {
-        m_binding = nullptr;
-    }
+    explicit LuaQuest(uint32_t questId) : QuestScript(), m_questId(questId) {}
 
     ~LuaQuest()
     {
@@ -2180,9 +2392,16 @@ public:
 
     void OnQuestStart(Player* mTarget, QuestLogEntry* qLogEntry)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        GET_LOCK
+
+        LuaObjectBinding* binding = getBinding();
+        if (binding == nullptr)
+        {
+            RELEASE_LOCK
+            return;
+        }
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[QUEST_EVENT_ON_ACCEPT]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(binding->m_functionReferences[QUEST_EVENT_ON_ACCEPT], LUA_CALL_QUEST, m_questId);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(qLogEntry->getQuestProperties()->id);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -2192,9 +2411,16 @@ public:
 
     void OnQuestComplete(Player* mTarget, QuestLogEntry* qLogEntry)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        GET_LOCK
+
+        LuaObjectBinding* binding = getBinding();
+        if (binding == nullptr)
+        {
+            RELEASE_LOCK
+            return;
+        }
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[QUEST_EVENT_ON_COMPLETE]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(binding->m_functionReferences[QUEST_EVENT_ON_COMPLETE], LUA_CALL_QUEST, m_questId);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(qLogEntry->getQuestProperties()->id);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -2204,9 +2430,16 @@ public:
 
     void OnQuestCancel(Player* mTarget)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        GET_LOCK
+
+        LuaObjectBinding* binding = getBinding();
+        if (binding == nullptr)
+        {
+            RELEASE_LOCK
+            return;
+        }
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[QUEST_EVENT_ON_CANCEL]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(binding->m_functionReferences[QUEST_EVENT_ON_CANCEL], LUA_CALL_QUEST, m_questId);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(1);
 
@@ -2215,9 +2448,16 @@ public:
 
     void OnGameObjectActivate(uint32_t entry, Player* mTarget, QuestLogEntry* qLogEntry)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        GET_LOCK
+
+        LuaObjectBinding* binding = getBinding();
+        if (binding == nullptr)
+        {
+            RELEASE_LOCK
+            return;
+        }
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[QUEST_EVENT_GAMEOBJECT_ACTIVATE]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(binding->m_functionReferences[QUEST_EVENT_GAMEOBJECT_ACTIVATE], LUA_CALL_QUEST, m_questId);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(entry);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(qLogEntry->getQuestProperties()->id);
@@ -2228,9 +2468,16 @@ public:
 
     void OnCreatureKill(uint32_t entry, Player* mTarget, QuestLogEntry* qLogEntry)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        GET_LOCK
+
+        LuaObjectBinding* binding = getBinding();
+        if (binding == nullptr)
+        {
+            RELEASE_LOCK
+            return;
+        }
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[QUEST_EVENT_ON_CREATURE_KILL]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(binding->m_functionReferences[QUEST_EVENT_ON_CREATURE_KILL], LUA_CALL_QUEST, m_questId);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(entry);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(qLogEntry->getQuestProperties()->id);
@@ -2241,9 +2488,16 @@ public:
 
     void OnExploreArea(uint32_t areaId, Player* mTarget, QuestLogEntry* qLogEntry)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        GET_LOCK
+
+        LuaObjectBinding* binding = getBinding();
+        if (binding == nullptr)
+        {
+            RELEASE_LOCK
+            return;
+        }
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[QUEST_EVENT_ON_EXPLORE_AREA]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(binding->m_functionReferences[QUEST_EVENT_ON_EXPLORE_AREA], LUA_CALL_QUEST, m_questId);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(areaId);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(qLogEntry->getQuestProperties()->id);
@@ -2254,9 +2508,16 @@ public:
 
     void OnPlayerItemPickup(uint32_t itemId, uint32_t totalCount, Player* mTarget, QuestLogEntry* qLogEntry)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        GET_LOCK
+
+        LuaObjectBinding* binding = getBinding();
+        if (binding == nullptr)
+        {
+            RELEASE_LOCK
+            return;
+        }
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[QUEST_EVENT_ON_PLAYER_ITEMPICKUP]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(binding->m_functionReferences[QUEST_EVENT_ON_PLAYER_ITEMPICKUP], LUA_CALL_QUEST, m_questId);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(itemId);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(totalCount);
         LuaGlobal::instance()->luaEngine()->PushUnit(mTarget);
@@ -2265,21 +2526,30 @@ public:
 
         RELEASE_LOCK
     }
-    LuaObjectBinding* m_binding;
+    // quest scripts are shared by all maps, the binding is taken from the state of the caller
+    LuaObjectBinding* getBinding()
+    {
+        return LuaGlobal::instance()->luaEngine()->getQuestBinding(m_questId);
+    }
+
+    uint32_t m_questId;
 };
 
 class LuaInstance : public InstanceScript
 {
 public:
-    explicit LuaInstance(MapMgr* pMapMgr) : InstanceScript(pMapMgr), m_instanceId(pMapMgr->GetInstanceID()), m_binding(nullptr) {}
+    explicit LuaInstance(MapMgr* pMapMgr) : InstanceScript(pMapMgr), m_instanceId(pMapMgr->GetInstanceID()), m_binding(nullptr), m_engine(nullptr) {}
     ~LuaInstance() {}
 
+    EventableObject* getPostedCallOwner() { return mInstance; }
+    MapMgr* getPostedCallMap() { return mInstance; }
+
     // Player
     void OnPlayerDeath(Player* pVictim, Unit* pKiller)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaInstance::OnPlayerDeath, pVictim, pKiller)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ON_PLAYER_DEATH]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ON_PLAYER_DEATH], LUA_CALL_INSTANCE, mInstance->GetMapId());
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(m_instanceId);
         LuaGlobal::instance()->luaEngine()->PushUnit(pVictim);
         LuaGlobal::instance()->luaEngine()->PushUnit(pKiller);
@@ -2290,9 +2560,9 @@ public:
 
     void OnPlayerEnter(Player* pPlayer)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaInstance::OnPlayerEnter, pPlayer)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ON_PLAYER_ENTER]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ON_PLAYER_ENTER], LUA_CALL_INSTANCE, mInstance->GetMapId());
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(m_instanceId);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -2302,9 +2572,9 @@ public:
 
     void OnAreaTrigger(Player* pPlayer, uint32_t uAreaId)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaInstance::OnAreaTrigger, pPlayer, uAreaId)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ON_AREA_TRIGGER]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ON_AREA_TRIGGER], LUA_CALL_INSTANCE, mInstance->GetMapId());
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(m_instanceId);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(uAreaId);
@@ -2315,9 +2585,9 @@ public:
 
     void OnZoneChange(Player* pPlayer, uint32_t uNewZone, uint32_t uOldZone)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaInstance::OnZoneChange, pPlayer, uNewZone, uOldZone)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ON_ZONE_CHANGE]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ON_ZONE_CHANGE], LUA_CALL_INSTANCE, mInstance->GetMapId());
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(m_instanceId);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(uNewZone);
@@ -2330,9 +2600,9 @@ public:
     // Creature / GameObject - part of it is simple reimplementation for easier use Creature / GO < --- > Script
     void OnCreatureDeath(Creature* pVictim, Unit* pKiller)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaInstance::OnCreatureDeath, pVictim, pKiller)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ON_CREATURE_DEATH]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ON_CREATURE_DEATH], LUA_CALL_INSTANCE, mInstance->GetMapId());
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(m_instanceId);
         LuaGlobal::instance()->luaEngine()->PushUnit(pVictim);
         LuaGlobal::instance()->luaEngine()->PushUnit(pKiller);
@@ -2343,9 +2613,9 @@ public:
 
     void OnCreaturePushToWorld(Creature* pCreature)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaInstance::OnCreaturePushToWorld, pCreature)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ON_CREATURE_PUSH]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ON_CREATURE_PUSH], LUA_CALL_INSTANCE, mInstance->GetMapId());
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(m_instanceId);
         LuaGlobal::instance()->luaEngine()->PushUnit(pCreature);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -2355,9 +2625,9 @@ public:
 
     void OnGameObjectActivate(GameObject* pGameObject, Player* pPlayer)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaInstance::OnGameObjectActivate, pGameObject, pPlayer)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ON_GO_ACTIVATE]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ON_GO_ACTIVATE], LUA_CALL_INSTANCE, mInstance->GetMapId());
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(m_instanceId);
         LuaGlobal::instance()->luaEngine()->PushGo(pGameObject);
         LuaGlobal::instance()->luaEngine()->PushUnit(pPlayer);
@@ -2368,9 +2638,9 @@ public:
 
     void OnGameObjectPushToWorld(GameObject* pGameObject)
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaInstance::OnGameObjectPushToWorld, pGameObject)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ON_GO_PUSH]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ON_GO_PUSH], LUA_CALL_INSTANCE, mInstance->GetMapId());
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(m_instanceId);
         LuaGlobal::instance()->luaEngine()->PushGo(pGameObject);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(2);
@@ -2381,9 +2651,9 @@ public:
     // Standard virtual methods
     void OnLoad()
     {
-        CHECK_BINDING_ACQUIRELOCK
+        CHECK_BINDING_ACQUIRELOCK(&LuaInstance::OnLoad)
 
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ONLOAD]);
+        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_ONLOAD], LUA_CALL_INSTANCE, mInstance->GetMapId());
         LuaGlobal::instance()->luaEngine()->PUSH_UINT(m_instanceId);
         LuaGlobal::instance()->luaEngine()->ExecuteCall(1);
 
@@ -2392,16 +2662,18 @@ public:
 
     void Destroy()
     {
-        CHECK_BINDING_ACQUIRELOCK
-
-        LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_DESTROY]);
-        LuaGlobal::instance()->luaEngine()->PUSH_UINT(m_instanceId);
-        LuaGlobal::instance()->luaEngine()->ExecuteCall(1);
+        // called while the map is deleted, which is inside no state, there is nothing left to post to
+        if (m_binding != nullptr && LuaGlobal::instance()->enterEngine(m_engine))
+        {
+            LuaGlobal::instance()->luaEngine()->BeginCall(m_binding->m_functionReferences[INSTANCE_EVENT_DESTROY], LUA_CALL_INSTANCE, mInstance->GetMapId());
+            LuaGlobal::instance()->luaEngine()->PUSH_UINT(m_instanceId);
+            LuaGlobal::instance()->luaEngine()->ExecuteCall(1);
 
-        RELEASE_LOCK
+            RELEASE_LOCK
+        }
 
         typedef std::unordered_map<uint32_t, LuaInstance*> IMAP;
-        IMAP& iMap = LuaGlobal::instance()->luaEngine()->getLuInstanceMap();
+        IMAP& iMap = m_engine->getLuInstanceMap();
         for (auto itr = iMap.begin(); itr != iMap.end(); ++itr)
         {
             if (itr->second == this)
@@ -2415,6 +2687,7 @@ public:
 
     uint32_t m_instanceId;
     LuaObjectBinding* m_binding;
+    LuaEngine* m_engine;
 };
 
 CreatureAIScript* CreateLuaCreature(Creature* src)
@@ -2423,14 +2696,16 @@ CreatureAIScript* CreateLuaCreature(Creature* src)
     if (src != nullptr)
     {
         uint32_t id = src->getEntry();
-        LuaObjectBinding* pBinding = LuaGlobal::instance()->luaEngine()->getUnitBinding(id);
+        LuaEngine* engine = LuaGlobal::instance()->luaEngine();
+        LuaObjectBinding* pBinding = engine->getUnitBinding(id);
         if (pBinding != nullptr)
         {
             typedef std::multimap<uint32_t, LuaCreature*> CRCMAP;
-            CRCMAP& cMap = LuaGlobal::instance()->luaEngine()->getLuCreatureMap();
+            CRCMAP& cMap = engine->getLuCreatureMap();
             script = new LuaCreature(src);
             cMap.emplace(std::make_pair(id, script));
             script->m_binding = pBinding;
+            script->m_engine = engine;
         }
     }
     return script;
@@ -2442,15 +2717,16 @@ GameObjectAIScript* CreateLuaGameObjectScript(GameObject* src)
     if (src != nullptr)
     {
         uint32_t id = src->GetGameObjectProperties()->entry;
-        LuaObjectBinding* pBinding = nullptr;
-        pBinding = LuaGlobal::instance()->luaEngine()->getGameObjectBinding(id);
+        LuaEngine* engine = LuaGlobal::instance()->luaEngine();
+        LuaObjectBinding* pBinding = engine->getGameObjectBinding(id);
         if (pBinding != nullptr)
         {
             typedef std::multimap<uint32_t, LuaGameObjectScript*> GMAP;
-            GMAP& gMap = LuaGlobal::instance()->luaEngine()->getLuGameObjectMap();
+            GMAP& gMap = engine->getLuGameObjectMap();
             script = new LuaGameObjectScript(src);
             gMap.emplace(std::make_pair(id, script));
             script->m_binding = pBinding;
+            script->m_engine = engine;
         }
     }
     return script;
@@ -2468,16 +2744,15 @@ QuestScript* CreateLuaQuestScript(uint32_t id)
         if (itr != qMap.end())
         {
             if (itr->second == nullptr)
-                pLua = itr->second = new LuaQuest();
+                pLua = itr->second = new LuaQuest(id);
             else
                 pLua = itr->second;
         }
         else
         {
-            pLua = new LuaQuest();
+            pLua = new LuaQuest(id);
             qMap.insert(std::make_pair(id, pLua));
         }
-        pLua->m_binding = pBinding;
     }
     return pLua;
 }
@@ -2486,11 +2761,12 @@ InstanceScript* CreateLuaInstance(MapMgr* pMapMgr)
 {
     LuaInstance* pLua = nullptr;
     uint32_t id = pMapMgr->GetMapId();
-    LuaObjectBinding* pBinding = LuaGlobal::instance()->luaEngine()->getInstanceBinding(id);
+    LuaEngine* engine = LuaGlobal::instance()->getEngineForMap(pMapMgr);
+    LuaObjectBinding* pBinding = engine->getInstanceBinding(id);
     if (pBinding != nullptr)
     {
         typedef std::unordered_map<uint32_t, LuaInstance*> IMAP;
-        IMAP& iMap = LuaGlobal::instance()->luaEngine()->getLuInstanceMap();
+        IMAP& iMap = engine->getLuInstanceMap();
         auto itr = iMap.find(id);
         if (itr != iMap.end())
         {
@@ -2505,6 +2781,7 @@ InstanceScript* CreateLuaInstance(MapMgr* pMapMgr)
             iMap.insert(std::make_pair(id, pLua));
         }
         pLua->m_binding = pBinding;
+        pLua->m_engine = engine;
     }
     return pLua;
 }
@@ -2590,6 +2867,8 @@ GossipScript* CreateLuaGOGossipScript(uint32_t id)
 void LuaEngine::Startup()
 {
     DLLLogDetail("LuaEngineMgr : AscEmu Lua Engine ( ALE ) %s: Loaded", ARCH);
+    GET_ENGINE_LOCK(this)
+
     //Create a new global state that will server as the lua universe.
     lu = luaL_newstate();
 
@@ -2689,7 +2968,7 @@ void LuaEngine::Startup()
     RegisterHook(SERVER_HOOK_EVENT_ON_AURA_REMOVE, (void*)LuaHookOnAuraRemove)
     RegisterHook(SERVER_HOOK_EVENT_ON_RESURRECT, (void*)LuaHookOnResurrect)
 
-    for (const auto& dummySpell : LuaGlobal::instance()->m_luaDummySpells)
+    for (const auto& dummySpell : LuaGlobal::instance()->luaEngine()->m_luaDummySpells)
     {
         auto dummyHook = LuaGlobal::instance()->luaEngine()->HookInfo.dummyHooks;
         if (std::find(dummyHook.begin(), dummyHook.end(), dummySpell.first) == dummyHook.end())
@@ -2698,7 +2977,22 @@ void LuaEngine::Startup()
             LuaGlobal::instance()->luaEngine()->HookInfo.dummyHooks.push_back(dummySpell.first);
         }
     }
+
+    RELEASE_LOCK
+
+    LuaGlobal::instance()->startMapEngines(worldConfig.luaEngine.mapStates);
 }
+
+void LuaEngine::StartupMapState()
+{
+    GET_ENGINE_LOCK(this)
+
+    lu = luaL_newstate();
+    LoadScripts();
+
+    RELEASE_LOCK
+}
+
 void LuaEngine::RegisterEvent(uint8_t regtype, uint32_t id, uint32_t evt, uint16_t functionRef)
 {
     switch (regtype)
@@ -2772,13 +3066,13 @@ void LuaEngine::RegisterEvent(uint8_t regtype, uint32_t id, uint32_t evt, uint16
         case REGTYPE_SERVHOOK:
         {
             if (evt < NUM_SERVER_HOOKS)
-                LuaGlobal::instance()->EventAsToFuncName[evt].push_back(functionRef);
+                EventAsToFuncName[evt].push_back(functionRef);
         }
         break;
         case REGTYPE_DUMMYSPELL:
         {
             if (id)
-                LuaGlobal::instance()->m_luaDummySpells.insert(std::pair<uint32_t, uint16_t>(id, functionRef));
+                m_luaDummySpells.insert(std::pair<uint32_t, uint16_t>(id, functionRef));
         }
         break;
         case REGTYPE_INSTANCE:
@@ -2936,7 +3230,7 @@ void LuaEngine::Unload()
     m_go_gossipBinding.clear();
 
     //Serv hooks : had forgotten these.
-    for (auto& next : LuaGlobal::instance()->EventAsToFuncName)
+    for (auto& next : EventAsToFuncName)
     {
         for (auto itr = next.begin(); itr != next.end(); ++itr)
             luaL_unref(lu, LUA_REGISTRYINDEX, (*itr));
@@ -2944,11 +3238,11 @@ void LuaEngine::Unload()
         next.clear();
     }
 
-    for (auto& m_luaDummySpell : LuaGlobal::instance()->m_luaDummySpells)
+    for (auto& m_luaDummySpell : m_luaDummySpells)
     {
         luaL_unref(lu, LUA_REGISTRYINDEX, m_luaDummySpell.second);
     }
-    LuaGlobal::instance()->m_luaDummySpells.clear();
+    m_luaDummySpells.clear();
 
     for (auto itr : m_pendingThreads)
     {
@@ -2963,21 +3257,30 @@ void LuaEngine::Unload()
 void LuaEngine::Restart()
 {
     DLLLogDetail("LuaEngineMgr : Restarting Engine.");
-    GET_LOCK
+    GET_ENGINE_LOCK(this)
     getcoLock().Acquire();
     Unload();
+    // the profiles point to the chunks of the old state
+    m_profiler.reset();
     lu = luaL_newstate();
     LoadScripts();
+
+    // map states only update their own scripts, the main state registers new ones with the ScriptMgr
+    const bool registerScripts = isMainState();
+
     for (auto& itr : m_unitBinding)
     {
         typedef std::multimap<uint32_t, LuaCreature*> CMAP;
-        CMAP& cMap = LuaGlobal::instance()->luaEngine()->getLuCreatureMap();
+        CMAP& cMap = getLuCreatureMap();
         auto it = cMap.find(itr.first);
         auto itend = cMap.upper_bound(itr.first);
         if (it == cMap.end())
         {
-            m_scriptMgr->register_creature_script(itr.first, CreateLuaCreature);
-            cMap.emplace(std::make_pair(itr.first, (LuaCreature*)nullptr));
+            if (registerScripts)
+            {
+                m_scriptMgr->register_creature_script(itr.first, CreateLuaCreature);
+                cMap.emplace(std::make_pair(itr.first, (LuaCreature*)nullptr));
+            }
         }
         else
         {
@@ -2990,13 +3293,16 @@ void LuaEngine::Restart()
     for (auto& itr : m_gameobjectBinding)
     {
         typedef std::multimap<uint32_t, LuaGameObjectScript*> GMAP;
-        GMAP& gMap = LuaGlobal::instance()->luaEngine()->getLuGameObjectMap();
+        GMAP& gMap = getLuGameObjectMap();
         auto it = gMap.find(itr.first);
         auto itend = gMap.upper_bound(itr.first);
         if (it == gMap.end())
         {
-            m_scriptMgr->register_gameobject_script(itr.first, CreateLuaGameObjectScript);
-            gMap.emplace(std::make_pair(itr.first, (LuaGameObjectScript*)nullptr));
+            if (registerScripts)
+            {
+                m_scriptMgr->register_gameobject_script(itr.first, CreateLuaGameObjectScript);
+                gMap.emplace(std::make_pair(itr.first, (LuaGameObjectScript*)nullptr));
+            }
         }
         else
         {
@@ -3006,33 +3312,33 @@ void LuaEngine::Restart()
         }
     }
 
-    for (auto& itr : m_questBinding)
+    if (registerScripts)
     {
-        typedef std::unordered_map<uint32_t, LuaQuest*> QMAP;
-        QMAP& qMap = LuaGlobal::instance()->luaEngine()->getLuQuestMap();
-        auto it = qMap.find(itr.first);
-        if (it == qMap.end())
-        {
-            m_scriptMgr->register_quest_script(itr.first, CreateLuaQuestScript(itr.first));
-            qMap.insert(std::make_pair(itr.first, (LuaQuest*)nullptr));
-        }
-        else
+        for (auto& itr : m_questBinding)
         {
-            LuaQuest* q_interface = it->second;
-            if (q_interface != nullptr)
-                q_interface->m_binding = &itr.second;
+            typedef std::unordered_map<uint32_t, LuaQuest*> QMAP;
+            QMAP& qMap = getLuQuestMap();
+            auto it = qMap.find(itr.first);
+            if (it == qMap.end())
+            {
+                m_scriptMgr->register_quest_script(itr.first, CreateLuaQuestScript(itr.first));
+                qMap.insert(std::make_pair(itr.first, (LuaQuest*)nullptr));
+            }
         }
     }
 
     for (auto& itr : m_instanceBinding)
     {
         typedef std::unordered_map<uint32_t, LuaInstance*> IMAP;
-        IMAP& iMap = LuaGlobal::instance()->luaEngine()->getLuInstanceMap();
+        IMAP& iMap = getLuInstanceMap();
         auto it = iMap.find(itr.first);
         if (it == iMap.end())
         {
-            m_scriptMgr->register_instance_script(itr.first, CreateLuaInstance);
-            iMap.insert(std::make_pair(itr.first, (LuaInstance*)nullptr));
+            if (registerScripts)
+            {
+                m_scriptMgr->register_instance_script(itr.first, CreateLuaInstance);
+                iMap.insert(std::make_pair(itr.first, (LuaInstance*)nullptr));
+            }
         }
         else
         {
@@ -3041,123 +3347,128 @@ void LuaEngine::Restart()
         }
     }
 
-    for (auto itr = m_unit_gossipBinding.begin(); itr != m_unit_gossipBinding.end(); ++itr)
+    if (registerScripts)
     {
-        typedef std::unordered_map<uint32_t, LuaGossip*> GMAP;
-        GMAP& gMap = LuaGlobal::instance()->luaEngine()->getUnitGossipInterfaceMap();
-        auto it = gMap.find(itr->first);
-        if (it == gMap.end())
+        for (auto itr = m_unit_gossipBinding.begin(); itr != m_unit_gossipBinding.end(); ++itr)
         {
-            GossipScript* gs = CreateLuaUnitGossipScript(itr->first);
-            if (gs != nullptr)
+            typedef std::unordered_map<uint32_t, LuaGossip*> GMAP;
+            GMAP& gMap = getUnitGossipInterfaceMap();
+            auto it = gMap.find(itr->first);
+            if (it == gMap.end())
             {
-                m_scriptMgr->register_creature_gossip(itr->first, gs);
-                gMap.insert(std::make_pair(itr->first, (LuaGossip*)nullptr));
+                GossipScript* gs = CreateLuaUnitGossipScript(itr->first);
+                if (gs != nullptr)
+                {
+                    m_scriptMgr->register_creature_gossip(itr->first, gs);
+                    gMap.insert(std::make_pair(itr->first, (LuaGossip*)nullptr));
+                }
+            }
+            else
+            {
+                LuaGossip* u_gossip = it->second;
+                if (u_gossip != nullptr)
+                    u_gossip->m_unit_gossip_binding = &itr->second;
             }
         }
-        else
-        {
-            LuaGossip* u_gossip = it->second;
-            if (u_gossip != nullptr)
-                u_gossip->m_unit_gossip_binding = &itr->second;
-        }
-    }
 
-    for (auto itr = m_item_gossipBinding.begin(); itr != m_item_gossipBinding.end(); ++itr)
-    {
-        typedef std::unordered_map<uint32_t, LuaGossip*> GMAP;
-        GMAP& gMap = LuaGlobal::instance()->luaEngine()->getItemGossipInterfaceMap();
-        auto it = gMap.find(itr->first);
-        if (it == gMap.end())
+        for (auto itr = m_item_gossipBinding.begin(); itr != m_item_gossipBinding.end(); ++itr)
         {
-            GossipScript* gs = CreateLuaItemGossipScript(itr->first);
-            if (gs != nullptr)
+            typedef std::unordered_map<uint32_t, LuaGossip*> GMAP;
+            GMAP& gMap = getItemGossipInterfaceMap();
+            auto it = gMap.find(itr->first);
+            if (it == gMap.end())
             {
-                m_scriptMgr->register_item_gossip(itr->first, gs);
-                gMap.insert(std::make_pair(itr->first, (LuaGossip*)nullptr));
+                GossipScript* gs = CreateLuaItemGossipScript(itr->first);
+                if (gs != nullptr)
+                {
+                    m_scriptMgr->register_item_gossip(itr->first, gs);
+                    gMap.insert(std::make_pair(itr->first, (LuaGossip*)nullptr));
+                }
+            }
+            else
+            {
+                LuaGossip* i_gossip = it->second;
+                if (i_gossip != nullptr)
+                    i_gossip->m_item_gossip_binding = &itr->second;
             }
         }
-        else
-        {
-            LuaGossip* i_gossip = it->second;
-            if (i_gossip != nullptr)
-                i_gossip->m_item_gossip_binding = &itr->second;
-        }
-    }
 
-    for (auto itr = m_go_gossipBinding.begin(); itr != m_go_gossipBinding.end(); ++itr)
-    {
-        typedef std::unordered_map<uint32_t, LuaGossip*> GMAP;
-        GMAP& gMap = LuaGlobal::instance()->luaEngine()->getGameObjectGossipInterfaceMap();
-        auto it = gMap.find(itr->first);
-        if (it == gMap.end())
+        for (auto itr = m_go_gossipBinding.begin(); itr != m_go_gossipBinding.end(); ++itr)
         {
-            GossipScript* gs = CreateLuaGOGossipScript(itr->first);
-            if (gs != nullptr)
+            typedef std::unordered_map<uint32_t, LuaGossip*> GMAP;
+            GMAP& gMap = getGameObjectGossipInterfaceMap();
+            auto it = gMap.find(itr->first);
+            if (it == gMap.end())
             {
-                m_scriptMgr->register_go_gossip(itr->first, gs);
-                gMap.insert(std::make_pair(itr->first, (LuaGossip*)nullptr));
+                GossipScript* gs = CreateLuaGOGossipScript(itr->first);
+                if (gs != nullptr)
+                {
+                    m_scriptMgr->register_go_gossip(itr->first, gs);
+                    gMap.insert(std::make_pair(itr->first, (LuaGossip*)nullptr));
+                }
+            }
+            else
+            {
+                LuaGossip* g_gossip = it->second;
+                if (g_gossip != nullptr)
+                    g_gossip->m_go_gossip_binding = &itr->second;
             }
         }
-        else
-        {
-            LuaGossip* g_gossip = it->second;
-            if (g_gossip != nullptr)
-                g_gossip->m_go_gossip_binding = &itr->second;
+
+        /*
+        BIG SERV HOOK CHUNK EEK
+        */
+        RegisterHook(SERVER_HOOK_EVENT_ON_NEW_CHARACTER, (void*)LuaHookOnNewCharacter)
+        RegisterHook(SERVER_HOOK_EVENT_ON_KILL_PLAYER, (void*)LuaHookOnKillPlayer)
+        RegisterHook(SERVER_HOOK_EVENT_ON_FIRST_ENTER_WORLD, (void*)LuaHookOnFirstEnterWorld)
+        RegisterHook(SERVER_HOOK_EVENT_ON_ENTER_WORLD, (void*)LuaHookOnEnterWorld)
+        RegisterHook(SERVER_HOOK_EVENT_ON_GUILD_JOIN, (void*)LuaHookOnGuildJoin)
+        RegisterHook(SERVER_HOOK_EVENT_ON_DEATH, (void*)LuaHookOnDeath)
+        RegisterHook(SERVER_HOOK_EVENT_ON_REPOP, (void*)LuaHookOnRepop)
+        RegisterHook(SERVER_HOOK_EVENT_ON_EMOTE, (void*)LuaHookOnEmote)
+        RegisterHook(SERVER_HOOK_EVENT_ON_ENTER_COMBAT, (void*)LuaHookOnEnterCombat)
+        RegisterHook(SERVER_HOOK_EVENT_ON_CAST_SPELL, (void*)LuaHookOnCastSpell)
+        RegisterHook(SERVER_HOOK_EVENT_ON_TICK, (void*)LuaHookOnTick)
+        RegisterHook(SERVER_HOOK_EVENT_ON_LOGOUT_REQUEST, (void*)LuaHookOnLogoutRequest)
+        RegisterHook(SERVER_HOOK_EVENT_ON_LOGOUT, (void*)LuaHookOnLogout)
+        RegisterHook(SERVER_HOOK_EVENT_ON_QUEST_ACCEPT, (void*)LuaHookOnQuestAccept)
+        RegisterHook(SERVER_HOOK_EVENT_ON_ZONE, (void*)LuaHookOnZone)
+        RegisterHook(SERVER_HOOK_EVENT_ON_CHAT, (void*)LuaHookOnChat)
+        RegisterHook(SERVER_HOOK_EVENT_ON_LOOT, (void*)LuaHookOnLoot)
+        RegisterHook(SERVER_HOOK_EVENT_ON_GUILD_CREATE, (void*)LuaHookOnGuildCreate)
+        RegisterHook(SERVER_HOOK_EVENT_ON_FULL_LOGIN, (void*)LuaHookOnEnterWorld2)
+        RegisterHook(SERVER_HOOK_EVENT_ON_CHARACTER_CREATE, (void*)LuaHookOnCharacterCreate)
+        RegisterHook(SERVER_HOOK_EVENT_ON_QUEST_CANCELLED, (void*)LuaHookOnQuestCancelled)
+        RegisterHook(SERVER_HOOK_EVENT_ON_QUEST_FINISHED, (void*)LuaHookOnQuestFinished)
+        RegisterHook(SERVER_HOOK_EVENT_ON_HONORABLE_KILL, (void*)LuaHookOnHonorableKill)
+        RegisterHook(SERVER_HOOK_EVENT_ON_ARENA_FINISH, (void*)LuaHookOnArenaFinish)
+        RegisterHook(SERVER_HOOK_EVENT_ON_OBJECTLOOT, (void*)LuaHookOnObjectLoot)
+        RegisterHook(SERVER_HOOK_EVENT_ON_AREATRIGGER, (void*)LuaHookOnAreaTrigger)
+        RegisterHook(SERVER_HOOK_EVENT_ON_POST_LEVELUP, (void*)LuaHookOnPostLevelUp)
+        RegisterHook(SERVER_HOOK_EVENT_ON_PRE_DIE, (void*)LuaHookOnPreUnitDie)
+        RegisterHook(SERVER_HOOK_EVENT_ON_ADVANCE_SKILLLINE, (void*)LuaHookOnAdvanceSkillLine)
+        RegisterHook(SERVER_HOOK_EVENT_ON_DUEL_FINISHED, (void*)LuaHookOnDuelFinished)
+        RegisterHook(SERVER_HOOK_EVENT_ON_AURA_REMOVE, (void*)LuaHookOnAuraRemove)
+        RegisterHook(SERVER_HOOK_EVENT_ON_RESURRECT, (void*)LuaHookOnResurrect)
+
+        for (const auto& dummySpell : m_luaDummySpells)
+        {
+            auto dummyHook = HookInfo.dummyHooks;
+            if (std::find(dummyHook.begin(), dummyHook.end(), dummySpell.first) == dummyHook.end())
+            {
+                m_scriptMgr->register_dummy_spell(dummySpell.first, &LuaOnDummySpell);
+                HookInfo.dummyHooks.push_back(dummySpell.first);
+            }
         }
     }
 
-    /*
-    BIG SERV HOOK CHUNK EEK
-    */
-    RegisterHook(SERVER_HOOK_EVENT_ON_NEW_CHARACTER, (void*)LuaHookOnNewCharacter)
-    RegisterHook(SERVER_HOOK_EVENT_ON_KILL_PLAYER, (void*)LuaHookOnKillPlayer)
-    RegisterHook(SERVER_HOOK_EVENT_ON_FIRST_ENTER_WORLD, (void*)LuaHookOnFirstEnterWorld)
-    RegisterHook(SERVER_HOOK_EVENT_ON_ENTER_WORLD, (void*)LuaHookOnEnterWorld)
-    RegisterHook(SERVER_HOOK_EVENT_ON_GUILD_JOIN, (void*)LuaHookOnGuildJoin)
-    RegisterHook(SERVER_HOOK_EVENT_ON_DEATH, (void*)LuaHookOnDeath)
-    RegisterHook(SERVER_HOOK_EVENT_ON_REPOP, (void*)LuaHookOnRepop)
-    RegisterHook(SERVER_HOOK_EVENT_ON_EMOTE, (void*)LuaHookOnEmote)
-    RegisterHook(SERVER_HOOK_EVENT_ON_ENTER_COMBAT, (void*)LuaHookOnEnterCombat)
-    RegisterHook(SERVER_HOOK_EVENT_ON_CAST_SPELL, (void*)LuaHookOnCastSpell)
-    RegisterHook(SERVER_HOOK_EVENT_ON_TICK, (void*)LuaHookOnTick)
-    RegisterHook(SERVER_HOOK_EVENT_ON_LOGOUT_REQUEST, (void*)LuaHookOnLogoutRequest)
-    RegisterHook(SERVER_HOOK_EVENT_ON_LOGOUT, (void*)LuaHookOnLogout)
-    RegisterHook(SERVER_HOOK_EVENT_ON_QUEST_ACCEPT, (void*)LuaHookOnQuestAccept)
-    RegisterHook(SERVER_HOOK_EVENT_ON_ZONE, (void*)LuaHookOnZone)
-    RegisterHook(SERVER_HOOK_EVENT_ON_CHAT, (void*)LuaHookOnChat)
-    RegisterHook(SERVER_HOOK_EVENT_ON_LOOT, (void*)LuaHookOnLoot)
-    RegisterHook(SERVER_HOOK_EVENT_ON_GUILD_CREATE, (void*)LuaHookOnGuildCreate)
-    RegisterHook(SERVER_HOOK_EVENT_ON_FULL_LOGIN, (void*)LuaHookOnEnterWorld2)
-    RegisterHook(SERVER_HOOK_EVENT_ON_CHARACTER_CREATE, (void*)LuaHookOnCharacterCreate)
-    RegisterHook(SERVER_HOOK_EVENT_ON_QUEST_CANCELLED, (void*)LuaHookOnQuestCancelled)
-    RegisterHook(SERVER_HOOK_EVENT_ON_QUEST_FINISHED, (void*)LuaHookOnQuestFinished)
-    RegisterHook(SERVER_HOOK_EVENT_ON_HONORABLE_KILL, (void*)LuaHookOnHonorableKill)
-    RegisterHook(SERVER_HOOK_EVENT_ON_ARENA_FINISH, (void*)LuaHookOnArenaFinish)
-    RegisterHook(SERVER_HOOK_EVENT_ON_OBJECTLOOT, (void*)LuaHookOnObjectLoot)
-    RegisterHook(SERVER_HOOK_EVENT_ON_AREATRIGGER, (void*)LuaHookOnAreaTrigger)
-    RegisterHook(SERVER_HOOK_EVENT_ON_POST_LEVELUP, (void*)LuaHookOnPostLevelUp)
-    RegisterHook(SERVER_HOOK_EVENT_ON_PRE_DIE, (void*)LuaHookOnPreUnitDie)
-    RegisterHook(SERVER_HOOK_EVENT_ON_ADVANCE_SKILLLINE, (void*)LuaHookOnAdvanceSkillLine)
-    RegisterHook(SERVER_HOOK_EVENT_ON_DUEL_FINISHED, (void*)LuaHookOnDuelFinished)
-    RegisterHook(SERVER_HOOK_EVENT_ON_AURA_REMOVE, (void*)LuaHookOnAuraRemove)
-    RegisterHook(SERVER_HOOK_EVENT_ON_RESURRECT, (void*)LuaHookOnResurrect)
+    //hyper: do OnSpawns for spawned creatures.
+    std::vector<uint32_t> temp = m_onLoadInfo;
+    m_onLoadInfo.clear();
 
-    for (const auto& dummySpell : LuaGlobal::instance()->m_luaDummySpells)
-    {
-        auto dummyHook = LuaGlobal::instance()->luaEngine()->HookInfo.dummyHooks;
-        if (std::find(dummyHook.begin(), dummyHook.end(), dummySpell.first) == dummyHook.end())
-        {
-            m_scriptMgr->register_dummy_spell(dummySpell.first, &LuaOnDummySpell);
-            LuaGlobal::instance()->luaEngine()->HookInfo.dummyHooks.push_back(dummySpell.first);
-        }
-    }
     RELEASE_LOCK
     getcoLock().Release();
 
-    //hyper: do OnSpawns for spawned creatures.
-    std::vector<uint32_t> temp = LuaGlobal::instance()->m_onLoadInfo;
-    LuaGlobal::instance()->m_onLoadInfo.clear();
     for (auto itr = temp.begin(); itr != temp.end(); itr += 3)
     {
         //*itr = mapid; *(itr+1) = iid; *(itr+2) = lowguid
@@ -3187,6 +3498,12 @@ void LuaEngine::Restart()
 
 void LuaEngine::ResumeLuaThread(int ref)
 {
+    if (!LuaGlobal::instance()->enterEngine(this))
+    {
+        postCall(new CallbackP1<LuaEngine, int>(this, &LuaEngine::ResumeLuaThread, ref));
+        return;
+    }
+
     getcoLock().Acquire();
     lua_State* expectedThread = nullptr;
     lua_rawgeti(lu, LUA_REGISTRYINDEX, ref);
@@ -3202,9 +3519,29 @@ void LuaEngine::ResumeLuaThread(int ref)
         if (lua_rawequal(lu, -1, -2))
         {
             lua_pop(lu, 2);
+
+            LuaFunctionProfile* profile = nullptr;
+            lua_Debug ar;
+            if (worldConfig.luaEngine.profileCalls && lua_getstack(expectedThread, 0, &ar) && lua_getinfo(expectedThread, "S", &ar))
+                profile = &m_profiler.getProfile(LUA_CALL_EVENT, 0, ar.source, ar.short_src, ar.linedefined);
+
+            if (m_callDepth++ == 0)
+                m_instructionCount = 0;
+
+            const bool outerBudgetExceeded = m_instructionBudgetExceeded;
+            m_instructionBudgetExceeded = false;
+            SetInstructionBudget(expectedThread);
+
+            const auto startTime = LuaProfiler::now();
             int res = lua_resume(expectedThread, expectedThread, lua_gettop(expectedThread));
+            --m_callDepth;
             if (res && res != LUA_YIELD)
                 report(expectedThread);
+
+            if (profile != nullptr)
+                m_profiler.record(*profile, startTime, res && res != LUA_YIELD, m_instructionBudgetExceeded);
+
+            m_instructionBudgetExceeded = outerBudgetExceeded;
         }
         else
         {
@@ -3213,6 +3550,7 @@ void LuaEngine::ResumeLuaThread(int ref)
         luaL_unref(lu, LUA_REGISTRYINDEX, ref);
     }
     getcoLock().Release();
+    RELEASE_LOCK
 }
 
 //I know its not a good idea to do it like that BUT it is the easiest way. I will make it better in steps:
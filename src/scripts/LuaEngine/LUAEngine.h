@@ -13,6 +13,7 @@ This file is released under the MIT license. See README-MIT for more information
 #include "LuaMacros.h"
 #include "LuaGlobal.h"
 #include "LuaHelpers.h"
+#include "LuaProfiler.h"
 
 #ifdef DEBUG
 #define LUA_USE_APICHECK
@@ -38,7 +39,7 @@ class LuaGossip;
 class ArcLuna;
 
 #define RegisterHook(evt, _func) { \
-    if(LuaGlobal::instance()->EventAsToFuncName[(evt)].size() > 0 && !(LuaGlobal::instance()->luaEngine()->HookInfo.hooks[(evt)])) { \
+    if(LuaGlobal::instance()->luaEngine()->EventAsToFuncName[(evt)].size() > 0 && !(LuaGlobal::instance()->luaEngine()->HookInfo.hooks[(evt)])) { \
         LuaGlobal::instance()->luaEngine()->HookInfo.hooks[(evt)] = true; \
         m_scriptMgr->register_hook( (ServerHookEvents)(evt), (_func) ); } }
 
@@ -167,6 +168,7 @@ enum CustomLuaEvenTypes
     EVENT_LUA_TIMED,
     EVENT_LUA_CREATURE_EVENTS,
     EVENT_LUA_GAMEOBJ_EVENTS,
+    EVENT_LUA_POSTED_CALL,
     LUA_EVENTS_END
 };
 
@@ -198,6 +200,17 @@ class LuaEngine
     std::set<int> m_functionRefs;
     std::map< uint64_t, std::set<int> > m_objectFunctionRefs;
 
+    // binding of the call prepared by BeginCall
+    LuaCallType m_callType;
+    uint32_t m_callEntry;
+
+    // guarded by call_lock
+    LuaProfiler m_profiler;
+    bool m_instructionBudgetExceeded;
+    // calls running in this state, the outermost one and the calls made by its script share one budget
+    uint32_t m_callDepth;
+    uint64_t m_instructionCount;
+
     //maps to creature, & go script interfaces
     std::multimap<uint32_t, LuaCreature*> m_cAIScripts;
     std::multimap<uint32_t, LuaGameObjectScript*> m_gAIScripts;
@@ -220,17 +233,36 @@ public:
     LuaEngine();
     ~LuaEngine(){}
     void Startup();
+    // map states only load the scripts, the main state registers them with the ScriptMgr
+    void StartupMapState();
     void LoadScripts();
     void Restart();
+    bool isMainState() { return LuaGlobal::instance()->getMainEngine() == this; }
+
+    GossipMenu* m_menu;
+    std::vector<uint32_t> m_onLoadInfo;
+    std::vector<uint16_t> EventAsToFuncName[NUM_SERVER_HOOKS];
+    std::map<uint32_t, uint16_t> m_luaDummySpells;
 
     void RegisterEvent(uint8_t, uint32_t, uint32_t, uint16_t);
     void ResumeLuaThread(int);
-    void BeginCall(uint16_t);
+    void BeginCall(uint16_t fReference, LuaCallType type = LUA_CALL_OTHER, uint32_t entry = 0);
     void HyperCallFunction(const char*, int);
     void CallFunctionByReference(int);
     void DestroyAllLuaEvents();
+    // runs the callback from the event holder of this state, for calls that found the state busy (see LuaGlobal)
+    void postCall(CallbackBase* callback);
     inline bool ExecuteCall(uint8_t params = 0, uint8_t res = 0);
     inline void EndCall(uint8_t res = 0);
+
+    // lua_pcall with LuaEngine.ProfileCalls and LuaEngine.InstructionBudget applied,
+    // the function and its params have to be on top of the stack
+    int ProtectedCall(int params, int results, LuaCallType type, uint32_t entry);
+    // adds the instructions counted by the hook, returns true when the outermost call ran out of budget
+    bool countInstructions(int count);
+
+    std::vector<LuaFunctionProfile> getProfiles();
+    void resetProfiles();
     // Wrappers
     Unit* CheckUnit(lua_State* L, int narg)
     {
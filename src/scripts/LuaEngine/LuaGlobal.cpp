@@ -5,10 +5,18 @@ This file is released under the MIT license. See README-MIT for more information
 
 #include "LuaGlobal.h"
 #include "LUAEngine.h"
+#include "Map/MapMgr.h"
+#include "Server/Master.h"
+#include "TLSObject.h"
+
+#include <algorithm>
 
 std::unique_ptr<LuaGlobal> LuaGlobal::s_instance;
 
-LuaGlobal::LuaGlobal(): m_menu(nullptr)
+// states entered by this thread, the last one is used
+thread_local std::vector<LuaEngine*> t_enteredEngines;
+
+LuaGlobal::LuaGlobal()
 {
 }
 
@@ -22,12 +30,116 @@ std::unique_ptr<LuaGlobal>& LuaGlobal::instance()
     return s_instance;
 }
 
-std::unique_ptr<LuaEngine>& LuaGlobal::luaEngine()
+LuaEngine* LuaGlobal::luaEngine()
+{
+    if (!t_enteredEngines.empty())
+        return t_enteredEngines.back();
+
+    if (!m_mapEngines.empty())
+    {
+        if (MapMgr* mapMgr = t_currentMapContext.get())
+            return getEngineForMap(mapMgr);
+    }
+
+    return getMainEngine();
+}
+
+LuaEngine* LuaGlobal::getMainEngine()
 {
     if (!s_luaEngine)
     {
         s_luaEngine = std::make_unique<LuaEngine>();
     }
 
-    return s_luaEngine;
+    return s_luaEngine.get();
+}
+
+LuaEngine* LuaGlobal::getEngineForMap(MapMgr* mapMgr)
+{
+    if (m_mapEngines.empty() || mapMgr == nullptr)
+        return getMainEngine();
+
+    // instances of the same map are spread over the states
+    const uint32_t stateIndex = (mapMgr->GetMapId() * 31 + mapMgr->GetInstanceID()) % static_cast<uint32_t>(m_mapEngines.size());
+    return m_mapEngines[stateIndex].get();
+}
+
+void LuaGlobal::startMapEngines(uint32_t count)
+{
+    if (count == 0)
+        return;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        auto engine = std::make_unique<LuaEngine>();
+        engine->StartupMapState();
+        m_mapEngines.push_back(std::move(engine));
+    }
+
+    DLLLogDetail("LuaEngineMgr : Loaded the scripts into %u map states", count);
+}
+
+bool LuaGlobal::enterEngine(LuaEngine* engine)
+{
+    if (engine == nullptr)
+        engine = luaEngine();
+
+    // only wait for a state while holding no other one, see LuaGlobal
+    const bool isOtherState = !t_enteredEngines.empty() && std::find(t_enteredEngines.begin(), t_enteredEngines.end(), engine) == t_enteredEngines.end();
+    if (isOtherState)
+    {
+        if (!engine->getLock().AttemptAcquire())
+        {
+            DLLLogDetail("LuaEngineMgr : Another Lua state is busy, posting the call to it");
+            return false;
+        }
+    }
+    else
+    {
+        engine->getLock().Acquire();
+    }
+
+    t_enteredEngines.push_back(engine);
+    return true;
+}
+
+void LuaGlobal::leaveEngine()
+{
+    LuaEngine* engine = t_enteredEngines.back();
+    t_enteredEngines.pop_back();
+    engine->getLock().Release();
+}
+
+void LuaGlobal::setSharedValue(std::string const& key, LuaSharedValue const& value)
+{
+    std::lock_guard<std::mutex> guard(m_sharedValuesMutex);
+
+    if (value.type == LuaSharedValue::Nil)
+        m_sharedValues.erase(key);
+    else
+        m_sharedValues[key] = value;
+}
+
+LuaSharedValue LuaGlobal::getSharedValue(std::string const& key)
+{
+    std::lock_guard<std::mutex> guard(m_sharedValuesMutex);
+
+    const auto itr = m_sharedValues.find(key);
+    return itr != m_sharedValues.end() ? itr->second : LuaSharedValue();
+}
+
+double LuaGlobal::addSharedValue(std::string const& key, double value)
+{
+    std::lock_guard<std::mutex> guard(m_sharedValuesMutex);
+
+    LuaSharedValue& sharedValue = m_sharedValues[key];
+    if (sharedValue.type != LuaSharedValue::Number)
+    {
+        sharedValue.type = LuaSharedValue::Number;
+        sharedValue.number = 0.0;
+        sharedValue.string.clear();
+    }
+
+    sharedValue.number += value;
+    return sharedValue.number;
 }
@@ -6,26 +6,83 @@ This file is released under the MIT license. See README-MIT for more information
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <Management/Gossip/GossipScript.hpp>
 #include <Server/Script/ScriptMgr.h>
 #include "WoWGuid.h"
 #include "Management/Gossip/GossipMenu.hpp"
 
 class LuaEngine;
+class MapMgr;
 
+// A value stored with SetSharedValue, only plain values can be shared between the Lua states
+struct LuaSharedValue
+{
+    enum Type : uint8_t
+    {
+        Nil,
+        Boolean,
+        Number,
+        String
+    };
+
+    Type type = Nil;
+    double number = 0.0;
+    std::string string;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Owns the Lua states.
+// The main state loads the scripts and registers them with the ScriptMgr. With
+// LuaEngine.MapStates set, every map is assigned to one of that many map states which
+// load the same scripts, so the maps only wait for each other when they share a state.
+// Every script sees the state of the map that calls it: creature, gameobject and
+// instance scripts keep the state they were created in, gossip, quest, hook and dummy
+// spell calls go to the state of the map the calling thread updates, everything else
+// (world events, console) to the main state.
+// Lua globals are not shared between the states, SetSharedValue/GetSharedValue/
+// AddSharedValue keep values that all maps need in LuaGlobal.
+// A script can still reach another state, e.g. when it makes a creature of another
+// state fire an event. The thread never waits for that state while it is inside its
+// own one: two threads doing so the other way round would deadlock. The call is made
+// when the other state is free at that moment, otherwise it is posted as an event to
+// the object of the script (or to the event holder of the state) and made from there,
+// outside of every state.
 class LuaGlobal
 {
     static std::unique_ptr<LuaGlobal> s_instance;
     LuaGlobal();
 
     std::unique_ptr<LuaEngine> s_luaEngine;
+    // created at startup and never resized, so they are read without a lock
+    std::vector<std::unique_ptr<LuaEngine>> m_mapEngines;
+
+    std::mutex m_sharedValuesMutex;
+    std::unordered_map<std::string, LuaSharedValue> m_sharedValues;
+
 public:
     static std::unique_ptr<LuaGlobal>& instance();
 
-    GossipMenu* m_menu;
-    std::vector<uint32_t> m_onLoadInfo;
-    std::vector<uint16_t> EventAsToFuncName[NUM_SERVER_HOOKS];
-    std::map<uint32_t, uint16_t> m_luaDummySpells;
+    // the state the calling thread is in, the state of the map it updates or the main state
+    LuaEngine* luaEngine();
+    LuaEngine* getMainEngine();
+    LuaEngine* getEngineForMap(MapMgr* mapMgr);
+
+    void startMapEngines(uint32_t count);
+    std::vector<std::unique_ptr<LuaEngine>>& getMapEngines() { return m_mapEngines; }
+
+    // locks the state and routes all calls of this thread to it until leaveEngine,
+    // without a state the one of the caller is used.
+    // Returns false without entering when the thread is inside another state and this one is busy,
+    // the caller posts the call then.
+    bool enterEngine(LuaEngine* engine = nullptr);
+    void leaveEngine();
 
-    std::unique_ptr<LuaEngine>& luaEngine();
+    void setSharedValue(std::string const& key, LuaSharedValue const& value);
+    LuaSharedValue getSharedValue(std::string const& key);
+    // adds to a number value in one step, returns the new value
+    double addSharedValue(std::string const& key, double value);
 };
@@ -65,7 +65,14 @@ This file is released under the MIT license. See README-MIT for more information
 #define REGTYPE_GO_GOSSIP (REGTYPE_GO | REGTYPE_GOSSIP)
 #define REGTYPE_ITEM_GOSSIP (REGTYPE_ITEM | REGTYPE_GOSSIP)
 
-#define GET_LOCK LuaGlobal::instance()->luaEngine()->getLock().Acquire();
-#define RELEASE_LOCK LuaGlobal::instance()->luaEngine()->getLock().Release();
-#define CHECK_BINDING_ACQUIRELOCK GET_LOCK if(m_binding == NULL) { RELEASE_LOCK return; }
+// enter the state of the caller, or a given one, all calls of the thread go to it until RELEASE_LOCK.
+// The state of the caller is always entered. A given one is busy when the thread is inside another
+// state (see LuaGlobal), GET_ENGINE_LOCK then returns from the function: it is only used where the
+// thread is inside no state (startup, console) or the function posts itself first.
+#define GET_LOCK LuaGlobal::instance()->enterEngine();
+#define GET_ENGINE_LOCK(engine) if (!LuaGlobal::instance()->enterEngine(engine)) return;
+#define RELEASE_LOCK LuaGlobal::instance()->leaveEngine();
+// enter the state of a creature, gameobject or instance script, takes the hook and its arguments.
+// When the state is busy the hook is posted to the object of the script and called from its map thread.
+#define CHECK_BINDING_ACQUIRELOCK(...) if (m_binding == NULL) return; if (!LuaGlobal::instance()->enterEngine(m_engine)) { postScriptCall(this, __VA_ARGS__); return; }
 #define sLuaEventMgr LuaGlobal::instance()->luaEngine()->LuaEventMgr
\ No newline at end of file
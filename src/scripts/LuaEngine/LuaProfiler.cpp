@@ -0,0 +1,154 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#include "LuaProfiler.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdarg>
+#include <cstdio>
+#include <map>
+#include <tuple>
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+
+namespace
+{
+    void writeLine(std::ostream& out, const char* format, ...)
+    {
+        char line[512];
+
+        va_list arguments;
+        va_start(arguments, format);
+        vsnprintf(line, sizeof(line), format, arguments);
+        va_end(arguments);
+
+        out << line << "\n";
+    }
+
+    double toMs(uint64_t time) { return static_cast<double>(time) / 1000.0; }
+
+    double getAverageUs(LuaCallTimings const& timings)
+    {
+        return timings.count ? static_cast<double>(timings.totalTime) / static_cast<double>(timings.count) : 0.0;
+    }
+}
+
+void LuaCallTimings::add(uint32_t time, bool failed, bool aborted)
+{
+    ++count;
+    totalTime += time;
+    maxTime = std::max(maxTime, time);
+
+    if (failed)
+        ++errorCount;
+
+    if (aborted)
+        ++abortCount;
+}
+
+void LuaCallTimings::merge(LuaCallTimings const& timings)
+{
+    count += timings.count;
+    totalTime += timings.totalTime;
+    maxTime = std::max(maxTime, timings.maxTime);
+    errorCount += timings.errorCount;
+    abortCount += timings.abortCount;
+}
+
+LuaFunctionProfile& LuaProfiler::getProfile(LuaCallType type, uint32_t entry, const char* source, const char* shortSource, int line)
+{
+    LuaFunctionProfile& profile = m_profiles[{ type, entry, source, line }];
+    if (profile.function.empty())
+    {
+        profile.type = type;
+        profile.entry = entry;
+        profile.function = std::string(shortSource) + ":" + std::to_string(line);
+    }
+
+    return profile;
+}
+
+void LuaProfiler::record(LuaFunctionProfile& profile, TimePoint startTime, bool failed, bool aborted)
+{
+    const auto time = static_cast<uint32_t>(duration_cast<microseconds>(now() - startTime).count());
+    profile.timings.add(time, failed, aborted);
+}
+
+std::vector<LuaFunctionProfile> LuaProfiler::getProfiles() const
+{
+    std::vector<LuaFunctionProfile> profiles;
+    profiles.reserve(m_profiles.size());
+
+    for (const auto& profile : m_profiles)
+        profiles.push_back(profile.second);
+
+    return profiles;
+}
+
+void LuaProfiler::writeReport(std::ostream& out, std::vector<LuaFunctionProfile> const& profiles, uint32_t count)
+{
+    std::array<LuaCallTimings, LUA_CALL_COUNT> typeTimings = {};
+    std::map<std::tuple<LuaCallType, uint32_t, std::string>, LuaCallTimings> functionTimings;
+
+    for (const auto& profile : profiles)
+    {
+        typeTimings[profile.type].merge(profile.timings);
+        functionTimings[std::make_tuple(profile.type, profile.entry, profile.function)].merge(profile.timings);
+    }
+
+    writeLine(out, "| %-11s | %10s | %10s | %9s | %9s | %7s | %7s |", "Type", "Calls", "Total ms", "Avg us", "Max us", "Errors", "Aborted");
+    for (uint8_t type = 0; type < LUA_CALL_COUNT; ++type)
+    {
+        const auto& timings = typeTimings[type];
+        if (timings.count == 0)
+            continue;
+
+        writeLine(out, "| %-11s | %10llu | %10.1f | %9.1f | %9u | %7llu | %7llu |", getCallTypeName(static_cast<LuaCallType>(type)),
+            static_cast<unsigned long long>(timings.count), toMs(timings.totalTime), getAverageUs(timings), timings.maxTime,
+            static_cast<unsigned long long>(timings.errorCount), static_cast<unsigned long long>(timings.abortCount));
+    }
+
+    std::vector<std::pair<std::tuple<LuaCallType, uint32_t, std::string>, LuaCallTimings>> slowest(functionTimings.begin(), functionTimings.end());
+    std::sort(slowest.begin(), slowest.end(), [](auto const& left, auto const& right) { return left.second.totalTime > right.second.totalTime; });
+    if (slowest.size() > count)
+        slowest.resize(count);
+
+    out << "\n";
+    writeLine(out, "| %-11s | %10s | %10s | %10s | %9s | %9s | %7s | %s", "Type", "Entry", "Calls", "Total ms", "Avg us", "Max us", "Errors", "Function");
+    for (const auto& function : slowest)
+    {
+        const auto& timings = function.second;
+        writeLine(out, "| %-11s | %10u | %10llu | %10.1f | %9.1f | %9u | %7llu | %s", getCallTypeName(std::get<0>(function.first)), std::get<1>(function.first),
+            static_cast<unsigned long long>(timings.count), toMs(timings.totalTime), getAverageUs(timings), timings.maxTime,
+            static_cast<unsigned long long>(timings.errorCount + timings.abortCount), std::get<2>(function.first).c_str());
+    }
+}
+
+const char* LuaProfiler::getCallTypeName(LuaCallType type)
+{
+    switch (type)
+    {
+        case LUA_CALL_CREATURE:
+            return "Creature";
+        case LUA_CALL_GAMEOBJECT:
+            return "GameObject";
+        case LUA_CALL_INSTANCE:
+            return "Instance";
+        case LUA_CALL_GOSSIP:
+            return "Gossip";
+        case LUA_CALL_QUEST:
+            return "Quest";
+        case LUA_CALL_HOOK:
+            return "Hook";
+        case LUA_CALL_DUMMY_SPELL:
+            return "DummySpell";
+        case LUA_CALL_EVENT:
+            return "Event";
+        default:
+            return "Other";
+    }
+}
@@ -0,0 +1,92 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum LuaCallType : uint8_t
+{
+    LUA_CALL_CREATURE,
+    LUA_CALL_GAMEOBJECT,
+    LUA_CALL_INSTANCE,
+    LUA_CALL_GOSSIP,
+    LUA_CALL_QUEST,
+    LUA_CALL_HOOK,
+    LUA_CALL_DUMMY_SPELL,
+    LUA_CALL_EVENT,
+    LUA_CALL_OTHER,
+    LUA_CALL_COUNT
+};
+
+struct LuaCallTimings
+{
+    uint64_t count = 0;
+    uint64_t totalTime = 0;             // microseconds
+    uint32_t maxTime = 0;
+    uint64_t errorCount = 0;
+    uint64_t abortCount = 0;            // stopped by LuaEngine.InstructionBudget
+
+    void add(uint32_t time, bool failed, bool aborted);
+    void merge(LuaCallTimings const& timings);
+};
+
+struct LuaFunctionProfile
+{
+    LuaCallType type = LUA_CALL_OTHER;
+    uint32_t entry = 0;                 // creature/gameobject entry, map id, quest id, hook or spell id
+    std::string function;               // source:line the function is defined at
+    LuaCallTimings timings;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Records the calls into one Lua state per binding type, entry and called function.
+// Functions are identified by their chunk and line instead of the registry ref, since
+// refs are reused by later events. It is only used under the lock of its state, the
+// report merges the profiles of all states by function name.
+class LuaProfiler
+{
+public:
+    typedef std::chrono::steady_clock::time_point TimePoint;
+
+    static TimePoint now() { return std::chrono::steady_clock::now(); }
+
+    // created on the first call of the function, source is the chunk name kept by the Lua state
+    LuaFunctionProfile& getProfile(LuaCallType type, uint32_t entry, const char* source, const char* shortSource, int line);
+    void record(LuaFunctionProfile& profile, TimePoint startTime, bool failed, bool aborted);
+
+    std::vector<LuaFunctionProfile> getProfiles() const;
+    void reset() { m_profiles.clear(); }
+
+    // writes the totals per binding type and the count functions with the most time
+    static void writeReport(std::ostream& out, std::vector<LuaFunctionProfile> const& profiles, uint32_t count);
+    static const char* getCallTypeName(LuaCallType type);
+
+private:
+    struct ProfileKey
+    {
+        LuaCallType type;
+        uint32_t entry;
+        const char* source;
+        int line;
+
+        bool operator==(ProfileKey const& key) const { return type == key.type && entry == key.entry && source == key.source && line == key.line; }
+    };
+
+    struct ProfileKeyHash
+    {
+        size_t operator()(ProfileKey const& key) const
+        {
+            return std::hash<const void*>()(key.source) ^ std::hash<uint64_t>()(static_cast<uint64_t>(key.entry) << 32 | static_cast<uint32_t>(key.line)) ^ key.type;
+        }
+    };
+
+    std::unordered_map<ProfileKey, LuaFunctionProfile, ProfileKeyHash> m_profiles;
+};
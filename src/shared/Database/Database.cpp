@@ -26,6 +26,7 @@
  //////////////////////////////////////////////
 
 #include "DatabaseCommon.hpp"
+#include "DatabaseSnapshot.hpp"
 #include "Util.hpp"
 #include <string>
 #include <vector>
@@ -86,6 +87,8 @@ Database::Database()
 
     m_dbConnection = nullptr;
     m_queryBufferConnection = nullptr;
+
+    m_snapshot = nullptr;
 }
 
 Database::~Database()
@@ -126,15 +129,8 @@ QueryResult* Database::Query(const char* QueryString, ...)
     vsnprintf(sql, 16384, QueryString, vlist);
     va_end(vlist);
 
-    // Send the query
-    QueryResult* qResult = NULL;
-    DatabaseConnection* con = GetFreeConnection();
-
-    if (_SendQuery(con, sql, false))
-        qResult = _StoreQueryResult(con);
-
-    con->Busy.Release();
-    return qResult;
+    bool success;
+    return _Query(sql, &success);
 }
 
 QueryResult* Database::Query(bool *success, const char* QueryString, ...)
@@ -145,37 +141,47 @@ QueryResult* Database::Query(bool *success, const char* QueryString, ...)
     vsnprintf(sql, 16384, QueryString, vlist);
     va_end(vlist);
 
-    // Send the query
-    QueryResult* qResult = NULL;
-    DatabaseConnection* con = GetFreeConnection();
+    return _Query(sql, success);
+}
+
+QueryResult* Database::QueryNA(const char* QueryString)
+{
+    bool success;
+    return _Query(QueryString, &success);
+}
+
+QueryResult* Database::_Query(const char* QueryString, bool* success)
+{
+    DatabaseSnapshot* snapshot = m_snapshot;
 
-    if (_SendQuery(con, sql, false))
+    QueryResult* qResult = NULL;
+    if (snapshot != nullptr && snapshot->tryQuery(QueryString, qResult))
     {
-        qResult = _StoreQueryResult(con);
         *success = true;
+        return qResult;
     }
-    else
-    {
-        *success = false;
-    }
-
-    con->Busy.Release();
-    return qResult;
-}
 
-QueryResult* Database::QueryNA(const char* QueryString)
-{
     // Send the query
-    QueryResult* qResult = NULL;
     DatabaseConnection* con = GetFreeConnection();
 
-    if (_SendQuery(con, QueryString, false))
+    *success = _SendQuery(con, QueryString, false);
+    if (*success)
         qResult = _StoreQueryResult(con);
 
     con->Busy.Release();
+
+    // failed queries are not recorded, they are sent again on the next start
+    if (snapshot != nullptr && *success)
+        qResult = snapshot->record(QueryString, qResult);
+
     return qResult;
 }
 
+void Database::setSnapshot(DatabaseSnapshot* snapshot)
+{
+    m_snapshot = snapshot;
+}
+
 QueryResult* Database::FQuery(const char* QueryString, DatabaseConnection* con)
 {
     // Send the query
@@ -201,19 +207,21 @@ void QueryBuffer::AddQuery(const char* format, ...)
     va_end(vlist);
 
     size_t len = strlen(query);
-    char* pBuffer = new char[len + 1];
-    memcpy(pBuffer, query, len + 1);
+    QueuedQuery queuedQuery;
+    queuedQuery.query = new char[len + 1];
+    memcpy(queuedQuery.query, query, len + 1);
 
-    queries.push_back(pBuffer);
+    queries.push_back(queuedQuery);
 }
 
 void QueryBuffer::AddQueryNA(const char* str)
 {
     size_t len = strlen(str);
-    char* pBuffer = new char[len + 1];
-    memcpy(pBuffer, str, len + 1);
+    QueuedQuery queuedQuery;
+    queuedQuery.query = new char[len + 1];
+    memcpy(queuedQuery.query, str, len + 1);
 
-    queries.push_back(pBuffer);
+    queries.push_back(queuedQuery);
 }
 
 void Database::destroyQueryBufferConnection()
@@ -230,8 +238,17 @@ void Database::dbRunAllQueries()
     while (auto query = queries_queue.pop())
     {
         createDbConnection();
-        _SendQuery(m_dbConnection, query, false);
-        delete[] query;
+        if (query->statement != nullptr)
+        {
+            _ExecutePrepared(m_dbConnection, query->statement, nullptr);
+            delete query->statement;
+        }
+        else
+        {
+            _SendQuery(m_dbConnection, query->query, false);
+            delete[] query->query;
+        }
+        delete query;
     }
 }
 
@@ -259,10 +276,19 @@ void Database::queryBufferRunAllQueries()
 void QueryBuffer::AddQueryStr(const std::string & str)
 {
     size_t len = str.size();
-    char* pBuffer = new char[len + 1];
-    memcpy(pBuffer, str.c_str(), len + 1);
+    QueuedQuery queuedQuery;
+    queuedQuery.query = new char[len + 1];
+    memcpy(queuedQuery.query, str.c_str(), len + 1);
+
+    queries.push_back(queuedQuery);
+}
+
+void QueryBuffer::addPreparedStatement(PreparedStatement* statement)
+{
+    QueuedQuery queuedQuery;
+    queuedQuery.statement = statement;
 
-    queries.push_back(pBuffer);
+    queries.push_back(queuedQuery);
 }
 
 void Database::PerformQueryBuffer(QueryBuffer* b, DatabaseConnection* ccon)
@@ -276,10 +302,18 @@ void Database::PerformQueryBuffer(QueryBuffer* b, DatabaseConnection* ccon)
 
     _BeginTransaction(con);
 
-    for (std::vector<char*>::iterator itr = b->queries.begin(); itr != b->queries.end(); ++itr)
+    for (std::vector<QueuedQuery>::iterator itr = b->queries.begin(); itr != b->queries.end(); ++itr)
     {
-        _SendQuery(con, *itr, false);
-        delete[](*itr);
+        if (itr->statement != nullptr)
+        {
+            _ExecutePrepared(con, itr->statement, nullptr);
+            delete itr->statement;
+        }
+        else
+        {
+            _SendQuery(con, itr->query, false);
+            delete[] itr->query;
+        }
     }
 
     _EndTransaction(con);
@@ -301,10 +335,11 @@ bool Database::Execute(const char* QueryString, ...)
         return WaitExecuteNA(query);
 
     size_t len = strlen(query);
-    char* pBuffer = new char[len + 1];
-    memcpy(pBuffer, query, len + 1);
+    QueuedQuery* queuedQuery = new QueuedQuery;
+    queuedQuery->query = new char[len + 1];
+    memcpy(queuedQuery->query, query, len + 1);
 
-    queries_queue.push(pBuffer);
+    queries_queue.push(queuedQuery);
     return true;
 }
 
@@ -314,10 +349,11 @@ bool Database::ExecuteNA(const char* QueryString)
         return WaitExecuteNA(QueryString);
 
     size_t len = strlen(QueryString);
-    char* pBuffer = new char[len + 1];
-    memcpy(pBuffer, QueryString, len + 1);
+    QueuedQuery* queuedQuery = new QueuedQuery;
+    queuedQuery->query = new char[len + 1];
+    memcpy(queuedQuery->query, QueryString, len + 1);
 
-    queries_queue.push(pBuffer);
+    queries_queue.push(queuedQuery);
     return true;
 }
 
@@ -344,6 +380,81 @@ bool Database::WaitExecuteNA(const char* QueryString)
     return Result;
 }
 
+void Database::registerPreparedStatement(uint32_t id, const char* sql)
+{
+    if (id >= m_preparedStatementSql.size())
+    {
+        m_preparedStatementSql.resize(id + 1);
+        m_preparedStatementParameterCounts.resize(id + 1, 0);
+    }
+
+    if (!m_preparedStatementSql[id].empty())
+        sLogger.failure("Database : Prepared statement %u is registered twice, `%s` replaces `%s`", id, sql, m_preparedStatementSql[id].c_str());
+
+    // statements contain no quoted '?', so every one of them is a parameter
+    uint32_t parameterCount = 0;
+    for (const char* c = sql; *c != '\0'; ++c)
+    {
+        if (*c == '?')
+            ++parameterCount;
+    }
+
+    m_preparedStatementSql[id] = sql;
+    m_preparedStatementParameterCounts[id] = parameterCount;
+}
+
+const std::string* Database::_GetPreparedStatementSql(uint32_t id) const
+{
+    if (id >= m_preparedStatementSql.size() || m_preparedStatementSql[id].empty())
+        return nullptr;
+
+    return &m_preparedStatementSql[id];
+}
+
+PreparedStatement* Database::getPreparedStatement(uint32_t id)
+{
+    if (_GetPreparedStatementSql(id) == nullptr)
+        sLogger.failure("Database : Prepared statement %u is not registered for database `%s`", id, mDatabaseName.c_str());
+
+    return new PreparedStatement(id, id < m_preparedStatementParameterCounts.size() ? m_preparedStatementParameterCounts[id] : 0);
+}
+
+bool Database::executePrepared(PreparedStatement* statement)
+{
+    DatabaseConnection* con = GetFreeConnection();
+    bool result = _ExecutePrepared(con, statement, nullptr);
+    con->Busy.Release();
+
+    delete statement;
+    return result;
+}
+
+void Database::executePreparedAsync(PreparedStatement* statement)
+{
+    if (m_dbThread->isKilled())
+    {
+        executePrepared(statement);
+        return;
+    }
+
+    QueuedQuery* queuedQuery = new QueuedQuery;
+    queuedQuery->statement = statement;
+
+    queries_queue.push(queuedQuery);
+}
+
+PreparedQueryResult* Database::queryPrepared(PreparedStatement* statement)
+{
+    PreparedQueryResult* result = nullptr;
+
+    DatabaseConnection* con = GetFreeConnection();
+    _ExecutePrepared(con, statement, &result);
+    con->Busy.Release();
+
+    delete statement;
+    return result;
+}
+
 void AsyncQuery::AddQuery(const char* format, ...)
 {
     AsyncQueryResult res;
@@ -22,8 +22,10 @@
 
 #include "CThreads.h"
 #include "Field.hpp"
+#include "PreparedStatement.hpp"
 #include <Threading/Queue.h>
 #include <CallBack.h>
+#include <atomic>
 #include <string>
 #include "Threading/AEThread.h"
 
@@ -31,6 +33,7 @@ class QueryResult;
 class QueryThread;
 class Database;
 class SQLCallbackBase;
+class DatabaseSnapshot;
 
 struct DatabaseConnection
 {
@@ -60,15 +63,25 @@ class SERVER_DECL AsyncQuery
         inline void SetDB(Database* dbb) { db = dbb; }
 };
 
+// text query or prepared statement, executed in the order they were added
+struct QueuedQuery
+{
+    char* query = nullptr;
+    PreparedStatement* statement = nullptr;
+};
+
 class SERVER_DECL QueryBuffer
 {
-        std::vector<char*> queries;
+        std::vector<QueuedQuery> queries;
     public:
 
         friend class Database;
         void AddQuery(const char* format, ...);
         void AddQueryNA(const char* str);
         void AddQueryStr(const std::string & str);
+
+        // takes the ownership of statement
+        void addPreparedStatement(PreparedStatement* statement);
 };
 
 class SERVER_DECL Database
@@ -139,6 +152,25 @@ class SERVER_DECL Database
 
         void FreeQueryResult(QueryResult* p);
 
+        //////////////////////////////////////////////////////////////////////////////////////////
+        // Prepared statements
+        // Statements are registered once at startup, before any of them is used. Every connection
+        // prepares a statement the first time it executes it. The functions below take the
+        // ownership of the statement returned by getPreparedStatement.
+        //////////////////////////////////////////////////////////////////////////////////////////
+        void registerPreparedStatement(uint32_t id, const char* sql);
+        PreparedStatement* getPreparedStatement(uint32_t id);
+
+        // wait for completion
+        bool executePrepared(PreparedStatement* statement);
+        // queued with the queries of Execute, which keeps their order
+        void executePreparedAsync(PreparedStatement* statement);
+        // nullptr when the statement fails or returns no rows
+        PreparedQueryResult* queryPrepared(PreparedStatement* statement);
+
+        // Query, QueryNA and their callers use the snapshot first and record the queries it does not contain
+        void setSnapshot(DatabaseSnapshot* snapshot);
+
         DatabaseConnection* GetFreeConnection();
 
         void PerformQueryBuffer(QueryBuffer* b, DatabaseConnection* ccon);
@@ -162,13 +194,25 @@ class SERVER_DECL Database
         virtual bool _SendQuery(DatabaseConnection* con, const char* Sql, bool Self) = 0;
         virtual QueryResult* _StoreQueryResult(DatabaseConnection* con) = 0;
 
+        // result is nullptr when the rows are not needed
+        virtual bool _ExecutePrepared(DatabaseConnection* con, PreparedStatement* statement, PreparedQueryResult** result) = 0;
+        const std::string* _GetPreparedStatementSql(uint32_t id) const;
+
+        QueryResult* _Query(const char* QueryString, bool* success);
+
+        std::atomic<DatabaseSnapshot*> m_snapshot;
+
         //////////////////////////////////////////////////////////////////////////////////////////
         FQueue<QueryBuffer*> query_buffer;
 
         //////////////////////////////////////////////////////////////////////////////////////////
-        FQueue<char*> queries_queue;
+        FQueue<QueuedQuery*> queries_queue;
         DatabaseConnection** Connections;
 
+        // sql of the registered prepared statements, indexed by statement id
+        std::vector<std::string> m_preparedStatementSql;
+        std::vector<uint32_t> m_preparedStatementParameterCounts;
+
         uint32 _counter;
         //////////////////////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,440 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#include "DatabaseSnapshot.hpp"
+
+#include "DatabaseCommon.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr char DATABASE_SNAPSHOT_MAGIC[4] = { 'A', 'E', 'S', 'N' };
+    constexpr uint32_t DATABASE_SNAPSHOT_FORMAT_VERSION = 1;
+
+    constexpr uint32_t SNAPSHOT_NULL_FIELD = UINT32_MAX;
+
+    template <typename T>
+    bool readValue(const char* data, size_t size, size_t& position, T& value)
+    {
+        if (size - position < sizeof(T))
+            return false;
+
+        memcpy(&value, data + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    void writeValue(FILE* file, T value)
+    {
+        fwrite(&value, sizeof(T), 1, file);
+    }
+
+    void appendValue(std::vector<char>& data, uint32_t value)
+    {
+        data.insert(data.end(), reinterpret_cast<const char*>(&value), reinterpret_cast<const char*>(&value) + sizeof(value));
+    }
+}
+
+SnapshotQueryResult::SnapshotQueryResult(const char* data, size_t size, uint32_t fieldCount, uint32_t rowCount, std::shared_ptr<std::vector<char>> ownedData) :
+    QueryResult(fieldCount, rowCount), m_data(data), m_size(size), m_position(0), m_readRows(0), m_ownedData(std::move(ownedData))
+{
+    mCurrentRow = new Field[fieldCount];
+
+    // same as MySQLDatabase::_StoreQueryResult, the first row is fetched right away
+    NextRow();
+}
+
+SnapshotQueryResult::~SnapshotQueryResult()
+{
+    delete[] mCurrentRow;
+}
+
+bool SnapshotQueryResult::NextRow()
+{
+    if (m_readRows >= mRowCount)
+        return false;
+
+    for (uint32_t i = 0; i < mFieldCount; ++i)
+    {
+        uint32_t length;
+        if (!readValue(m_data, m_size, m_position, length))
+            return false;
+
+        if (length == SNAPSHOT_NULL_FIELD)
+        {
+            mCurrentRow[i].SetValue(nullptr);
+            continue;
+        }
+
+        if (m_size - m_position < static_cast<size_t>(length) + 1)
+            return false;
+
+        // the snapshot data is never written, Field only takes non const values
+        mCurrentRow[i].SetValue(const_cast<char*>(m_data + m_position));
+        m_position += static_cast<size_t>(length) + 1;
+    }
+
+    ++m_readRows;
+    return true;
+}
+
+DatabaseSnapshot::DatabaseSnapshot() : m_hitCount(0), m_missCount(0)
+{
+}
+
+DatabaseSnapshot::~DatabaseSnapshot()
+{
+    unmapFile();
+}
+
+bool DatabaseSnapshot::open(std::string const& fileName, std::string const& key)
+{
+    close();
+
+    m_fileName = fileName;
+    m_key = key;
+    m_isOpen = true;
+    m_hitCount = 0;
+    m_missCount = 0;
+
+    if (!mapFile(fileName))
+        return false;
+
+    if (!readEntries(key))
+    {
+        m_entryIndices.clear();
+        m_entries.clear();
+        unmapFile();
+        return false;
+    }
+
+    m_entryUsed.reset(new std::atomic<bool>[m_entries.size()]());
+    return true;
+}
+
+void DatabaseSnapshot::close()
+{
+    if (!m_isOpen)
+        return;
+
+    size_t unusedCount = 0;
+    for (size_t i = 0; i < m_entries.size(); ++i)
+    {
+        if (!m_entryUsed[i])
+            ++unusedCount;
+    }
+
+    if (!m_recordedEntries.empty() || unusedCount != 0)
+    {
+        // the old file stays mapped until the new one is complete, its entries are copied from it
+        const std::string tempFileName = m_fileName + ".tmp";
+        const bool isWritten = writeFile(tempFileName);
+
+        unmapFile();
+
+        if (isWritten)
+        {
+            std::remove(m_fileName.c_str());
+            if (std::rename(tempFileName.c_str(), m_fileName.c_str()) != 0)
+                sLogger.failure("DatabaseSnapshot : Could not replace %s", m_fileName.c_str());
+            else
+                sLogger.info("DatabaseSnapshot : Saved %u queries to %s, %u new, %u removed", static_cast<uint32_t>(m_entries.size() - unusedCount + m_recordedEntries.size()),
+                    m_fileName.c_str(), static_cast<uint32_t>(m_recordedEntries.size()), static_cast<uint32_t>(unusedCount));
+        }
+        else
+        {
+            std::remove(tempFileName.c_str());
+        }
+    }
+
+    unmapFile();
+
+    m_entryIndices.clear();
+    m_entries.clear();
+    m_entryUsed.reset();
+    m_recordedEntries.clear();
+    m_recordedQueries.clear();
+    m_isOpen = false;
+}
+
+void DatabaseSnapshot::remove(std::string const& fileName)
+{
+    if (std::remove(fileName.c_str()) == 0)
+        sLogger.info("DatabaseSnapshot : Removed %s", fileName.c_str());
+}
+
+bool DatabaseSnapshot::tryQuery(const char* sql, QueryResult*& result)
+{
+    const auto itr = m_entryIndices.find(sql);
+    if (itr == m_entryIndices.end())
+    {
+        ++m_missCount;
+        return false;
+    }
+
+    ++m_hitCount;
+    m_entryUsed[itr->second] = true;
+
+    const Entry& entry = m_entries[itr->second];
+    result = entry.rowCount != 0 ? new SnapshotQueryResult(entry.data, static_cast<size_t>(entry.dataSize), entry.fieldCount, entry.rowCount) : nullptr;
+    return true;
+}
+
+QueryResult* DatabaseSnapshot::record(const char* sql, QueryResult* result)
+{
+    RecordedEntry entry;
+    entry.query = sql;
+    entry.fieldCount = result != nullptr ? result->GetFieldCount() : 0;
+    entry.rowCount = 0;
+    entry.data = std::make_shared<std::vector<char>>();
+
+    if (result != nullptr)
+    {
+        // the result is already on its first row
+        do
+        {
+            Field* fields = result->Fetch();
+            for (uint32_t i = 0; i < entry.fieldCount; ++i)
+            {
+                const char* value = fields[i].GetString();
+                if (value == nullptr)
+                {
+                    appendValue(*entry.data, SNAPSHOT_NULL_FIELD);
+                    continue;
+                }
+
+                const uint32_t length = static_cast<uint32_t>(strlen(value));
+                appendValue(*entry.data, length);
+                entry.data->insert(entry.data->end(), value, value + length + 1);
+            }
+
+            ++entry.rowCount;
+        } while (result->NextRow());
+
+        delete result;
+    }
+
+    QueryResult* snapshotResult = nullptr;
+    if (entry.rowCount != 0)
+        snapshotResult = new SnapshotQueryResult(entry.data->data(), entry.data->size(), entry.fieldCount, entry.rowCount, entry.data);
+
+    std::lock_guard<std::mutex> guard(m_recordMutex);
+    if (m_recordedQueries.insert(entry.query).second)
+        m_recordedEntries.push_back(std::move(entry));
+
+    return snapshotResult;
+}
+
+bool DatabaseSnapshot::mapFile(std::string const& fileName)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_fileHandle = file;
+    m_mappingHandle = mapping;
+    m_mappedData = static_cast<char*>(data);
+    m_mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const int file = ::open(fileName.c_str(), O_RDONLY);
+    if (file == -1)
+        return false;
+
+    struct stat fileStat;
+    if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    m_mappedData = static_cast<char*>(data);
+    m_mappedSize = static_cast<size_t>(fileStat.st_size);
+#endif
+
+    return true;
+}
+
+void DatabaseSnapshot::unmapFile()
+{
+    if (m_mappedData == nullptr)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_mappedData);
+    CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+    CloseHandle(static_cast<HANDLE>(m_fileHandle));
+    m_mappingHandle = nullptr;
+    m_fileHandle = nullptr;
+#else
+    munmap(m_mappedData, m_mappedSize);
+#endif
+
+    m_mappedData = nullptr;
+    m_mappedSize = 0;
+}
+
+bool DatabaseSnapshot::readEntries(std::string const& key)
+{
+    size_t position = 0;
+
+    char magic[4];
+    uint32_t formatVersion;
+    uint32_t keyLength;
+    if (m_mappedSize < sizeof(magic) || memcmp(m_mappedData, DATABASE_SNAPSHOT_MAGIC, sizeof(magic)) != 0)
+    {
+        sLogger.failure("DatabaseSnapshot : %s is not a database snapshot", m_fileName.c_str());
+        return false;
+    }
+
+    position += sizeof(magic);
+    if (!readValue(m_mappedData, m_mappedSize, position, formatVersion) || formatVersion != DATABASE_SNAPSHOT_FORMAT_VERSION)
+    {
+        sLogger.info("DatabaseSnapshot : %s has an old format, it is created again", m_fileName.c_str());
+        return false;
+    }
+
+    if (!readValue(m_mappedData, m_mappedSize, position, keyLength) || m_mappedSize - position < keyLength
+        || key.compare(0, std::string::npos, m_mappedData + position, keyLength) != 0)
+    {
+        sLogger.info("DatabaseSnapshot : World database changed since %s was created, it is created again", m_fileName.c_str());
+        return false;
+    }
+
+    position += keyLength;
+
+    uint32_t entryCount;
+    if (!readValue(m_mappedData, m_mappedSize, position, entryCount))
+        return false;
+
+    m_entries.reserve(entryCount);
+    m_entryIndices.reserve(entryCount);
+
+    for (uint32_t i = 0; i < entryCount; ++i)
+    {
+        uint32_t queryLength;
+        if (!readValue(m_mappedData, m_mappedSize, position, queryLength) || m_mappedSize - position < queryLength)
+            break;
+
+        std::string query(m_mappedData + position, queryLength);
+        position += queryLength;
+
+        Entry entry;
+        if (!readValue(m_mappedData, m_mappedSize, position, entry.fieldCount) || !readValue(m_mappedData, m_mappedSize, position, entry.rowCount)
+            || !readValue(m_mappedData, m_mappedSize, position, entry.dataSize) || m_mappedSize - position < entry.dataSize)
+            break;
+
+        entry.data = m_mappedData + position;
+        position += static_cast<size_t>(entry.dataSize);
+
+        m_entryIndices.emplace(std::move(query), m_entries.size());
+        m_entries.push_back(entry);
+    }
+
+    if (m_entries.size() != entryCount)
+    {
+        sLogger.failure("DatabaseSnapshot : %s is truncated, it is created again", m_fileName.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool DatabaseSnapshot::writeFile(std::string const& fileName)
+{
+    FILE* file = fopen(fileName.c_str(), "wb");
+    if (file == nullptr)
+    {
+        sLogger.failure("DatabaseSnapshot : Could not open %s", fileName.c_str());
+        return false;
+    }
+
+    uint32_t entryCount = static_cast<uint32_t>(m_recordedEntries.size());
+    for (size_t i = 0; i < m_entries.size(); ++i)
+    {
+        if (m_entryUsed[i])
+            ++entryCount;
+    }
+
+    fwrite(DATABASE_SNAPSHOT_MAGIC, sizeof(DATABASE_SNAPSHOT_MAGIC), 1, file);
+    writeValue(file, DATABASE_SNAPSHOT_FORMAT_VERSION);
+    writeValue(file, static_cast<uint32_t>(m_key.size()));
+    fwrite(m_key.data(), 1, m_key.size(), file);
+    writeValue(file, entryCount);
+
+    for (const auto& entryIndex : m_entryIndices)
+    {
+        if (!m_entryUsed[entryIndex.second])
+            continue;
+
+        const Entry& entry = m_entries[entryIndex.second];
+        writeValue(file, static_cast<uint32_t>(entryIndex.first.size()));
+        fwrite(entryIndex.first.data(), 1, entryIndex.first.size(), file);
+        writeValue(file, entry.fieldCount);
+        writeValue(file, entry.rowCount);
+        writeValue(file, entry.dataSize);
+        fwrite(entry.data, 1, static_cast<size_t>(entry.dataSize), file);
+    }
+
+    for (const auto& entry : m_recordedEntries)
+    {
+        writeValue(file, static_cast<uint32_t>(entry.query.size()));
+        fwrite(entry.query.data(), 1, entry.query.size(), file);
+        writeValue(file, entry.fieldCount);
+        writeValue(file, entry.rowCount);
+        writeValue(file, static_cast<uint64_t>(entry.data->size()));
+        if (!entry.data->empty())
+            fwrite(entry.data->data(), 1, entry.data->size(), file);
+    }
+
+    const bool isWritten = ferror(file) == 0;
+    if (fclose(file) != 0 || !isWritten)
+    {
+        sLogger.failure("DatabaseSnapshot : Could not write %s", fileName.c_str());
+        return false;
+    }
+
+    return true;
+}
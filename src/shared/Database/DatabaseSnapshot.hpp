@@ -0,0 +1,126 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include "Database.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Result rows of a query, stored as { uint32_t length (UINT32_MAX for NULL), char value[length], '\0' }
+// for every field. Field values point directly into the row data, which is either a memory
+// mapped snapshot file or a copy of a MySQL result.
+class SERVER_DECL SnapshotQueryResult : public QueryResult
+{
+public:
+    SnapshotQueryResult(const char* data, size_t size, uint32_t fieldCount, uint32_t rowCount, std::shared_ptr<std::vector<char>> ownedData = nullptr);
+    ~SnapshotQueryResult();
+
+    bool NextRow() override;
+
+private:
+    const char* m_data;
+    size_t m_size;
+    size_t m_position;
+    uint32_t m_readRows;
+
+    std::shared_ptr<std::vector<char>> m_ownedData;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Binary snapshot of query results, used to skip the database while the static world tables
+// are loaded at startup.
+// The file is only used when its key (built by the caller from the database revision and table
+// checksums) matches, otherwise every query goes to the database and its result is recorded.
+// On close() a new file is written when queries were missing or unused, it contains only the
+// results of this run.
+//
+// File layout (native byte order):
+//  char magic[4], uint32_t formatVersion, uint32_t keyLength, char key[keyLength], uint32_t entryCount
+//  entryCount x { uint32_t queryLength, char query[queryLength], uint32_t fieldCount, uint32_t rowCount,
+//                 uint64_t dataSize, char data[dataSize] }
+class SERVER_DECL DatabaseSnapshot
+{
+public:
+    DatabaseSnapshot();
+    ~DatabaseSnapshot();
+
+    DatabaseSnapshot(DatabaseSnapshot&&) = delete;
+    DatabaseSnapshot(DatabaseSnapshot const&) = delete;
+    DatabaseSnapshot& operator=(DatabaseSnapshot&&) = delete;
+    DatabaseSnapshot& operator=(DatabaseSnapshot const&) = delete;
+
+    // returns true when the file exists and belongs to key, the snapshot records in both cases
+    bool open(std::string const& fileName, std::string const& key);
+    void close();
+
+    bool isOpen() const { return m_isOpen; }
+    bool isLoaded() const { return m_mappedData != nullptr; }
+
+    static void remove(std::string const& fileName);
+
+    // true when the query is part of the snapshot, result is nullptr for empty results like Database::Query
+    bool tryQuery(const char* sql, QueryResult*& result);
+
+    // copies a database result into the snapshot, the returned result has to be used instead of the passed one
+    QueryResult* record(const char* sql, QueryResult* result);
+
+    uint32_t getHitCount() const { return m_hitCount; }
+    uint32_t getMissCount() const { return m_missCount; }
+
+private:
+    struct Entry
+    {
+        const char* data;
+        uint64_t dataSize;
+        uint32_t fieldCount;
+        uint32_t rowCount;
+    };
+
+    struct RecordedEntry
+    {
+        std::string query;
+        uint32_t fieldCount;
+        uint32_t rowCount;
+        std::shared_ptr<std::vector<char>> data;
+    };
+
+    bool mapFile(std::string const& fileName);
+    void unmapFile();
+    bool readEntries(std::string const& key);
+
+    bool writeFile(std::string const& fileName);
+
+    std::string m_fileName;
+    std::string m_key;
+    bool m_isOpen = false;
+
+    char* m_mappedData = nullptr;
+    size_t m_mappedSize = 0;
+#ifdef _WIN32
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#endif
+
+    // only written in open(), so lookups need no lock
+    std::unordered_map<std::string, size_t> m_entryIndices;
+    std::vector<Entry> m_entries;
+    std::unique_ptr<std::atomic<bool>[]> m_entryUsed;
+
+    std::mutex m_recordMutex;
+    std::vector<RecordedEntry> m_recordedEntries;
+    std::unordered_set<std::string> m_recordedQueries;
+
+    std::atomic<uint32_t> m_hitCount;
+    std::atomic<uint32_t> m_missCount;
+};
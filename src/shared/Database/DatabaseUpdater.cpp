@@ -91,15 +91,17 @@ void DatabaseUpdater::setupDatabase(std::string database, Database& dbPointer)
     }
 }
 
-void DatabaseUpdater::checkAndApplyDBUpdatesIfNeeded(std::string database, Database& dbPointer)
+bool DatabaseUpdater::checkAndApplyDBUpdatesIfNeeded(std::string database, Database& dbPointer)
 {
-    applyUpdatesForDatabase(database, dbPointer);
+    const uint32_t appliedUpdates = applyUpdatesForDatabase(database, dbPointer);
 
     while (dbPointer.GetQueueSize() > 0)
     {
         sLogger.info("-- busy updating database \"%s\". Waiting for %u queries to be executed.", database.c_str(), dbPointer.GetQueueSize());
         Arcemu::Sleep(500);
     }
+
+    return appliedUpdates != 0;
 }
 
 struct DatabaseUpdateFile
@@ -109,7 +111,7 @@ struct DatabaseUpdateFile
     uint32_t minorVersion;
 };
 
-void DatabaseUpdater::applyUpdatesForDatabase(std::string database, Database& dbPointer)
+uint32_t DatabaseUpdater::applyUpdatesForDatabase(std::string database, Database& dbPointer)
 {
     const std::string sqlUpdateDir = "sql/" + database + "/updates";
 
@@ -120,7 +122,7 @@ void DatabaseUpdater::applyUpdatesForDatabase(std::string database, Database& db
     if (!result)
     {
         sLogger.failure("%s_db_version query failed!", database.c_str());
-        return;
+        return 0;
     }
 
     Field* fields = result->Fetch();
@@ -231,4 +233,6 @@ void DatabaseUpdater::applyUpdatesForDatabase(std::string database, Database& db
             }
         }
     }
+
+    return static_cast<uint32_t>(applyNewUpdateFilesStore.size());
 }
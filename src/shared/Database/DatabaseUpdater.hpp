@@ -15,9 +15,10 @@ class DatabaseUpdater
 public:
     void static initBaseIfNeeded(std::string dbName, std::string dbBaseType, Database& dbPointer);
 
-    void static checkAndApplyDBUpdatesIfNeeded(std::string database, Database& dbPointer);
+    // returns true when update files were applied
+    bool static checkAndApplyDBUpdatesIfNeeded(std::string database, Database& dbPointer);
 
 private:
     void static setupDatabase(std::string database,  Database& dbPointer);
-    void static applyUpdatesForDatabase(std::string database, Database& dbPointer);
+    uint32_t static applyUpdatesForDatabase(std::string database, Database& dbPointer);
 };
@@ -21,12 +21,20 @@
 #include "DatabaseCommon.hpp"
 #include "MySQLDatabase.h"
 
+#include <memory>
+#include <type_traits>
+
+// my_bool before MySQL 8.0, bool since
+using MySQLBool = std::remove_pointer<decltype(MYSQL_BIND::is_null)>::type;
+
 MySQLDatabase::~MySQLDatabase()
 {
     for(int32 i = 0; i < mConnectionCount; ++i)
     {
-        mysql_close(((MySQLDatabaseConnection*)Connections[i])->MySql);
-        delete Connections[i];
+        MySQLDatabaseConnection* con = static_cast<MySQLDatabaseConnection*>(Connections[i]);
+        _ClosePreparedStatements(con);
+        mysql_close(con->MySql);
+        delete con;
     }
     delete [] Connections;
 }
@@ -237,9 +245,276 @@ bool MySQLDatabase::_Reconnect(MySQLDatabaseConnection* conn)
         return false;
     }
 
+    // statements belong to the old connection
+    _ClosePreparedStatements(conn);
+
     if(conn->MySql != NULL)
         mysql_close(conn->MySql);
 
     conn->MySql = temp;
     return true;
 }
+
+void MySQLDatabase::_ClosePreparedStatements(MySQLDatabaseConnection* con)
+{
+    for (MYSQL_STMT* stmt : con->Statements)
+    {
+        if (stmt != nullptr)
+            mysql_stmt_close(stmt);
+    }
+
+    con->Statements.clear();
+}
+
+MYSQL_STMT* MySQLDatabase::_GetPreparedStatement(MySQLDatabaseConnection* con, uint32_t id, uint32_t& errorNumber, std::string& error)
+{
+    if (id < con->Statements.size() && con->Statements[id] != nullptr)
+        return con->Statements[id];
+
+    const std::string* sql = _GetPreparedStatementSql(id);
+    if (sql == nullptr)
+    {
+        error = "statement is not registered";
+        return nullptr;
+    }
+
+    MYSQL_STMT* stmt = mysql_stmt_init(con->MySql);
+    if (stmt == nullptr)
+    {
+        errorNumber = mysql_errno(con->MySql);
+        error = mysql_error(con->MySql);
+        return nullptr;
+    }
+
+    if (mysql_stmt_prepare(stmt, sql->c_str(), static_cast<unsigned long>(sql->length())) != 0)
+    {
+        errorNumber = mysql_stmt_errno(stmt);
+        error = mysql_stmt_error(stmt);
+        mysql_stmt_close(stmt);
+        return nullptr;
+    }
+
+    if (id >= con->Statements.size())
+        con->Statements.resize(id + 1, nullptr);
+
+    con->Statements[id] = stmt;
+    return stmt;
+}
+
+bool MySQLDatabase::_ExecutePrepared(DatabaseConnection* con, PreparedStatement* statement, PreparedQueryResult** result)
+{
+    MySQLDatabaseConnection* mySqlCon = static_cast<MySQLDatabaseConnection*>(con);
+
+    uint32_t errorNumber = 0;
+    std::string error;
+    if (_ExecutePreparedStatement(mySqlCon, statement, result, errorNumber, error))
+        return true;
+
+    // 1243: Unknown prepared statement handler, 2030: Statement not prepared
+    // the server lost the statement (e.g. after an automatic reconnect), prepare it again
+    bool retry = errorNumber == 1243 || errorNumber == 2030;
+    if (retry)
+        _ClosePreparedStatements(mySqlCon);
+    else
+        retry = _HandleError(mySqlCon, errorNumber);
+
+    if (retry)
+    {
+        errorNumber = 0;
+        if (_ExecutePreparedStatement(mySqlCon, statement, result, errorNumber, error))
+            return true;
+    }
+
+    const std::string* sql = _GetPreparedStatementSql(statement->getId());
+    sLogger.failure("Prepared statement %u failed due to [%s], Query: [%s]", statement->getId(), error.c_str(), sql != nullptr ? sql->c_str() : "");
+    return false;
+}
+
+bool MySQLDatabase::_ExecutePreparedStatement(MySQLDatabaseConnection* con, PreparedStatement* statement, PreparedQueryResult** result, uint32_t& errorNumber, std::string& error)
+{
+    MYSQL_STMT* stmt = _GetPreparedStatement(con, statement->getId(), errorNumber, error);
+    if (stmt == nullptr)
+        return false;
+
+    std::vector<PreparedField>& parameters = statement->getParameters();
+    if (mysql_stmt_param_count(stmt) != parameters.size())
+    {
+        error = "statement has " + std::to_string(mysql_stmt_param_count(stmt)) + " parameters, " + std::to_string(parameters.size()) + " were passed";
+        return false;
+    }
+
+    // integers are sent as 64 bit values, the server converts them to the column type
+    std::vector<MYSQL_BIND> binds(parameters.size());
+    std::vector<unsigned long> lengths(parameters.size());
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        MYSQL_BIND& bind = binds[i];
+        switch (parameters[i].getType())
+        {
+            case PreparedField::Type::UInt64:
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.buffer = parameters[i].getUInt64Buffer();
+                bind.is_unsigned = true;
+                break;
+            case PreparedField::Type::Int64:
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.buffer = parameters[i].getInt64Buffer();
+                break;
+            case PreparedField::Type::Double:
+                bind.buffer_type = MYSQL_TYPE_DOUBLE;
+                bind.buffer = parameters[i].getDoubleBuffer();
+                break;
+            case PreparedField::Type::String:
+                lengths[i] = static_cast<unsigned long>(parameters[i].getStringBuffer().length());
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = &parameters[i].getStringBuffer()[0];
+                bind.buffer_length = lengths[i];
+                bind.length = &lengths[i];
+                break;
+            default:
+                bind.buffer_type = MYSQL_TYPE_NULL;
+                break;
+        }
+    }
+
+    if ((!binds.empty() && mysql_stmt_bind_param(stmt, binds.data())) || mysql_stmt_execute(stmt) != 0)
+    {
+        errorNumber = mysql_stmt_errno(stmt);
+        error = mysql_stmt_error(stmt);
+        return false;
+    }
+
+    if (mysql_stmt_field_count(stmt) == 0)
+        return true;
+
+    if (mysql_stmt_store_result(stmt) != 0)
+    {
+        errorNumber = mysql_stmt_errno(stmt);
+        error = mysql_stmt_error(stmt);
+        return false;
+    }
+
+    const bool success = _StorePreparedResult(stmt, result);
+    if (!success)
+    {
+        errorNumber = mysql_stmt_errno(stmt);
+        error = mysql_stmt_error(stmt);
+    }
+
+    mysql_stmt_free_result(stmt);
+    return success;
+}
+
+bool MySQLDatabase::_StorePreparedResult(MYSQL_STMT* stmt, PreparedQueryResult** result)
+{
+    const uint32_t rowCount = static_cast<uint32_t>(mysql_stmt_num_rows(stmt));
+    const uint32_t fieldCount = mysql_stmt_field_count(stmt);
+    if (result == nullptr || rowCount == 0)
+        return true;
+
+    MYSQL_RES* metadata = mysql_stmt_result_metadata(stmt);
+    if (metadata == nullptr)
+        return false;
+
+    MYSQL_FIELD* fields = mysql_fetch_fields(metadata);
+
+    union ColumnBuffer
+    {
+        uint64_t u;
+        int64_t i;
+        double d;
+    };
+
+    // numbers are fetched in binary form, everything else (decimals, dates, blobs) as string
+    std::vector<MYSQL_BIND> binds(fieldCount);
+    std::vector<ColumnBuffer> numberBuffers(fieldCount);
+    std::vector<std::vector<char>> stringBuffers(fieldCount);
+    std::vector<unsigned long> lengths(fieldCount);
+    // not a vector, MySQLBool is bool with MySQL 8 and std::vector<bool> has no addressable elements
+    std::unique_ptr<MySQLBool[]> nulls(new MySQLBool[fieldCount]());
+    for (uint32_t i = 0; i < fieldCount; ++i)
+    {
+        MYSQL_BIND& bind = binds[i];
+        bind.length = &lengths[i];
+        bind.is_null = &nulls[i];
+
+        switch (fields[i].type)
+        {
+            case MYSQL_TYPE_TINY:
+            case MYSQL_TYPE_SHORT:
+            case MYSQL_TYPE_INT24:
+            case MYSQL_TYPE_LONG:
+            case MYSQL_TYPE_LONGLONG:
+            case MYSQL_TYPE_YEAR:
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.buffer = &numberBuffers[i];
+                bind.is_unsigned = (fields[i].flags & UNSIGNED_FLAG) != 0;
+                break;
+            case MYSQL_TYPE_FLOAT:
+            case MYSQL_TYPE_DOUBLE:
+                bind.buffer_type = MYSQL_TYPE_DOUBLE;
+                bind.buffer = &numberBuffers[i];
+                break;
+            default:
+                // longer values are fetched with mysql_stmt_fetch_column
+                stringBuffers[i].resize(256);
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = stringBuffers[i].data();
+                bind.buffer_length = static_cast<unsigned long>(stringBuffers[i].size());
+                break;
+        }
+    }
+
+    mysql_free_result(metadata);
+
+    if (mysql_stmt_bind_result(stmt, binds.data()))
+        return false;
+
+    std::vector<PreparedField> values(static_cast<size_t>(rowCount) * fieldCount);
+    for (uint32_t row = 0; row < rowCount; ++row)
+    {
+        const int status = mysql_stmt_fetch(stmt);
+        if (status != 0 && status != MYSQL_DATA_TRUNCATED)
+            return false;
+
+        for (uint32_t i = 0; i < fieldCount; ++i)
+        {
+            if (nulls[i])
+                continue;
+
+            PreparedField& value = values[static_cast<size_t>(row) * fieldCount + i];
+            switch (binds[i].buffer_type)
+            {
+                case MYSQL_TYPE_LONGLONG:
+                    if (binds[i].is_unsigned)
+                        value.setUInt64(numberBuffers[i].u);
+                    else
+                        value.setInt64(numberBuffers[i].i);
+                    break;
+                case MYSQL_TYPE_DOUBLE:
+                    value.setDouble(numberBuffers[i].d);
+                    break;
+                default:
+                    if (lengths[i] <= stringBuffers[i].size())
+                    {
+                        value.setString(stringBuffers[i].data(), lengths[i]);
+                    }
+                    else
+                    {
+                        value.setString(std::string(lengths[i], '\0'));
+
+                        MYSQL_BIND column = MYSQL_BIND();
+                        column.buffer_type = MYSQL_TYPE_STRING;
+                        column.buffer = &value.getStringBuffer()[0];
+                        column.buffer_length = lengths[i];
+                        if (mysql_stmt_fetch_column(stmt, &column, i, 0) != 0)
+                            return false;
+                    }
+                    break;
+            }
+        }
+    }
+
+    *result = new PreparedQueryResult(fieldCount, rowCount, std::move(values));
+    return true;
+}
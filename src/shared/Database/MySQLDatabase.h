@@ -21,12 +21,16 @@
 #define _MYSQLDATABASE_H
 
 #include <string>
+#include <vector>
 #include <mysql.h>
 
 
 struct MySQLDatabaseConnection : public DatabaseConnection
 {
     MYSQL* MySql;
+
+    // prepared statements of this connection, indexed by statement id
+    std::vector<MYSQL_STMT*> Statements;
 };
 
 
@@ -63,6 +67,12 @@ class SERVER_DECL MySQLDatabase : public Database
         bool _Reconnect(MySQLDatabaseConnection* conn);
 
         QueryResult* _StoreQueryResult(DatabaseConnection* con);
+
+        bool _ExecutePrepared(DatabaseConnection* con, PreparedStatement* statement, PreparedQueryResult** result);
+        bool _ExecutePreparedStatement(MySQLDatabaseConnection* con, PreparedStatement* statement, PreparedQueryResult** result, uint32_t& errorNumber, std::string& error);
+        bool _StorePreparedResult(MYSQL_STMT* stmt, PreparedQueryResult** result);
+        MYSQL_STMT* _GetPreparedStatement(MySQLDatabaseConnection* con, uint32_t id, uint32_t& errorNumber, std::string& error);
+        void _ClosePreparedStatements(MySQLDatabaseConnection* con);
 };
 
 
@@ -0,0 +1,129 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#include "PreparedStatement.hpp"
+
+#include "Logging/Logger.hpp"
+
+const char* PreparedField::GetString()
+{
+    switch (m_type)
+    {
+        case Type::Null:
+            return nullptr;
+        case Type::UInt64:
+            m_string = std::to_string(m_value.u);
+            break;
+        case Type::Int64:
+            m_string = std::to_string(m_value.i);
+            break;
+        case Type::Double:
+            m_string = std::to_string(m_value.d);
+            break;
+        default:
+            break;
+    }
+
+    return m_string.c_str();
+}
+
+PreparedStatement::PreparedStatement(uint32_t id, uint32_t parameterCount) : m_id(id), m_parameters(parameterCount)
+{
+}
+
+PreparedField* PreparedStatement::getParameter(uint8_t index)
+{
+    if (index >= m_parameters.size())
+    {
+        sLogger.failure("PreparedStatement : Statement %u has %u parameters, parameter %u is not set", m_id, static_cast<uint32_t>(m_parameters.size()), index);
+        return nullptr;
+    }
+
+    return &m_parameters[index];
+}
+
+void PreparedStatement::setBool(uint8_t index, bool value)
+{
+    setUInt64(index, value ? 1 : 0);
+}
+
+void PreparedStatement::setUInt8(uint8_t index, uint8_t value)
+{
+    setUInt64(index, value);
+}
+
+void PreparedStatement::setInt8(uint8_t index, int8_t value)
+{
+    setInt64(index, value);
+}
+
+void PreparedStatement::setUInt16(uint8_t index, uint16_t value)
+{
+    setUInt64(index, value);
+}
+
+void PreparedStatement::setInt16(uint8_t index, int16_t value)
+{
+    setInt64(index, value);
+}
+
+void PreparedStatement::setUInt32(uint8_t index, uint32_t value)
+{
+    setUInt64(index, value);
+}
+
+void PreparedStatement::setInt32(uint8_t index, int32_t value)
+{
+    setInt64(index, value);
+}
+
+void PreparedStatement::setUInt64(uint8_t index, uint64_t value)
+{
+    if (PreparedField* parameter = getParameter(index))
+        parameter->setUInt64(value);
+}
+
+void PreparedStatement::setInt64(uint8_t index, int64_t value)
+{
+    if (PreparedField* parameter = getParameter(index))
+        parameter->setInt64(value);
+}
+
+void PreparedStatement::setFloat(uint8_t index, float value)
+{
+    setDouble(index, value);
+}
+
+void PreparedStatement::setDouble(uint8_t index, double value)
+{
+    if (PreparedField* parameter = getParameter(index))
+        parameter->setDouble(value);
+}
+
+void PreparedStatement::setString(uint8_t index, std::string value)
+{
+    if (PreparedField* parameter = getParameter(index))
+        parameter->setString(std::move(value));
+}
+
+void PreparedStatement::setNull(uint8_t index)
+{
+    if (PreparedField* parameter = getParameter(index))
+        parameter->setNull();
+}
+
+PreparedQueryResult::PreparedQueryResult(uint32_t fieldCount, uint32_t rowCount, std::vector<PreparedField> fields) :
+    m_fieldCount(fieldCount), m_rowCount(rowCount), m_currentRow(0), m_fields(std::move(fields))
+{
+}
+
+bool PreparedQueryResult::NextRow()
+{
+    if (m_currentRow + 1 >= m_rowCount)
+        return false;
+
+    ++m_currentRow;
+    return true;
+}
@@ -0,0 +1,156 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include "Common.hpp"
+#include "CommonTypes.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Typed value of a prepared statement parameter or of a column in a prepared result.
+// Integers are kept as 64 bit values and floating point values as double, the getters
+// convert them like a static_cast. String values are only parsed when a number is requested.
+class SERVER_DECL PreparedField
+{
+public:
+    enum class Type : uint8_t
+    {
+        Null,
+        UInt64,
+        Int64,
+        Double,
+        String
+    };
+
+    PreparedField() { m_value.u = 0; }
+
+    bool isSet() const { return m_type != Type::Null; }
+    Type getType() const { return m_type; }
+
+    void setNull() { m_type = Type::Null; m_string.clear(); }
+    void setUInt64(uint64_t value) { m_type = Type::UInt64; m_value.u = value; }
+    void setInt64(int64_t value) { m_type = Type::Int64; m_value.i = value; }
+    void setDouble(double value) { m_type = Type::Double; m_value.d = value; }
+    void setString(std::string value) { m_type = Type::String; m_string = std::move(value); }
+    void setString(const char* value, size_t length) { m_type = Type::String; m_string.assign(value, length); }
+
+    // same names as Field, so loaders can switch between both results
+    const char* GetString();
+    float GetFloat() const { return getNumber<float>(); }
+    double GetDouble() const { return getNumber<double>(); }
+    bool GetBool() const { return getNumber<int64_t>() > 0; }
+
+    uint8_t GetUInt8() const { return getNumber<uint8_t>(); }
+    int8_t GetInt8() const { return getNumber<int8_t>(); }
+    uint16_t GetUInt16() const { return getNumber<uint16_t>(); }
+    int16_t GetInt16() const { return getNumber<int16_t>(); }
+    uint32_t GetUInt32() const { return getNumber<uint32_t>(); }
+    int32_t GetInt32() const { return getNumber<int32_t>(); }
+    uint64_t GetUInt64() const { return getNumber<uint64_t>(); }
+    int64_t GetInt64() const { return getNumber<int64_t>(); }
+
+    // raw storage, used by the database backend to bind the value
+    uint64_t* getUInt64Buffer() { return &m_value.u; }
+    int64_t* getInt64Buffer() { return &m_value.i; }
+    double* getDoubleBuffer() { return &m_value.d; }
+    std::string& getStringBuffer() { return m_string; }
+
+private:
+    template <typename T>
+    T getNumber() const
+    {
+        switch (m_type)
+        {
+            case Type::UInt64:
+                return static_cast<T>(m_value.u);
+            case Type::Int64:
+                return static_cast<T>(m_value.i);
+            case Type::Double:
+                return static_cast<T>(m_value.d);
+            case Type::String:
+                if (std::is_floating_point<T>::value)
+                    return static_cast<T>(strtod(m_string.c_str(), nullptr));
+                if (std::is_signed<T>::value)
+                    return static_cast<T>(strtoll(m_string.c_str(), nullptr, 10));
+                return static_cast<T>(strtoull(m_string.c_str(), nullptr, 10));
+            default:
+                return T();
+        }
+    }
+
+    Type m_type = Type::Null;
+    union
+    {
+        uint64_t u;
+        int64_t i;
+        double d;
+    } m_value;
+
+    std::string m_string;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// A statement registered with Database::registerPreparedStatement and its parameters.
+// Created by Database::getPreparedStatement, the execute and query functions of Database
+// take the ownership. Parameters are counted from 0 in the order of the '?' in the sql,
+// a parameter that is never set is sent as NULL.
+class SERVER_DECL PreparedStatement
+{
+public:
+    PreparedStatement(uint32_t id, uint32_t parameterCount);
+
+    uint32_t getId() const { return m_id; }
+
+    void setBool(uint8_t index, bool value);
+    void setUInt8(uint8_t index, uint8_t value);
+    void setInt8(uint8_t index, int8_t value);
+    void setUInt16(uint8_t index, uint16_t value);
+    void setInt16(uint8_t index, int16_t value);
+    void setUInt32(uint8_t index, uint32_t value);
+    void setInt32(uint8_t index, int32_t value);
+    void setUInt64(uint8_t index, uint64_t value);
+    void setInt64(uint8_t index, int64_t value);
+    void setFloat(uint8_t index, float value);
+    void setDouble(uint8_t index, double value);
+    void setString(uint8_t index, std::string value);
+    void setNull(uint8_t index);
+
+    std::vector<PreparedField>& getParameters() { return m_parameters; }
+
+private:
+    PreparedField* getParameter(uint8_t index);
+
+    uint32_t m_id;
+    std::vector<PreparedField> m_parameters;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Binary result of a prepared statement, used like QueryResult: it is only created for
+// results with at least one row and Fetch() returns the first row after creation.
+class SERVER_DECL PreparedQueryResult
+{
+public:
+    PreparedQueryResult(uint32_t fieldCount, uint32_t rowCount, std::vector<PreparedField> fields);
+
+    bool NextRow();
+
+    PreparedField* Fetch() { return &m_fields[m_currentRow * m_fieldCount]; }
+    uint32_t GetFieldCount() const { return m_fieldCount; }
+    uint32_t GetRowCount() const { return m_rowCount; }
+
+private:
+    uint32_t m_fieldCount;
+    uint32_t m_rowCount;
+    uint32_t m_currentRow;
+
+    // rowCount * fieldCount values, row by row
+    std::vector<PreparedField> m_fields;
+};
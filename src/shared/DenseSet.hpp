@@ -0,0 +1,193 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+// Default index policy: erase and contains search linearly.
+template <typename T>
+struct DenseSetLinearIndex
+{
+    typedef T Key;
+    static constexpr bool isHashed = false;
+
+    static Key getKey(T value) { return value; }
+};
+
+// Index policy for larger sets: the set keeps a hash map from the key of an element to its slot.
+// Nothing is stored in the elements, so they can be in any number of sets at once.
+template <typename T>
+struct DenseSetHashIndex
+{
+    typedef T Key;
+    static constexpr bool isHashed = true;
+
+    static Key getKey(T value) { return value; }
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Unordered set stored in one contiguous vector.
+// Iterating is linear in memory and insert does not allocate once the vector has grown.
+// Erase moves the last element into the freed slot.
+//
+// With a hashed IndexPolicy erase and contains are O(1), without one they search linearly,
+// which is fine for small sets. IndexPolicy::getKey(value) is only called by insert and by
+// the calls taking a value, the keys are stored next to the elements: eraseKey never touches
+// the element, it may already be deleted.
+//
+// Elements may be inserted and erased from inside forEach. Every element that is in the
+// set for the whole loop is visited exactly once, inserted elements are visited as well.
+template <typename T, typename IndexPolicy = DenseSetLinearIndex<T>>
+class DenseSet
+{
+public:
+    typedef typename IndexPolicy::Key Key;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    bool insert(T value)
+    {
+        const Key key = IndexPolicy::getKey(value);
+
+        if constexpr (IndexPolicy::isHashed)
+        {
+            if (!m_slots.emplace(key, static_cast<uint32_t>(m_values.size())).second)
+                return false;
+
+            m_keys.push_back(key);
+        }
+        else if (findKey(key) != npos)
+        {
+            return false;
+        }
+
+        m_values.push_back(value);
+        return true;
+    }
+
+    bool erase(T value) { return eraseKey(IndexPolicy::getKey(value)); }
+
+    bool eraseKey(Key const& key)
+    {
+        const size_t position = findKey(key);
+        if (position == npos)
+            return false;
+
+        eraseAt(position);
+        return true;
+    }
+
+    bool contains(T value) const { return find(value) != npos; }
+
+    size_t find(T value) const { return findKey(IndexPolicy::getKey(value)); }
+
+    size_t findKey(Key const& key) const
+    {
+        if constexpr (IndexPolicy::isHashed)
+        {
+            const auto itr = m_slots.find(key);
+            return itr != m_slots.end() ? itr->second : npos;
+        }
+        else
+        {
+            for (size_t i = 0; i < m_values.size(); ++i)
+                if (m_values[i] == key)
+                    return i;
+
+            return npos;
+        }
+    }
+
+    // Calls func for every element, func may insert and erase elements (not nested)
+    template <typename Func>
+    void forEach(Func func)
+    {
+        m_isIterating = true;
+
+        // m_cursor is moved back by eraseAt when the current element is erased
+        for (m_cursor = 0; m_cursor < m_values.size(); ++m_cursor)
+            func(m_values[m_cursor]);
+
+        m_isIterating = false;
+    }
+
+    // Elements are not touched, they may already be deleted
+    void clear()
+    {
+        m_values.clear();
+        m_keys.clear();
+        m_slots.clear();
+    }
+
+    void reserve(size_t count)
+    {
+        m_values.reserve(count);
+
+        if constexpr (IndexPolicy::isHashed)
+        {
+            m_keys.reserve(count);
+            m_slots.reserve(count);
+        }
+    }
+
+    size_t size() const { return m_values.size(); }
+    bool empty() const { return m_values.empty(); }
+
+    const_iterator begin() const { return m_values.begin(); }
+    const_iterator end() const { return m_values.end(); }
+
+private:
+    void eraseAt(size_t position)
+    {
+        if constexpr (IndexPolicy::isHashed)
+            m_slots.erase(m_keys[position]);
+
+        // Erasing at or before the cursor: move the current (already visited) element into the
+        // freed slot and free the cursor slot instead, it is filled with the unvisited last element
+        // and visited again after the cursor moved back.
+        if (m_isIterating && position <= m_cursor)
+        {
+            if (position != m_cursor)
+                moveElement(m_cursor, position);
+
+            position = m_cursor--;
+        }
+
+        const size_t last = m_values.size() - 1;
+        if (position != last)
+            moveElement(last, position);
+
+        m_values.pop_back();
+
+        if constexpr (IndexPolicy::isHashed)
+            m_keys.pop_back();
+    }
+
+    void moveElement(size_t from, size_t to)
+    {
+        m_values[to] = m_values[from];
+
+        if constexpr (IndexPolicy::isHashed)
+        {
+            m_keys[to] = m_keys[from];
+            m_slots[m_keys[to]] = static_cast<uint32_t>(to);
+        }
+    }
+
+    std::vector<T> m_values;
+
+    // only used with a hashed index, m_keys[i] is the key of m_values[i]
+    std::vector<Key> m_keys;
+    std::unordered_map<Key, uint32_t> m_slots;
+
+    bool m_isIterating = false;
+    size_t m_cursor = 0;
+};
@@ -0,0 +1,180 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#include "AsyncLogWriter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace AscEmu::Logging
+{
+    namespace
+    {
+        std::atomic<uint64_t> nextWriterId = 1;
+    }
+
+    AsyncLogWriter::AsyncLogWriter(WriteCallback writeCallback, FlushCallback flushCallback, uint32_t flushInterval, uint32_t bufferSize, bool dropWhenFull) :
+        m_writeCallback(std::move(writeCallback)), m_flushCallback(std::move(flushCallback)), m_flushInterval(std::max(flushInterval, 1u)),
+        m_bufferSize(std::max(bufferSize, 16u)), m_dropWhenFull(dropWhenFull), m_id(nextWriterId++)
+    {
+        m_thread = std::thread(&AsyncLogWriter::run, this);
+    }
+
+    AsyncLogWriter::~AsyncLogWriter()
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_wakeUpMutex);
+            m_isRunning = false;
+        }
+        m_wakeUpCondition.notify_one();
+
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+    void AsyncLogWriter::push(Severity severity, uint8_t targets, const char* text)
+    {
+        ProducerBuffer* buffer = getProducerBuffer();
+
+        LogEntry* entry = buffer->ring.beginPush();
+        if (entry == nullptr)
+        {
+            if (m_dropWhenFull && severity < FAILURE)
+            {
+                ++m_droppedCount;
+                return;
+            }
+
+            ++m_blockedCount;
+            while ((entry = buffer->ring.beginPush()) == nullptr)
+            {
+                wakeUp();
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+
+        // the slot keeps the capacity of its string, so this only allocates for longer messages
+        entry->severity = severity;
+        entry->targets = targets;
+        entry->text.assign(text);
+        buffer->ring.commitPush();
+
+        if (severity >= FAILURE || buffer->ring.size() * 2 >= buffer->ring.capacity())
+            wakeUp();
+    }
+
+    AsyncLogStats AsyncLogWriter::getStats()
+    {
+        std::lock_guard<std::mutex> guard(m_buffersMutex);
+        return { m_writtenCount.load(), m_droppedCount.load(), m_blockedCount.load(), static_cast<uint32_t>(m_buffers.size()) };
+    }
+
+    AsyncLogWriter::ProducerBuffer* AsyncLogWriter::getProducerBuffer()
+    {
+        // the buffer stays registered until the writer emptied it after the thread ended
+        struct ProducerHandle
+        {
+            uint64_t writerId = 0;
+            std::shared_ptr<ProducerBuffer> buffer;
+
+            ~ProducerHandle()
+            {
+                if (buffer)
+                    buffer->abandoned = true;
+            }
+        };
+
+        thread_local ProducerHandle handle;
+
+        if (handle.writerId != m_id)
+        {
+            if (handle.buffer)
+                handle.buffer->abandoned = true;
+
+            handle.writerId = m_id;
+            handle.buffer = std::make_shared<ProducerBuffer>(m_bufferSize);
+
+            std::lock_guard<std::mutex> guard(m_buffersMutex);
+            m_buffers.push_back(handle.buffer);
+        }
+
+        return handle.buffer.get();
+    }
+
+    void AsyncLogWriter::run()
+    {
+        while (true)
+        {
+            bool isRunning;
+            {
+                std::unique_lock<std::mutex> lock(m_wakeUpMutex);
+                m_wakeUpCondition.wait_for(lock, std::chrono::milliseconds(m_flushInterval), [this] { return m_wakeUpRequested || !m_isRunning; });
+
+                m_wakeUpRequested = false;
+                isRunning = m_isRunning;
+            }
+
+            if (writeQueuedEntries() != 0)
+                m_flushCallback();
+
+            if (!isRunning)
+                break;
+        }
+    }
+
+    size_t AsyncLogWriter::writeQueuedEntries()
+    {
+        size_t count = 0;
+
+        std::lock_guard<std::mutex> guard(m_buffersMutex);
+
+        for (auto itr = m_buffers.begin(); itr != m_buffers.end();)
+        {
+            ProducerBuffer* buffer = itr->get();
+
+            // read before emptying, a buffer abandoned afterwards is emptied on the next run
+            const bool isAbandoned = buffer->abandoned;
+
+            while (LogEntry* entry = buffer->ring.front())
+            {
+                m_writeCallback(*entry);
+                buffer->ring.pop();
+                ++count;
+            }
+
+            if (isAbandoned)
+                itr = m_buffers.erase(itr);
+            else
+                ++itr;
+        }
+
+        m_writtenCount += count;
+
+        const uint64_t droppedCount = m_droppedCount;
+        if (droppedCount != m_reportedDroppedCount)
+        {
+            LogEntry entry;
+            entry.severity = WARNING;
+            entry.targets = LOG_TARGET_CONSOLE | LOG_TARGET_NORMAL_FILE;
+            entry.text = "Logger : " + std::to_string(droppedCount - m_reportedDroppedCount) + " messages dropped, log buffer was full";
+            m_writeCallback(entry);
+
+            m_reportedDroppedCount = droppedCount;
+            ++count;
+        }
+
+        return count;
+    }
+
+    void AsyncLogWriter::wakeUp()
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_wakeUpMutex);
+            m_wakeUpRequested = true;
+        }
+        m_wakeUpCondition.notify_one();
+    }
+}
@@ -0,0 +1,109 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Severity.hpp"
+#include "Threading/SpscRingBuffer.hpp"
+
+namespace AscEmu::Logging
+{
+    enum LogTarget : uint8_t
+    {
+        LOG_TARGET_CONSOLE      = 0x01,
+        LOG_TARGET_NORMAL_FILE  = 0x02,
+        LOG_TARGET_ERROR_FILE   = 0x04
+    };
+
+    struct LogEntry
+    {
+        Severity severity = INFO;
+        uint8_t targets = 0;
+        std::string text;
+    };
+
+    struct AsyncLogStats
+    {
+        uint64_t written;
+        uint64_t dropped;
+        uint64_t blocked;           // messages that waited for a full buffer
+        uint32_t producerCount;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // Moves the writing of log messages off the logging threads.
+    // Every thread that logs gets its own lock-free ring buffer, the writer thread empties
+    // them, hands the messages to the write callback and flushes once per batch.
+    // When a buffer is full the message is dropped if dropWhenFull is set, otherwise the
+    // producer waits for the writer. Errors always wait and wake the writer at once.
+    class AsyncLogWriter
+    {
+    public:
+        typedef std::function<void(LogEntry const&)> WriteCallback;
+        typedef std::function<void()> FlushCallback;
+
+        AsyncLogWriter(WriteCallback writeCallback, FlushCallback flushCallback, uint32_t flushInterval, uint32_t bufferSize, bool dropWhenFull);
+
+        // writes all queued messages before the writer thread stops
+        ~AsyncLogWriter();
+
+        AsyncLogWriter(AsyncLogWriter&&) = delete;
+        AsyncLogWriter(AsyncLogWriter const&) = delete;
+        AsyncLogWriter& operator=(AsyncLogWriter&&) = delete;
+        AsyncLogWriter& operator=(AsyncLogWriter const&) = delete;
+
+        void push(Severity severity, uint8_t targets, const char* text);
+
+        AsyncLogStats getStats();
+
+    private:
+        struct ProducerBuffer
+        {
+            explicit ProducerBuffer(size_t capacity) : ring(capacity) {}
+
+            SpscRingBuffer<LogEntry> ring;
+            std::atomic<bool> abandoned = false;
+        };
+
+        ProducerBuffer* getProducerBuffer();
+
+        void run();
+        size_t writeQueuedEntries();
+        void wakeUp();
+
+        WriteCallback m_writeCallback;
+        FlushCallback m_flushCallback;
+
+        const uint32_t m_flushInterval;
+        const uint32_t m_bufferSize;
+        const bool m_dropWhenFull;
+        const uint64_t m_id;
+
+        std::mutex m_buffersMutex;
+        std::vector<std::shared_ptr<ProducerBuffer>> m_buffers;
+
+        std::mutex m_wakeUpMutex;
+        std::condition_variable m_wakeUpCondition;
+        bool m_wakeUpRequested = false;
+        bool m_isRunning = true;
+
+        std::atomic<uint64_t> m_writtenCount = 0;
+        std::atomic<uint64_t> m_droppedCount = 0;
+        std::atomic<uint64_t> m_blockedCount = 0;
+        uint64_t m_reportedDroppedCount = 0;
+
+        std::thread m_thread;
+    };
+}
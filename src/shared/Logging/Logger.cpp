@@ -4,6 +4,7 @@ This file is released under the MIT license. See README-MIT for more information
 */
 
 #include "Logger.hpp"
+#include "AsyncLogWriter.hpp"
 #include "ConsoleDefines.hpp"
 #include "Util.hpp"
 #include "Config/Config.h"
@@ -11,6 +12,7 @@ This file is released under the MIT license. See README-MIT for more information
 #include <iostream>
 #include <cstdarg>
 #include <string>
+#include <thread>
 
 namespace AscEmu::Logging
 {
@@ -20,8 +22,15 @@ namespace AscEmu::Logging
         return mInstance;
     }
 
+    Logger::~Logger()
+    {
+        disableAsyncMode();
+    }
+
     void Logger::finalize()
     {
+        disableAsyncMode();
+
         if (this->normalLogFile != nullptr)
         {
             fflush(this->normalLogFile);
@@ -62,6 +71,8 @@ namespace AscEmu::Logging
             std::cerr << __FUNCTION__ << " : Error opening file " << error_filename << std::endl;
         else
             writeFile(this->errorLogFile, logMessage);
+
+        flushFiles();
     }
 
     void Logger::setMinimumMessageType(MessageType _minimumMessageType)
@@ -74,6 +85,52 @@ namespace AscEmu::Logging
         this->aelog_debug_flags = debug_flags;
     }
 
+    void Logger::enableAsyncMode(uint32_t flushInterval, uint32_t bufferSize, bool dropWhenFull)
+    {
+        disableAsyncMode();
+
+        auto writeCallback = [this](LogEntry const& entry) { writeEntry(entry.severity, entry.targets, entry.text.c_str()); };
+        auto flushCallback = [this]()
+        {
+            std::cout.flush();
+            flushFiles();
+        };
+
+        this->asyncWriter = new AsyncLogWriter(writeCallback, flushCallback, flushInterval, bufferSize, dropWhenFull);
+    }
+
+    void Logger::disableAsyncMode()
+    {
+        // new messages are written synchronously from here on
+        AsyncLogWriter* writer = this->asyncWriter.exchange(nullptr);
+        if (writer == nullptr)
+            return;
+
+        // threads that got the writer before finish their push
+        while (this->asyncWriterUsers != 0)
+            std::this_thread::yield();
+
+        // the writer thread writes everything that is still queued before it stops
+        delete writer;
+    }
+
+    bool Logger::isAsyncModeEnabled() const
+    {
+        return this->asyncWriter != nullptr;
+    }
+
+    AsyncLogStats Logger::getAsyncStats()
+    {
+        AsyncLogStats stats = {};
+
+        ++this->asyncWriterUsers;
+        if (AsyncLogWriter* writer = this->asyncWriter)
+            stats = writer->getStats();
+        --this->asyncWriterUsers;
+
+        return stats;
+    }
+
     void Logger::trace(const char* message, ...)
     {
         va_list arguments;
@@ -148,43 +205,41 @@ namespace AscEmu::Logging
         if (this->minimumMessageType > messageType)
             return;
 
-        char logMessage[327680];
-        createLogMessage(logMessage, severity, messageType, message, arguments);
-  
-        setSeverityConsoleColor(severity);
-        std::cout << logMessage << "\n";
-        setConsoleColor(CONSOLE_COLOR_NORMAL);
+        char logMessage[MAX_MESSAGE_LENGTH];
+        createLogMessage(logMessage, sizeof(logMessage), severity, messageType, message, arguments);
 
+        uint8_t targets = LOG_TARGET_CONSOLE | LOG_TARGET_NORMAL_FILE;
         if (severity >= Severity::FAILURE)
-            writeFile(this->errorLogFile, logMessage);
+            targets |= LOG_TARGET_ERROR_FILE;
 
-        writeFile(this->normalLogFile, logMessage);
+        writeMessage(severity, targets, logMessage);
     }
 
     void Logger::file(Severity severity, MessageType messageType, const char* message, ...)
     {
-        char logMessage[327680];
+        char logMessage[MAX_MESSAGE_LENGTH];
         va_list arguments;
         va_start(arguments, message);
-        createLogMessage(logMessage, severity, messageType, message, arguments);
+        createLogMessage(logMessage, sizeof(logMessage), severity, messageType, message, arguments);
         va_end(arguments);
 
+        uint8_t targets = LOG_TARGET_NORMAL_FILE;
         if (severity >= Severity::FAILURE)
-            writeFile(this->errorLogFile, logMessage);
+            targets |= LOG_TARGET_ERROR_FILE;
 
-        writeFile(this->normalLogFile, logMessage);
+        writeMessage(severity, targets, logMessage);
     }
 
-    void Logger::createLogMessage(char* result, Severity severity, MessageType messageType, const char* message, va_list arguments)
+    void Logger::createLogMessage(char* result, size_t size, Severity severity, MessageType messageType, const char* message, va_list arguments)
     {
-        char formattedMessage[32768];
-        vsnprintf(formattedMessage, 32768, message, arguments);
-
         std::string currentTime = Util::GetCurrentTimeString();
         std::string severityText = getSeverityText(severity);
         std::string messageTypeText = getMessageTypeText(messageType);
 
-        sprintf(result, "%s %s%s: %s", currentTime.c_str(), severityText.c_str(), messageTypeText.c_str(), formattedMessage);
+        // the message is formatted right behind the prefix, longer messages are cut
+        const int prefixLength = snprintf(result, size, "%s %s%s: ", currentTime.c_str(), severityText.c_str(), messageTypeText.c_str());
+        if (prefixLength >= 0 && static_cast<size_t>(prefixLength) < size)
+            vsnprintf(result + prefixLength, size - prefixLength, message, arguments);
     }
 
     std::string Logger::getMessageTypeText(MessageType messageType)
@@ -218,12 +273,52 @@ namespace AscEmu::Logging
         }
     }
 
+    void Logger::writeMessage(Severity severity, uint8_t targets, const char* msg)
+    {
+        // counted before the writer is read, disableAsyncMode waits for it then
+        ++this->asyncWriterUsers;
+        if (AsyncLogWriter* writer = this->asyncWriter)
+        {
+            writer->push(severity, targets, msg);
+            --this->asyncWriterUsers;
+            return;
+        }
+        --this->asyncWriterUsers;
+
+        writeEntry(severity, targets, msg);
+        flushFiles();
+    }
+
+    void Logger::writeEntry(Severity severity, uint8_t targets, const char* msg)
+    {
+        if (targets & LOG_TARGET_CONSOLE)
+        {
+            setSeverityConsoleColor(severity);
+            std::cout << msg << "\n";
+            setConsoleColor(CONSOLE_COLOR_NORMAL);
+        }
+
+        if (targets & LOG_TARGET_ERROR_FILE)
+            writeFile(this->errorLogFile, msg);
+
+        if (targets & LOG_TARGET_NORMAL_FILE)
+            writeFile(this->normalLogFile, msg);
+    }
+
     void Logger::writeFile(FILE* file, const char* msg)
     {
         if (file == nullptr)
             return;
         fprintf(file, "%s\n", msg);
-        fflush(file);
+    }
+
+    void Logger::flushFiles()
+    {
+        if (this->normalLogFile != nullptr)
+            fflush(this->normalLogFile);
+
+        if (this->errorLogFile != nullptr)
+            fflush(this->errorLogFile);
     }
 
 #ifndef _WIN32
@@ -10,15 +10,28 @@ This file is released under the MIT license. See README-MIT for more information
 #include "MessageType.hpp"
 #include "Severity.hpp"
 
+#include <atomic>
+
 namespace AscEmu::Logging
 {
+    class AsyncLogWriter;
+    struct AsyncLogStats;
+
     class SERVER_DECL Logger
     {
+        // prefix (time, severity and type) and message
+        static constexpr size_t MAX_MESSAGE_LENGTH = 32768;
+
         FILE* normalLogFile = nullptr;
         FILE* errorLogFile = nullptr;
         MessageType minimumMessageType = MessageType::MINOR;
         uint32_t aelog_debug_flags;
 
+        // set while messages are written by the writer thread
+        std::atomic<AsyncLogWriter*> asyncWriter = nullptr;
+        // threads that might use asyncWriter, disableAsyncMode deletes it when they are done
+        std::atomic<uint32_t> asyncWriterUsers = 0;
+
 #ifdef _WIN32
         HANDLE handle_stdout;
 #endif
@@ -39,6 +52,14 @@ namespace AscEmu::Logging
 
         void setDebugFlags(DebugFlags debug_flags);
 
+        // Messages are formatted by the logging thread and written by a writer thread, see AsyncLogWriter.
+        // Enable while no other thread logs (startup). Disabling can happen while other threads log,
+        // they write their messages themselves at once and the queued ones are written before it returns.
+        void enableAsyncMode(uint32_t flushInterval, uint32_t bufferSize, bool dropWhenFull);
+        void disableAsyncMode();
+        bool isAsyncModeEnabled() const;
+        AsyncLogStats getAsyncStats();
+
         void trace(const char* message, ...);
 
         void debug(const char* message, ...);
@@ -61,13 +82,18 @@ namespace AscEmu::Logging
 
     private:
         Logger() = default;
-        ~Logger() = default;
+        ~Logger();
 
-        void createLogMessage(char* result, Severity severity, MessageType messageType, const char* message, va_list arguments);
+        void createLogMessage(char* result, size_t size, Severity severity, MessageType messageType, const char* message, va_list arguments);
         std::string getMessageTypeText(MessageType messageType);
         std::string getSeverityText(Severity severity);
 
+        // hands the message to the writer thread or writes it right away
+        void writeMessage(Severity severity, uint8_t targets, const char* msg);
+        void writeEntry(Severity severity, uint8_t targets, const char* msg);
+
         void writeFile(FILE* file, const char* msg);
+        void flushFiles();
 
 #ifndef _WIN32
         void setConsoleColor(const char* color);
@@ -41,7 +41,11 @@ enum LogonRealmOpcodes
     LRCMSG_ACCOUNT_REQUEST            = 0x015,  // request account data
     LRSMSG_ACCOUNT_RESULT             = 0x016,  // send account information to realm
     LRCMSG_ALL_ACCOUNT_REQUEST        = 0x017,  // request all account data
-    LRSMSG_ALL_ACCOUNT_RESULT         = 0x018,  // send id, name, rank of all accounts to realm
+    LRSMSG_ALL_ACCOUNT_RESULT         = 0x018,  // send id, name, rank of all accounts to realm (old, see account sync)
+    LRCMSG_ACCOUNT_SYNC_REQUEST       = 0x019,  // request the accounts changed since a version, or all of them
+    LRSMSG_ACCOUNT_SYNC_SNAPSHOT      = 0x01A,  // send a compressed part of all accounts
+    LRCMSG_ACCOUNT_SYNC_SNAPSHOT_ACK  = 0x01B,  // request the next part of all accounts
+    LRSMSG_ACCOUNT_SYNC_DELTA         = 0x01C,  // send the compressed account changes, pushed by logonserver
 
     LRMSG_MAX_OPCODES                           // max opcodes
 };
@@ -65,6 +69,26 @@ enum AccountDatabaseResult
     Result_Account_Exists
 };
 
+//////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Account sync
+///
+/// The realm requests all accounts once (LRCMSG_ACCOUNT_SYNC_REQUEST with epoch 0), the
+/// logonserver sends them in compressed parts, the realm acknowledges every part. Then the
+/// logonserver pushes the changes (LRSMSG_ACCOUNT_SYNC_DELTA) of its account change log.
+/// When the realm reconnects it requests the changes since its last version, the logonserver
+/// answers with all accounts again when its change log does not reach back that far or was
+/// started again (new epoch).
+///
+/// Every account is written as uint8 AccountSyncChange, uint32 id, string name, string gm flags.
+//////////////////////////////////////////////////////////////////////////////////////////
+#define ACCOUNT_SYNC_PROTOCOL_VERSION 1
+
+enum AccountSyncChange
+{
+    AccountSync_Set = 1,        // account added or changed
+    AccountSync_Removed
+};
+
 #pragma pack(push, 1)
 struct LogonWorldPacket
 {
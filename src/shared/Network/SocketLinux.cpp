@@ -11,7 +11,7 @@
 
 void Socket::PostEvent(uint32 events)
 {
-    int epoll_fd = sSocketMgr.GetEpollFd();
+    int epoll_fd = sSocketMgr.GetEpollFd(m_fd);
 
     struct epoll_event ev;
     memset(&ev, 0, sizeof(epoll_event));
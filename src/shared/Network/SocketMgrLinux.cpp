@@ -44,6 +44,12 @@ void SocketMgr::AddSocket(Socket* s)
     }
 
     if(max_fd < s->GetFd()) max_fd = s->GetFd();
+
+    // shard the socket onto the worker with the fewest sockets
+    const uint32 workerId = GetLeastLoadedWorker();
+    fdworkers[s->GetFd()] = static_cast<uint8>(workerId);
+    ++workers[workerId].socket_count;
+
     fds[s->GetFd()] = s;
     ++socket_count;
 
@@ -54,7 +60,7 @@ void SocketMgr::AddSocket(Socket* s)
     ev.events |= EPOLLET;            /* use edge-triggered instead of level-triggered because we're using nonblocking sockets */
     ev.data.fd = s->GetFd();
 
-    if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, ev.data.fd, &ev))
+    if(epoll_ctl(workers[workerId].epoll_fd, EPOLL_CTL_ADD, ev.data.fd, &ev))
         sLogger.failure("Could not add event to epoll set on fd %u", ev.data.fd);
 }
 
@@ -63,6 +69,11 @@ void SocketMgr::AddListenSocket(ListenSocketBase* s)
     assert(listenfds[s->GetFd()] == 0);
     listenfds[s->GetFd()] = s;
 
+    // every listener accepts on its own worker, the accepted sockets get sharded in AddSocket
+    const uint32 workerId = next_listen_worker;
+    next_listen_worker = (next_listen_worker + 1) % worker_count;
+    fdworkers[s->GetFd()] = static_cast<uint8>(workerId);
+
     // Add epoll event based on socket activity.
     struct epoll_event ev;
     memset(&ev, 0, sizeof(epoll_event));
@@ -70,7 +81,7 @@ void SocketMgr::AddListenSocket(ListenSocketBase* s)
     ev.events |= EPOLLET;            /* use edge-triggered instead of level-triggered because we're using nonblocking sockets */
     ev.data.fd = s->GetFd();
 
-    if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, ev.data.fd, &ev))
+    if(epoll_ctl(workers[workerId].epoll_fd, EPOLL_CTL_ADD, ev.data.fd, &ev))
         sLogger.failure("Could not add event to epoll set on fd %u", ev.data.fd);
 }
 
@@ -85,16 +96,36 @@ void SocketMgr::RemoveSocket(Socket* s)
     fds[s->GetFd()] = NULL;
     --socket_count;
 
+    const uint32 workerId = fdworkers[s->GetFd()];
+    --workers[workerId].socket_count;
+
     // Remove from epoll list.
     struct epoll_event ev;
     memset(&ev, 0, sizeof(epoll_event));
     ev.data.fd = s->GetFd();
     ev.events = EPOLLIN | EPOLLOUT | EPOLLERR | EPOLLHUP | EPOLLONESHOT;
 
-    if(epoll_ctl(epoll_fd, EPOLL_CTL_DEL, ev.data.fd, &ev))
+    if(epoll_ctl(workers[workerId].epoll_fd, EPOLL_CTL_DEL, ev.data.fd, &ev))
         sLogger.failure("Could not remove fd %u from epoll set, errno %u", s->GetFd(), errno);
 }
 
+uint32 SocketMgr::GetLeastLoadedWorker()
+{
+    uint32 workerId = 0;
+    unsigned long lowestCount = workers[0].socket_count.load();
+    for(uint32 i = 1; i < worker_count; ++i)
+    {
+        const unsigned long count = workers[i].socket_count.load();
+        if(count < lowestCount)
+        {
+            lowestCount = count;
+            workerId = i;
+        }
+    }
+
+    return workerId;
+}
+
 void SocketMgr::CloseAll()
 {
     for(uint32 i = 0; i < SOCKET_HOLDER_SIZE; ++i)
@@ -104,14 +135,27 @@ void SocketMgr::CloseAll()
 
 void SocketMgr::SpawnWorkerThreads()
 {
-    uint32 count = 1;
-    for(uint32 i = 0; i < count; ++i)
-        ThreadPool.ExecuteTask(new SocketWorkerThread());
+    sLogger.info("epoll: Spawning %u worker threads.", worker_count);
+    for(uint32 i = 0; i < worker_count; ++i)
+        ThreadPool.ExecuteTask(new SocketWorkerThread(i));
 }
 
 void SocketMgr::ShowStatus()
 {
     sLogger.info("sockets count = %u", static_cast<uint32_t>(socket_count.load()));
+
+    for(uint32 i = 0; i < worker_count; ++i)
+    {
+        const SocketWorker& worker = workers[i];
+        sLogger.info("worker %u: sockets = %u, wakeups = %llu, events = %llu, reads = %llu, writes = %llu, accepts = %llu, disconnects = %llu",
+            i, static_cast<uint32_t>(worker.socket_count.load()),
+            static_cast<unsigned long long>(worker.wakeups.load()),
+            static_cast<unsigned long long>(worker.events.load()),
+            static_cast<unsigned long long>(worker.reads.load()),
+            static_cast<unsigned long long>(worker.writes.load()),
+            static_cast<unsigned long long>(worker.accepts.load()),
+            static_cast<unsigned long long>(worker.disconnects.load()));
+    }
 }
 
 bool SocketWorkerThread::runThread()
@@ -121,9 +165,17 @@ bool SocketWorkerThread::runThread()
     int i;
     running = true;
 
+    SocketWorker& worker = sSocketMgr.workers[workerId];
+
     while(running)
     {
-        fd_count = epoll_wait(sSocketMgr.epoll_fd, events, THREAD_EVENT_SIZE, 5000);
+        fd_count = epoll_wait(worker.epoll_fd, events, THREAD_EVENT_SIZE, 5000);
+        if(fd_count > 0)
+        {
+            ++worker.wakeups;
+            worker.events += fd_count;
+        }
+
         for(i = 0; i < fd_count; ++i)
         {
             if(events[i].data.fd >= SOCKET_HOLDER_SIZE)
@@ -137,7 +189,10 @@ bool SocketWorkerThread::runThread()
             if(ptr == NULL)
             {
                 if((ptr = ((Socket*)sSocketMgr.listenfds[events[i].data.fd])) != NULL)
+                {
                     ((ListenSocketBase*)ptr)->OnAccept();
+                    ++worker.accepts;
+                }
                 else
                     sLogger.failure("Returned invalid fd (no pointer) of FD %u", events[i].data.fd);
 
@@ -147,10 +202,12 @@ bool SocketWorkerThread::runThread()
             if(events[i].events & EPOLLHUP || events[i].events & EPOLLERR)
             {
                 ptr->Disconnect();
+                ++worker.disconnects;
                 continue;
             }
             else if(events[i].events & EPOLLIN)
             {
+                ++worker.reads;
                 ptr->ReadCallback(0);               // Len is unknown at this point.
 
                 /* changing to written state? */
@@ -159,6 +216,7 @@ bool SocketWorkerThread::runThread()
             }
             else if(events[i].events & EPOLLOUT)
             {
+                ++worker.writes;
                 ptr->BurstBegin();          // Lock receive mutex
                 ptr->WriteCallback();       // Perform actual send()
                 if(ptr->writeBuffer.GetSize() > 0)
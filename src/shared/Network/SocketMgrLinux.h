@@ -22,24 +22,53 @@
 #define THREAD_EVENT_SIZE 4096      // This is the number of socket events each thread can receieve at once.
 // This default value should be more than enough.
 
+#define SOCKET_MAX_WORKER_THREADS 32    // Upper limit for epoll worker threads. Every worker owns its own epoll
+// instance and services only the sockets that were sharded onto it.
+
 class Socket;
 class SocketWorkerThread;
 class ListenSocketBase;
 
+/// per worker epoll instance + statistics
+struct SocketWorker
+{
+    /// /dev/epoll instance handle of this worker
+    int epoll_fd;
+
+    /// sockets currently assigned to this worker
+    std::atomic<unsigned long> socket_count;
+
+    /// counters since startup
+    std::atomic<uint64> wakeups;
+    std::atomic<uint64> events;
+    std::atomic<uint64> reads;
+    std::atomic<uint64> writes;
+    std::atomic<uint64> accepts;
+    std::atomic<uint64> disconnects;
+};
+
 class SocketMgr
 {
-        /// /dev/epoll instance handle
-        int epoll_fd;
+        /// epoll workers, listen sockets are spread over them in turn
+        SocketWorker workers[SOCKET_MAX_WORKER_THREADS];
+        uint32 worker_count = 1;
+        uint32 next_listen_worker = 0;
 
         // fd -> pointer binding.
         Socket* fds[SOCKET_HOLDER_SIZE];
         ListenSocketBase* listenfds[SOCKET_HOLDER_SIZE];
 
+        // fd -> worker binding.
+        uint8 fdworkers[SOCKET_HOLDER_SIZE];
+
         /// socket counter
         std::atomic<unsigned long> socket_count;
 
         int max_fd;
 
+        /// returns the worker with the fewest sockets
+        uint32 GetLeastLoadedWorker();
+
     private:
         SocketMgr() = default;
         ~SocketMgr() = default;
@@ -55,27 +84,55 @@ class SocketMgr
             return mInstance;
         }
 
-        /// constructor > create epoll device handle + initialize event set
+        /// sets the amount of epoll workers, has to be called before initialize()
+        void setWorkerThreadCount(uint32 count)
+        {
+            if (count == 0)
+                count = 1;
+            else if (count > SOCKET_MAX_WORKER_THREADS)
+                count = SOCKET_MAX_WORKER_THREADS;
+
+            worker_count = count;
+        }
+
+        uint32 getWorkerThreadCount() const { return worker_count; }
+
+        /// constructor > create epoll device handles + initialize event set
         void initialize()
         {
-            epoll_fd = epoll_create(SOCKET_HOLDER_SIZE);
-            if(epoll_fd == -1)
+            for (uint32 i = 0; i < worker_count; ++i)
             {
-                sLogger.failure("Could not create epoll fd (/dev/epoll).");
-                exit(-1);
+                workers[i].epoll_fd = epoll_create(SOCKET_HOLDER_SIZE);
+                if (workers[i].epoll_fd == -1)
+                {
+                    sLogger.failure("Could not create epoll fd (/dev/epoll).");
+                    exit(-1);
+                }
+
+                workers[i].socket_count = 0;
+                workers[i].wakeups = 0;
+                workers[i].events = 0;
+                workers[i].reads = 0;
+                workers[i].writes = 0;
+                workers[i].accepts = 0;
+                workers[i].disconnects = 0;
             }
 
+            next_listen_worker = 0;
+
             // null out the pointer array
             memset(fds, 0, sizeof(void*) * SOCKET_HOLDER_SIZE);
             memset(listenfds, 0, sizeof(void*) * SOCKET_HOLDER_SIZE);
+            memset(fdworkers, 0, sizeof(uint8) * SOCKET_HOLDER_SIZE);
             max_fd = 0;
         }
 
-        /// destructor > destroy epoll handle
+        /// destructor > destroy epoll handles
         void finalize()
         {
-            // close epoll handle
-            close(epoll_fd);
+            // close epoll handles
+            for (uint32 i = 0; i < worker_count; ++i)
+                close(workers[i].epoll_fd);
         }
 
         SocketMgr(SocketMgr&&) = delete;
@@ -90,8 +147,8 @@ class SocketMgr
         /// remove a socket from epoll set/fd mapping
         void RemoveSocket(Socket* s);
 
-        /// returns epoll fd
-        inline int GetEpollFd() { return epoll_fd; }
+        /// returns epoll fd of the worker which owns the socket fd
+        inline int GetEpollFd(SOCKET fd) { return workers[fdworkers[fd]].epoll_fd; }
 
         /// closes all sockets
         void CloseAll();
@@ -110,7 +167,10 @@ class SocketWorkerThread : public ThreadBase
         /// epoll event struct
         struct epoll_event events[THREAD_EVENT_SIZE];
         bool running;
+        uint32 workerId;
     public:
+        explicit SocketWorkerThread(uint32 id) : running(false), workerId(id) {}
+
         bool runThread();
         void onShutdown()
         {
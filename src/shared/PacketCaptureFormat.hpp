@@ -0,0 +1,53 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Binary packet capture file (.aepc), written by the world server and read by packet_capture_dump.
+// All values are little endian.
+//
+//  PacketCaptureFileHeader
+//  opcodeNameCount x { uint16_t opcode, uint8_t nameLength, char name[nameLength] }
+//  records until the end of the file: PacketCaptureRecordHeader, uint8_t data[capturedLength]
+
+static constexpr char PACKET_CAPTURE_MAGIC[4] = { 'A', 'E', 'P', 'C' };
+static constexpr uint16_t PACKET_CAPTURE_FORMAT_VERSION = 1;
+
+enum PacketCaptureDirection : uint8_t
+{
+    PACKET_CAPTURE_CLIENT_TO_SERVER = 0,
+    PACKET_CAPTURE_SERVER_TO_CLIENT = 1
+};
+
+#pragma pack(push, 1)
+
+struct PacketCaptureFileHeader
+{
+    char magic[4];
+    uint16_t formatVersion;
+    uint8_t versionId;              // Classic = 0 ... Mop = 4, see OpcodeTables
+    uint8_t reserved;
+    uint64_t startTime;             // unix time
+    uint32_t opcodeNameCount;
+};
+
+struct PacketCaptureRecordHeader
+{
+    uint32_t time;                  // ms since startTime
+    uint32_t accountId;
+    uint32_t length;                // size of the packet
+    uint32_t capturedLength;        // size of the stored data, smaller if the packet was cut
+    uint16_t opcode;                // opcode as sent on the wire
+    uint8_t direction;
+    uint8_t reserved;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(PacketCaptureFileHeader) == 20, "capture file layout changed");
+static_assert(sizeof(PacketCaptureRecordHeader) == 20, "capture file layout changed");
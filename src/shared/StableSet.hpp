@@ -0,0 +1,238 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Unordered set of pointers with O(1) insert, erase and contains.
+// The elements are stored in one vector, an open addressing table (linear probing)
+// maps every element to its position.
+//
+// The set is iterated through a View. While a View exists erase only clears the slot
+// (nullptr, skipped by the iterator) and the set is compacted when the last View is
+// gone, so the set can be changed from inside a loop, also from nested loops.
+// Elements inserted during a loop are visited by it.
+template <typename T>
+class StableSet
+{
+    static constexpr uint32_t EMPTY_SLOT = 0;
+    static constexpr size_t MIN_TABLE_SIZE = 16;
+
+public:
+    class Iterator
+    {
+    public:
+        Iterator(const StableSet* set, size_t position) : m_set(set), m_position(position) { skipErased(); }
+
+        T operator*() const { return m_set->m_values[m_position]; }
+
+        Iterator& operator++()
+        {
+            ++m_position;
+            skipErased();
+            return *this;
+        }
+
+        // the end iterator follows the current size, so inserted elements are reached
+        bool operator!=(Iterator const& other) const
+        {
+            if (isEnd() || other.isEnd())
+                return isEnd() != other.isEnd();
+
+            return m_position != other.m_position;
+        }
+
+    private:
+        bool isEnd() const { return m_position >= m_set->m_values.size(); }
+
+        void skipErased()
+        {
+            while (!isEnd() && m_set->m_values[m_position] == nullptr)
+                ++m_position;
+        }
+
+        const StableSet* m_set;
+        size_t m_position;
+    };
+
+    class View
+    {
+    public:
+        explicit View(StableSet& set) : m_set(&set) { ++m_set->m_viewCount; }
+        View(View const& other) : m_set(other.m_set) { ++m_set->m_viewCount; }
+        View& operator=(View const&) = delete;
+
+        ~View()
+        {
+            if (--m_set->m_viewCount == 0 && m_set->m_erasedCount != 0)
+                m_set->compact();
+        }
+
+        Iterator begin() const { return Iterator(m_set, 0); }
+        Iterator end() const { return Iterator(m_set, std::numeric_limits<size_t>::max()); }
+
+        size_t size() const { return m_set->size(); }
+        bool empty() const { return m_set->empty(); }
+
+    private:
+        StableSet* m_set;
+    };
+
+    StableSet() = default;
+    StableSet(StableSet const&) = delete;
+    StableSet& operator=(StableSet const&) = delete;
+
+    View view() { return View(*this); }
+
+    bool insert(T value)
+    {
+        if (value == nullptr || contains(value))
+            return false;
+
+        if ((size() + 1) * 2 > m_table.size())
+            rehash(std::max(MIN_TABLE_SIZE, m_table.size() * 2));
+
+        m_values.push_back(value);
+        m_table[findSlot(value)] = static_cast<uint32_t>(m_values.size());
+
+        return true;
+    }
+
+    bool erase(T value)
+    {
+        if (m_table.empty())
+            return false;
+
+        const size_t slot = findSlot(value);
+        if (m_table[slot] == EMPTY_SLOT)
+            return false;
+
+        const size_t position = m_table[slot] - 1;
+        eraseSlot(slot);
+
+        if (m_viewCount != 0)
+        {
+            m_values[position] = nullptr;
+            ++m_erasedCount;
+            return true;
+        }
+
+        // nobody iterates, fill the gap with the last element
+        const size_t last = m_values.size() - 1;
+        if (position != last)
+        {
+            m_values[position] = m_values[last];
+            m_table[findSlot(m_values[position])] = static_cast<uint32_t>(position + 1);
+        }
+
+        m_values.pop_back();
+        return true;
+    }
+
+    bool contains(T value) const
+    {
+        return !m_table.empty() && m_table[findSlot(value)] != EMPTY_SLOT;
+    }
+
+    void clear()
+    {
+        if (m_viewCount != 0)
+        {
+            for (auto& value : m_values)
+                value = nullptr;
+
+            m_erasedCount = m_values.size();
+        }
+        else
+        {
+            m_values.clear();
+            m_erasedCount = 0;
+        }
+
+        m_table.assign(m_table.size(), EMPTY_SLOT);
+    }
+
+    size_t size() const { return m_values.size() - m_erasedCount; }
+    bool empty() const { return size() == 0; }
+
+private:
+    size_t getHash(T value) const
+    {
+        // fibonacci hashing, the low bits of pointers are mostly zero
+        const uint64_t hash = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value)) * 11400714819323198485ull;
+        return static_cast<size_t>(hash >> 32) & (m_table.size() - 1);
+    }
+
+    // slot of value or the empty slot where it belongs
+    size_t findSlot(T value) const
+    {
+        const size_t mask = m_table.size() - 1;
+
+        size_t slot = getHash(value);
+        while (m_table[slot] != EMPTY_SLOT && m_values[m_table[slot] - 1] != value)
+            slot = (slot + 1) & mask;
+
+        return slot;
+    }
+
+    // backward shift deletion keeps the probe sequences intact without tombstones
+    void eraseSlot(size_t slot)
+    {
+        const size_t mask = m_table.size() - 1;
+
+        size_t next = slot;
+        while (true)
+        {
+            next = (next + 1) & mask;
+            if (m_table[next] == EMPTY_SLOT)
+                break;
+
+            // an entry can move to the freed slot when its home slot is not between slot and next
+            const size_t home = getHash(m_values[m_table[next] - 1]);
+            if (((next - home) & mask) >= ((next - slot) & mask))
+            {
+                m_table[slot] = m_table[next];
+                slot = next;
+            }
+        }
+
+        m_table[slot] = EMPTY_SLOT;
+    }
+
+    void rehash(size_t tableSize)
+    {
+        m_table.assign(tableSize, EMPTY_SLOT);
+
+        for (size_t position = 0; position < m_values.size(); ++position)
+            if (m_values[position] != nullptr)
+                m_table[findSlot(m_values[position])] = static_cast<uint32_t>(position + 1);
+    }
+
+    void compact()
+    {
+        size_t target = 0;
+        for (size_t position = 0; position < m_values.size(); ++position)
+            if (m_values[position] != nullptr)
+                m_values[target++] = m_values[position];
+
+        m_values.resize(target);
+        m_erasedCount = 0;
+
+        rehash(m_table.size());
+    }
+
+    std::vector<T> m_values;
+    // position + 1 of the element, EMPTY_SLOT for free slots
+    std::vector<uint32_t> m_table;
+
+    uint32_t m_viewCount = 0;
+    size_t m_erasedCount = 0;
+};
@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Unbounded lock-free multi producer / single consumer queue (Vyukov).
+// push() can be called from any thread and never blocks, it is a single atomic exchange.
+// pop(), consumeAll() and empty() may only be called by one consumer thread at a time.
+// A value pushed by a producer that got preempted between exchange and link becomes
+// visible to the consumer once the producer continues, values behind it wait as well.
+template <typename T>
+class MpscQueue
+{
+    struct Node
+    {
+        Node() = default;
+        explicit Node(T&& value) : value(std::move(value)) {}
+
+        T value{};
+        std::atomic<Node*> next = nullptr;
+    };
+
+public:
+    MpscQueue() : m_head(new Node()), m_tail(m_head.load(std::memory_order_relaxed)) {}
+
+    ~MpscQueue()
+    {
+        T value;
+        while (pop(value))
+        {
+        }
+
+        delete m_tail;
+    }
+
+    MpscQueue(MpscQueue&&) = delete;
+    MpscQueue(MpscQueue const&) = delete;
+    MpscQueue& operator=(MpscQueue&&) = delete;
+    MpscQueue& operator=(MpscQueue const&) = delete;
+
+    void push(T value)
+    {
+        Node* node = new Node(std::move(value));
+
+        Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    // consumer only
+    bool pop(T& value)
+    {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr)
+            return false;
+
+        // next becomes the new stub node
+        value = std::move(next->value);
+        m_tail = next;
+        delete tail;
+
+        return true;
+    }
+
+    // consumer only, calls func(value) for every queued value and returns their count.
+    // Values pushed by func are consumed as well.
+    template <typename Func>
+    size_t consumeAll(Func func)
+    {
+        size_t count = 0;
+
+        T value;
+        while (pop(value))
+        {
+            func(value);
+            ++count;
+        }
+
+        return count;
+    }
+
+    // consumer only
+    bool empty() const { return m_tail->next.load(std::memory_order_acquire) == nullptr; }
+
+private:
+    // producers and consumer are kept on different cache lines
+    alignas(64) std::atomic<Node*> m_head;
+    alignas(64) Node* m_tail;
+};
@@ -0,0 +1,81 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Bounded lock-free single producer / single consumer ring buffer.
+// The slots are allocated once and reused, values are written and read in place:
+// the producer fills the slot returned by beginPush() and publishes it with commitPush(),
+// the consumer reads the slot returned by front() and releases it with pop().
+template <typename T>
+class SpscRingBuffer
+{
+public:
+    // capacity is rounded up to a power of two
+    explicit SpscRingBuffer(size_t capacity) : m_slots(getSlotCount(capacity)), m_mask(m_slots.size() - 1) {}
+
+    SpscRingBuffer(SpscRingBuffer&&) = delete;
+    SpscRingBuffer(SpscRingBuffer const&) = delete;
+    SpscRingBuffer& operator=(SpscRingBuffer&&) = delete;
+    SpscRingBuffer& operator=(SpscRingBuffer const&) = delete;
+
+    // producer only, nullptr when the buffer is full
+    T* beginPush()
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == m_slots.size())
+            return nullptr;
+
+        return &m_slots[head & m_mask];
+    }
+
+    // producer only
+    void commitPush()
+    {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // consumer only, nullptr when the buffer is empty
+    T* front()
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire))
+            return nullptr;
+
+        return &m_slots[tail & m_mask];
+    }
+
+    // consumer only
+    void pop()
+    {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // exact for producer and consumer, an estimate for other threads
+    size_t size() const { return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire); }
+    size_t capacity() const { return m_slots.size(); }
+
+private:
+    static size_t getSlotCount(size_t capacity)
+    {
+        size_t count = 1;
+        while (count < capacity)
+            count <<= 1;
+
+        return count;
+    }
+
+    std::vector<T> m_slots;
+    const size_t m_mask;
+
+    // producer and consumer are kept on different cache lines
+    alignas(64) std::atomic<size_t> m_head = 0;
+    alignas(64) std::atomic<size_t> m_tail = 0;
+};
@@ -443,4 +443,13 @@ namespace Util
         return version;
     }
 
+    std::string getPathInDirectory(std::string const& directory, std::string const& fileName)
+    {
+        // no separators, drives or relative parts, the file has to stay in directory
+        if (fileName.empty() || fileName == "." || fileName == ".." || fileName.find_first_of("/\\:") != std::string::npos)
+            return "";
+
+        return (fs::path(directory) / fileName).string();
+    }
+
 }
@@ -158,6 +158,9 @@ namespace Util
 
     uint32_t readMinorVersionFromString(std::string fileName);
 
+    /*! \brief Returns the path of fileName in directory, or an empty string when fileName is not a plain file name. */
+    std::string getPathInDirectory(std::string const& directory, std::string const& fileName);
+
     //////////////////////////////////////////////////////////////////////////////////////////
     // Benchmark
     class BenchmarkTime
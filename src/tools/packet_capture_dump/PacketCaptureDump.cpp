@@ -0,0 +1,325 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+// Reads world packet captures (.aepc) written by the world server, prints or filters them.
+
+#include "PacketCaptureFormat.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        std::string inputFile;
+        std::string outputFile;
+
+        std::vector<std::string> opcodeFilters;
+        std::set<uint16_t> opcodes;
+        std::set<uint32_t> accounts;
+        int direction = -1;
+        uint32_t fromTime = 0;
+        uint32_t toTime = UINT32_MAX;
+
+        bool printData = true;
+        bool printStats = false;
+    };
+
+    struct OpcodeStats
+    {
+        uint64_t count = 0;
+        uint64_t bytes = 0;
+    };
+
+    void printUsage(const char* program)
+    {
+        printf("Usage: %s <capture.aepc> [options]\n", program);
+        printf("  -o, --opcode <name|hex>    only packets with this opcode, can be repeated\n");
+        printf("  -a, --account <id>         only packets of this account, can be repeated\n");
+        printf("  -d, --direction <c|s>      only client (c) or server (s) packets\n");
+        printf("  -f, --from <ms>            only packets at or after ms since capture start\n");
+        printf("  -t, --to <ms>              only packets before ms since capture start\n");
+        printf("  -n, --no-data              print headers without hex dump\n");
+        printf("  -s, --stats                print packet count and size per opcode\n");
+        printf("  -w, --write <file>         write the matching packets into a new capture file\n");
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& options)
+    {
+        if (argc < 2)
+            return false;
+
+        options.inputFile = argv[1];
+
+        for (int i = 2; i < argc; ++i)
+        {
+            const std::string option = argv[i];
+            const bool hasValue = i + 1 < argc;
+
+            if ((option == "-o" || option == "--opcode") && hasValue)
+                options.opcodeFilters.push_back(argv[++i]);
+            else if ((option == "-a" || option == "--account") && hasValue)
+                options.accounts.insert(static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10)));
+            else if ((option == "-d" || option == "--direction") && hasValue)
+                options.direction = argv[++i][0] == 'c' ? PACKET_CAPTURE_CLIENT_TO_SERVER : PACKET_CAPTURE_SERVER_TO_CLIENT;
+            else if ((option == "-f" || option == "--from") && hasValue)
+                options.fromTime = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+            else if ((option == "-t" || option == "--to") && hasValue)
+                options.toTime = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+            else if (option == "-n" || option == "--no-data")
+                options.printData = false;
+            else if (option == "-s" || option == "--stats")
+                options.printStats = true;
+            else if ((option == "-w" || option == "--write") && hasValue)
+                options.outputFile = argv[++i];
+            else
+                return false;
+        }
+
+        return true;
+    }
+
+    bool resolveOpcodeFilters(Options& options, std::map<uint16_t, std::string> const& opcodeNames)
+    {
+        for (const auto& filter : options.opcodeFilters)
+        {
+            if (filter.compare(0, 2, "0x") == 0 || filter.compare(0, 2, "0X") == 0)
+            {
+                options.opcodes.insert(static_cast<uint16_t>(strtoul(filter.c_str(), nullptr, 16)));
+                continue;
+            }
+
+            const auto opcodeName = std::find_if(opcodeNames.begin(), opcodeNames.end(), [&filter](auto const& entry) { return entry.second == filter; });
+            if (opcodeName == opcodeNames.end())
+            {
+                fprintf(stderr, "Opcode %s is not part of this capture\n", filter.c_str());
+                return false;
+            }
+
+            options.opcodes.insert(opcodeName->first);
+        }
+
+        return true;
+    }
+
+    bool matches(Options const& options, PacketCaptureRecordHeader const& record)
+    {
+        if (!options.opcodes.empty() && options.opcodes.find(record.opcode) == options.opcodes.end())
+            return false;
+
+        if (!options.accounts.empty() && options.accounts.find(record.accountId) == options.accounts.end())
+            return false;
+
+        if (options.direction != -1 && record.direction != options.direction)
+            return false;
+
+        return record.time >= options.fromTime && record.time < options.toTime;
+    }
+
+    // same layout as the text packet log of the world server
+    void printHexDump(std::vector<uint8_t> const& data)
+    {
+        printf("|------------------------------------------------|----------------|\n");
+        printf("|00 01 02 03 04 05 06 07 08 09 0A 0B 0C 0D 0E 0F |0123456789ABCDEF|\n");
+        printf("|------------------------------------------------|----------------|\n");
+
+        for (size_t line = 0; line < data.size(); line += 16)
+        {
+            const size_t lineLength = std::min<size_t>(16, data.size() - line);
+
+            printf("|");
+            for (size_t i = 0; i < 16; ++i)
+            {
+                if (i < lineLength)
+                    printf("%02X ", data[line + i]);
+                else
+                    printf("   ");
+            }
+
+            printf("|");
+            for (size_t i = 0; i < 16; ++i)
+            {
+                if (i < lineLength)
+                    printf("%c", data[line + i] < 32 || data[line + i] > 126 ? '.' : data[line + i]);
+                else
+                    printf(" ");
+            }
+            printf("|\n");
+        }
+
+        printf("-------------------------------------------------------------------\n\n");
+    }
+
+    std::string getOpcodeName(std::map<uint16_t, std::string> const& opcodeNames, uint16_t opcode)
+    {
+        const auto itr = opcodeNames.find(opcode);
+        return itr != opcodeNames.end() ? itr->second : "UNKNOWN";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    FILE* input = fopen(options.inputFile.c_str(), "rb");
+    if (input == nullptr)
+    {
+        fprintf(stderr, "Could not open %s\n", options.inputFile.c_str());
+        return 1;
+    }
+
+    PacketCaptureFileHeader fileHeader;
+    if (fread(&fileHeader, sizeof(fileHeader), 1, input) != 1 || memcmp(fileHeader.magic, PACKET_CAPTURE_MAGIC, sizeof(fileHeader.magic)) != 0)
+    {
+        fprintf(stderr, "%s is not a packet capture\n", options.inputFile.c_str());
+        fclose(input);
+        return 1;
+    }
+
+    if (fileHeader.formatVersion != PACKET_CAPTURE_FORMAT_VERSION)
+    {
+        fprintf(stderr, "Capture format %u is not supported\n", fileHeader.formatVersion);
+        fclose(input);
+        return 1;
+    }
+
+    // the opcode name table is copied as it is into filtered captures
+    std::vector<uint8_t> opcodeNameTable;
+    std::map<uint16_t, std::string> opcodeNames;
+    for (uint32_t i = 0; i < fileHeader.opcodeNameCount; ++i)
+    {
+        uint8_t entry[3];
+        if (fread(entry, sizeof(entry), 1, input) != 1)
+        {
+            fprintf(stderr, "Capture header is truncated\n");
+            fclose(input);
+            return 1;
+        }
+
+        std::string name(entry[2], '\0');
+        if (entry[2] != 0 && fread(&name[0], entry[2], 1, input) != 1)
+        {
+            fprintf(stderr, "Capture header is truncated\n");
+            fclose(input);
+            return 1;
+        }
+
+        uint16_t opcode;
+        memcpy(&opcode, entry, sizeof(opcode));
+        opcodeNames.emplace(opcode, name);
+
+        opcodeNameTable.insert(opcodeNameTable.end(), entry, entry + sizeof(entry));
+        opcodeNameTable.insert(opcodeNameTable.end(), name.begin(), name.end());
+    }
+
+    if (!resolveOpcodeFilters(options, opcodeNames))
+    {
+        fclose(input);
+        return 1;
+    }
+
+    FILE* output = nullptr;
+    if (!options.outputFile.empty())
+    {
+        output = fopen(options.outputFile.c_str(), "wb");
+        if (output == nullptr)
+        {
+            fprintf(stderr, "Could not open %s\n", options.outputFile.c_str());
+            fclose(input);
+            return 1;
+        }
+
+        fwrite(&fileHeader, sizeof(fileHeader), 1, output);
+        fwrite(opcodeNameTable.data(), 1, opcodeNameTable.size(), output);
+    }
+
+    const time_t startTime = static_cast<time_t>(fileHeader.startTime);
+    char startTimeString[32];
+    strftime(startTimeString, sizeof(startTimeString), "%Y-%m-%d %H:%M:%S", localtime(&startTime));
+
+    const bool printPackets = output == nullptr && !options.printStats;
+    if (printPackets)
+        printf("Capture started %s, version id %u, %u opcodes\n\n", startTimeString, fileHeader.versionId, fileHeader.opcodeNameCount);
+
+    std::map<uint16_t, OpcodeStats> opcodeStats;
+    uint64_t recordCount = 0;
+    uint64_t matchCount = 0;
+
+    PacketCaptureRecordHeader record;
+    std::vector<uint8_t> data;
+    while (fread(&record, sizeof(record), 1, input) == 1)
+    {
+        data.resize(record.capturedLength);
+        if (record.capturedLength != 0 && fread(data.data(), record.capturedLength, 1, input) != 1)
+        {
+            fprintf(stderr, "Last packet is truncated\n");
+            break;
+        }
+
+        ++recordCount;
+        if (!matches(options, record))
+            continue;
+
+        ++matchCount;
+
+        auto& stats = opcodeStats[record.opcode];
+        ++stats.count;
+        stats.bytes += record.length;
+
+        if (output != nullptr)
+        {
+            fwrite(&record, sizeof(record), 1, output);
+            fwrite(data.data(), 1, data.size(), output);
+        }
+
+        if (!printPackets)
+            continue;
+
+        printf("{%s} Packet: (0x%04X) %s PacketSize = %u time = %u accountid = %u%s\n", record.direction == PACKET_CAPTURE_SERVER_TO_CLIENT ? "SERVER" : "CLIENT",
+            record.opcode, getOpcodeName(opcodeNames, record.opcode).c_str(), record.length, record.time, record.accountId,
+            record.capturedLength < record.length ? " (cut)" : "");
+
+        if (options.printData)
+            printHexDump(data);
+    }
+
+    if (options.printStats)
+    {
+        std::vector<std::pair<uint16_t, OpcodeStats>> sortedStats(opcodeStats.begin(), opcodeStats.end());
+        std::sort(sortedStats.begin(), sortedStats.end(), [](auto const& a, auto const& b) { return a.second.count > b.second.count; });
+
+        printf("Capture started %s, %llu packets, %llu matching\n\n", startTimeString, static_cast<unsigned long long>(recordCount),
+            static_cast<unsigned long long>(matchCount));
+        printf("%-6s | %-45s | %10s | %12s\n", "Opcode", "Name", "Count", "Bytes");
+        for (const auto& stats : sortedStats)
+        {
+            printf("0x%04X | %-45s | %10llu | %12llu\n", stats.first, getOpcodeName(opcodeNames, stats.first).c_str(),
+                static_cast<unsigned long long>(stats.second.count), static_cast<unsigned long long>(stats.second.bytes));
+        }
+    }
+
+    if (output != nullptr)
+    {
+        fclose(output);
+        printf("%llu of %llu packets written to %s\n", static_cast<unsigned long long>(matchCount), static_cast<unsigned long long>(recordCount),
+            options.outputFile.c_str());
+    }
+
+    fclose(input);
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#include "UpdateCompressor.hpp"
+#include "Log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <vector>
+#include <zlib.h>
+
+namespace
+{
+    // one stream per level, deflateParams on a reset stream is not safe with every zlib version
+    struct ThreadStreams
+    {
+        std::array<z_stream, Z_BEST_COMPRESSION + 1> streams{};
+        std::array<bool, Z_BEST_COMPRESSION + 1> isInitialized{};
+        std::vector<uint8_t> buffer;
+
+        ~ThreadStreams()
+        {
+            for (size_t level = 0; level < streams.size(); ++level)
+                if (isInitialized[level])
+                    deflateEnd(&streams[level]);
+        }
+    };
+
+    thread_local ThreadStreams t_updateStreams;
+}
+
+UpdateCompressor& UpdateCompressor::getInstance()
+{
+    static UpdateCompressor mInstance;
+    return mInstance;
+}
+
+const uint8_t* UpdateCompressor::compress(const uint8_t* data, uint32_t size, int level, uint32_t& compressedSize)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+
+    level = std::clamp(level, Z_NO_COMPRESSION, Z_BEST_COMPRESSION);
+
+    ThreadStreams& threadStream = t_updateStreams;
+    z_stream& stream = threadStream.streams[level];
+
+    if (!threadStream.isInitialized[level])
+    {
+        if (deflateInit(&stream, level) != Z_OK)
+        {
+            sLogger.failure("UpdateCompressor : deflateInit failed.");
+            return nullptr;
+        }
+
+        threadStream.isInitialized[level] = true;
+        ++m_streamCount;
+    }
+    else if (deflateReset(&stream) != Z_OK)
+    {
+        sLogger.failure("UpdateCompressor : deflateReset failed.");
+        return nullptr;
+    }
+
+    // size prefix + compressed data
+    const uLong bound = deflateBound(&stream, size);
+    if (threadStream.buffer.size() < bound + 4)
+        threadStream.buffer.resize(bound + 4);
+
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = size;
+    stream.next_out = threadStream.buffer.data() + 4;
+    stream.avail_out = static_cast<uInt>(bound);
+
+    // deflateBound guarantees that a single finishing call is enough
+    if (deflate(&stream, Z_FINISH) != Z_STREAM_END)
+    {
+        sLogger.failure("UpdateCompressor : deflate failed: did not end stream");
+        return nullptr;
+    }
+
+    *reinterpret_cast<uint32_t*>(threadStream.buffer.data()) = size;
+    compressedSize = static_cast<uint32_t>(stream.total_out) + 4;
+
+    ++m_packetCount;
+    m_bytesIn += size;
+    m_bytesOut += compressedSize;
+    m_compressionTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+
+    return threadStream.buffer.data();
+}
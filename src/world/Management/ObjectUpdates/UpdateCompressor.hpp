@@ -0,0 +1,49 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "CommonTypes.hpp"
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Deflates SMSG_COMPRESSED_UPDATE_OBJECT payloads.
+// Every thread that compresses keeps its own zlib stream per level and one output buffer,
+// the streams are reset (deflateReset) instead of set up again for every packet.
+class SERVER_DECL UpdateCompressor
+{
+private:
+    UpdateCompressor() = default;
+    ~UpdateCompressor() = default;
+
+public:
+    static UpdateCompressor& getInstance();
+
+    UpdateCompressor(UpdateCompressor&&) = delete;
+    UpdateCompressor(UpdateCompressor const&) = delete;
+    UpdateCompressor& operator=(UpdateCompressor&&) = delete;
+    UpdateCompressor& operator=(UpdateCompressor const&) = delete;
+
+    // Returns the compressed data prefixed by the uncompressed size (uint32) or nullptr on failure.
+    // The data belongs to the calling thread and stays valid until its next compress call.
+    const uint8_t* compress(const uint8_t* data, uint32_t size, int level, uint32_t& compressedSize);
+
+    uint64_t getPacketCount() const { return m_packetCount; }
+    uint64_t getBytesIn() const { return m_bytesIn; }
+    uint64_t getBytesOut() const { return m_bytesOut; }
+    uint64_t getCompressionTime() const { return m_compressionTime; }
+    uint32_t getStreamCount() const { return m_streamCount; }
+
+private:
+    std::atomic<uint64_t> m_packetCount = 0;
+    std::atomic<uint64_t> m_bytesIn = 0;
+    std::atomic<uint64_t> m_bytesOut = 0;
+    std::atomic<uint64_t> m_compressionTime = 0;     // microseconds
+    std::atomic<uint32_t> m_streamCount = 0;
+};
+
+#define sUpdateCompressor UpdateCompressor::getInstance()
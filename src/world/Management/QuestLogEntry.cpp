@@ -8,6 +8,7 @@ This file is released under the MIT license. See README-MIT for more information
 #include "QuestLogEntry.hpp"
 #include "Server/WorldSession.h"
 #include "Server/MainServerDefines.h"
+#include "Server/CharacterDatabaseStatements.hpp"
 #include "Database/Database.h"
 #include "Management/ItemInterface.h"
 #include "QuestMgr.h"
@@ -82,23 +83,24 @@ void QuestLogEntry::loadFromDB(Field* fields)
 
 void QuestLogEntry::saveToDB(QueryBuffer* queryBuffer)
 {
-    std::stringstream ss;
-
-    ss << "REPLACE INTO questlog VALUES(";
-    ss << m_player->getGuidLow() << "," << m_questProperties->id << "," << uint32_t(m_slot) << "," << m_expirytime;
+    PreparedStatement* statement = CharacterDatabase.getPreparedStatement(CHARACTER_REP_QUESTLOG);
+    statement->setUInt32(0, m_player->getGuidLow());
+    statement->setUInt32(1, m_questProperties->id);
+    statement->setUInt32(2, m_slot);
+    statement->setUInt32(3, m_expirytime);
 
     for (uint8_t i = 0; i < 4; ++i)
-        ss << "," << m_explored_areas[i];
+        statement->setUInt32(4 + i, m_explored_areas[i]);
 
     for (uint8_t i = 0; i < 4; ++i)
-        ss << "," << m_mobcount[i];
+        statement->setUInt32(8 + i, m_mobcount[i]);
 
-    ss << "," << m_state << ");";
+    statement->setUInt32(12, m_state);
 
     if (queryBuffer == nullptr)
-        CharacterDatabase.Execute(ss.str().c_str());
+        CharacterDatabase.executePreparedAsync(statement);
     else
-        queryBuffer->AddQueryStr(ss.str());
+        queryBuffer->addPreparedStatement(statement);
 }
 
 uint8_t QuestLogEntry::getSlot() const { return m_slot; }
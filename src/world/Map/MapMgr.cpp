@@ -35,6 +35,7 @@
 #include "Macros/ScriptMacros.hpp"
 #include "MapMgr.h"
 #include "MapScriptInterface.h"
+#include "MapUpdateScheduler.hpp"
 #include "WorldCreator.h"
 #include "Objects/Units/Creatures/Pet.h"
 #include "Server/Packets/SmsgUpdateWorldState.h"
@@ -45,7 +46,9 @@
 
 using namespace AscEmu::Packets;
 
-Arcemu::Utility::TLSObject<MapMgr*> t_currentMapContext;
+SERVER_DECL Arcemu::Utility::TLSObject<MapMgr*> t_currentMapContext;
+
+uint64_t MapUpdateKey::getKey(Object* object) { return object->getGuid(); }
 
 extern bool bServerShutdown;
 
@@ -80,6 +83,9 @@ MapMgr::MapMgr(Map* map, uint32 mapId, uint32 instanceid) : CellHandler<MapCell>
     forced_expire = false;
     InactiveMoveTime = 0;
     mLoopCounter = 0;
+    m_tickProfiler = sMapTickProfilerRegistry.createProfiler(mapId, instanceid);
+    m_lastActiveTime = Util::getMSTime();
+    eventHolder.SetEventAddedHandler([this]() { wakeUp(); });
     pInstance = nullptr;
     thread_kill_only = false;
     thread_running = false;
@@ -98,7 +104,6 @@ MapMgr::MapMgr(Map* map, uint32 mapId, uint32 instanceid) : CellHandler<MapCell>
 
     activeGameObjects.clear();
     activeCreatures.clear();
-    creature_iterator = activeCreatures.begin();
     pet_iterator = m_PetStorage.begin();
     m_corpses.clear();
     _sqlids_creatures.clear();
@@ -113,6 +118,7 @@ MapMgr::~MapMgr()
 {
     _shutdown = true;
     sEventMgr.RemoveEvents(this);
+    sMapTickProfilerRegistry.removeProfiler(m_tickProfiler);
     if (ScriptInterface != nullptr)
     {
         delete ScriptInterface;
@@ -152,16 +158,14 @@ MapMgr::~MapMgr()
     CreatureStorage.clear();
     m_TransportStorage.clear();
 
-    for (auto itr = m_corpses.begin(); itr != m_corpses.end();)
+    // removing a corpse from world erases it from m_corpses
+    m_corpses.forEach([](Corpse* pCorpse)
     {
-        Corpse* pCorpse = *itr;
-        ++itr;
-
         if (pCorpse->IsInWorld())
             pCorpse->RemoveFromWorld(false);
 
         delete pCorpse;
-    }
+    });
     m_corpses.clear();
 
     if (mInstanceScript != NULL)
@@ -299,6 +303,8 @@ void MapMgr::PushObject(Object* obj)
             }
         }
 
+        obj->m_lastInRangeScanPosition = obj->GetPosition();
+
         // Forced Cells
         for (auto& cell : m_forcedcells)
             UpdateInRangeSet(obj, plObj, cell, &buf);
@@ -443,13 +449,29 @@ void MapMgr::RemoveObject(Object* obj, bool free_guid)
     if (obj->IsActive())
         obj->Deactivate(this);
 
-    //there is a very small chance that on double player ports on same update player is added to multiple insertpools but not removed
-    //one clear example was the double port proc when exploiting double resurrect
-    m_objectinsertlock.Acquire();
-    m_objectinsertpool.erase(obj);
-    m_objectinsertlock.Release();
+    if (t_currentMapContext.get() == this)
+    {
+        //there is a very small chance that on double player ports on same update player is added to multiple insertpools but not removed
+        //one clear example was the double port proc when exploiting double resurrect
+        if (obj->m_inQueue)
+        {
+            _ProcessInsertRequests();
+            m_objectInsertPool.erase(obj);
+        }
+
+        // updates queued by other threads must not outlive the object
+        _ProcessUpdateNotifications();
+        _updates.erase(obj);
+    }
+    else
+    {
+        if (obj->m_inQueue)
+            m_objectInsertQueue.push({ obj, true });
+
+        // _updates belongs to the map thread, it drops the object with its next notifications
+        m_updateNotifications.push({ obj, obj->getGuid(), true });
+    }
 
-    _updates.erase(obj);
     obj->ClearUpdateMask();
 
     // Remove object from all needed places
@@ -624,38 +646,20 @@ void MapMgr::ChangeObjectLocation(Object* obj)
     if (obj->isCreatureOrPlayer() && static_cast<Unit*>(obj)->mPlayerControler != nullptr)
         plObj = static_cast<Unit*>(obj)->mPlayerControler;
 
-    float fRange = 0.0f;
+    MapCell* pOldCell = obj->GetMapCell();
+
+    // The objects in range and the whole cell block are only checked again once the object moved
+    // MAPMGR_INRANGE_RESCAN_DISTANCE, in between only the cells entering and leaving the block are.
+    const bool isRescan = pOldCell == nullptr
+        || obj->m_lastInRangeScanPosition.Distance2DSq(obj->GetPosition()) >= MAPMGR_INRANGE_RESCAN_DISTANCE * MAPMGR_INRANGE_RESCAN_DISTANCE;
 
     // Update in-range data for old objects
-    if (obj->hasInRangeObjects())
+    if (isRescan && obj->hasInRangeObjects())
     {
-        for (const auto& iter : obj->getInRangeObjectsSet())
+        for (const auto& curObj : obj->getInRangeObjectsSet())
         {
-            if (iter)
-            {
-                Object* curObj = iter;
-
-                fRange = GetUpdateDistance(curObj, obj, plObj);
-
-                if (fRange > 0.0f && (curObj->GetDistance2dSq(obj) > fRange))
-                {
-                    if (plObj != nullptr)
-                        plObj->RemoveIfVisible(curObj->getGuid());
-
-                    if (curObj->isPlayer())
-                        static_cast<Player*>(curObj)->RemoveIfVisible(obj->getGuid());
-
-                    if (curObj->isCreatureOrPlayer() && static_cast<Unit*>(curObj)->mPlayerControler != nullptr)
-                        static_cast<Unit*>(curObj)->mPlayerControler->RemoveIfVisible(obj->getGuid());
-
-                    curObj->removeObjectFromInRangeObjectsSet(obj);
-
-                    if (obj->GetMapMgr() != this)
-                        return;             //Something removed us.
-
-                    obj->removeObjectFromInRangeObjectsSet(curObj);
-                }
-            }
+            if (curObj && !RemoveIfOutOfRange(obj, plObj, curObj))
+                return;             //Something removed us.
         }
     }
 
@@ -679,7 +683,6 @@ void MapMgr::ChangeObjectLocation(Object* obj)
     }
 
     MapCell* objCell = GetCell(cellX, cellY);
-    MapCell* pOldCell = obj->GetMapCell();
     if (objCell == nullptr)
     {
         objCell = Create(cellX, cellY);
@@ -730,28 +733,85 @@ void MapMgr::ChangeObjectLocation(Object* obj)
         }
     }
 
+    // Cell block around a cell, in which the object looks for new objects in range
+    auto getCellBlock = [this, obj, cellNumber](uint32 x, uint32 y, uint32& startX, uint32& startY, uint32& endX, uint32& endY)
+    {
+        endX = x + cellNumber;
+        endY = y + cellNumber;
+        startX = x > 0 ? x - cellNumber : 0;
+        startY = y > 0 ? y - cellNumber : 0;
+
+        //If the object announcing it's position is a special one, then it should do so in a much wider area - like the distance between the two transport towers in Orgrimmar, or more. - By: VLack
+        if (obj->isGameObject() && (static_cast< GameObject* >(obj)->GetOverrides() & GAMEOBJECT_ONMOVEWIDE))
+        {
+            endX = x + 5 <= _sizeX ? x + 6 : (_sizeX - 1);
+            endY = y + 5 <= _sizeY ? y + 6 : (_sizeY - 1);
+            startX = x > 5 ? x - 6 : 0;
+            startY = y > 5 ? y - 6 : 0;
+        }
+    };
+
     // Update in-range set for new objects
-    uint32 endX = cellX + cellNumber;
-    uint32 endY = cellY + cellNumber;
-    uint32 startX = cellX > 0 ? cellX - cellNumber : 0;
-    uint32 startY = cellY > 0 ? cellY - cellNumber : 0;
+    uint32 startX, startY, endX, endY;
+    getCellBlock(cellX, cellY, startX, startY, endX, endY);
 
-    //If the object announcing it's position is a special one, then it should do so in a much wider area - like the distance between the two transport towers in Orgrimmar, or more. - By: VLack
-    if (obj->isGameObject() && (static_cast< GameObject* >(obj)->GetOverrides() & GAMEOBJECT_ONMOVEWIDE))
+    if (isRescan)
     {
-        endX = cellX + 5 <= _sizeX ? cellX + 6 : (_sizeX - 1);
-        endY = cellY + 5 <= _sizeY ? cellY + 6 : (_sizeY - 1);
-        startX = cellX > 5 ? cellX - 6 : 0;
-        startY = cellY > 5 ? cellY - 6 : 0;
-    }
+        for (uint32 posX = startX; posX <= endX; ++posX)
+        {
+            for (uint32 posY = startY; posY <= endY; ++posY)
+            {
+                MapCell* cell = GetCell(posX, posY);
+                if (cell)
+                    UpdateInRangeSet(obj, plObj, cell, &buf);
+            }
+        }
 
-    for (uint32 posX = startX; posX <= endX; ++posX)
+        obj->m_lastInRangeScanPosition = obj->GetPosition();
+    }
+    else if (objCell != pOldCell)
     {
-        for (uint32 posY = startY; posY <= endY; ++posY)
+        uint32 oldStartX, oldStartY, oldEndX, oldEndY;
+        getCellBlock(pOldCell->_x, pOldCell->_y, oldStartX, oldStartY, oldEndX, oldEndY);
+
+        // Objects of the cells which left the block can be out of range now
+        for (uint32 posX = oldStartX; posX <= oldEndX; ++posX)
         {
-            MapCell* cell = GetCell(posX, posY);
-            if (cell)
-                UpdateInRangeSet(obj, plObj, cell, &buf);
+            for (uint32 posY = oldStartY; posY <= oldEndY; ++posY)
+            {
+                if (posX >= startX && posX <= endX && posY >= startY && posY <= endY)
+                    continue;
+
+                MapCell* cell = GetCell(posX, posY);
+                if (cell == nullptr)
+                    continue;
+
+                for (auto iter = cell->Begin(); iter != cell->End();)
+                {
+                    Object* curObj = *iter;
+                    ++iter;
+
+                    if (curObj && obj->isObjectInInRangeObjectsSet(curObj) && !RemoveIfOutOfRange(obj, plObj, curObj))
+                    {
+                        delete buf;
+                        return;         //Something removed us.
+                    }
+                }
+            }
+        }
+
+        // Cells which entered the block are scanned fully
+        for (uint32 posX = startX; posX <= endX; ++posX)
+        {
+            for (uint32 posY = startY; posY <= endY; ++posY)
+            {
+                if (posX >= oldStartX && posX <= oldEndX && posY >= oldStartY && posY <= oldEndY)
+                    continue;
+
+                MapCell* cell = GetCell(posX, posY);
+                if (cell)
+                    UpdateInRangeSet(obj, plObj, cell, &buf);
+            }
         }
     }
 
@@ -759,6 +819,30 @@ void MapMgr::ChangeObjectLocation(Object* obj)
         delete buf;
 }
 
+bool MapMgr::RemoveIfOutOfRange(Object* obj, Player* plObj, Object* curObj)
+{
+    const float fRange = GetUpdateDistance(curObj, obj, plObj);
+    if (fRange == 0.0f || curObj->GetDistance2dSq(obj) <= fRange)
+        return true;
+
+    if (plObj != nullptr)
+        plObj->RemoveIfVisible(curObj->getGuid());
+
+    if (curObj->isPlayer())
+        static_cast<Player*>(curObj)->RemoveIfVisible(obj->getGuid());
+
+    if (curObj->isCreatureOrPlayer() && static_cast<Unit*>(curObj)->mPlayerControler != nullptr)
+        static_cast<Unit*>(curObj)->mPlayerControler->RemoveIfVisible(obj->getGuid());
+
+    curObj->removeObjectFromInRangeObjectsSet(obj);
+
+    if (obj->GetMapMgr() != this)
+        return false;
+
+    obj->removeObjectFromInRangeObjectsSet(curObj);
+    return true;
+}
+
 void MapMgr::OutOfMapBoundariesTeleport(Object* object)
 {
     if (object->isPlayer())
@@ -790,7 +874,6 @@ void MapMgr::UpdateInRangeSet(Object* obj, Player* plObj, MapCell* cell, ByteBuf
 
     Player* plObj2;
     int count;
-    bool cansee, isvisible;
 
     auto iter = cell->Begin();
     while (iter != cell->End())
@@ -862,70 +945,79 @@ void MapMgr::UpdateInRangeSet(Object* obj, Player* plObj, MapCell* cell, ByteBuf
             else
             {
                 // Check visibility
-                if (curObj->isPlayer())
-                {
-                    plObj2 = static_cast<Player*>(curObj);
-                    cansee = plObj2->canSee(obj);
-                    isvisible = plObj2->IsVisible(obj->getGuid());
-                    if (!cansee && isvisible)
-                    {
-                        plObj2->getUpdateMgr().pushOutOfRangeGuid(obj->GetNewGUID());
-                        plObj2->RemoveVisibleObject(obj->getGuid());
-                    }
-                    else if (cansee && !isvisible)
-                    {
-                        if (!*buf)
-                            * buf = new ByteBuffer(2500);
+                UpdateInRangeVisibility(obj, plObj, curObj, buf);
+            }
+        }
+    }
+}
 
-                        count = obj->buildCreateUpdateBlockForPlayer(*buf, plObj2);
-                        plObj2->getUpdateMgr().pushCreationData(*buf, count);
-                        plObj2->AddVisibleObject(obj->getGuid());
-                        (*buf)->clear();
-                    }
-                }
-                else if (curObj->isCreatureOrPlayer() && static_cast<Unit*>(curObj)->mPlayerControler != nullptr)
-                {
-                    plObj2 = static_cast<Unit*>(curObj)->mPlayerControler;
-                    cansee = plObj2->canSee(obj);
-                    isvisible = plObj2->IsVisible(obj->getGuid());
-                    if (!cansee && isvisible)
-                    {
-                        plObj2->getUpdateMgr().pushOutOfRangeGuid(obj->GetNewGUID());
-                        plObj2->RemoveVisibleObject(obj->getGuid());
-                    }
-                    else if (cansee && !isvisible)
-                    {
-                        if (!*buf)
-                            * buf = new ByteBuffer(2500);
+void MapMgr::UpdateInRangeVisibility(Object* obj, Player* plObj, Object* curObj, ByteBuffer** buf)
+{
+    Player* plObj2;
+    int count;
+    bool cansee, isvisible;
 
-                        count = obj->buildCreateUpdateBlockForPlayer(*buf, plObj2);
-                        plObj2->getUpdateMgr().pushCreationData(*buf, count);
-                        plObj2->AddVisibleObject(obj->getGuid());
-                        (*buf)->clear();
-                    }
-                }
+    if (curObj->isPlayer())
+    {
+        plObj2 = static_cast<Player*>(curObj);
+        cansee = plObj2->canSee(obj);
+        isvisible = plObj2->IsVisible(obj->getGuid());
+        if (!cansee && isvisible)
+        {
+            plObj2->getUpdateMgr().pushOutOfRangeGuid(obj->GetNewGUID());
+            plObj2->RemoveVisibleObject(obj->getGuid());
+        }
+        else if (cansee && !isvisible)
+        {
+            if (!*buf)
+                * buf = new ByteBuffer(2500);
 
-                if (plObj != nullptr)
-                {
-                    cansee = plObj->canSee(curObj);
-                    isvisible = plObj->IsVisible(curObj->getGuid());
-                    if (!cansee && isvisible)
-                    {
-                        plObj->getUpdateMgr().pushOutOfRangeGuid(curObj->GetNewGUID());
-                        plObj->RemoveVisibleObject(curObj->getGuid());
-                    }
-                    else if (cansee && !isvisible)
-                    {
-                        if (!*buf)
-                            * buf = new ByteBuffer(2500);
+            count = obj->buildCreateUpdateBlockForPlayer(*buf, plObj2);
+            plObj2->getUpdateMgr().pushCreationData(*buf, count);
+            plObj2->AddVisibleObject(obj->getGuid());
+            (*buf)->clear();
+        }
+    }
+    else if (curObj->isCreatureOrPlayer() && static_cast<Unit*>(curObj)->mPlayerControler != nullptr)
+    {
+        plObj2 = static_cast<Unit*>(curObj)->mPlayerControler;
+        cansee = plObj2->canSee(obj);
+        isvisible = plObj2->IsVisible(obj->getGuid());
+        if (!cansee && isvisible)
+        {
+            plObj2->getUpdateMgr().pushOutOfRangeGuid(obj->GetNewGUID());
+            plObj2->RemoveVisibleObject(obj->getGuid());
+        }
+        else if (cansee && !isvisible)
+        {
+            if (!*buf)
+                * buf = new ByteBuffer(2500);
 
-                        count = curObj->buildCreateUpdateBlockForPlayer(*buf, plObj);
-                        plObj->getUpdateMgr().pushCreationData(*buf, count);
-                        plObj->AddVisibleObject(curObj->getGuid());
-                        (*buf)->clear();
-                    }
-                }
-            }
+            count = obj->buildCreateUpdateBlockForPlayer(*buf, plObj2);
+            plObj2->getUpdateMgr().pushCreationData(*buf, count);
+            plObj2->AddVisibleObject(obj->getGuid());
+            (*buf)->clear();
+        }
+    }
+
+    if (plObj != nullptr)
+    {
+        cansee = plObj->canSee(curObj);
+        isvisible = plObj->IsVisible(curObj->getGuid());
+        if (!cansee && isvisible)
+        {
+            plObj->getUpdateMgr().pushOutOfRangeGuid(curObj->GetNewGUID());
+            plObj->RemoveVisibleObject(curObj->getGuid());
+        }
+        else if (cansee && !isvisible)
+        {
+            if (!*buf)
+                * buf = new ByteBuffer(2500);
+
+            count = curObj->buildCreateUpdateBlockForPlayer(*buf, plObj);
+            plObj->getUpdateMgr().pushCreationData(*buf, count);
+            plObj->AddVisibleObject(curObj->getGuid());
+            (*buf)->clear();
         }
     }
 }
@@ -961,20 +1053,74 @@ float MapMgr::GetUpdateDistance(Object* curObj, Object* obj, Player* plObj)
     return m_UpdateDistance;
 }
 
+void MapMgr::_ProcessInsertRequests()
+{
+    m_objectInsertQueue.consumeAll([this](ObjectInsertRequest const& request)
+    {
+        if (request.cancel)
+            m_objectInsertPool.erase(request.object);
+        else
+            m_objectInsertPool.insert(request.object);
+    });
+
+    // an object removed by another thread before it was added again must leave _updates first
+    _ProcessUpdateNotifications();
+}
+
+void MapMgr::_ProcessUpdateNotifications()
+{
+    if (m_updateNotifications.empty())
+        return;
+
+    std::vector<UpdateNotification> notifications;
+    m_updateNotifications.consumeAll([&notifications](UpdateNotification const& notification)
+    {
+        notifications.push_back(notification);
+    });
+
+    // an object removed after its update can already be deleted, it must not be touched
+    std::unordered_map<uint64_t, size_t> lastRemoval;
+    for (size_t i = 0; i < notifications.size(); ++i)
+    {
+        if (notifications[i].remove)
+            lastRemoval[notifications[i].guid] = i;
+    }
+
+    for (size_t i = 0; i < notifications.size(); ++i)
+    {
+        if (notifications[i].remove)
+        {
+            _updates.eraseKey(notifications[i].guid);
+            continue;
+        }
+
+        Object* obj = notifications[i].object;
+        const auto removal = lastRemoval.find(notifications[i].guid);
+        if (removal != lastRemoval.end() && removal->second > i)
+            continue;
+
+        if (obj->GetMapMgr() != this || !obj->IsInWorld())
+            continue;
+
+        _updates.insert(obj);
+    }
+}
+
 void MapMgr::_UpdateObjects()
 {
-    if (!_updates.size() && !_processQueue.size())
+    if (!_updates.size() && !_processQueue.size() && m_updateNotifications.empty())
         return;
 
+    _ProcessUpdateNotifications();
+
     ByteBuffer update(2500);
     uint32 count = 0;
 
-    m_updateMutex.Acquire();
-
-    for (auto pObj : _updates)
+    // objects can be queued while we build the updates
+    _updates.forEach([&update, &count](Object* pObj)
     {
         if (pObj == nullptr)
-            continue;
+            return;
 
         if (pObj->isItem() || pObj->isContainer())
         {
@@ -1034,22 +1180,16 @@ void MapMgr::_UpdateObjects()
             }
         }
         pObj->ClearUpdateMask();
-    }
+    });
     _updates.clear();
-    m_updateMutex.Release();
 
     // generate pending a9packets and send to clients.
-    for (auto it = _processQueue.begin(); it != _processQueue.end();)
+    _processQueue.forEach([this](Player* player)
     {
-        Player* player = *it;
-
-        auto it2 = it;
-        ++it;
-
-        _processQueue.erase(it2);
+        _processQueue.erase(player);
         if (player->GetMapMgr() == this)
             player->ProcessPendingUpdates();
-    }
+    });
 }
 
 
@@ -1262,7 +1402,7 @@ float MapMgr::GetADTLandHeight(float x, float y)
     if (tile == nullptr)
         return TERRAIN_INVALID_HEIGHT;
 
-    float rv = tile->m_map.GetHeight(x, y);
+    float rv = tile->m_map->GetHeight(x, y);
     tile->DecRef();
 
     return rv;
@@ -1296,7 +1436,7 @@ float MapMgr::GetLiquidHeight(float x, float y)
     if (tile == nullptr)
         return TERRAIN_INVALID_HEIGHT;
 
-    float rv = tile->m_map.GetTileLiquidHeight(x, y);
+    float rv = tile->m_map->GetTileLiquidHeight(x, y);
     tile->DecRef();
 
     return rv;
@@ -1308,7 +1448,7 @@ uint8 MapMgr::GetLiquidType(float x, float y)
     if (tile == nullptr)
         return 0;
 
-    uint8 rv = tile->m_map.GetTileLiquidType(x, y);
+    uint8 rv = tile->m_map->GetTileLiquidType(x, y);
     tile->DecRef();
 
     return rv;
@@ -1464,7 +1604,7 @@ bool MapMgr::_CellActive(uint32 x, uint32 y)
             MapCell* objCell = GetCell(posX, posY);
             if (objCell != nullptr)
             {
-                if (objCell->HasPlayers() || m_forcedcells.find(objCell) != m_forcedcells.end())
+                if (objCell->HasPlayers() || m_forcedcells.contains(objCell))
                 {
                     return true;
                 }
@@ -1478,9 +1618,13 @@ bool MapMgr::_CellActive(uint32 x, uint32 y)
 void MapMgr::ObjectUpdated(Object* obj)
 {
     // set our fields to dirty stupid fucked up code in places.. i hate doing this but i've got to :<- burlex
-    m_updateMutex.Acquire();
-    _updates.insert(obj);
-    m_updateMutex.Release();
+    if (t_currentMapContext.get() == this)
+        _updates.insert(obj);
+    else
+    {
+        m_updateNotifications.push({ obj, obj->getGuid(), false });
+        wakeUp();
+    }
 }
 
 void MapMgr::PushToProcessed(Player* plr)
@@ -1562,17 +1706,38 @@ bool MapMgr::runThread()
 
 bool MapMgr::Do()
 {
-#ifdef WIN32
-    threadid = GetCurrentThreadId();
-#endif
+    SetThreadName("Map mgr - M%u|I%u", this->_mapId, this->m_instanceID);
+
+    startMapUpdates();
+
+    while (!isMapUpdateFinished())
+    {
+        uint32 exec_start = Util::getMSTime();
 
+        //Now update sessions of this map + objects
+        updateMap();
+        updateTickMode();
+
+        const uint32 tickPeriod = getTickPeriod();
+        uint32 exec_time = Util::getMSTime() - exec_start;
+        if (exec_time < tickPeriod)
+            waitForNextTick(tickPeriod - exec_time);
+    }
+
+    return finishMapUpdates();
+}
+
+void MapMgr::startMapUpdates()
+{
     t_currentMapContext.set(this);
 
     thread_running = true;
-    ThreadState = THREADSTATE_BUSY;
-    SetThreadName("Map mgr - M%u|I%u", this->_mapId, this->m_instanceID);
 
-    uint32 last_exec = Util::getMSTime();
+    // KillThread or InstanceShutdown might have asked to terminate before the first tick
+    unsigned long threadState = ThreadState.load();
+    while (threadState != THREADSTATE_TERMINATE && !ThreadState.compare_exchange_weak(threadState, THREADSTATE_BUSY))
+    {
+    }
 
     // Create Instance script
     LoadInstanceScript();
@@ -1599,38 +1764,44 @@ bool MapMgr::Do()
     sObjectMgr.LoadCorpses(this);
     worldstateshandler.InitWorldStates(sObjectMgr.GetWorldStatesForMap(_mapId));
     worldstateshandler.setObserver(this);
+}
 
-    while (GetThreadState() != THREADSTATE_TERMINATE && !_shutdown)
-    {
-        uint32 exec_start = Util::getMSTime();
+bool MapMgr::isMapUpdateFinished()
+{
+    if (GetThreadState() == THREADSTATE_TERMINATE || _shutdown)
+        return true;
 
-        //////////////////////////////////////////////////////////////////////////////////////////
-        //first push to world new objects
-        m_objectinsertlock.Acquire();
+    // Check if we have to die :P
+    return InactiveMoveTime && UNIXTIME >= InactiveMoveTime;
+}
 
-        if (m_objectinsertpool.size())
-        {
-            for (auto o : m_objectinsertpool)
-                o->PushToWorld(this);
+void MapMgr::updateMap()
+{
+#ifdef WIN32
+    threadid = GetCurrentThreadId();
+#endif
 
-            m_objectinsertpool.clear();
-        }
+    // the map can be updated by a different thread on every tick
+    t_currentMapContext.set(this);
+    m_isSleeping = false;
 
-        m_objectinsertlock.Release();
-        //////////////////////////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////////////////////////
+    //first push to world new objects
+    _ProcessInsertRequests();
 
-        //Now update sessions of this map + objects
-        _PerformObjectDuties();
+    m_objectInsertPool.forEach([this](Object* o)
+    {
+        o->PushToWorld(this);
+    });
+    m_objectInsertPool.clear();
+    //////////////////////////////////////////////////////////////////////////////////////////
 
-        last_exec = Util::getMSTime();
-        uint32 exec_time = last_exec - exec_start;
-        if (exec_time < 20)  //mapmgr update period 20
-            Arcemu::Sleep(20 - exec_time);
+    _PerformObjectDuties();
+}
 
-        // Check if we have to die :P
-        if (InactiveMoveTime && UNIXTIME >= InactiveMoveTime)
-            break;
-    }
+bool MapMgr::finishMapUpdates()
+{
+    t_currentMapContext.set(this);
 
     // Teleport any left-over players out.
     TeleportPlayers();
@@ -1662,17 +1833,142 @@ bool MapMgr::Do()
         sInstanceMgr.m_singleMaps[GetMapId()] = nullptr;
     }
 
+    // no wake up may point to the map once it is deleted
+    m_isSleeping = false;
+    sMapUpdateScheduler.removeMap(this);
+
     thread_running = false;
     if (thread_kill_only)
         return false;
 
     // delete ourselves
+    t_currentMapContext.set(nullptr);
     delete this;
 
     // already deleted, so the threadpool doesn't have to.
     return false;
 }
 
+MapTickMode MapMgr::updateTickMode()
+{
+    const auto& serverConfig = worldConfig.server;
+    const uint32_t now = Util::getMSTime();
+
+    if (!m_PlayerStorage.empty() || !_combatProgress.empty())
+    {
+        m_lastActiveTime = now;
+
+        if (serverConfig.mapBusyPlayerCount && m_PlayerStorage.size() >= serverConfig.mapBusyPlayerCount)
+            m_tickMode = MAP_TICK_MODE_BUSY;
+        else
+            m_tickMode = MAP_TICK_MODE_ACTIVE;
+    }
+    else if (serverConfig.mapHibernateDelay && now - m_lastActiveTime >= serverConfig.mapHibernateDelay * 1000 && canHibernate())
+    {
+        if (m_tickMode != MAP_TICK_MODE_HIBERNATE)
+            sLogger.debug("MapMgr : Map %u instance %u hibernates", _mapId, m_instanceID);
+
+        m_tickMode = MAP_TICK_MODE_HIBERNATE;
+    }
+    else
+    {
+        m_tickMode = MAP_TICK_MODE_IDLE;
+    }
+
+    return m_tickMode;
+}
+
+uint32_t MapMgr::getTickPeriod() const
+{
+    switch (m_tickMode)
+    {
+        case MAP_TICK_MODE_BUSY:
+            return worldConfig.server.mapBusyTickPeriod;
+        case MAP_TICK_MODE_IDLE:
+            return worldConfig.server.mapIdleTickPeriod ? worldConfig.server.mapIdleTickPeriod : MAPMGR_UPDATE_PERIOD;
+        case MAP_TICK_MODE_HIBERNATE:
+        {
+            // expiring instances have to wake up in time to shut down
+            if (InactiveMoveTime)
+            {
+                const time_t timeLeft = InactiveMoveTime > UNIXTIME ? InactiveMoveTime - UNIXTIME : 0;
+                return static_cast<uint32_t>(std::min<time_t>(timeLeft * 1000, MAPMGR_HIBERNATE_PERIOD));
+            }
+
+            return MAPMGR_HIBERNATE_PERIOD;
+        }
+        default:
+            return MAPMGR_UPDATE_PERIOD;
+    }
+}
+
+bool MapMgr::canHibernate()
+{
+    return activeCreatures.empty() && activeGameObjects.empty() && m_forcedcells.empty() && Sessions.empty()
+        && m_PetStorage.empty() && m_DynamicObjectStorage.empty() && m_TransportStorage.empty()
+        && _updates.empty() && _processQueue.empty() && m_battleground == nullptr && eventHolder.GetEventCount() == 0;
+}
+
+bool MapMgr::beginSleep()
+{
+    if (m_tickMode != MAP_TICK_MODE_IDLE && m_tickMode != MAP_TICK_MODE_HIBERNATE)
+        return false;
+
+    // pairs with the fence in wakeUp(), either we see the new work or the producer sees the flag
+    m_isSleeping = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (!m_objectInsertQueue.empty() || !m_updateNotifications.empty() || isMapUpdateFinished()
+        || (m_tickMode == MAP_TICK_MODE_HIBERNATE && eventHolder.GetEventCount() != 0))
+    {
+        m_isSleeping = false;
+        return false;
+    }
+
+    return true;
+}
+
+void MapMgr::wakeUp()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (!m_isSleeping.load(std::memory_order_relaxed) || !m_isSleeping.exchange(false))
+        return;
+
+    if (sMapUpdateScheduler.isEnabled())
+    {
+        sMapUpdateScheduler.wakeUpMap(this);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_wakeUpMutex);
+        m_wakeUpRequested = true;
+    }
+
+    m_wakeUpCondition.notify_one();
+}
+
+void MapMgr::waitForNextTick(uint32_t time)
+{
+    if (m_tickMode != MAP_TICK_MODE_IDLE && m_tickMode != MAP_TICK_MODE_HIBERNATE)
+    {
+        Arcemu::Sleep(time);
+        return;
+    }
+
+    // something arrived while the tick ended, tick again soon
+    if (!beginSleep())
+    {
+        Arcemu::Sleep(std::min<uint32_t>(time, MAPMGR_UPDATE_PERIOD));
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_wakeUpMutex);
+    m_wakeUpCondition.wait_for(lock, std::chrono::milliseconds(time), [this]() { return m_wakeUpRequested; });
+    m_wakeUpRequested = false;
+}
+
 void MapMgr::BeginInstanceExpireCountdown()
 {
     // so players getting removed don't overwrite us
@@ -1686,12 +1982,14 @@ void MapMgr::BeginInstanceExpireCountdown()
 
     // set our expire time to 60 seconds.
     InactiveMoveTime = UNIXTIME + 60;
+    wakeUp();
 }
 
 void MapMgr::InstanceShutdown()
 {
     pInstance = nullptr;
     SetThreadState(THREADSTATE_TERMINATE);
+    wakeUp();
 }
 
 void MapMgr::KillThread()
@@ -1699,6 +1997,7 @@ void MapMgr::KillThread()
     pInstance = nullptr;
     thread_kill_only = true;
     SetThreadState(THREADSTATE_TERMINATE);
+    wakeUp();
     while(thread_running)
     {
         Arcemu::Sleep(100);
@@ -1707,9 +2006,8 @@ void MapMgr::KillThread()
 
 void MapMgr::AddObject(Object* obj)
 {
-    m_objectinsertlock.Acquire();
-    m_objectinsertpool.insert(obj);
-    m_objectinsertlock.Release();
+    m_objectInsertQueue.push({ obj, false });
+    wakeUp();
 }
 
 Unit* MapMgr::GetUnit(const uint64 & guid)
@@ -1761,6 +2059,7 @@ Object* MapMgr::_GetObject(const uint64 & guid)
 void MapMgr::_PerformObjectDuties()
 {
     ++mLoopCounter;
+    m_tickProfiler->beginTick();
 
     uint32 mstime = Util::getMSTime();
     uint32 difftime = mstime - lastUnitUpdate;
@@ -1771,6 +2070,7 @@ void MapMgr::_PerformObjectDuties()
     // Update any events.
     // we make update of events before objects so in case there are 0 timediff events they do not get deleted after update but on next server update loop
     eventHolder.Update(difftime);
+    m_tickProfiler->endPhase(MAP_TICK_PHASE_EVENTS);
 
     // Update Transporters
     {
@@ -1787,35 +2087,50 @@ void MapMgr::_PerformObjectDuties()
         }
         lastTransportUpdate = mstime;
     }
+    m_tickProfiler->endPhase(MAP_TICK_PHASE_TRANSPORTS);
 
     // Update creatures.
     {
-        for (creature_iterator = activeCreatures.begin(); creature_iterator != activeCreatures.end();)
+        // creatures can despawn themselves and others during their update
+        auto objectStart = MapTickProfiler::now();
+        activeCreatures.forEach([this, difftime, &objectStart](Creature* ptr)
         {
-            Creature* ptr = *creature_iterator;
-            ++creature_iterator;
+            // the creature might be deleted during its update
+            const uint64 guid = ptr->getGuid();
+            const uint32 entry = ptr->getEntry();
             ptr->Update(difftime);
-        }
+            m_tickProfiler->recordObject(MAP_TICK_PHASE_CREATURES, guid, entry, objectStart);
+        });
+        m_tickProfiler->endPhase(MAP_TICK_PHASE_CREATURES);
 
+        objectStart = MapTickProfiler::now();
         for (pet_iterator = m_PetStorage.begin(); pet_iterator != m_PetStorage.end();)
         {
             Pet* ptr2 = pet_iterator->second;
             ++pet_iterator;
+            const uint64 guid = ptr2->getGuid();
+            const uint32 entry = ptr2->getEntry();
             ptr2->Update(difftime);
+            m_tickProfiler->recordObject(MAP_TICK_PHASE_PETS, guid, entry, objectStart);
         }
+        m_tickProfiler->endPhase(MAP_TICK_PHASE_PETS);
     }
 
     // Update players.
     {
+        auto objectStart = MapTickProfiler::now();
         for (auto itr = m_PlayerStorage.begin(); itr != m_PlayerStorage.end();)
         {
             Player* ptr = itr->second;
             ++itr;
+            const uint64 guid = ptr->getGuid();
             ptr->Update(difftime);
+            m_tickProfiler->recordObject(MAP_TICK_PHASE_PLAYERS, guid, 0, objectStart);
         }
 
         lastUnitUpdate = mstime;
     }
+    m_tickProfiler->endPhase(MAP_TICK_PHASE_PLAYERS);
 
     // Dynamic objects are updated every 100ms
     // We take the pointer, increment, and update in this order because during the update the DynamicObject might get deleted,
@@ -1833,36 +2148,39 @@ void MapMgr::_PerformObjectDuties()
 
         lastDynamicObjectUpdate = mstime;
     }
+    m_tickProfiler->endPhase(MAP_TICK_PHASE_DYNAMIC_OBJECTS);
 
     // Update gameobjects only every 200ms
     difftime = mstime - lastGameobjectUpdate;
     if (difftime >= 200)
     {
+        auto objectStart = MapTickProfiler::now();
         for (auto itr = GOStorage.begin(); itr != GOStorage.end(); )
         {
             GameObject* gameobject = *itr;
             ++itr;
             if (gameobject != nullptr)
+            {
+                const uint64 guid = gameobject->getGuid();
+                const uint32 entry = gameobject->getEntry();
                 gameobject->Update(difftime);
+                m_tickProfiler->recordObject(MAP_TICK_PHASE_GAMEOBJECTS, guid, entry, objectStart);
+            }
         }
 
         lastGameobjectUpdate = mstime;
     }
+    m_tickProfiler->endPhase(MAP_TICK_PHASE_GAMEOBJECTS);
 
     // Sessions are updated on every second loop
     if (mLoopCounter % 2)
     {
-        for (auto itr = Sessions.begin(); itr != Sessions.end();)
+        Sessions.forEach([this](WorldSession* session)
         {
-            WorldSession* session = (*itr);
-            auto it2 = itr;
-
-            ++itr;
-
             if (session->GetInstance() != m_instanceID)
             {
-                Sessions.erase(it2);
-                continue;
+                Sessions.erase(session);
+                return;
             }
 
             // Don't update players not on our map.
@@ -1870,25 +2188,29 @@ void MapMgr::_PerformObjectDuties()
             // .. and that could be disastrous to our client :P
             if (session->GetPlayer() && (session->GetPlayer()->GetMapMgr() != this && session->GetPlayer()->GetMapMgr() != nullptr))
             {
-                continue;
+                return;
             }
 
             uint8 result;
 
             if ((result = session->Update(m_instanceID)) != 0)
             {
+                Sessions.erase(session);
                 if (result == 1)
                 {
                     // complete deletion
                     sWorld.deleteSession(session);
                 }
-                Sessions.erase(it2);
             }
-        }
+        });
     }
+    m_tickProfiler->endPhase(MAP_TICK_PHASE_SESSIONS);
 
     // Finally, A9 Building/Distribution
     _UpdateObjects();
+    m_tickProfiler->endPhase(MAP_TICK_PHASE_UPDATE_OBJECTS);
+
+    m_tickProfiler->endTick(mLoopCounter);
 }
 
 void MapMgr::EventCorpseDespawn(uint64 guid)
@@ -2296,7 +2618,7 @@ bool MapMgr::cellHasAreaID(uint32_t CellX, uint32_t CellY, uint16_t &AreaID)
     {
         for (uint32_t yc = (CellY%CellsPerTile) * 16 / CellsPerTile; yc < (CellY%CellsPerTile) * 16 / CellsPerTile + 16 / CellsPerTile; yc++)
         {
-            const auto areaid = _terrain->GetTile(OffsetTileX, OffsetTileY)->m_map.m_areaMap[yc * 16 + xc];
+            const auto areaid = _terrain->GetTile(OffsetTileX, OffsetTileY)->m_map->m_areaMap[yc * 16 + xc];
             if (areaid)
             {
                 AreaID = areaid;
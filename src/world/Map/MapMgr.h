@@ -9,10 +9,19 @@ This file is released under the MIT license. See README-MIT for more information
 #include "CellHandler.h"
 #include "Management/WorldStatesHandler.h"
 #include "MapDefines.h"
+#include "MapMgrDefines.hpp"
 #include "CThreads.h"
 #include "Objects/Units/Creatures/Summons/SummonDefines.hpp"
 #include "Server/EventableObject.h"
 #include "Storage/DBC/DBCStructures.hpp"
+#include "DenseSet.hpp"
+#include "Threading/MpscQueue.hpp"
+#include "MapTickProfiler.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 
 namespace Arcemu
 {
@@ -43,11 +52,9 @@ class DynamicObject;
 class Unit;
 class CreatureGroup;
 
-extern Arcemu::Utility::TLSObject<MapMgr*> t_currentMapContext;
+extern SERVER_DECL Arcemu::Utility::TLSObject<MapMgr*> t_currentMapContext;
 
 typedef std::set<Object*> ObjectSet;
-typedef std::set<Object*> UpdateQueue;
-typedef std::set<Player*> PUpdateQueue;
 typedef std::set<Player*> PlayerSet;
 typedef std::set<uint64> CombatProgressMap;
 typedef std::set<Creature*> CreatureSet;
@@ -57,6 +64,23 @@ typedef std::unordered_map<uint32, Object*> StorageMap;
 typedef std::unordered_map<uint32, Creature*> CreatureSqlIdMap;
 typedef std::unordered_map<uint32, GameObject*> GameObjectSqlIdMap;
 
+// The per tick MapMgr containers keep their index in the set, not in the objects:
+// an object changing maps can be in the containers of both maps for a moment.
+// _updates is keyed by guid, removals queued by other threads are applied without touching the
+// object (it can already be deleted) and never hit a new object at the same address.
+struct MapUpdateKey
+{
+    typedef uint64_t Key;
+    static constexpr bool isHashed = true;
+
+    static Key getKey(Object* object);
+};
+
+typedef DenseSet<Object*, MapUpdateKey> UpdateQueue;
+typedef DenseSet<Player*, DenseSetHashIndex<Player*>> PUpdateQueue;
+typedef DenseSet<Creature*, DenseSetHashIndex<Creature*>> ActiveCreatureSet;
+typedef DenseSet<GameObject*, DenseSetHashIndex<GameObject*>> ActiveGameObjectSet;
+
 class SERVER_DECL MapMgr : public CellHandler <MapCell>, public EventableObject, public CThread, public WorldStatesHandler::WorldStatesObserver
 {
     friend class MapCell;
@@ -67,7 +91,7 @@ public:
     uint32 GetAreaFlag(float x, float y, float z, bool *is_outdoors = nullptr) const;
 
     // This will be done in regular way soon
-    std::set<MapCell*> m_forcedcells;
+    DenseSet<MapCell*> m_forcedcells;
 
     void addForcedCell(MapCell* c);
     void removeForcedCell(MapCell* c);
@@ -78,8 +102,6 @@ public:
     void updateAllCells(bool apply, uint32_t areamask);
     void updateAllCells(bool apply);
 
-    Mutex m_objectinsertlock;
-    ObjectSet m_objectinsertpool;
     void AddObject(Object*);
 
     // Local (mapmgr) storage/generation of GameObjects
@@ -99,7 +121,6 @@ public:
     // Local (mapmgr) storage/generation of Creatures
     uint32 m_CreatureHighGuid;
     std::vector<Creature*> CreatureStorage;
-    CreatureSet::iterator creature_iterator;        /// required by owners despawning creatures and deleting *(++itr)
     uint64 GenerateCreatureGUID(uint32 entry, bool canUseOldGuid = true);
     Creature* CreateCreature(uint32 entry);
     Creature* CreateAndSpawnCreature(uint32 pEntry, float pX, float pY, float pZ, float pO);
@@ -150,6 +171,24 @@ public:
     bool runThread() override;
     bool Do();
 
+    // Map update steps, used by Do() or by the MapUpdateScheduler workers
+    void startMapUpdates();
+    bool isMapUpdateFinished();
+    void updateMap();
+    // returns false, deletes the map unless only the thread was killed
+    bool finishMapUpdates();
+
+    // Adaptive tick rate, updateTickMode is called by the map thread after every tick
+    MapTickMode updateTickMode();
+    MapTickMode getTickMode() const { return m_tickMode; }
+    // time in ms until the next tick in the current tick mode
+    uint32_t getTickPeriod() const;
+    // Marks an idle or hibernating map as sleeping until its next tick.
+    // Returns false when work arrived in the meantime and the map should tick again soon.
+    bool beginSleep();
+    // Lets a sleeping map tick right away, can be called from any thread
+    void wakeUp();
+
     MapMgr(Map* map, uint32 mapid, uint32 instanceid);
     ~MapMgr();
 
@@ -211,6 +250,7 @@ public:
 
     void _PerformObjectDuties();
     uint32 mLoopCounter;
+    std::shared_ptr<MapTickProfiler> m_tickProfiler;
     uint32 lastGameobjectUpdate;
     uint32 lastTransportUpdate;
     uint32_t lastDynamicObjectUpdate = 0;
@@ -255,10 +295,14 @@ protected:
 private:
     // Objects that exist on map
     uint32 _mapId;
-    std::set<Object*> _mapWideStaticObjects;
+    DenseSet<Object*> _mapWideStaticObjects;
 
     bool _CellActive(uint32 x, uint32 y);
+    // with onlyNewObjects the objects already in range of obj are skipped
     void UpdateInRangeSet(Object* obj, Player* plObj, MapCell* cell, ByteBuffer** buf);
+    void UpdateInRangeVisibility(Object* obj, Player* plObj, Object* curObj, ByteBuffer** buf);
+    // drops obj and curObj from each others in-range set when they are too far apart, false when obj left the map
+    bool RemoveIfOutOfRange(Object* obj, Player* plObj, Object* curObj);
 
     //Zyres: Refactoring 05/04/2016
     float GetUpdateDistance(Object* curObj, Object* obj, Player* plObj);
@@ -269,13 +313,50 @@ public:
     float m_UpdateDistance;
 
 private:
+    // Object insertion
+    struct ObjectInsertRequest
+    {
+        Object* object;
+        bool cancel;
+    };
+
+    void _ProcessInsertRequests();
+
+    // AddObject and RemoveObject of queued objects from any thread, in call order
+    MpscQueue<ObjectInsertRequest> m_objectInsertQueue;
+    // objects waiting for PushToWorld, only used by the map thread
+    DenseSet<Object*> m_objectInsertPool;
+
     // Update System
-    Mutex m_updateMutex;
+    struct UpdateNotification
+    {
+        Object* object;
+        uint64_t guid;
+        bool remove;
+    };
+
+    void _ProcessUpdateNotifications();
+
     UpdateQueue _updates;
+    // objects updated or removed by other threads, applied to _updates by the map thread in call order
+    MpscQueue<UpdateNotification> m_updateNotifications;
     PUpdateQueue _processQueue;
 
     // Sessions
-    std::set<WorldSession*> Sessions;
+    DenseSet<WorldSession*> Sessions;
+
+    // Adaptive tick rate
+    bool canHibernate();
+    void waitForNextTick(uint32_t time);
+
+    MapTickMode m_tickMode = MAP_TICK_MODE_ACTIVE;
+    uint32_t m_lastActiveTime;
+    std::atomic<bool> m_isSleeping = false;
+
+    // used to wake up the map thread when the MapUpdateScheduler is disabled
+    std::mutex m_wakeUpMutex;
+    std::condition_variable m_wakeUpCondition;
+    bool m_wakeUpRequested = false;
 
     // Map Information
     MySQLStructure::MapInfo const* pMapInfo;
@@ -289,11 +370,11 @@ public:
 #ifdef WIN32
     DWORD threadid;
 #endif
-    GameObjectSet activeGameObjects;
-    CreatureSet activeCreatures;
+    ActiveGameObjectSet activeGameObjects;
+    ActiveCreatureSet activeCreatures;
     EventableObjectHolder eventHolder;
     CBattleground* m_battleground;
-    std::set<Corpse*> m_corpses;
+    DenseSet<Corpse*> m_corpses;
     CreatureSqlIdMap _sqlids_creatures;
     GameObjectSqlIdMap _sqlids_gameobjects;
 
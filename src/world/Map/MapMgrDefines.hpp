@@ -5,6 +5,23 @@ This file is released under the MIT license. See README-MIT for more information
 
 #pragma once
 
+// time in ms between two map updates
+#define MAPMGR_UPDATE_PERIOD 20
+
+// distance (yards) an object moves before its objects in range are checked again, see MapMgr::ChangeObjectLocation
+#define MAPMGR_INRANGE_RESCAN_DISTANCE 10.0f
+
+// a hibernating map still checks its state once in this time (ms)
+#define MAPMGR_HIBERNATE_PERIOD 60000
+
+enum MapTickMode
+{
+    MAP_TICK_MODE_BUSY      = 0,    // many players, ticks with the busy period
+    MAP_TICK_MODE_ACTIVE    = 1,    // players or combat, ticks with MAPMGR_UPDATE_PERIOD
+    MAP_TICK_MODE_IDLE      = 2,    // nothing going on, ticks with the idle period
+    MAP_TICK_MODE_HIBERNATE = 3     // nothing to update at all, ticks when woken up
+};
+
 enum MapMgrTimers
 {
     MMUPDATE_OBJECTS        = 0,
@@ -193,15 +193,8 @@ class SERVER_DECL MapScriptInterface
         void DeleteGameObject(GameObject* ptr);
         void DeleteCreature(Creature* ptr);
 
-        MapScriptInterface & operator=(MapScriptInterface & msi)
-        {
-            if (this != &msi)
-            {
-                this->mapMgr = msi.mapMgr;
-            }
-
-            return *this;
-        }
+        MapScriptInterface(MapScriptInterface const&) = delete;
+        MapScriptInterface& operator=(MapScriptInterface const&) = delete;
 
     private:
 
@@ -0,0 +1,286 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#include "MapTickProfiler.hpp"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <fstream>
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+
+namespace
+{
+    uint32_t getMicroseconds(MapTickProfiler::TimePoint start, MapTickProfiler::TimePoint end)
+    {
+        return static_cast<uint32_t>(duration_cast<microseconds>(end - start).count());
+    }
+
+    size_t getHistogramBucket(uint32_t time)
+    {
+        return static_cast<size_t>(std::upper_bound(MAP_TICK_HISTOGRAM_BOUNDS.begin(), MAP_TICK_HISTOGRAM_BOUNDS.end(), time) - MAP_TICK_HISTOGRAM_BOUNDS.begin());
+    }
+
+    void writeLine(std::ostream& out, const char* format, ...)
+    {
+        char line[512];
+
+        va_list arguments;
+        va_start(arguments, format);
+        vsnprintf(line, sizeof(line), format, arguments);
+        va_end(arguments);
+
+        out << line << "\n";
+    }
+
+    double toMs(uint64_t time) { return static_cast<double>(time) / 1000.0; }
+
+    double getAverageMs(MapTickTimings const& timings)
+    {
+        return timings.count ? toMs(timings.totalTime) / static_cast<double>(timings.count) : 0.0;
+    }
+
+    // keeps the slowest entries sorted, slowest first
+    template <typename T>
+    void insertSlowest(std::vector<T>& entries, T const& entry)
+    {
+        if (entries.size() >= MAP_TICK_SLOWEST_ENTRIES && entries.back().duration >= entry.duration)
+            return;
+
+        const auto position = std::find_if(entries.begin(), entries.end(), [&entry](T const& other) { return other.duration < entry.duration; });
+        entries.insert(position, entry);
+
+        if (entries.size() > MAP_TICK_SLOWEST_ENTRIES)
+            entries.pop_back();
+    }
+}
+
+void MapTickTimings::add(uint32_t time, uint32_t objects)
+{
+    ++count;
+    totalTime += time;
+    maxTime = std::max(maxTime, time);
+    objectCount += objects;
+    ++histogram[getHistogramBucket(time)];
+}
+
+void MapTickProfiler::beginTick()
+{
+    m_tickStart = m_phaseStart = now();
+    m_phaseTimes.fill(0);
+    m_phaseObjects.fill(0);
+    m_tickObjects.clear();
+}
+
+void MapTickProfiler::endPhase(MapTickPhase phase)
+{
+    const auto phaseEnd = now();
+    m_phaseTimes[phase] += getMicroseconds(m_phaseStart, phaseEnd);
+    m_phaseStart = phaseEnd;
+}
+
+void MapTickProfiler::recordObject(MapTickPhase phase, uint64_t guid, uint32_t entry, TimePoint& objectStart)
+{
+    const auto objectEnd = now();
+    const uint32_t duration = getMicroseconds(objectStart, objectEnd);
+    objectStart = objectEnd;
+
+    ++m_phaseObjects[phase];
+
+    // only objects that can make it into the slowest list are kept
+    if (duration > m_slowObjectThreshold)
+        insertSlowest(m_tickObjects, { guid, entry, phase, duration, 0 });
+}
+
+void MapTickProfiler::endTick(uint32_t loopCounter)
+{
+    const uint32_t tickDuration = getMicroseconds(m_tickStart, now());
+
+    std::lock_guard<std::mutex> guard(m_statsMutex);
+
+    uint32_t objectCount = 0;
+    for (uint8_t phase = 0; phase < MAP_TICK_PHASE_COUNT; ++phase)
+    {
+        m_stats.phases[phase].add(m_phaseTimes[phase], m_phaseObjects[phase]);
+        objectCount += m_phaseObjects[phase];
+    }
+
+    m_stats.ticks.add(tickDuration, objectCount);
+    insertSlowest(m_stats.slowestTicks, { loopCounter, time(nullptr), tickDuration, m_phaseTimes });
+
+    for (auto& objectRecord : m_tickObjects)
+    {
+        objectRecord.loopCounter = loopCounter;
+        insertSlowest(m_stats.slowestObjects, objectRecord);
+    }
+
+    if (m_stats.slowestObjects.size() >= MAP_TICK_SLOWEST_ENTRIES)
+        m_slowObjectThreshold = m_stats.slowestObjects.back().duration;
+}
+
+MapTickStats MapTickProfiler::getStats()
+{
+    std::lock_guard<std::mutex> guard(m_statsMutex);
+    return m_stats;
+}
+
+void MapTickProfiler::reset()
+{
+    std::lock_guard<std::mutex> guard(m_statsMutex);
+    m_stats = MapTickStats();
+
+    m_slowObjectThreshold = 0;
+}
+
+void MapTickProfiler::writeSummary(std::ostream& out)
+{
+    const MapTickStats stats = getStats();
+
+    auto slowestPhase = MAP_TICK_PHASE_EVENTS;
+    for (uint8_t phase = 0; phase < MAP_TICK_PHASE_COUNT; ++phase)
+        if (stats.phases[phase].totalTime > stats.phases[slowestPhase].totalTime)
+            slowestPhase = static_cast<MapTickPhase>(phase);
+
+    writeLine(out, "| %5u | %8u | %10llu | %8.3f | %8.3f | %-15s |", m_mapId, m_instanceId, static_cast<unsigned long long>(stats.ticks.count),
+        getAverageMs(stats.ticks), toMs(stats.ticks.maxTime), stats.ticks.count ? getPhaseName(slowestPhase) : "-");
+}
+
+void MapTickProfiler::writeReport(std::ostream& out)
+{
+    const MapTickStats stats = getStats();
+
+    writeLine(out, "Map %u, instance %u: %llu ticks, avg %.3f ms, max %.3f ms", m_mapId, m_instanceId,
+        static_cast<unsigned long long>(stats.ticks.count), getAverageMs(stats.ticks), toMs(stats.ticks.maxTime));
+
+    writeLine(out, "  %-15s | %10s | %9s | %9s | %12s", "Phase", "Total ms", "Avg ms", "Max ms", "Objects/tick");
+    for (uint8_t phase = 0; phase < MAP_TICK_PHASE_COUNT; ++phase)
+    {
+        const auto& timings = stats.phases[phase];
+        writeLine(out, "  %-15s | %10.1f | %9.3f | %9.3f | %12.1f", getPhaseName(static_cast<MapTickPhase>(phase)), toMs(timings.totalTime),
+            getAverageMs(timings), toMs(timings.maxTime), timings.count ? static_cast<double>(timings.objectCount) / static_cast<double>(timings.count) : 0.0);
+    }
+
+    out << "  Tick histogram:";
+    for (size_t bucket = 0; bucket < MAP_TICK_HISTOGRAM_BUCKETS; ++bucket)
+    {
+        if (bucket < MAP_TICK_HISTOGRAM_BOUNDS.size())
+            out << " <" << toMs(MAP_TICK_HISTOGRAM_BOUNDS[bucket]) << "ms:" << stats.ticks.histogram[bucket];
+        else
+            out << " >=" << toMs(MAP_TICK_HISTOGRAM_BOUNDS.back()) << "ms:" << stats.ticks.histogram[bucket];
+    }
+    out << "\n";
+
+    writeLine(out, "  Slowest ticks:");
+    for (const auto& tick : stats.slowestTicks)
+    {
+        char timeString[32];
+        strftime(timeString, sizeof(timeString), "%Y-%m-%d %H:%M:%S", localtime(&tick.time));
+
+        out << "    " << timeString << " loop " << tick.loopCounter << ": " << toMs(tick.duration) << " ms (";
+        for (uint8_t phase = 0; phase < MAP_TICK_PHASE_COUNT; ++phase)
+            out << (phase ? ", " : "") << getPhaseName(static_cast<MapTickPhase>(phase)) << " " << toMs(tick.phaseTimes[phase]);
+        out << ")\n";
+    }
+
+    writeLine(out, "  Slowest objects:");
+    for (const auto& object : stats.slowestObjects)
+    {
+        writeLine(out, "    guid %llu entry %u (%s) loop %u: %.3f ms", static_cast<unsigned long long>(object.guid), object.entry,
+            getPhaseName(object.phase), object.loopCounter, toMs(object.duration));
+    }
+}
+
+const char* MapTickProfiler::getPhaseName(MapTickPhase phase)
+{
+    switch (phase)
+    {
+        case MAP_TICK_PHASE_EVENTS: return "Events";
+        case MAP_TICK_PHASE_TRANSPORTS: return "Transports";
+        case MAP_TICK_PHASE_CREATURES: return "Creatures";
+        case MAP_TICK_PHASE_PETS: return "Pets";
+        case MAP_TICK_PHASE_PLAYERS: return "Players";
+        case MAP_TICK_PHASE_DYNAMIC_OBJECTS: return "DynamicObjects";
+        case MAP_TICK_PHASE_GAMEOBJECTS: return "GameObjects";
+        case MAP_TICK_PHASE_SESSIONS: return "Sessions";
+        case MAP_TICK_PHASE_UPDATE_OBJECTS: return "UpdateObjects";
+        default: return "Unknown";
+    }
+}
+
+MapTickProfilerRegistry& MapTickProfilerRegistry::getInstance()
+{
+    static MapTickProfilerRegistry mInstance;
+    return mInstance;
+}
+
+std::shared_ptr<MapTickProfiler> MapTickProfilerRegistry::createProfiler(uint32_t mapId, uint32_t instanceId)
+{
+    auto profiler = std::make_shared<MapTickProfiler>(mapId, instanceId);
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_profilers.push_back(profiler);
+
+    return profiler;
+}
+
+void MapTickProfilerRegistry::removeProfiler(std::shared_ptr<MapTickProfiler> const& profiler)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_profilers.erase(std::remove(m_profilers.begin(), m_profilers.end(), profiler), m_profilers.end());
+}
+
+std::vector<std::shared_ptr<MapTickProfiler>> MapTickProfilerRegistry::getProfilers()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_profilers;
+}
+
+std::shared_ptr<MapTickProfiler> MapTickProfilerRegistry::getProfiler(uint32_t mapId, uint32_t instanceId)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (const auto& profiler : m_profilers)
+        if (profiler->getMapId() == mapId && profiler->getInstanceId() == instanceId)
+            return profiler;
+
+    return nullptr;
+}
+
+void MapTickProfilerRegistry::writeSummary(std::ostream& out)
+{
+    writeLine(out, "| %5s | %8s | %10s | %8s | %8s | %-15s |", "Map", "Instance", "Ticks", "Avg ms", "Max ms", "Slowest phase");
+    for (const auto& profiler : getProfilers())
+        profiler->writeSummary(out);
+}
+
+bool MapTickProfilerRegistry::writeReportToFile(std::string const& fileName)
+{
+    std::ofstream file(fileName);
+    if (!file.is_open())
+        return false;
+
+    const time_t now = time(nullptr);
+    char timeString[32];
+    strftime(timeString, sizeof(timeString), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    file << "Map tick profile " << timeString << "\n\n";
+
+    writeSummary(file);
+    file << "\n";
+
+    for (const auto& profiler : getProfilers())
+    {
+        profiler->writeReport(file);
+        file << "\n";
+    }
+
+    return file.good();
+}
+
+void MapTickProfilerRegistry::resetAll()
+{
+    for (const auto& profiler : getProfilers())
+        profiler->reset();
+}
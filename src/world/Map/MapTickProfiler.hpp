@@ -0,0 +1,158 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "CommonTypes.hpp"
+
+enum MapTickPhase : uint8_t
+{
+    MAP_TICK_PHASE_EVENTS,
+    MAP_TICK_PHASE_TRANSPORTS,
+    MAP_TICK_PHASE_CREATURES,
+    MAP_TICK_PHASE_PETS,
+    MAP_TICK_PHASE_PLAYERS,
+    MAP_TICK_PHASE_DYNAMIC_OBJECTS,
+    MAP_TICK_PHASE_GAMEOBJECTS,
+    MAP_TICK_PHASE_SESSIONS,
+    MAP_TICK_PHASE_UPDATE_OBJECTS,
+    MAP_TICK_PHASE_COUNT
+};
+
+// upper bounds of the histogram buckets in microseconds, the last bucket takes everything above
+static constexpr std::array<uint32_t, 9> MAP_TICK_HISTOGRAM_BOUNDS = { 250, 500, 1000, 2500, 5000, 10000, 20000, 50000, 100000 };
+static constexpr size_t MAP_TICK_HISTOGRAM_BUCKETS = MAP_TICK_HISTOGRAM_BOUNDS.size() + 1;
+static constexpr size_t MAP_TICK_SLOWEST_ENTRIES = 10;
+
+typedef std::array<uint64_t, MAP_TICK_HISTOGRAM_BUCKETS> MapTickHistogram;
+
+struct MapTickTimings
+{
+    uint64_t count = 0;
+    uint64_t totalTime = 0;             // microseconds
+    uint32_t maxTime = 0;
+    uint64_t objectCount = 0;
+    MapTickHistogram histogram = {};
+
+    void add(uint32_t time, uint32_t objects);
+};
+
+struct MapTickRecord
+{
+    uint32_t loopCounter;
+    time_t time;
+    uint32_t duration;
+    std::array<uint32_t, MAP_TICK_PHASE_COUNT> phaseTimes;
+};
+
+struct MapObjectRecord
+{
+    uint64_t guid;
+    uint32_t entry;
+    MapTickPhase phase;
+    uint32_t duration;
+    uint32_t loopCounter;
+};
+
+struct MapTickStats
+{
+    MapTickTimings ticks;
+    std::array<MapTickTimings, MAP_TICK_PHASE_COUNT> phases;
+
+    // sorted, slowest first
+    std::vector<MapTickRecord> slowestTicks;
+    std::vector<MapObjectRecord> slowestObjects;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Records how long the phases of MapMgr::_PerformObjectDuties take on every tick.
+// The map thread collects the current tick without locking and merges it into the
+// stats when the tick ends. The stats can be read from any thread.
+class SERVER_DECL MapTickProfiler
+{
+public:
+    typedef std::chrono::steady_clock::time_point TimePoint;
+
+    MapTickProfiler(uint32_t mapId, uint32_t instanceId) : m_mapId(mapId), m_instanceId(instanceId) {}
+
+    static TimePoint now() { return std::chrono::steady_clock::now(); }
+
+    void beginTick();
+    void endPhase(MapTickPhase phase);
+
+    // Records the update of one object which started at objectStart, objectStart is moved to now
+    void recordObject(MapTickPhase phase, uint64_t guid, uint32_t entry, TimePoint& objectStart);
+    void endTick(uint32_t loopCounter);
+
+    uint32_t getMapId() const { return m_mapId; }
+    uint32_t getInstanceId() const { return m_instanceId; }
+
+    MapTickStats getStats();
+    void reset();
+
+    void writeSummary(std::ostream& out);
+    void writeReport(std::ostream& out);
+
+    static const char* getPhaseName(MapTickPhase phase);
+
+private:
+    const uint32_t m_mapId;
+    const uint32_t m_instanceId;
+
+    // current tick, only used by the map thread
+    TimePoint m_tickStart;
+    TimePoint m_phaseStart;
+    std::array<uint32_t, MAP_TICK_PHASE_COUNT> m_phaseTimes = {};
+    std::array<uint32_t, MAP_TICK_PHASE_COUNT> m_phaseObjects = {};
+    std::vector<MapObjectRecord> m_tickObjects;
+    std::atomic<uint32_t> m_slowObjectThreshold = 0;
+
+    std::mutex m_statsMutex;
+    MapTickStats m_stats;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Keeps the profilers of all maps, so the console can read them while maps come and go.
+class SERVER_DECL MapTickProfilerRegistry
+{
+private:
+    MapTickProfilerRegistry() = default;
+    ~MapTickProfilerRegistry() = default;
+
+public:
+    static MapTickProfilerRegistry& getInstance();
+
+    MapTickProfilerRegistry(MapTickProfilerRegistry&&) = delete;
+    MapTickProfilerRegistry(MapTickProfilerRegistry const&) = delete;
+    MapTickProfilerRegistry& operator=(MapTickProfilerRegistry&&) = delete;
+    MapTickProfilerRegistry& operator=(MapTickProfilerRegistry const&) = delete;
+
+    std::shared_ptr<MapTickProfiler> createProfiler(uint32_t mapId, uint32_t instanceId);
+    void removeProfiler(std::shared_ptr<MapTickProfiler> const& profiler);
+
+    std::vector<std::shared_ptr<MapTickProfiler>> getProfilers();
+    std::shared_ptr<MapTickProfiler> getProfiler(uint32_t mapId, uint32_t instanceId);
+
+    void writeSummary(std::ostream& out);
+    bool writeReportToFile(std::string const& fileName);
+    void resetAll();
+
+private:
+    std::mutex m_mutex;
+    std::vector<std::shared_ptr<MapTickProfiler>> m_profilers;
+};
+
+#define sMapTickProfilerRegistry MapTickProfilerRegistry::getInstance()
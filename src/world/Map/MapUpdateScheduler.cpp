@@ -0,0 +1,208 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#include "MapUpdateScheduler.hpp"
+#include "MapMgr.h"
+#include "MapMgrDefines.hpp"
+#include "Log.hpp"
+#include "Threading/LegacyThreadPool.h"
+
+#include <algorithm>
+
+using AscEmu::Threading::AEThread;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+MapUpdateScheduler& MapUpdateScheduler::getInstance()
+{
+    static MapUpdateScheduler mInstance;
+    return mInstance;
+}
+
+void MapUpdateScheduler::initialize(uint32_t workerCount)
+{
+    if (workerCount == 0)
+    {
+        sLogger.info("MapUpdateScheduler : Disabled, every map runs on its own thread");
+        return;
+    }
+
+    for (uint32_t i = 0; i < workerCount; ++i)
+    {
+        m_workers.push_back(std::make_unique<AEThread>("MapUpdateWorker" + std::to_string(i),
+            [this](AEThread& thread) { this->workerRunner(thread); }, milliseconds(0)));
+    }
+
+    sLogger.info("MapUpdateScheduler : Started %u map update workers", workerCount);
+}
+
+void MapUpdateScheduler::finalize()
+{
+    if (!isEnabled())
+        return;
+
+    for (auto& worker : m_workers)
+        worker->requestKill();
+
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers)
+        worker->join();
+
+    m_workers.clear();
+
+    sLogger.info("MapUpdateScheduler : Stopped after %llu ticks, %llu of them late (max %u ms)",
+        static_cast<unsigned long long>(m_tickCount.load()), static_cast<unsigned long long>(m_lateTickCount.load()), m_maxTickLateness.load());
+}
+
+void MapUpdateScheduler::addMap(MapMgr* mapMgr)
+{
+    if (!isEnabled())
+    {
+        ThreadPool.ExecuteTask(mapMgr);
+        return;
+    }
+
+    // KillThread() waits for this flag, set it before the first tick is done
+    mapMgr->thread_running = true;
+
+    pushMap({ steady_clock::now(), mapMgr, false });
+}
+
+void MapUpdateScheduler::pushMap(ScheduledMap scheduledMap)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+
+        const auto wokenMap = std::find(m_wokenMaps.begin(), m_wokenMaps.end(), scheduledMap.mapMgr);
+        if (wokenMap != m_wokenMaps.end())
+        {
+            m_wokenMaps.erase(wokenMap);
+            scheduledMap.deadline = steady_clock::now();
+        }
+
+        m_maps.push_back(scheduledMap);
+        std::push_heap(m_maps.begin(), m_maps.end(), std::greater<ScheduledMap>());
+    }
+
+    m_condition.notify_one();
+}
+
+void MapUpdateScheduler::wakeUpMap(MapMgr* mapMgr)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+
+        const auto scheduledMap = std::find_if(m_maps.begin(), m_maps.end(), [mapMgr](ScheduledMap const& entry) { return entry.mapMgr == mapMgr; });
+        if (scheduledMap == m_maps.end())
+        {
+            // still being ticked, pushMap picks it up
+            m_wokenMaps.push_back(mapMgr);
+            return;
+        }
+
+        // waking up is rare, rebuilding the heap is cheap enough for it
+        scheduledMap->deadline = steady_clock::now();
+        std::make_heap(m_maps.begin(), m_maps.end(), std::greater<ScheduledMap>());
+    }
+
+    m_condition.notify_one();
+}
+
+void MapUpdateScheduler::removeMap(MapMgr* mapMgr)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    // the map is not in m_maps while its last tick runs, only a wake up can still point to it
+    m_wokenMaps.erase(std::remove(m_wokenMaps.begin(), m_wokenMaps.end(), mapMgr), m_wokenMaps.end());
+}
+
+uint32_t MapUpdateScheduler::getScheduledMapCount()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return static_cast<uint32_t>(m_maps.size());
+}
+
+uint32_t MapUpdateScheduler::getSleepingMapCount()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return static_cast<uint32_t>(std::count_if(m_maps.begin(), m_maps.end(), [](ScheduledMap const& scheduledMap)
+    {
+        const MapTickMode tickMode = scheduledMap.mapMgr->getTickMode();
+        return tickMode == MAP_TICK_MODE_IDLE || tickMode == MAP_TICK_MODE_HIBERNATE;
+    }));
+}
+
+void MapUpdateScheduler::workerRunner(AEThread& thread)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (thread.isKilled())
+        return;
+
+    if (m_maps.empty())
+    {
+        m_condition.wait_for(lock, milliseconds(100));
+        return;
+    }
+
+    const auto now = steady_clock::now();
+    const ScheduledMap scheduledMap = m_maps.front();
+    if (scheduledMap.deadline > now)
+    {
+        // woken up earlier when a map with an earlier deadline is added
+        m_condition.wait_until(lock, scheduledMap.deadline);
+        return;
+    }
+
+    std::pop_heap(m_maps.begin(), m_maps.end(), std::greater<ScheduledMap>());
+    m_maps.pop_back();
+    lock.unlock();
+
+    runScheduledMap(scheduledMap, now);
+}
+
+void MapUpdateScheduler::runScheduledMap(ScheduledMap scheduledMap, TimePoint now)
+{
+    MapMgr* mapMgr = scheduledMap.mapMgr;
+
+    if (!scheduledMap.started)
+    {
+        mapMgr->startMapUpdates();
+        scheduledMap.started = true;
+    }
+
+    if (mapMgr->isMapUpdateFinished())
+    {
+        // map is gone after this call
+        mapMgr->finishMapUpdates();
+        return;
+    }
+
+    // woken up maps are scheduled for now, so they are never late
+    const auto lateness = static_cast<uint32_t>(duration_cast<milliseconds>(now - scheduledMap.deadline).count());
+    if (lateness >= MAPMGR_UPDATE_PERIOD)
+    {
+        ++m_lateTickCount;
+
+        uint32_t maxLateness = m_maxTickLateness;
+        while (lateness > maxLateness && !m_maxTickLateness.compare_exchange_weak(maxLateness, lateness));
+
+        sLogger.debug("MapUpdateScheduler : Map %u instance %u ticked %u ms late", mapMgr->GetMapId(), mapMgr->GetInstanceID(), lateness);
+    }
+
+    mapMgr->updateMap();
+    ++m_tickCount;
+
+    mapMgr->updateTickMode();
+
+    uint32_t tickPeriod = mapMgr->getTickPeriod();
+    if (tickPeriod > MAPMGR_UPDATE_PERIOD && !mapMgr->beginSleep())
+        tickPeriod = MAPMGR_UPDATE_PERIOD;
+
+    scheduledMap.deadline = now + milliseconds(tickPeriod);
+    pushMap(scheduledMap);
+}
@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "CommonTypes.hpp"
+#include "Threading/AEThread.h"
+
+class MapMgr;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Updates all maps on a fixed number of worker threads.
+// Every map is a task with a tick deadline. Idle workers take the map with the earliest
+// deadline, tick it once and queue it again for its next deadline. A map is only owned by
+// one worker at a time, so map code runs single threaded as with one thread per map.
+// The deadline follows the tick period of the map (MapMgr::getTickPeriod), sleeping maps
+// are moved to the front when they are woken up.
+// When the scheduler is disabled (0 workers) every map runs on its own thread as before.
+class SERVER_DECL MapUpdateScheduler
+{
+    typedef std::chrono::steady_clock::time_point TimePoint;
+
+    struct ScheduledMap
+    {
+        TimePoint deadline;
+        MapMgr* mapMgr;
+        bool started;
+
+        bool operator>(ScheduledMap const& other) const { return deadline > other.deadline; }
+    };
+
+private:
+    MapUpdateScheduler() = default;
+    ~MapUpdateScheduler() = default;
+
+public:
+    static MapUpdateScheduler& getInstance();
+    void initialize(uint32_t workerCount);
+    void finalize();
+
+    MapUpdateScheduler(MapUpdateScheduler&&) = delete;
+    MapUpdateScheduler(MapUpdateScheduler const&) = delete;
+    MapUpdateScheduler& operator=(MapUpdateScheduler&&) = delete;
+    MapUpdateScheduler& operator=(MapUpdateScheduler const&) = delete;
+
+    // Starts updating the map, either on the worker pool or on its own thread
+    void addMap(MapMgr* mapMgr);
+
+    // Moves the next tick of a sleeping map to now, called by MapMgr::wakeUp
+    void wakeUpMap(MapMgr* mapMgr);
+    // Forgets a map that stopped updating, it can be deleted afterwards
+    void removeMap(MapMgr* mapMgr);
+
+    bool isEnabled() const { return !m_workers.empty(); }
+    uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+    uint32_t getScheduledMapCount();
+    uint32_t getSleepingMapCount();
+
+    // A tick is late when it starts more than one tick period after its deadline
+    uint64_t getTickCount() const { return m_tickCount; }
+    uint64_t getLateTickCount() const { return m_lateTickCount; }
+    uint32_t getMaxTickLateness() const { return m_maxTickLateness; }
+
+private:
+    void workerRunner(AscEmu::Threading::AEThread& thread);
+    void runScheduledMap(ScheduledMap scheduledMap, TimePoint now);
+    void pushMap(ScheduledMap scheduledMap);
+
+    std::vector<std::unique_ptr<AscEmu::Threading::AEThread>> m_workers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    // min heap on the deadline, a plain vector so deadlines of sleeping maps can be changed
+    std::vector<ScheduledMap> m_maps;
+    // maps woken up while a worker was still ticking them
+    std::vector<MapMgr*> m_wokenMaps;
+
+    std::atomic<uint64_t> m_tickCount = 0;
+    std::atomic<uint64_t> m_lateTickCount = 0;
+    std::atomic<uint32_t> m_maxTickLateness = 0;
+};
+
+#define sMapUpdateScheduler MapUpdateScheduler::getInstance()
@@ -26,6 +26,17 @@
 
 #include "Logging/Logger.hpp"
 
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 TerrainHolder::TerrainHolder(uint32 mapid)
 {
     TileCountX = TileCountY = 0;
@@ -76,7 +87,7 @@ uint32_t TerrainHolder::GetAreaFlagWithoutAdtId(float x, float y)
     auto tile = this->GetTile(x, y);
     if (tile)
     {
-        return tile->m_map.GetTileArea(x, y);
+        return tile->m_map->GetTileArea(x, y);
     }
 
     return 0;
@@ -164,7 +175,7 @@ uint32 TerrainHolder::GetAreaFlag(float x, float y)
         // No generated map for this area (usually instances)
         return 0;
     }
-    uint32 rv = tile->m_map.GetTileArea(x, y);
+    uint32 rv = tile->m_map->GetTileArea(x, y);
     tile->DecRef();
     return rv;
 }
@@ -172,6 +183,9 @@ uint32 TerrainHolder::GetAreaFlag(float x, float y)
 TerrainTile::~TerrainTile()
 {
     m_parent->m_tiles[m_tx][m_ty] = NULL;
+
+    if (m_map != nullptr)
+        sTerrainTileCache.release(m_mapid, m_tx, m_ty);
 }
 
 TerrainTile::TerrainTile(TerrainHolder* parent, uint32 mapid, int32 x, int32 y)
@@ -180,13 +194,124 @@ TerrainTile::TerrainTile(TerrainHolder* parent, uint32 mapid, int32 x, int32 y)
     m_mapid = mapid;
     m_tx = x;
     m_ty = y;
-    ++m_refs;
+    m_map = nullptr;
+    m_refs = 1;
+}
+
+TerrainTileCache& TerrainTileCache::getInstance()
+{
+    static TerrainTileCache mInstance;
+    return mInstance;
+}
+
+void TerrainTileCache::initialize(uint32_t maxUnusedTiles)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_maxUnusedTiles = maxUnusedTiles;
+
+    sLogger.info("TerrainTileCache : Keeps up to %u unused terrain tiles mapped", maxUnusedTiles);
+}
+
+void TerrainTileCache::finalize()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    sLogger.info("TerrainTileCache : %llu tiles mapped, %llu times a mapped tile was shared", static_cast<unsigned long long>(m_mapCount.load()),
+        static_cast<unsigned long long>(m_shareCount.load()));
+
+    // tiles still in use belong to maps which are not deleted yet
+    unmapUnusedTiles(0);
+}
+
+uint64_t TerrainTileCache::getKey(uint32_t mapId, int32_t tileX, int32_t tileY)
+{
+    return (static_cast<uint64_t>(mapId) << 32) | (static_cast<uint64_t>(tileX & 0xFFFF) << 16) | static_cast<uint64_t>(tileY & 0xFFFF);
+}
+
+TileMap const* TerrainTileCache::acquire(uint32_t mapId, int32_t tileX, int32_t tileY)
+{
+    const uint64_t key = getKey(mapId, tileX, tileY);
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    const auto itr = m_tiles.find(key);
+    if (itr != m_tiles.end())
+    {
+        CachedTile& cachedTile = itr->second;
+        if (cachedTile.users++ == 0)
+            m_unusedTiles.erase(cachedTile.unusedPosition);
+
+        ++m_shareCount;
+        return cachedTile.map.get();
+    }
+
+    // mapping only reads the headers, the arrays are paged in when they are used
+    char filename[1024];
+    snprintf(filename, sizeof(filename), "%smaps/%04u_%02u_%02u.map", sWorld.settings.server.dataDir.c_str(), mapId, tileX, tileY);
+
+    CachedTile& cachedTile = m_tiles[key];
+    cachedTile.map = std::make_unique<TileMap>();
+    cachedTile.map->Load(filename);
+    cachedTile.users = 1;
+
+    m_mappedBytes += cachedTile.map->getMappedSize();
+    ++m_mapCount;
+
+    return cachedTile.map.get();
+}
+
+void TerrainTileCache::release(uint32_t mapId, int32_t tileX, int32_t tileY)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    const auto itr = m_tiles.find(getKey(mapId, tileX, tileY));
+    if (itr == m_tiles.end() || itr->second.users == 0)
+    {
+        sLogger.failure("TerrainTileCache : Tile %u_%02d_%02d is released but not in use", mapId, tileX, tileY);
+        return;
+    }
+
+    if (--itr->second.users != 0)
+        return;
+
+    itr->second.unusedPosition = m_unusedTiles.insert(m_unusedTiles.end(), itr->first);
+    unmapUnusedTiles(m_maxUnusedTiles);
+}
+
+void TerrainTileCache::unmapUnusedTiles(size_t maxUnusedTiles)
+{
+    while (m_unusedTiles.size() > maxUnusedTiles)
+    {
+        const auto itr = m_tiles.find(m_unusedTiles.front());
+        m_mappedBytes -= itr->second.map->getMappedSize();
+        m_tiles.erase(itr);
+
+        m_unusedTiles.pop_front();
+    }
+}
+
+uint32_t TerrainTileCache::getTileCount()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return static_cast<uint32_t>(m_tiles.size());
+}
+
+uint32_t TerrainTileCache::getUnusedTileCount()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return static_cast<uint32_t>(m_unusedTiles.size());
+}
+
+uint64_t TerrainTileCache::getMappedBytes()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_mappedBytes;
 }
 
-float TileMap::GetHeightB(float x, float y, int x_int, int y_int)
+float TileMap::GetHeightB(float x, float y, int x_int, int y_int) const
 {
     int32 a, b, c;
-    uint8* V9_h1_ptr = &m_heightMap9B[x_int * 128 + x_int + y_int];
+    const uint8* V9_h1_ptr = &m_heightMap9B[x_int * 128 + x_int + y_int];
     if (x + y < 1)
     {
         if (x > y)
@@ -238,10 +363,10 @@ float TileMap::GetHeightB(float x, float y, int x_int, int y_int)
     return (a * x + b * y + c) * m_heightMapMult + m_tileHeight;
 }
 
-float TileMap::GetHeightS(float x, float y, int x_int, int y_int)
+float TileMap::GetHeightS(float x, float y, int x_int, int y_int) const
 {
     int32 a, b, c;
-    uint16* V9_h1_ptr = &m_heightMap9S[x_int * 128 + x_int + y_int];
+    const uint16* V9_h1_ptr = &m_heightMap9S[x_int * 128 + x_int + y_int];
     if (x + y < 1)
     {
         if (x > y)
@@ -293,7 +418,7 @@ float TileMap::GetHeightS(float x, float y, int x_int, int y_int)
     return (a * x + b * y + c) * m_heightMapMult + m_tileHeight;
 }
 
-float TileMap::GetHeightF(float x, float y, int x_int, int y_int)
+float TileMap::GetHeightF(float x, float y, int x_int, int y_int) const
 {
     float a, b, c;
     // Select triangle:
@@ -347,7 +472,7 @@ float TileMap::GetHeightF(float x, float y, int x_int, int y_int)
     return a * x + b * y + c;
 }
 
-float TileMap::GetHeight(float x, float y)
+float TileMap::GetHeight(float x, float y) const
 {
     if (m_heightMap9F == NULL)
         return m_tileHeight;
@@ -377,7 +502,7 @@ const bool TerrainHolder::GetAreaInfo(float x, float y, float z, uint32 &mogp_fl
     {
         if (auto tile = this->GetTile(x, y))
         {
-            float map_height = tile->m_map.GetHeight(x, y);
+            float map_height = tile->m_map->GetHeight(x, y);
             if (z + 2.0f > map_height && map_height > vmap_z)
             {
                 return false;
@@ -406,24 +531,25 @@ TileMap::TileMap()
     m_liquidHeight = 0;
     m_liquidWidth = 0;
     m_defaultLiquidType = 0;
+
+    m_mappedData = nullptr;
+    m_mappedSize = 0;
+#ifdef _WIN32
+    m_fileHandle = nullptr;
+    m_mappingHandle = nullptr;
+#endif
 }
 
 TileMap::~TileMap()
 {
-    delete[] m_areaMap;
-    delete[] m_heightMap8F;
-    delete[] m_heightMap9F;
-
-    delete[] m_liquidType;
-    delete[] m_liquidMap;
+    unmapFile();
 }
 
-void TileMap::Load(char* filename)
+void TileMap::Load(const char* filename)
 {
     sLogger.debug("Loading %s", filename);
-    FILE* f = fopen(filename, "rb");
 
-    if (f == NULL)
+    if (!mapFile(filename))
     {
         sLogger.failure("%s does not exist", filename);
         return;
@@ -431,9 +557,9 @@ void TileMap::Load(char* filename)
 
     TileMapHeader header;
 
-    if (fread(&header, sizeof(header), 1, f) != 1)
+    if (!readHeader(0, &header, sizeof(header)))
     {
-        fclose(f);
+        unmapFile();
         return;
     }
 
@@ -441,31 +567,130 @@ void TileMap::Load(char* filename)
     if (header.buildMagic != BUILD_VERSION)  // wow version
     {
         sLogger.failure("%s: from incorrect client (you: %u us: %u)", filename, header.buildMagic, BUILD_VERSION);
-        fclose(f);
+        unmapFile();
         return;
     }
 #endif
 
     if (header.areaMapOffset != 0)
-        LoadAreaData(f, header);
+        LoadAreaData(header);
 
     if (header.heightMapOffset != 0)
-        LoadHeightData(f, header);
+        LoadHeightData(header);
 
     if (header.liquidMapOffset != 0)
-        LoadLiquidData(f, header);
-
-    fclose(f);
+        LoadLiquidData(header);
 }
 
-void TileMap::LoadLiquidData(FILE* f, TileMapHeader & header)
+bool TileMap::mapFile(const char* filename)
 {
-    TileMapLiquidHeader liquidHeader;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
 
-    if (fseek(f, header.liquidMapOffset, SEEK_SET) != 0)
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_fileHandle = file;
+    m_mappingHandle = mapping;
+    m_mappedData = static_cast<char*>(data);
+    m_mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const int file = ::open(filename, O_RDONLY);
+    if (file == -1)
+        return false;
+
+    struct stat fileStat;
+    if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    m_mappedData = static_cast<char*>(data);
+    m_mappedSize = static_cast<size_t>(fileStat.st_size);
+#endif
+
+    return true;
+}
+
+void TileMap::unmapFile()
+{
+    if (m_mappedData == nullptr)
         return;
 
-    if (fread(&liquidHeader, sizeof(liquidHeader), 1, f) != 1)
+#ifdef _WIN32
+    UnmapViewOfFile(m_mappedData);
+    CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+    CloseHandle(static_cast<HANDLE>(m_fileHandle));
+    m_mappingHandle = nullptr;
+    m_fileHandle = nullptr;
+#else
+    munmap(m_mappedData, m_mappedSize);
+#endif
+
+    m_mappedData = nullptr;
+    m_mappedSize = 0;
+}
+
+bool TileMap::readHeader(uint32_t offset, void* header, size_t size) const
+{
+    if (offset > m_mappedSize || m_mappedSize - offset < size)
+        return false;
+
+    memcpy(header, m_mappedData + offset, size);
+    return true;
+}
+
+template <typename T>
+const T* TileMap::getArray(size_t offset, size_t count)
+{
+    const size_t size = count * sizeof(T);
+    if (offset > m_mappedSize || m_mappedSize - offset < size)
+        return nullptr;
+
+    const char* data = m_mappedData + offset;
+    if (reinterpret_cast<uintptr_t>(data) % alignof(T) == 0)
+        return reinterpret_cast<const T*>(data);
+
+    std::unique_ptr<uint8_t[]> copy(new uint8_t[size]);
+    memcpy(copy.get(), data, size);
+    m_alignedCopies.push_back(std::move(copy));
+
+    return reinterpret_cast<const T*>(m_alignedCopies.back().get());
+}
+
+void TileMap::LoadLiquidData(TileMapHeader const& header)
+{
+    TileMapLiquidHeader liquidHeader;
+
+    if (!readHeader(header.liquidMapOffset, &liquidHeader, sizeof(liquidHeader)))
         return;
 
     m_defaultLiquidType = liquidHeader.liquidType;
@@ -475,84 +700,68 @@ void TileMap::LoadLiquidData(FILE* f, TileMapHeader & header)
     m_liquidWidth = liquidHeader.width;
     m_liquidHeight = liquidHeader.height;
 
+    size_t offset = header.liquidMapOffset + sizeof(liquidHeader);
+
     if (!(liquidHeader.flags & MAP_LIQUID_NO_TYPE))
     {
-        m_liquidType = new uint8[16 * 16];
-        if (fread(m_liquidType, sizeof(uint8), 16 * 16, f) != 16 * 16)
-            return;
+        m_liquidType = getArray<uint8>(offset, 16 * 16);
+        offset += 16 * 16 * sizeof(uint8);
     }
 
     if (!(liquidHeader.flags & MAP_LIQUID_NO_HEIGHT))
-    {
-        m_liquidMap = new float[m_liquidWidth * m_liquidHeight];
-        if (fread(m_liquidMap, sizeof(float), m_liquidWidth * m_liquidHeight, f) != 16 * 16)
-            return;
-    }
+        m_liquidMap = getArray<float>(offset, m_liquidWidth * m_liquidHeight);
 }
 
-void TileMap::LoadHeightData(FILE* f, TileMapHeader & header)
+void TileMap::LoadHeightData(TileMapHeader const& header)
 {
     TileMapHeightHeader mapHeader;
 
-    if (fseek(f, header.heightMapOffset, SEEK_SET) != 0)
-        return;
-
-    if (fread(&mapHeader, sizeof(mapHeader), 1, f) != 1)
+    if (!readHeader(header.heightMapOffset, &mapHeader, sizeof(mapHeader)))
         return;
 
     m_tileHeight = mapHeader.gridHeight;
     m_heightMapFlags = mapHeader.flags;
 
+    if (m_heightMapFlags & MAP_HEIGHT_NO_HEIGHT)
+        return;
+
+    const size_t offset = header.heightMapOffset + sizeof(mapHeader);
+
+    // both arrays or none, GetHeight only checks m_heightMap9F
     if (m_heightMapFlags & MAP_HEIGHT_AS_INT16)
     {
         m_heightMapMult = (mapHeader.gridMaxHeight - mapHeader.gridHeight) / 65535;
 
-        m_heightMap9S = new uint16[129 * 129];
-        m_heightMap8S = new uint16[128 * 128];
-        if (fread(m_heightMap9S, sizeof(uint16), 129 * 129, f) != 129 * 129 ||
-            fread(m_heightMap8S, sizeof(uint16), 128 * 128, f) != 128 * 128)
-            return;
+        m_heightMap8S = getArray<uint16>(offset + 129 * 129 * sizeof(uint16), 128 * 128);
+        m_heightMap9S = m_heightMap8S != nullptr ? getArray<uint16>(offset, 129 * 129) : nullptr;
     }
     else if (m_heightMapFlags & MAP_HEIGHT_AS_INT8)
     {
         m_heightMapMult = (mapHeader.gridMaxHeight - mapHeader.gridHeight) / 255;
 
-        m_heightMap9B = new uint8[129 * 129];
-        m_heightMap8B = new uint8[128 * 128];
-        if (fread(m_heightMap9B, sizeof(uint8), 129 * 129, f) != 129 * 129 ||
-            fread(m_heightMap8B, sizeof(uint8), 128 * 128, f) != 128 * 128)
-            return;
+        m_heightMap8B = getArray<uint8>(offset + 129 * 129 * sizeof(uint8), 128 * 128);
+        m_heightMap9B = m_heightMap8B != nullptr ? getArray<uint8>(offset, 129 * 129) : nullptr;
     }
     else
     {
-        m_heightMap9F = new float[129 * 129];
-        m_heightMap8F = new float[128 * 128];
-        if (fread(m_heightMap9F, sizeof(float), 129 * 129, f) != 129 * 129 ||
-            fread(m_heightMap8F, sizeof(float), 128 * 128, f) != 128 * 128)
-            return;
+        m_heightMap8F = getArray<float>(offset + 129 * 129 * sizeof(float), 128 * 128);
+        m_heightMap9F = m_heightMap8F != nullptr ? getArray<float>(offset, 129 * 129) : nullptr;
     }
 }
 
-void TileMap::LoadAreaData(FILE* f, TileMapHeader & header)
+void TileMap::LoadAreaData(TileMapHeader const& header)
 {
     TileMapAreaHeader areaHeader;
 
-    if (fseek(f, header.areaMapOffset, SEEK_SET) != 0)
-        return;
-
-    if (fread(&areaHeader, sizeof(areaHeader), 1, f) != 1)
+    if (!readHeader(header.areaMapOffset, &areaHeader, sizeof(areaHeader)))
         return;
 
     m_area = areaHeader.gridArea;
     if (!(areaHeader.flags & MAP_AREA_NO_AREA))
-    {
-        m_areaMap = new uint16[16 * 16];
-        if (fread(m_areaMap, sizeof(uint16), 16 * 16, f) != 16 * 16)
-            return;
-    }
+        m_areaMap = getArray<uint16>(header.areaMapOffset + sizeof(areaHeader), 16 * 16);
 }
 
-float TileMap::GetTileLiquidHeight(float x, float y)
+float TileMap::GetTileLiquidHeight(float x, float y) const
 {
     if (m_liquidMap == NULL)
         return m_liquidLevel;
@@ -572,7 +781,7 @@ float TileMap::GetTileLiquidHeight(float x, float y)
     return m_liquidMap[cx_int * m_liquidWidth + cy_int];
 }
 
-uint8 TileMap::GetTileLiquidType(float x, float y)
+uint8 TileMap::GetTileLiquidType(float x, float y) const
 {
     if (m_liquidType == NULL)
         return (uint8)m_defaultLiquidType;
@@ -584,7 +793,7 @@ uint8 TileMap::GetTileLiquidType(float x, float y)
     return m_liquidType[lx * 16 + ly];
 }
 
-uint32 TileMap::GetTileArea(float x, float y)
+uint32 TileMap::GetTileArea(float x, float y) const
 {
     if (m_areaMap == NULL)
         return m_area;
@@ -5,7 +5,13 @@ This file is released under the MIT license. See README-MIT for more information
 
 #pragma once
 
+#include <atomic>
 #include <cstdio>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "Threading/Mutex.h"
 #include <Server/World.h>
@@ -92,33 +98,36 @@ enum ZLiquidStatus : uint32_t
     LIQUID_MAP_UNDER_WATER = 0x00000008
 };
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Terrain of one map tile (a .map file). The file is mapped read only and the arrays
+// point into the mapping, so the same TileMap is shared by all instances of a map.
 class TileMap
 {
 public:
     // Area Map
     uint16_t m_area;
-    uint16_t* m_areaMap;
+    const uint16_t* m_areaMap;
 
     // Height Map
     union
     {
-        float* m_heightMap8F;
-        uint16_t* m_heightMap8S;
-        uint8_t* m_heightMap8B;
+        const float* m_heightMap8F;
+        const uint16_t* m_heightMap8S;
+        const uint8_t* m_heightMap8B;
     };
     union
     {
-        float* m_heightMap9F;
-        uint16_t* m_heightMap9S;
-        uint8_t* m_heightMap9B;
+        const float* m_heightMap9F;
+        const uint16_t* m_heightMap9S;
+        const uint8_t* m_heightMap9B;
     };
     uint32_t m_heightMapFlags;
     float m_heightMapMult;
     float m_tileHeight;
 
     // Liquid Map
-    uint8_t* m_liquidType;
-    float* m_liquidMap;
+    const uint8_t* m_liquidType;
+    const float* m_liquidMap;
     float m_liquidLevel;
     uint8_t m_liquidOffX;
     uint8_t m_liquidOffY;
@@ -129,23 +138,109 @@ public:
     TileMap();
     ~TileMap();
 
-    void Load(char* filename);
+    TileMap(TileMap&&) = delete;
+    TileMap(TileMap const&) = delete;
+    TileMap& operator=(TileMap&&) = delete;
+    TileMap& operator=(TileMap const&) = delete;
 
-    void LoadLiquidData(FILE* f, TileMapHeader & header);
-    void LoadHeightData(FILE* f, TileMapHeader & header);
-    void LoadAreaData(FILE* f, TileMapHeader & header);
+    void Load(const char* filename);
 
-    float GetHeight(float x, float y);
-    float GetHeightB(float x, float y, int x_int, int y_int);
-    float GetHeightS(float x, float y, int x_int, int y_int);
-    float GetHeightF(float x, float y, int x_int, int y_int);
+    size_t getMappedSize() const { return m_mappedSize; }
 
-    float GetTileLiquidHeight(float x, float y);
-    uint8_t GetTileLiquidType(float x, float y);
+    float GetHeight(float x, float y) const;
+    float GetHeightB(float x, float y, int x_int, int y_int) const;
+    float GetHeightS(float x, float y, int x_int, int y_int) const;
+    float GetHeightF(float x, float y, int x_int, int y_int) const;
 
-    uint32_t GetTileArea(float x, float y);
+    float GetTileLiquidHeight(float x, float y) const;
+    uint8_t GetTileLiquidType(float x, float y) const;
+
+    uint32_t GetTileArea(float x, float y) const;
+
+private:
+    void LoadLiquidData(TileMapHeader const& header);
+    void LoadHeightData(TileMapHeader const& header);
+    void LoadAreaData(TileMapHeader const& header);
+
+    bool mapFile(const char* filename);
+    void unmapFile();
+
+    bool readHeader(uint32_t offset, void* header, size_t size) const;
+
+    // nullptr when the array is not inside the file, arrays at an offset which is not
+    // aligned for T are copied
+    template <typename T>
+    const T* getArray(size_t offset, size_t count);
+
+    char* m_mappedData;
+    size_t m_mappedSize;
+#ifdef _WIN32
+    void* m_fileHandle;
+    void* m_mappingHandle;
+#endif
+
+    std::vector<std::unique_ptr<uint8_t[]>> m_alignedCopies;
 };
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Process wide cache of the mapped terrain tiles.
+// A tile is mapped once and shared by every TerrainHolder that loads it, e.g. all copies
+// of a dungeon or battleground. Tiles that are no longer used stay mapped for the next
+// instance until more than maxUnusedTiles unused tiles exist, then the least recently
+// used one is unmapped.
+class SERVER_DECL TerrainTileCache
+{
+    struct CachedTile
+    {
+        std::unique_ptr<TileMap> map;
+        uint32_t users = 0;
+        std::list<uint64_t>::iterator unusedPosition;
+    };
+
+private:
+    TerrainTileCache() = default;
+    ~TerrainTileCache() = default;
+
+public:
+    static TerrainTileCache& getInstance();
+    void initialize(uint32_t maxUnusedTiles);
+    void finalize();
+
+    TerrainTileCache(TerrainTileCache&&) = delete;
+    TerrainTileCache(TerrainTileCache const&) = delete;
+    TerrainTileCache& operator=(TerrainTileCache&&) = delete;
+    TerrainTileCache& operator=(TerrainTileCache const&) = delete;
+
+    // Never nullptr, tiles without file are cached as empty TileMap. Every acquire needs a release.
+    TileMap const* acquire(uint32_t mapId, int32_t tileX, int32_t tileY);
+    void release(uint32_t mapId, int32_t tileX, int32_t tileY);
+
+    uint32_t getTileCount();
+    uint32_t getUnusedTileCount();
+    uint64_t getMappedBytes();
+
+    // acquires which mapped the file / acquires which used an already mapped tile
+    uint64_t getMapCount() const { return m_mapCount; }
+    uint64_t getShareCount() const { return m_shareCount; }
+
+private:
+    static uint64_t getKey(uint32_t mapId, int32_t tileX, int32_t tileY);
+    void unmapUnusedTiles(size_t maxUnusedTiles);
+
+    std::mutex m_mutex;
+    std::unordered_map<uint64_t, CachedTile> m_tiles;
+
+    // least recently used first
+    std::list<uint64_t> m_unusedTiles;
+    size_t m_maxUnusedTiles = 256;
+    uint64_t m_mappedBytes = 0;
+
+    std::atomic<uint64_t> m_mapCount{ 0 };
+    std::atomic<uint64_t> m_shareCount{ 0 };
+};
+
+#define sTerrainTileCache TerrainTileCache::getInstance()
+
 class TerrainTile
 {
 public:
@@ -156,8 +251,8 @@ public:
     int32_t m_tx;
     int32_t m_ty;
 
-    //Children
-    TileMap m_map;
+    //Children, shared with the tiles of the other instances of this map
+    TileMap const* m_map;
 
     TerrainTile(TerrainHolder* parent, uint32_t mapid, int32_t x, int32_t y);
     ~TerrainTile();
@@ -167,11 +262,7 @@ public:
 
     void Load()
     {
-        char filename[1024];
-
-        // Normal map stuff
-        sprintf(filename, "%smaps/%04u_%02u_%02u.map", sWorld.settings.server.dataDir.c_str(), m_mapid, m_tx, m_ty);
-        m_map.Load(filename);
+        m_map = sTerrainTileCache.acquire(m_mapid, m_tx, m_ty);
     }
 };
 
@@ -25,6 +25,7 @@
 #include "InstanceDefines.hpp"
 #include "MapMgr.h"
 #include "WorldCreator.h"
+#include "MapUpdateScheduler.hpp"
 
 #include "Chat/ChatHandler.hpp"
 #include "Server/Packets/SmsgUpdateLastInstance.h"
@@ -651,7 +652,7 @@ MapMgr* InstanceMgr::_CreateInstance(uint32_t mapid, uint32_t instanceid)
             if (const auto newMap = new MapMgr(m_maps[mapid], mapid, instanceid))
             {
                 // Scheduling the new map for running
-                ThreadPool.ExecuteTask(newMap);
+                sMapUpdateScheduler.addMap(newMap);
                 m_singleMaps[mapid] = newMap;
 
                 return newMap;
@@ -681,7 +682,7 @@ MapMgr* InstanceMgr::_CreateInstance(Instance* in)
     in->m_mapMgr->iInstanceMode = in->m_difficulty;
     in->m_mapMgr->InactiveMoveTime = 60 + UNIXTIME;
 
-    ThreadPool.ExecuteTask(in->m_mapMgr);
+    sMapUpdateScheduler.addMap(in->m_mapMgr);
     return in->m_mapMgr;
 }
 
@@ -1051,7 +1052,7 @@ MapMgr* InstanceMgr::CreateBattlegroundInstance(uint32_t mapid)
     m_instances[mapid]->insert(std::make_pair(instance->m_instanceId, instance));
 
     m_mapLock.Release();
-    ThreadPool.ExecuteTask(mapMgr);
+    sMapUpdateScheduler.addMap(mapMgr);
 
     return mapMgr;
 }
@@ -1091,7 +1092,7 @@ MapMgr* InstanceMgr::CreateInstance(uint32_t /*instanceType*/, uint32_t mapid)
     m_instances[mapid]->insert(std::make_pair(instance->m_instanceId, instance));
 
     m_mapLock.Release();
-    ThreadPool.ExecuteTask(mapMgr);
+    sMapUpdateScheduler.addMap(mapMgr);
 
     return mapMgr;
 }
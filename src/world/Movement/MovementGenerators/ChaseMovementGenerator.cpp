@@ -131,6 +131,15 @@ bool ChaseMovementGenerator::update(Unit* owner, uint32_t diff)
         }
     }
 
+    // the path is calculated by a pathfinding worker, wait until it is ready
+    if (_path && _path->isPathPending())
+    {
+        if (_path->pollPath())
+            launchPath(owner, target, maxTarget);
+
+        return true;
+    }
+
     // if we're done moving, we want to clean up
     if (owner->hasUnitStateFlag(UNIT_STATE_CHASE_MOVE) && owner->movespline->Finalized())
     {
@@ -188,50 +197,59 @@ bool ChaseMovementGenerator::update(Unit* owner, uint32_t diff)
 
             bool forcedest = owner->canFly() || owner->isInWater();
 
-            bool success = _path->calculatePath(x, y, z, forcedest);
-            if (!success || (_path->getPathType() & (PATHFIND_NOPATH /* | PATHFIND_INCOMPLETE*/)))
-            {
-                if (cOwner)
-                    cOwner->getAIInterface()->setCannotReachTarget(true);
-                owner->stopMoving();
-                return true;
-            }
+            _shortenPath = shortenPath;
+            _path->calculatePathAsync(x, y, z, forcedest);
+            if (!_path->isPathPending())
+                launchPath(owner, target, maxTarget);
+        }
+    }
 
-            if (shortenPath)
-                _path->shortenPathUntilDist(positionToVector3(target->GetPosition()), maxTarget);
+    // and then, finally, we're done for the tick
+    return true;
+}
 
-            if (cOwner)
-                cOwner->getAIInterface()->setCannotReachTarget(false);
+void ChaseMovementGenerator::launchPath(Unit* owner, Unit* target, float maxTarget)
+{
+    Creature* const cOwner = owner->ToCreature();
 
-            bool walk = false;
-            if (cOwner && !cOwner->isPet())
-            {
-                switch (cOwner->getMovementTemplate().getChase())
-                {
-                    case CreatureChaseMovementType::CanWalk:
-                        walk = owner->isWalking();
-                        break;
-                    case CreatureChaseMovementType::AlwaysWalk:
-                        walk = true;
-                        break;
-                    default:
-                        break;
-                }
-            }
+    if (_path->getPathType() & (PATHFIND_NOPATH /* | PATHFIND_INCOMPLETE*/))
+    {
+        if (cOwner)
+            cOwner->getAIInterface()->setCannotReachTarget(true);
+        owner->stopMoving();
+        return;
+    }
 
-            owner->addUnitStateFlag(UNIT_STATE_CHASE_MOVE);
-            addFlag(MOVEMENTGENERATOR_FLAG_INFORM_ENABLED);
+    if (_shortenPath)
+        _path->shortenPathUntilDist(positionToVector3(target->GetPosition()), maxTarget);
 
-            MovementNew::MoveSplineInit init(owner);
-            init.MovebyPath(_path->getPath());
-            init.SetWalk(walk);
-            init.SetFacing(target);
-            init.Launch();
+    if (cOwner)
+        cOwner->getAIInterface()->setCannotReachTarget(false);
+
+    bool walk = false;
+    if (cOwner && !cOwner->isPet())
+    {
+        switch (cOwner->getMovementTemplate().getChase())
+        {
+            case CreatureChaseMovementType::CanWalk:
+                walk = owner->isWalking();
+                break;
+            case CreatureChaseMovementType::AlwaysWalk:
+                walk = true;
+                break;
+            default:
+                break;
         }
     }
 
-    // and then, finally, we're done for the tick
-    return true;
+    owner->addUnitStateFlag(UNIT_STATE_CHASE_MOVE);
+    addFlag(MOVEMENTGENERATOR_FLAG_INFORM_ENABLED);
+
+    MovementNew::MoveSplineInit init(owner);
+    init.MovebyPath(_path->getPath());
+    init.SetWalk(walk);
+    init.SetFacing(target);
+    init.Launch();
 }
 
 void ChaseMovementGenerator::deactivate(Unit* owner)
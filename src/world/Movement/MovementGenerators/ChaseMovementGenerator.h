@@ -32,6 +32,8 @@ public:
 private:
     static constexpr uint32 RANGE_CHECK_INTERVAL = 100; // time (ms) until we attempt to recalculate
 
+    void launchPath(Unit* owner, Unit* target, float maxTarget);
+
     Optional<ChaseRange> const _range;
     Optional<ChaseAngle> const _angle;
 
@@ -40,4 +42,5 @@ private:
     SmallTimeTracker _rangeCheckTimer;
     bool _movingTowards = true;
     bool _mutualChase = true;
+    bool _shortenPath = false;
 };
@@ -0,0 +1,143 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#include "PathCache.hpp"
+#include "Logging/Logger.hpp"
+
+#include <algorithm>
+
+size_t PathCache::PathKeyHash::operator()(PathKey const& key) const
+{
+    size_t hash = std::hash<uint64_t>()(static_cast<uint64_t>(key.startPoly));
+    hash ^= std::hash<uint64_t>()(static_cast<uint64_t>(key.endPoly)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<uint32_t>()(static_cast<uint32_t>(key.includeFlags) << 16 | key.excludeFlags) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+PathCache& PathCache::getInstance()
+{
+    static PathCache mInstance;
+    return mInstance;
+}
+
+void PathCache::initialize(uint32_t maxPathsPerMap)
+{
+    m_maxPathsPerMap = maxPathsPerMap;
+
+    if (m_maxPathsPerMap == 0)
+        sLogger.info("PathCache : Disabled");
+    else
+        sLogger.info("PathCache : Keeps up to %u paths per map", m_maxPathsPerMap);
+}
+
+void PathCache::finalize()
+{
+    if (!isEnabled())
+        return;
+
+    const uint64_t queryCount = m_hitCount + m_missCount;
+    sLogger.info("PathCache : %llu of %llu paths found in the cache, %llu invalidated", static_cast<unsigned long long>(m_hitCount.load()),
+        static_cast<unsigned long long>(queryCount), static_cast<unsigned long long>(m_invalidatedCount.load()));
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_maps.clear();
+}
+
+PathCache::MapPathCache& PathCache::getMapCache(uint32_t mapId)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    auto& mapCache = m_maps[mapId];
+    if (mapCache == nullptr)
+        mapCache = std::make_unique<MapPathCache>();
+
+    return *mapCache;
+}
+
+bool PathCache::getPath(uint32_t mapId, dtNavMesh const* navMesh, dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter,
+    dtPolyRef* path, uint32_t& pathLength, uint32_t maxPathLength)
+{
+    if (!isEnabled())
+        return false;
+
+    MapPathCache& mapCache = getMapCache(mapId);
+    std::lock_guard<std::mutex> guard(mapCache.mutex);
+
+    const auto itr = mapCache.paths.find({ startPoly, endPoly, filter.getIncludeFlags(), filter.getExcludeFlags() });
+    if (itr == mapCache.paths.end())
+    {
+        ++m_missCount;
+        return false;
+    }
+
+    std::vector<dtPolyRef> const& polys = itr->second.polys;
+
+    // the salt of a polygon changes when its tile is loaded again
+    const bool isValid = polys.size() <= maxPathLength && std::all_of(polys.begin(), polys.end(), [navMesh](dtPolyRef polyRef)
+    {
+        return navMesh->isValidPolyRef(polyRef);
+    });
+
+    if (!isValid)
+    {
+        mapCache.lru.erase(itr->second.lruPosition);
+        mapCache.paths.erase(itr);
+
+        ++m_invalidatedCount;
+        ++m_missCount;
+        return false;
+    }
+
+    std::copy(polys.begin(), polys.end(), path);
+    pathLength = static_cast<uint32_t>(polys.size());
+
+    mapCache.lru.splice(mapCache.lru.end(), mapCache.lru, itr->second.lruPosition);
+
+    ++m_hitCount;
+    return true;
+}
+
+void PathCache::addPath(uint32_t mapId, dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter, dtPolyRef const* path, uint32_t pathLength)
+{
+    if (!isEnabled() || pathLength == 0)
+        return;
+
+    MapPathCache& mapCache = getMapCache(mapId);
+    std::lock_guard<std::mutex> guard(mapCache.mutex);
+
+    const PathKey key = { startPoly, endPoly, filter.getIncludeFlags(), filter.getExcludeFlags() };
+    const auto result = mapCache.paths.try_emplace(key);
+
+    CachedPath& cachedPath = result.first->second;
+    cachedPath.polys.assign(path, path + pathLength);
+
+    if (!result.second)
+    {
+        mapCache.lru.splice(mapCache.lru.end(), mapCache.lru, cachedPath.lruPosition);
+        return;
+    }
+
+    cachedPath.lruPosition = mapCache.lru.insert(mapCache.lru.end(), key);
+
+    while (mapCache.paths.size() > m_maxPathsPerMap)
+    {
+        mapCache.paths.erase(mapCache.lru.front());
+        mapCache.lru.pop_front();
+    }
+}
+
+uint32_t PathCache::getPathCount()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    uint32_t pathCount = 0;
+    for (const auto& mapCache : m_maps)
+    {
+        std::lock_guard<std::mutex> mapGuard(mapCache.second->mutex);
+        pathCount += static_cast<uint32_t>(mapCache.second->paths.size());
+    }
+
+    return pathCount;
+}
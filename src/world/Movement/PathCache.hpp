@@ -0,0 +1,101 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include "DetourNavMesh.h"
+#include "DetourNavMeshQuery.h"
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Polygon corridors found by PathGenerator, reused when another path starts and ends on
+// the same polygons with the same filter (pack members chasing the same target, pets
+// following their owner). Only the point path is built again for such a path.
+// Every map has its own cache with the least recently used corridors, instances share
+// the cache of their map like they share the navmesh. A corridor with a polygon of an
+// unloaded tile is dropped when it is used.
+// Used by the map threads and the pathfinding workers.
+class SERVER_DECL PathCache
+{
+    struct PathKey
+    {
+        dtPolyRef startPoly;
+        dtPolyRef endPoly;
+        uint16_t includeFlags;
+        uint16_t excludeFlags;
+
+        bool operator==(PathKey const& other) const
+        {
+            return startPoly == other.startPoly && endPoly == other.endPoly && includeFlags == other.includeFlags && excludeFlags == other.excludeFlags;
+        }
+    };
+
+    struct PathKeyHash
+    {
+        size_t operator()(PathKey const& key) const;
+    };
+
+    struct CachedPath
+    {
+        std::vector<dtPolyRef> polys;
+        std::list<PathKey>::iterator lruPosition;
+    };
+
+    struct MapPathCache
+    {
+        std::mutex mutex;
+        std::unordered_map<PathKey, CachedPath, PathKeyHash> paths;
+        // least recently used first
+        std::list<PathKey> lru;
+    };
+
+private:
+    PathCache() = default;
+    ~PathCache() = default;
+
+public:
+    static PathCache& getInstance();
+    void initialize(uint32_t maxPathsPerMap);
+    void finalize();
+
+    PathCache(PathCache&&) = delete;
+    PathCache(PathCache const&) = delete;
+    PathCache& operator=(PathCache&&) = delete;
+    PathCache& operator=(PathCache const&) = delete;
+
+    bool isEnabled() const { return m_maxPathsPerMap != 0; }
+
+    // copies the corridor into path, returns false when there is none
+    bool getPath(uint32_t mapId, dtNavMesh const* navMesh, dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter,
+        dtPolyRef* path, uint32_t& pathLength, uint32_t maxPathLength);
+    // only complete corridors (ending on endPoly) should be added
+    void addPath(uint32_t mapId, dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter, dtPolyRef const* path, uint32_t pathLength);
+
+    uint32_t getPathCount();
+    uint64_t getHitCount() const { return m_hitCount; }
+    uint64_t getMissCount() const { return m_missCount; }
+    uint64_t getInvalidatedCount() const { return m_invalidatedCount; }
+
+private:
+    MapPathCache& getMapCache(uint32_t mapId);
+
+    uint32_t m_maxPathsPerMap = 0;
+
+    std::mutex m_mutex;
+    std::unordered_map<uint32_t, std::unique_ptr<MapPathCache>> m_maps;
+
+    std::atomic<uint64_t> m_hitCount = 0;
+    std::atomic<uint64_t> m_missCount = 0;
+    std::atomic<uint64_t> m_invalidatedCount = 0;
+};
+
+#define sPathCache PathCache::getInstance()
@@ -4,6 +4,8 @@ This file is released under the MIT license. See README-MIT for more information
 */
 
 #include "PathGenerator.h"
+#include "PathCache.hpp"
+#include "PathfindingService.hpp"
 #include "Map/Map.h"
 #include "Map/MapMgr.h"
 #include "Objects/Units/Creatures/Creature.h"
@@ -18,22 +20,90 @@ PathGenerator::PathGenerator(Object* owner) :
     _polyLength(0), _type(PATHFIND_BLANK), _useStraightPath(false),
     _forceDestination(false), _pointPathLimit(MAX_POINT_PATH_LENGTH), _useRaycast(false),
     _endPosition(G3D::Vector3::zero()), _source(owner), _navMesh(nullptr),
-    _navMeshQuery(nullptr)
+    _navMeshQuery(nullptr), _sourceIsCreature(false), _sourceCanSwim(false), _sourceCanFly(false),
+    _sourceIsInWater(false), _sourceIsFlying(false), _sourceIsFalling(false), _startUnderWater(false),
+    _endUnderWater(false), _waterShortcutAllowed(false), _pathNormalized(false), _pointPathBuilt(false)
 {
     memset(_pathPolyRefs, 0, sizeof(_pathPolyRefs));
 
-    uint32_t mapId = _source->GetMapId();
+    _mapId = _source->GetMapId();
     if (worldConfig.terrainCollision.isPathfindingEnabled)
     {
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        _navMesh = mmap->GetNavMesh(mapId);
-        _navMeshQuery = mmap->GetNavMeshQuery(mapId, _source->GetInstanceID());
+        _navMesh = mmap->GetNavMesh(_mapId);
+        _navMeshQuery = mmap->GetNavMeshQuery(_mapId, _source->GetInstanceID());
     }
 
     createFilter();
 }
 
+PathGenerator::~PathGenerator()
+{
+    cancelPath();
+}
+
 bool PathGenerator::calculatePath(float destX, float destY, float destZ, bool forceDest)
+{
+    cancelPath();
+
+    if (preparePath(destX, destY, destZ, forceDest))
+        buildPath(_navMeshQuery);
+
+    finishPath();
+    return true;
+}
+
+void PathGenerator::calculatePathAsync(float destX, float destY, float destZ, bool forceDest)
+{
+    // raycasts are only used for single calculations like charge
+    if (!sPathfindingService.isEnabled() || _useRaycast)
+    {
+        calculatePath(destX, destY, destZ, forceDest);
+        return;
+    }
+
+    cancelPath();
+
+    if (!preparePath(destX, destY, destZ, forceDest))
+    {
+        finishPath();
+        return;
+    }
+
+    _request = sPathfindingService.queuePath(*this, _source->GetMapId());
+}
+
+bool PathGenerator::pollPath()
+{
+    if (_request == nullptr || !_request->finished.load(std::memory_order_acquire))
+        return false;
+
+    // moving leaves _request empty
+    const std::shared_ptr<PathRequest> request = std::move(_request);
+
+    PathGenerator& result = request->path;
+    memcpy(_pathPolyRefs, result._pathPolyRefs, sizeof(_pathPolyRefs));
+    _polyLength = result._polyLength;
+    _pathPoints = std::move(result._pathPoints);
+    _type = result._type;
+    _actualEndPosition = result._actualEndPosition;
+    _pathNormalized = result._pathNormalized;
+    _pointPathBuilt = result._pointPathBuilt;
+
+    finishPath();
+    return true;
+}
+
+void PathGenerator::cancelPath()
+{
+    if (_request == nullptr)
+        return;
+
+    _request->cancelled = true;
+    _request = nullptr;
+}
+
+bool PathGenerator::preparePath(float destX, float destY, float destZ, bool forceDest)
 {
     float x, y, z;
     _source->getPosition(x, y, z);
@@ -45,24 +115,115 @@ bool PathGenerator::calculatePath(float destX, float destY, float destZ, bool fo
     setStartPosition(start);
 
     _forceDestination = forceDest;
+    _pointPathBuilt = false;
 
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
     Unit* _sourceUnit = _source->ToUnit();
-    if (!_navMesh || !_navMeshQuery || (_sourceUnit && _sourceUnit->hasUnitStateFlag(UNIT_STATE_IGNORE_PATHFINDING)) ||
+    if (!_navMesh || !_navMeshQuery || !_source->GetMapMgr() || (_sourceUnit && _sourceUnit->hasUnitStateFlag(UNIT_STATE_IGNORE_PATHFINDING)) ||
         !haveTile(start) || !haveTile(dest))
     {
         buildShortcut();
         _type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
-        return true;
+        return false;
     }
 
     updateFilter();
-
-    buildPolyPath(start, dest);
+    updateSourceState();
     return true;
 }
 
+void PathGenerator::updateSourceState()
+{
+    Unit* _sourceUnit = _source->ToUnit();
+
+    _sourceIsCreature = _source->isCreature();
+    _sourceCanSwim = _sourceUnit && _sourceUnit->canSwim();
+    _sourceCanFly = _sourceUnit && _sourceUnit->canFly();
+    _sourceIsInWater = _sourceUnit && _sourceUnit->isInWater();
+    _sourceIsFlying = _sourceUnit && _sourceUnit->IsFlying();
+    _sourceIsFalling = _sourceUnit && _sourceUnit->IsFalling();
+
+    _startUnderWater = _source->GetMapMgr()->isUnderWater(_startPosition.x, _startPosition.y, _startPosition.z);
+    _endUnderWater = _source->GetMapMgr()->isUnderWater(_endPosition.x, _endPosition.y, _endPosition.z);
+
+    _waterShortcutAllowed = false;
+    if (!_sourceCanSwim)
+        return;
+
+    // Check both start and end points, if they're both in water, then we can *safely* let the creature move
+    _waterShortcut[0] = getStartPosition();
+    _waterShortcut[1] = getEndPosition();
+    _waterShortcutAllowed = true;
+
+    for (G3D::Vector3& point : _waterShortcut)
+    {
+        _source->updateAllowedPositionZ(point.x, point.y, point.z);
+
+        float outx = point.x + 3.5f * cos(_source->GetOrientation());
+        float outy = point.y + 3.5f * sin(_source->GetOrientation());
+        float outz = _source->GetMapMgr()->GetLandHeight(outx, outy, point.z + 2);
+        float waterz;
+        uint32_t watertype;
+        _source->GetMapMgr()->GetLiquidInfo(outx, outy, outz, waterz, watertype);
+        outz = std::max(waterz, outz);
+
+        ZLiquidStatus liquidStatus = _source->GetMapMgr()->getLiquidStatus(_source->GetPhase(), point.x, point.y, point.z, MAP_ALL_LIQUIDS, nullptr);
+
+        // One of the points is not in the water, cancel movement.
+        if (waterz >= outz || liquidStatus == LIQUID_MAP_IN_WATER)
+        {
+            if (_source->ToUnit()->getAIInterface()->getCurrentTarget())
+                point.z = _source->ToUnit()->getAIInterface()->getCurrentTarget()->GetPositionZ();
+            else
+                point.z = _source->GetPositionZ();
+        }
+        else
+            _waterShortcutAllowed = false;
+    }
+}
+
+void PathGenerator::buildPath(dtNavMeshQuery const* navMeshQuery)
+{
+    _navMeshQuery = navMeshQuery;
+
+    buildPolyPath(getStartPosition(), getEndPosition());
+}
+
+void PathGenerator::finishPath()
+{
+    if (!_pathNormalized)
+        normalizePath();
+
+    if (!_pointPathBuilt)
+        return;
+
+    _pointPathBuilt = false;
+
+    // first point is always our current location - we need the next one
+    setActualEndPosition(_pathPoints[_pathPoints.size() - 1]);
+
+    // force the given destination, if needed
+    if (_forceDestination &&
+        (!(_type & PATHFIND_NORMAL) || !inRange(getEndPosition(), getActualEndPosition(), 1.0f, 1.0f)))
+    {
+        // we may want to keep partial subpath
+        if (dist3DSqr(getActualEndPosition(), getEndPosition()) < 0.3f * dist3DSqr(getStartPosition(), getEndPosition()))
+        {
+            setActualEndPosition(getEndPosition());
+            _pathPoints[_pathPoints.size()-1] = getEndPosition();
+        }
+        else
+        {
+            setActualEndPosition(getEndPosition());
+            buildShortcut();
+            normalizePath();
+        }
+
+        _type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+    }
+}
+
 dtPolyRef PathGenerator::getPathPolyByPosition(dtPolyRef const* polyPath, uint32_t polyPathSize, float const* point, float* distance) const
 {
     if (!polyPath || !polyPathSize)
@@ -146,49 +307,19 @@ void PathGenerator::buildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
     // make shortcut path and mark it as NOPATH ( with flying and swimming exception )
     // its up to caller how he will use this info
 
-    bool waterPath = false;
-    bool path = false;
-
-    if (_source->isCreature())
-    {
-        waterPath = _source->ToCreature()->canSwim();
-        path = _source->ToCreature()->canFly();
-    }
-    else
-    {
-        waterPath = _source->ToPlayer()->canSwim();
-    }
+    bool waterPath = _sourceCanSwim;
+    bool path = _sourceIsCreature && _sourceCanFly;
 
-    if (startPoly == INVALID_POLYREF || endPoly == INVALID_POLYREF || waterPath && _source->ToUnit()->isInWater() || path && _source->ToUnit()->IsFlying())
+    if (startPoly == INVALID_POLYREF || endPoly == INVALID_POLYREF || waterPath && _sourceIsInWater || path && _sourceIsFlying)
     {
         buildShortcut();
-        
+
         if (waterPath)
         {
-            // Check both start and end points, if they're both in water, then we can *safely* let the creature move
-            for (uint32_t i = 0; i < _pathPoints.size(); ++i)
-            {
-                float outx = _pathPoints[i].x + 3.5f * cos(_source->GetOrientation());
-                float outy = _pathPoints[i].y + 3.5f * sin(_source->GetOrientation());
-                float outz = _source->GetMapMgr()->GetLandHeight(outx, outy, _pathPoints[i].z + 2);
-                float waterz;
-                uint32_t watertype;
-                _source->GetMapMgr()->GetLiquidInfo(outx, outy, outz, waterz, watertype);
-                outz = std::max(waterz, outz);
-
-                ZLiquidStatus liquidStatus = _source->GetMapMgr()->getLiquidStatus(_source->GetPhase(), _pathPoints[i].x, _pathPoints[i].y, _pathPoints[i].z, MAP_ALL_LIQUIDS, nullptr);
-
-                // One of the points is not in the water, cancel movement.
-                if (waterz >= outz || liquidStatus == LIQUID_MAP_IN_WATER)
-                {
-                    if (_source->ToUnit()->getAIInterface()->getCurrentTarget())
-                        _pathPoints[i].z = _source->ToUnit()->getAIInterface()->getCurrentTarget()->GetPositionZ();
-                    else
-                        _pathPoints[i].z = _source->GetPositionZ();
-                }
-                else
-                    waterPath = false;
-            }
+            // liquid checks of the shortcut are done by updateSourceState
+            _pathPoints.assign(std::begin(_waterShortcut), std::end(_waterShortcut));
+            _pathNormalized = true;
+            waterPath = _waterShortcutAllowed;
         }
 
         if (path || waterPath)
@@ -212,23 +343,19 @@ void PathGenerator::buildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
     {
         bool buildShotrcut = false;
 
-        G3D::Vector3 const& p = (distToStartPoly > 7.0f) ? startPos : endPos;
-        if (_source->GetMapMgr()->isUnderWater(p.x, p.y, p.z))
+        const bool underWater = (distToStartPoly > 7.0f) ? _startUnderWater : _endUnderWater;
+        if (underWater)
         {
-            if (Unit* _sourceUnit = _source->ToUnit())
-                if (_sourceUnit->canSwim())
-                    buildShotrcut = true;
+            if (_sourceCanSwim)
+                buildShotrcut = true;
         }
         else
         {
-            if (Unit* _sourceUnit = _source->ToUnit())
-            {
-                if (_sourceUnit->canFly())
-                    buildShotrcut = true;
-                // Allow to build a shortcut if the unit is falling and it's trying to move downwards towards a target (i.e. charging)
-                else if (_sourceUnit->IsFalling() && endPos.z < startPos.z)
-                    buildShotrcut = true;
-            }
+            if (_sourceCanFly)
+                buildShotrcut = true;
+            // Allow to build a shortcut if the unit is falling and it's trying to move downwards towards a target (i.e. charging)
+            else if (_sourceIsFalling && endPos.z < startPos.z)
+                buildShotrcut = true;
         }
 
         if (buildShotrcut)
@@ -440,7 +567,6 @@ void PathGenerator::buildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
                 _pathPoints[0] = getStartPosition();
                 _pathPoints[1] = G3D::Vector3(hitPos[2], hitPos[0], hitPos[1]);
 
-                normalizePath();
                 _type = PATHFIND_INCOMPLETE;
                 addFarFromPolyFlags(startFarFromPoly, false);
                 return;
@@ -455,7 +581,6 @@ void PathGenerator::buildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
                 _pathPoints[0] = getStartPosition();
                 _pathPoints[1] = G3D::Vector3(endPoint[2], endPoint[0], endPoint[1]);
 
-                normalizePath();
                 if (startFarFromPoly || endFarFromPoly)
                 {
                     _type = PathType(PATHFIND_INCOMPLETE);
@@ -467,6 +592,11 @@ void PathGenerator::buildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
                 return;
             }
         }
+        else if (sPathCache.getPath(_mapId, _navMesh, startPoly, endPoly, _filter, _pathPolyRefs, _polyLength, MAX_POINT_PATH_LENGTH))
+        {
+            // another path between the same polygons was found before, only the point path is built again
+            dtResult = DT_SUCCESS;
+        }
         else
         {
             dtResult = _navMeshQuery->findPath(
@@ -478,6 +608,10 @@ void PathGenerator::buildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
                             _pathPolyRefs,      // [out] path
                             (int*)&_polyLength,
                 MAX_POINT_PATH_LENGTH);         // max number of polygons in output path
+
+            // partial paths ran out of search nodes, they are not cached
+            if (dtStatusSucceed(dtResult) && !dtStatusDetail(dtResult, DT_PARTIAL_RESULT) && _polyLength && _pathPolyRefs[_polyLength - 1] == endPoly)
+                sPathCache.addPath(_mapId, startPoly, endPoly, _filter, _pathPolyRefs, _polyLength);
         }
 
         if (!_polyLength || dtStatusFailed(dtResult))
@@ -565,35 +699,17 @@ void PathGenerator::buildPointPath(const float *startPoint, const float *endPoin
     for (uint32_t i = 0; i < pointCount; ++i)
         _pathPoints[i] = G3D::Vector3(pathPoints[i*VERTEX_SIZE+2], pathPoints[i*VERTEX_SIZE], pathPoints[i*VERTEX_SIZE+1]);
 
-    normalizePath();
-
-    // first point is always our current location - we need the next one
-    setActualEndPosition(_pathPoints[pointCount-1]);
-
-    // force the given destination, if needed
-    if (_forceDestination &&
-        (!(_type & PATHFIND_NORMAL) || !inRange(getEndPosition(), getActualEndPosition(), 1.0f, 1.0f)))
-    {
-        // we may want to keep partial subpath
-        if (dist3DSqr(getActualEndPosition(), getEndPosition()) < 0.3f * dist3DSqr(getStartPosition(), getEndPosition()))
-        {
-            setActualEndPosition(getEndPosition());
-            _pathPoints[_pathPoints.size()-1] = getEndPosition();
-        }
-        else
-        {
-            setActualEndPosition(getEndPosition());
-            buildShortcut();
-        }
-
-        _type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
-    }
+    // normalizing and the forced destination are done by finishPath
+    _pathNormalized = false;
+    _pointPathBuilt = true;
 }
 
 void PathGenerator::normalizePath()
 {
     for (uint32_t i = 0; i < _pathPoints.size(); ++i)
         _source->updateAllowedPositionZ(_pathPoints[i].x, _pathPoints[i].y, _pathPoints[i].z);
+
+    _pathNormalized = true;
 }
 
 void PathGenerator::buildShortcut()
@@ -607,8 +723,6 @@ void PathGenerator::buildShortcut()
     _pathPoints[0] = getStartPosition();
     _pathPoints[1] = getActualEndPosition();
 
-    normalizePath();
-
     _type = PATHFIND_SHORTCUT;
 }
 
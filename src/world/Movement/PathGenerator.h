@@ -11,10 +11,13 @@ This file is released under the MIT license. See README-MIT for more information
 #include "Movement/Spline/MoveSplineInitArgs.h"
 #include <G3D/Vector3.h>
 
+#include <memory>
+
 #include "Macros/AIInterfaceMacros.hpp"
 
 class Unit;
 class Object;
+struct PathRequest;
 
 enum PathType
 {
@@ -34,11 +37,21 @@ class SERVER_DECL PathGenerator
 {
 public:
     explicit PathGenerator(Object* owner);
-    ~PathGenerator() = default;
+    PathGenerator(PathGenerator const&) = default;
+    ~PathGenerator();
 
     // Calculate the path from owner to given destination
     // return: true if new path was calculated, false otherwise (no change needed)
     bool calculatePath(float destX, float destY, float destZ, bool forceDest = false);
+
+    // Same as calculatePath, but the detour queries run on a worker of the PathfindingService.
+    // While isPathPending() is true the result getters still return the previous path, pollPath()
+    // applies the new one on a later update of the map. Without workers the path is calculated at once.
+    void calculatePathAsync(float destX, float destY, float destZ, bool forceDest = false);
+    bool isPathPending() const { return _request != nullptr; }
+    // returns true when the pending path is finished and applied
+    bool pollPath();
+    void cancelPath();
     bool isInvalidDestinationZ(Unit const* target) const;
 
     // option setters - use optional
@@ -59,6 +72,8 @@ public:
     void shortenPathUntilDist(G3D::Vector3 const& point, float dist);
 
 private:
+    friend class PathfindingService;
+
     dtPolyRef _pathPolyRefs[MAX_PATH_LENGTH];   // array of detour polygon references
     uint32_t _polyLength;                       // number of polygons in the path
 
@@ -75,11 +90,30 @@ private:
     G3D::Vector3 _actualEndPosition;            // {x, y, z} of the closest possible point to given destination
 
     Object* _source;                            // the object that is moving
+    uint32_t _mapId;                            // map of the source, key of the PathCache
     dtNavMesh const* _navMesh;                  // the nav mesh
     dtNavMeshQuery const* _navMeshQuery;        // the nav mesh query used to find the path
 
     dtQueryFilter _filter;                      // use single filter for all movements, update it when needed
 
+    // state of the source when the path was requested, buildPolyPath may run on a pathfinding worker
+    // and must not touch the source or its map
+    bool _sourceIsCreature;
+    bool _sourceCanSwim;
+    bool _sourceCanFly;
+    bool _sourceIsInWater;
+    bool _sourceIsFlying;
+    bool _sourceIsFalling;
+    bool _startUnderWater;
+    bool _endUnderWater;
+    G3D::Vector3 _waterShortcut[2];             // shortcut used by swimming units, z already checked against the liquid
+    bool _waterShortcutAllowed;                 // both points of the water shortcut are in water
+
+    bool _pathNormalized;                       // z of the path points is already adjusted by normalizePath
+    bool _pointPathBuilt;                       // buildPointPath made a path, finishPath checks the destination
+
+    std::shared_ptr<PathRequest> _request;      // pending calculatePathAsync
+
     void setStartPosition(G3D::Vector3 const& point) { _startPosition = point; }
     void setEndPosition(G3D::Vector3 const& point) { _actualEndPosition = point; _endPosition = point; }
     void setActualEndPosition(G3D::Vector3 const& point) { _actualEndPosition = point; }
@@ -89,8 +123,17 @@ private:
     {
         _polyLength = 0;
         _pathPoints.clear();
+        _pathNormalized = false;
     }
 
+    // map thread part of calculatePath, returns false when no detour query is needed
+    bool preparePath(float destX, float destY, float destZ, bool forceDest);
+    void updateSourceState();
+    // detour part of calculatePath, only uses the state stored by preparePath
+    void buildPath(dtNavMeshQuery const* navMeshQuery);
+    // map thread part of calculatePath after the detour queries
+    void finishPath();
+
     bool inRange(G3D::Vector3 const& p1, G3D::Vector3 const& p2, float r, float h) const;
     float dist3DSqr(G3D::Vector3 const& p1, G3D::Vector3 const& p2) const;
     bool inRangeYZX(float const* v1, float const* v2, float r, float h) const;
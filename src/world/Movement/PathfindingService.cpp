@@ -0,0 +1,181 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#include "PathfindingService.hpp"
+#include "Logging/Logger.hpp"
+#include "MMapFactory.h"
+#include "MMapManager.h"
+
+#include <chrono>
+#include <shared_mutex>
+
+using AscEmu::Threading::AEThread;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+PathfindingService& PathfindingService::getInstance()
+{
+    static PathfindingService mInstance;
+    return mInstance;
+}
+
+void PathfindingService::initialize(uint32_t workerCount)
+{
+    if (workerCount == 0)
+    {
+        sLogger.info("PathfindingService : Disabled, paths are calculated on the map threads");
+        return;
+    }
+
+    for (uint32_t i = 0; i < workerCount; ++i)
+    {
+        auto worker = std::make_unique<Worker>();
+        Worker* workerPtr = worker.get();
+        m_workers.push_back(std::move(worker));
+
+        workerPtr->thread = std::make_unique<AEThread>("PathfindingWorker" + std::to_string(i),
+            [this, workerPtr](AEThread& thread) { this->workerRunner(thread, *workerPtr); }, milliseconds(0));
+    }
+
+    sLogger.info("PathfindingService : Started %u pathfinding workers", workerCount);
+}
+
+void PathfindingService::finalize()
+{
+    if (!isEnabled())
+        return;
+
+    for (auto& worker : m_workers)
+        worker->thread->requestKill();
+
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker->thread->join();
+
+        for (auto& query : worker->queries)
+            dtFreeNavMeshQuery(query.second.query);
+    }
+
+    m_workers.clear();
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_requests.clear();
+    }
+
+    sLogger.info("PathfindingService : Stopped after %llu paths (%llu cancelled), %llu us average, %u us max",
+        static_cast<unsigned long long>(m_calculatedPathCount.load()), static_cast<unsigned long long>(m_cancelledPathCount.load()),
+        static_cast<unsigned long long>(getAveragePathTime()), m_maxPathTime.load());
+}
+
+std::shared_ptr<PathRequest> PathfindingService::queuePath(PathGenerator const& generator, uint32_t mapId)
+{
+    auto request = std::make_shared<PathRequest>(generator, mapId);
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_requests.push_back(request);
+    }
+
+    m_condition.notify_one();
+    return request;
+}
+
+uint32_t PathfindingService::getQueuedPathCount()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return static_cast<uint32_t>(m_requests.size());
+}
+
+uint64_t PathfindingService::getAveragePathTime() const
+{
+    const uint64_t pathCount = m_calculatedPathCount;
+    return pathCount ? m_totalPathTime / pathCount : 0;
+}
+
+void PathfindingService::workerRunner(AEThread& thread, Worker& worker)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (thread.isKilled())
+        return;
+
+    if (m_requests.empty())
+    {
+        m_condition.wait_for(lock, milliseconds(100));
+        return;
+    }
+
+    const std::shared_ptr<PathRequest> request = std::move(m_requests.front());
+    m_requests.pop_front();
+    lock.unlock();
+
+    calculatePath(worker, *request);
+}
+
+void PathfindingService::calculatePath(Worker& worker, PathRequest& request)
+{
+    if (request.cancelled)
+    {
+        ++m_cancelledPathCount;
+        request.finished.store(true, std::memory_order_release);
+        return;
+    }
+
+    const auto startTime = steady_clock::now();
+
+    MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+    {
+        std::shared_lock<std::shared_mutex> tileLock(mmap->getTileLock());
+
+        dtNavMesh const* navMesh = mmap->GetNavMesh(request.mapId);
+        dtNavMeshQuery const* navMeshQuery = navMesh == request.path._navMesh ? getNavMeshQuery(worker, request.mapId, navMesh) : nullptr;
+        if (navMeshQuery != nullptr)
+        {
+            request.path.buildPath(navMeshQuery);
+        }
+        else
+        {
+            // the navmesh was unloaded after the path was requested
+            request.path.buildShortcut();
+            request.path._type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+        }
+    }
+
+    const auto pathTime = static_cast<uint32_t>(duration_cast<microseconds>(steady_clock::now() - startTime).count());
+    m_totalPathTime += pathTime;
+    ++m_calculatedPathCount;
+
+    uint32_t maxPathTime = m_maxPathTime;
+    while (pathTime > maxPathTime && !m_maxPathTime.compare_exchange_weak(maxPathTime, pathTime));
+
+    request.finished.store(true, std::memory_order_release);
+}
+
+dtNavMeshQuery const* PathfindingService::getNavMeshQuery(Worker& worker, uint32_t mapId, dtNavMesh const* navMesh)
+{
+    NavMeshQuery& query = worker.queries[mapId];
+    if (query.query == nullptr)
+        query.query = dtAllocNavMeshQuery();
+
+    if (query.navMesh != navMesh)
+    {
+        // same node count as the queries of MMapManager
+        if (dtStatusFailed(query.query->init(navMesh, 1024)))
+        {
+            sLogger.failure("PathfindingService : Failed to initialize dtNavMeshQuery for mapId %04u", mapId);
+            query.navMesh = nullptr;
+            return nullptr;
+        }
+
+        query.navMesh = navMesh;
+    }
+
+    return query.query;
+}
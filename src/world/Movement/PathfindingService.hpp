@@ -0,0 +1,102 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include "PathGenerator.h"
+#include "Threading/AEThread.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// A path queued by PathGenerator::calculatePathAsync.
+// The worker builds the path in its own copy of the generator, the map thread takes the
+// result from it in PathGenerator::pollPath once finished is set.
+struct PathRequest
+{
+    PathRequest(PathGenerator const& generator, uint32_t mapId) : path(generator), mapId(mapId) {}
+
+    PathGenerator path;
+    uint32_t mapId;
+
+    // set by the generator when it does not need the path anymore, the worker skips it
+    std::atomic<bool> cancelled = false;
+    std::atomic<bool> finished = false;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Runs the detour queries of PathGenerator on a fixed number of worker threads, so long
+// paths of many units do not stall the map update.
+// dtNavMeshQuery is not thread safe, every worker owns one query object per map. The
+// navmesh is shared with the maps, MMapManager::getTileLock keeps tiles from being
+// added or removed while a worker uses it.
+// When the service is disabled (0 workers) paths are calculated on the map thread.
+class SERVER_DECL PathfindingService
+{
+    struct NavMeshQuery
+    {
+        dtNavMesh const* navMesh = nullptr;
+        dtNavMeshQuery* query = nullptr;
+    };
+
+    struct Worker
+    {
+        std::unique_ptr<AscEmu::Threading::AEThread> thread;
+        // map id to the query of this worker
+        std::unordered_map<uint32_t, NavMeshQuery> queries;
+    };
+
+private:
+    PathfindingService() = default;
+    ~PathfindingService() = default;
+
+public:
+    static PathfindingService& getInstance();
+    void initialize(uint32_t workerCount);
+    void finalize();
+
+    PathfindingService(PathfindingService&&) = delete;
+    PathfindingService(PathfindingService const&) = delete;
+    PathfindingService& operator=(PathfindingService&&) = delete;
+    PathfindingService& operator=(PathfindingService const&) = delete;
+
+    // Queues a copy of the prepared generator
+    std::shared_ptr<PathRequest> queuePath(PathGenerator const& generator, uint32_t mapId);
+
+    bool isEnabled() const { return !m_workers.empty(); }
+    uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+    uint32_t getQueuedPathCount();
+
+    uint64_t getCalculatedPathCount() const { return m_calculatedPathCount; }
+    uint64_t getCancelledPathCount() const { return m_cancelledPathCount; }
+    // microseconds
+    uint64_t getAveragePathTime() const;
+    uint32_t getMaxPathTime() const { return m_maxPathTime; }
+
+private:
+    void workerRunner(AscEmu::Threading::AEThread& thread, Worker& worker);
+    void calculatePath(Worker& worker, PathRequest& request);
+    dtNavMeshQuery const* getNavMeshQuery(Worker& worker, uint32_t mapId, dtNavMesh const* navMesh);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::shared_ptr<PathRequest>> m_requests;
+
+    std::atomic<uint64_t> m_calculatedPathCount = 0;
+    std::atomic<uint64_t> m_cancelledPathCount = 0;
+    std::atomic<uint64_t> m_totalPathTime = 0;
+    std::atomic<uint32_t> m_maxPathTime = 0;
+};
+
+#define sPathfindingService PathfindingService::getInstance()
@@ -26,6 +26,7 @@
 #include "Objects/Container.h"
 #include "Management/ItemInterface.h"
 #include "Server/MainServerDefines.h"
+#include "Server/CharacterDatabaseStatements.hpp"
 #include "Map/MapMgr.h"
 #include "Spell/SpellMgr.hpp"
 #include "Spell/Definitions/ProcFlags.hpp"
@@ -243,43 +244,23 @@ void Item::SaveToDB(int8 containerslot, int8 slot, bool firstsave, QueryBuffer*
     uint64 GiftCreatorGUID = getGiftCreatorGuid();
     uint64 CreatorGUID = getCreatorGuid();
 
-    std::stringstream ss;
-    ss << "DELETE FROM playeritems WHERE guid = " << getGuidLow() << ";";
+    PreparedStatement* deleteStatement = CharacterDatabase.getPreparedStatement(CHARACTER_DEL_PLAYERITEM);
+    deleteStatement->setUInt32(0, getGuidLow());
 
     if (firstsave)
     {
-        CharacterDatabase.WaitExecute(ss.str().c_str());
+        CharacterDatabase.executePrepared(deleteStatement);
     }
     else
     {
         if (buf == nullptr)
-            CharacterDatabase.Execute(ss.str().c_str());
+            CharacterDatabase.executePreparedAsync(deleteStatement);
         else
-            buf->AddQueryNA(ss.str().c_str());
+            buf->addPreparedStatement(deleteStatement);
     }
 
-
-    ss.rdbuf()->str("");
-
-    ss << "INSERT INTO playeritems VALUES(";
-
-    ss << getOwnerGuidLow() << ",";
-    ss << getGuidLow() << ",";
-    ss << getEntry() << ",";
-    ss << wrapped_item_id << ",";
-    ss << (WoWGuid::getGuidLowPartFromUInt64(GiftCreatorGUID)) << ",";
-    ss << (WoWGuid::getGuidLowPartFromUInt64(CreatorGUID)) << ",";
-
-    ss << getStackCount() << ",";
-    ss << int32(GetChargesLeft()) << ",";
-    ss << getFlags() << ",";
-    ss << random_prop << ", " << random_suffix << ", ";
-    ss << 0 << ",";
-    ss << getDurability() << ",";
-    ss << static_cast<int>(containerslot) << ",";
-    ss << static_cast<int>(slot) << ",'";
-
     // Pack together enchantment fields
+    std::stringstream enchantments;
     if (!Enchantments.empty())
     {
         for (EnchantmentMap::iterator itr = Enchantments.begin(); itr != Enchantments.end(); ++itr)
@@ -294,14 +275,31 @@ void Item::SaveToDB(int8 containerslot, int8 slot, bool firstsave, QueryBuffer*
 
             if (itr->second.Enchantment && (remaining_duration > 5 || itr->second.Duration == 0))
             {
-                ss << itr->second.Enchantment->Id << ",";
-                ss << remaining_duration << ",";
-                ss << itr->second.Slot << ";";
+                enchantments << itr->second.Enchantment->Id << ",";
+                enchantments << remaining_duration << ",";
+                enchantments << itr->second.Slot << ";";
             }
         }
     }
-    ss << "','";
-    ss << ItemExpiresOn << "','";
+
+    PreparedStatement* insertStatement = CharacterDatabase.getPreparedStatement(CHARACTER_INS_PLAYERITEM);
+    insertStatement->setUInt32(0, getOwnerGuidLow());
+    insertStatement->setUInt32(1, getGuidLow());
+    insertStatement->setUInt32(2, getEntry());
+    insertStatement->setUInt32(3, wrapped_item_id);
+    insertStatement->setUInt32(4, WoWGuid::getGuidLowPartFromUInt64(GiftCreatorGUID));
+    insertStatement->setUInt32(5, WoWGuid::getGuidLowPartFromUInt64(CreatorGUID));
+    insertStatement->setUInt32(6, getStackCount());
+    insertStatement->setInt32(7, int32(GetChargesLeft()));
+    insertStatement->setUInt32(8, getFlags());
+    insertStatement->setUInt32(9, random_prop);
+    insertStatement->setUInt32(10, random_suffix);
+    insertStatement->setUInt32(11, 0);
+    insertStatement->setUInt32(12, getDurability());
+    insertStatement->setInt32(13, containerslot);
+    insertStatement->setInt32(14, slot);
+    insertStatement->setString(15, enchantments.str());
+    insertStatement->setUInt64(16, static_cast<uint64_t>(ItemExpiresOn));
 
     ////////////////////////////////////////////////// Refund stuff /////////////////////////////////
 
@@ -310,30 +308,28 @@ void Item::SaveToDB(int8 containerslot, int8 slot, bool firstsave, QueryBuffer*
     {
         std::pair<time_t, uint32> refundentry = this->getOwner()->getItemInterface()->LookupRefundable(this->getGuid());
 
-        ss << uint32(refundentry.first) << "','";
-        ss << uint32(refundentry.second);
+        insertStatement->setUInt32(17, uint32(refundentry.first));
+        insertStatement->setUInt32(18, uint32(refundentry.second));
     }
     else
     {
-        ss << uint32(0) << "','";
-        ss << uint32(0);
+        insertStatement->setUInt32(17, 0);
+        insertStatement->setUInt32(18, 0);
     }
 
     /////////////////////////////////////////////////////////////////////////////////////////////////
-    ss << "','";
-    ss << text;
-    ss << "')";
+    insertStatement->setString(19, text);
 
     if (firstsave)
     {
-        CharacterDatabase.WaitExecute(ss.str().c_str());
+        CharacterDatabase.executePrepared(insertStatement);
     }
     else
     {
         if (buf == nullptr)
-            CharacterDatabase.Execute(ss.str().c_str());
+            CharacterDatabase.executePreparedAsync(insertStatement);
         else
-            buf->AddQueryNA(ss.str().c_str());
+            buf->addPreparedStatement(insertStatement);
     }
 
     m_isDirty = false;
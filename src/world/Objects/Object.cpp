@@ -95,6 +95,8 @@ bool Object::write(const uint8_t& member, uint8_t val)
 
     m_updateMask.SetBit(distance);
 
+    ++m_valuesGeneration;
+
     if (!skipping_updates)
         updateObject();
 
@@ -116,6 +118,8 @@ bool Object::write(const uint16_t& member, uint16_t val)
     m_updateMask.SetBit(distance);
     m_updateMask.SetBit(distance + 1);
 
+    ++m_valuesGeneration;
+
     if (!skipping_updates)
         updateObject();
 
@@ -136,6 +140,8 @@ bool Object::write(const float& member, float val)
 
     m_updateMask.SetBit(distance);
 
+    ++m_valuesGeneration;
+
     if (!skipping_updates)
         updateObject();
 
@@ -156,6 +162,8 @@ bool Object::write(const int32_t& member, int32_t val)
 
     m_updateMask.SetBit(distance);
 
+    ++m_valuesGeneration;
+
     if (!skipping_updates)
         updateObject();
 
@@ -176,6 +184,8 @@ bool Object::write(const uint32_t& member, uint32_t val)
 
     m_updateMask.SetBit(distance);
 
+    ++m_valuesGeneration;
+
     if (!skipping_updates)
         updateObject();
 
@@ -197,6 +207,8 @@ bool Object::write(const uint64_t& member, uint64_t val)
     m_updateMask.SetBit(distance);
     m_updateMask.SetBit(distance + 1);
 
+    ++m_valuesGeneration;
+
     if (!skipping_updates)
         updateObject();
 
@@ -217,6 +229,8 @@ bool Object::writeLow(const uint64_t& member, uint32_t val)
 
     m_updateMask.SetBit(distance);
 
+    ++m_valuesGeneration;
+
     if (!skipping_updates)
         updateObject();
 
@@ -237,6 +251,8 @@ bool Object::writeHigh(const uint64_t& member, uint32_t val)
 
     m_updateMask.SetBit(distance + 1);
 
+    ++m_valuesGeneration;
+
     if (!skipping_updates)
         updateObject();
 
@@ -262,6 +278,8 @@ bool Object::write(const uint64_t& member, uint32_t low, uint32_t high)
     m_updateMask.SetBit(distance);
     m_updateMask.SetBit(distance + 1);
 
+    ++m_valuesGeneration;
+
     if (!skipping_updates)
         updateObject();
 
@@ -382,6 +400,15 @@ uint32_t Object::buildCreateUpdateBlockForPlayer(ByteBuffer* data, Player* targe
     if (target == nullptr)
         return 0;
 
+    const bool isViewerIndependent = isCreateBlockViewerIndependent(target);
+    if (isViewerIndependent && hasValidCreateBlockCache())
+    {
+        data->append(m_createBlockCache.data.data(), m_createBlockCache.data.size());
+        return 1;
+    }
+
+    const size_t blockStart = data->wpos();
+
     uint8_t updateType = UPDATETYPE_CREATE_OBJECT;
 #if VERSION_STRING <= TBC
     uint8_t updateFlags = static_cast<uint8_t>(m_updateFlag);
@@ -488,10 +515,65 @@ uint32_t Object::buildCreateUpdateBlockForPlayer(ByteBuffer* data, Player* targe
 #if VERSION_STRING == Mop
     *data << uint8_t(0);
 #endif
+
+    if (isViewerIndependent && m_mapMgr != nullptr)
+    {
+        m_createBlockCache.data.assign(data->contents() + blockStart, data->contents() + data->wpos());
+        m_createBlockCache.mapMgr = m_mapMgr;
+        m_createBlockCache.mapUpdate = m_mapMgr->mLoopCounter;
+        m_createBlockCache.valuesGeneration = m_valuesGeneration;
+        m_createBlockCache.position = m_position;
+        m_createBlockCache.isValid = true;
+    }
+
     // Update count
     return 1;
 }
 
+bool Object::isCreateBlockViewerIndependent(Player* target)
+{
+    if (target == this)
+        return false;
+
+    switch (m_objectTypeId)
+    {
+        case TYPEID_UNIT:
+        {
+            // tagged creatures show different loot flags to every player
+            const auto creature = static_cast<Creature*>(this);
+            return !(creature->isTagged() && !creature->loot.isLooted());
+        }
+        case TYPEID_GAMEOBJECT:
+        {
+            // quest objects sparkle only for players who need them
+            const auto gameObject = static_cast<GameObject*>(this);
+            if (gameObject->isQuestGiver())
+                return false;
+
+            if (const auto properties = gameObject->GetGameObjectProperties())
+                return properties->goMap.empty() && properties->itemMap.empty();
+
+            return true;
+        }
+        case TYPEID_DYNAMICOBJECT:
+            return true;
+        default:
+            // players set their create bits depending on the target
+            return false;
+    }
+}
+
+bool Object::hasValidCreateBlockCache()
+{
+    // the movement block contains timestamps, so the cache is only valid for one map update
+    return m_createBlockCache.isValid
+        && m_mapMgr != nullptr
+        && m_createBlockCache.mapMgr == m_mapMgr
+        && m_createBlockCache.mapUpdate == m_mapMgr->mLoopCounter
+        && m_createBlockCache.valuesGeneration == m_valuesGeneration
+        && m_createBlockCache.position == m_position;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Object Type Id
 uint8_t Object::getObjectTypeId() const { return m_objectTypeId; }
@@ -1445,29 +1527,26 @@ void Object::addToInRangeObjects(Object* pObj)
         sLogger.failure("We are in range of ourselves!");
 
     if (pObj->isPlayer())
-        mInRangePlayersSet.push_back(pObj);
+        mInRangePlayersSet.insert(pObj);
 
-    mInRangeObjectsSet.push_back(pObj);
+    mInRangeObjectsSet.insert(pObj);
 }
 
 void Object::removeSelfFromInrangeSets()
 {
-    for (const auto& itr : mInRangeObjectsSet)
-    {
-        if (itr)
-            itr->removeObjectFromInRangeObjectsSet(this);
-    }
+    for (const auto& itr : mInRangeObjectsSet.view())
+        itr->removeObjectFromInRangeObjectsSet(this);
 }
 
 // Objects
-std::vector<Object*> Object::getInRangeObjectsSet()
+Object::InRangeSet::View Object::getInRangeObjectsSet()
 {
-    return mInRangeObjectsSet;
+    return mInRangeObjectsSet.view();
 }
 
 bool Object::hasInRangeObjects()
 {
-    return mInRangeObjectsSet.size() > 0;
+    return !mInRangeObjectsSet.empty();
 }
 
 size_t Object::getInRangeObjectsCount()
@@ -1477,26 +1556,17 @@ size_t Object::getInRangeObjectsCount()
 
 bool Object::isObjectInInRangeObjectsSet(Object* pObj)
 {
-    // Do not use std::find here - if something is added to or removed from the in range vector at the same time
-    // the std::find causes a crash because vector iterator is out of range.
-    // Tested with transports and gameobjects -Appled
-    for (const auto& inRangeObj : mInRangeObjectsSet)
-    {
-        if (inRangeObj == pObj)
-            return true;
-    }
-
-    return false;
+    return mInRangeObjectsSet.contains(pObj);
 }
 
 void Object::removeObjectFromInRangeObjectsSet(Object* pObj)
 {
     if (pObj != nullptr)
     {
-        if (pObj->isPlayer())
-            mInRangePlayersSet.erase(std::remove(mInRangePlayersSet.begin(), mInRangePlayersSet.end(), pObj), mInRangePlayersSet.end());
-
-        mInRangeObjectsSet.erase(std::remove(mInRangeObjectsSet.begin(), mInRangeObjectsSet.end(), pObj), mInRangeObjectsSet.end());
+        mInRangeObjectsSet.erase(pObj);
+        mInRangePlayersSet.erase(pObj);
+        mInRangeOppositeFactionSet.erase(pObj);
+        mInRangeSameFactionSet.erase(pObj);
 
         onRemoveInRangeObject(pObj);
     }
@@ -1507,9 +1577,9 @@ void Object::removeObjectFromInRangeObjectsSet(Object* pObj)
 }
 
 // Players
-std::vector<Object*> Object::getInRangePlayersSet()
+Object::InRangeSet::View Object::getInRangePlayersSet()
 {
-    return mInRangePlayersSet;
+    return mInRangePlayersSet.view();
 }
 
 size_t Object::getInRangePlayersCount()
@@ -1518,107 +1588,86 @@ size_t Object::getInRangePlayersCount()
 }
 
 // Opposite Faction
-std::vector<Object*> Object::getInRangeOppositeFactionSet()
+Object::InRangeSet::View Object::getInRangeOppositeFactionSet()
 {
-    return mInRangeOppositeFactionSet;
+    return mInRangeOppositeFactionSet.view();
 }
 
 bool Object::isObjectInInRangeOppositeFactionSet(Object* pObj)
 {
-    auto it = std::find(mInRangeOppositeFactionSet.begin(), mInRangeOppositeFactionSet.end(), pObj);
-    return it != mInRangeOppositeFactionSet.end();
+    return mInRangeOppositeFactionSet.contains(pObj);
 }
 
 void Object::updateInRangeOppositeFactionSet()
 {
-    mInRangeOppositeFactionSet.clear();
-
-    for (const auto& itr : mInRangeObjectsSet)
+    // only the objects whose hostility changed are moved, both sides are kept in sync
+    for (const auto& itr : mInRangeObjectsSet.view())
     {
-        if (itr)
+        if (!itr->isCreatureOrPlayer() && !itr->isGameObject())
+            continue;
+
+        if (isHostile(this, itr))
         {
-            if (itr->isCreatureOrPlayer() || itr->isGameObject())
-            {
-                if (isHostile(this, itr))
-                {
-                    if (!itr->isObjectInInRangeOppositeFactionSet(this))
-                        itr->mInRangeOppositeFactionSet.push_back(this);
-                    if (!isObjectInInRangeOppositeFactionSet(itr))
-                        mInRangeOppositeFactionSet.push_back(itr);
-                }
-                else
-                {
-                    if (itr->isObjectInInRangeOppositeFactionSet(this))
-                        itr->mInRangeOppositeFactionSet.erase(std::remove(itr->mInRangeOppositeFactionSet.begin(), itr->mInRangeOppositeFactionSet.end(), this), itr->mInRangeOppositeFactionSet.end());
-                    if (isObjectInInRangeOppositeFactionSet(itr))
-                        mInRangeOppositeFactionSet.erase(std::remove(mInRangeOppositeFactionSet.begin(), mInRangeOppositeFactionSet.end(), itr), mInRangeOppositeFactionSet.end());
-                }
-            }
+            itr->mInRangeOppositeFactionSet.insert(this);
+            mInRangeOppositeFactionSet.insert(itr);
+        }
+        else
+        {
+            itr->mInRangeOppositeFactionSet.erase(this);
+            mInRangeOppositeFactionSet.erase(itr);
         }
     }
 }
 
 void Object::addInRangeOppositeFaction(Object* obj)
 {
-    mInRangeOppositeFactionSet.push_back(obj);
+    mInRangeOppositeFactionSet.insert(obj);
 }
 
 void Object::removeObjectFromInRangeOppositeFactionSet(Object* obj)
 {
-    mInRangeOppositeFactionSet.erase(std::remove(mInRangeOppositeFactionSet.begin(), mInRangeOppositeFactionSet.end(), obj), mInRangeOppositeFactionSet.end());
+    mInRangeOppositeFactionSet.erase(obj);
 }
 
 // Same Faction
-std::vector<Object*> Object::getInRangeSameFactionSet()
+Object::InRangeSet::View Object::getInRangeSameFactionSet()
 {
-    return mInRangeSameFactionSet;
+    return mInRangeSameFactionSet.view();
 }
 
 bool Object::isObjectInInRangeSameFactionSet(Object* pObj)
 {
-    auto it = std::find(mInRangeSameFactionSet.begin(), mInRangeSameFactionSet.end(), pObj);
-    return it != mInRangeSameFactionSet.end();
+    return mInRangeSameFactionSet.contains(pObj);
 }
 
 void Object::updateInRangeSameFactionSet()
 {
-    mInRangeSameFactionSet.clear();
-
-    for (const auto& itr : mInRangeObjectsSet)
+    for (const auto& itr : mInRangeObjectsSet.view())
     {
-        if (itr)
-        {
-            if (itr->isCreatureOrPlayer() || itr->isGameObject())
-            {
-                if (isFriendly(this, itr))
-                {
-                    if (!itr->isObjectInInRangeSameFactionSet(this))
-                        itr->mInRangeSameFactionSet.push_back(this);
-
-                    if (!isObjectInInRangeOppositeFactionSet(itr))
-                        mInRangeSameFactionSet.push_back(itr);
-                }
-                else
-                {
-                    if (itr->isObjectInInRangeSameFactionSet(this))
-                        itr->mInRangeSameFactionSet.erase(std::remove(itr->mInRangeSameFactionSet.begin(), itr->mInRangeSameFactionSet.end(), this), itr->mInRangeSameFactionSet.end());
+        if (!itr->isCreatureOrPlayer() && !itr->isGameObject())
+            continue;
 
-                    if (isObjectInInRangeSameFactionSet(itr))
-                        mInRangeSameFactionSet.erase(std::remove(mInRangeSameFactionSet.begin(), mInRangeSameFactionSet.end(), itr), mInRangeSameFactionSet.end());
-                }
-            }
+        if (isFriendly(this, itr))
+        {
+            itr->mInRangeSameFactionSet.insert(this);
+            mInRangeSameFactionSet.insert(itr);
+        }
+        else
+        {
+            itr->mInRangeSameFactionSet.erase(this);
+            mInRangeSameFactionSet.erase(itr);
         }
     }
 }
 
 void Object::addInRangeSameFaction(Object* obj)
 {
-    mInRangeSameFactionSet.push_back(obj);
+    mInRangeSameFactionSet.insert(obj);
 }
 
 void Object::removeObjectFromInRangeSameFactionSet(Object* obj)
 {
-    mInRangeSameFactionSet.erase(std::remove(mInRangeSameFactionSet.begin(), mInRangeSameFactionSet.end(), obj), mInRangeSameFactionSet.end());
+    mInRangeSameFactionSet.erase(obj);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -3721,9 +3770,6 @@ void Object::Deactivate(MapMgr* mgr)
     switch (m_objectTypeId)
     {
     case TYPEID_UNIT:
-        // check iterator
-        if (mgr->creature_iterator != mgr->activeCreatures.end() && (*mgr->creature_iterator)->getGuid() == getGuid())
-            ++mgr->creature_iterator;
         mgr->activeCreatures.erase(static_cast<Creature*>(this));
         break;
 
@@ -3827,7 +3873,7 @@ void Object::OutPacketToSet(uint16 Opcode, uint16 Len, const void* Data, bool /*
         return;
 
     // We are on Object level, which means we can't send it to ourselves so we only send to Players inrange
-    for (const auto& itr : mInRangePlayersSet)
+    for (const auto& itr : mInRangePlayersSet.view())
     {
         if (itr)
             itr->OutPacket(Opcode, Len, Data);
@@ -3840,7 +3886,7 @@ void Object::SendMessageToSet(WorldPacket* data, bool /*bToSelf*/, bool /*myteam
         return;
 
     uint32 myphase = GetPhase();
-    for (const auto& itr : mInRangePlayersSet)
+    for (const auto& itr : mInRangePlayersSet.view())
     {
         if (itr && (itr->GetPhase() & myphase) != 0)
             itr->SendPacket(data);
@@ -3850,7 +3896,7 @@ void Object::SendMessageToSet(WorldPacket* data, bool /*bToSelf*/, bool /*myteam
 void Object::SendCreatureChatMessageInRange(Creature* creature, uint32_t textId, Unit* target/* = nullptr*/)
 {
     uint32 myphase = GetPhase();
-    for (const auto& itr : mInRangePlayersSet)
+    for (const auto& itr : mInRangePlayersSet.view())
     {
         Object* object = itr;
         if (object && (object->GetPhase() & myphase) != 0)
@@ -8,10 +8,12 @@ This file is released under the MIT license. See README-MIT for more information
 #include "ObjectDefines.h"
 #include "Server/UpdateMask.h"
 #include "CommonTypes.hpp"
+#include "StableSet.hpp"
 #include "Server/EventableObject.h"
 
 #include <set>
 #include <map>
+#include <vector>
 
 #include "WoWGuid.h"
 #include <LocationVector.h>
@@ -148,6 +150,9 @@ protected:
 
     bool skipping_updates = false;
 
+    // increased on every value change, used to invalidate the create block cache
+    uint32_t m_valuesGeneration = 0;
+
     const WoWObject* objectData() const { return wow_data; }
 
 public:
@@ -197,6 +202,22 @@ public:
     //! This includes any nested objects we have, inventory for example.
     virtual uint32_t buildCreateUpdateBlockForPlayer(ByteBuffer* data, Player* target);
 
+private:
+    // The create block of most creatures and gameobjects is the same for every player.
+    // It is built once per map update and copied for every other player that sees us in that update.
+    struct CreateBlockCache
+    {
+        std::vector<uint8_t> data;
+        MapMgr* mapMgr = nullptr;
+        uint32_t mapUpdate = 0;
+        uint32_t valuesGeneration = 0;
+        LocationVector position;
+        bool isValid = false;
+    } m_createBlockCache;
+
+    bool isCreateBlockViewerIndependent(Player* target);
+    bool hasValidCreateBlockCache();
+
     //////////////////////////////////////////////////////////////////////////////////////////
     // Object Type Id
 protected:
@@ -265,11 +286,16 @@ public:
 
     //////////////////////////////////////////////////////////////////////////////////////////
     // InRange sets
+    // The getters return views on the sets, objects can be added and removed while a view is iterated.
+    // A view must not outlive the object.
+public:
+    typedef StableSet<Object*> InRangeSet;
+
 private:
-    std::vector<Object*> mInRangeObjectsSet;
-    std::vector<Object*> mInRangePlayersSet;
-    std::vector<Object*> mInRangeOppositeFactionSet;
-    std::vector<Object*> mInRangeSameFactionSet;
+    InRangeSet mInRangeObjectsSet;
+    InRangeSet mInRangePlayersSet;
+    InRangeSet mInRangeOppositeFactionSet;
+    InRangeSet mInRangeSameFactionSet;
 
 public:
     // general
@@ -280,7 +306,7 @@ public:
     void removeSelfFromInrangeSets();
 
     // Objects
-    std::vector<Object*> getInRangeObjectsSet();
+    InRangeSet::View getInRangeObjectsSet();
 
     bool hasInRangeObjects();
     size_t getInRangeObjectsCount();
@@ -289,11 +315,11 @@ public:
     void removeObjectFromInRangeObjectsSet(Object* pObj);
 
     // Players
-    std::vector<Object*> getInRangePlayersSet();
+    InRangeSet::View getInRangePlayersSet();
     size_t getInRangePlayersCount();
 
     // Opposite Faction
-    std::vector<Object*> getInRangeOppositeFactionSet();
+    InRangeSet::View getInRangeOppositeFactionSet();
 
     bool isObjectInInRangeOppositeFactionSet(Object* pObj);
     void updateInRangeOppositeFactionSet();
@@ -302,7 +328,7 @@ public:
     void removeObjectFromInRangeOppositeFactionSet(Object* obj);
 
     // same faction
-    std::vector<Object*> getInRangeSameFactionSet();
+    InRangeSet::View getInRangeSameFactionSet();
 
     bool isObjectInInRangeSameFactionSet(Object* pObj);
     void updateInRangeSameFactionSet();
@@ -637,6 +663,8 @@ public:
         virtual bool CanActivate();
         virtual void Activate(MapMgr* mgr);
         virtual void Deactivate(MapMgr* mgr);
+        // position of the last full in-range scan, see MapMgr::ChangeObjectLocation
+        LocationVector m_lastInRangeScanPosition;
         // Player is in pvp queue.
         bool m_inQueue = false;
         void SetMapMgr(MapMgr* mgr) { m_mapMgr = mgr; }
@@ -42,11 +42,13 @@
 #include "Chat/ChannelMgr.hpp"
 #include "Management/Battleground/Battleground.h"
 #include "Management/ArenaTeam.h"
+#include "Management/ObjectUpdates/UpdateCompressor.hpp"
 #include "Server/LogonCommClient/LogonCommHandler.h"
 #include "Storage/MySQLDataStore.hpp"
 #include "Storage/MySQLStructures.h"
 #include "Server/Warden/SpeedDetector.h"
 #include "Server/MainServerDefines.h"
+#include "Server/CharacterDatabaseStatements.hpp"
 #include "Map/Area/AreaManagementGlobals.hpp"
 #include "Map/Area/AreaStorage.hpp"
 #include "Map/MapMgr.h"
@@ -2054,10 +2056,14 @@ void Player::_SaveQuestLogEntry(QueryBuffer* buf)
 {
     for (uint32_t removeableQuestId : m_removequests)
     {
+        PreparedStatement* statement = CharacterDatabase.getPreparedStatement(CHARACTER_DEL_QUESTLOG);
+        statement->setUInt32(0, getGuidLow());
+        statement->setUInt32(1, removeableQuestId);
+
         if (buf == nullptr)
-            CharacterDatabase.Execute("DELETE FROM questlog WHERE player_guid=%u AND quest_id=%u", getGuidLow(), removeableQuestId);
+            CharacterDatabase.executePreparedAsync(statement);
         else
-            buf->AddQuery("DELETE FROM questlog WHERE player_guid=%u AND quest_id=%u", getGuidLow(), removeableQuestId);
+            buf->addPreparedStatement(statement);
     }
 
     m_removequests.clear();
@@ -5834,70 +5840,22 @@ void Player::ClearCooldownsOnLine(uint32 skill_line, uint32 called_from)
 
 bool Player::CompressAndSendUpdateBuffer(uint32 size, const uint8* update_buffer)
 {
-    uint32 destsize = size + size / 10 + 16;
     int rate = worldConfig.getIntRate(INTRATE_COMPRESSION);
     if (size >= 40000 && rate < 6)
         rate = 6;
 
-    // set up stream
-    z_stream stream;
-    stream.zalloc = nullptr;
-    stream.zfree = nullptr;
-    stream.opaque = nullptr;
-
-    if (deflateInit(&stream, rate) != Z_OK)
-    {
-        sLogger.failure("deflateInit failed.");
+    uint32_t compressedSize;
+    const uint8_t* buffer = sUpdateCompressor.compress(update_buffer, size, rate, compressedSize);
+    if (buffer == nullptr)
         return false;
-    }
-
-    uint8* buffer = new uint8[destsize];
-
-    // set up stream pointers
-    stream.next_out = (Bytef*)buffer + 4;
-    stream.avail_out = destsize;
-    stream.next_in = (Bytef*)update_buffer;
-    stream.avail_in = size;
-
-    // call the actual process
-    if (deflate(&stream, Z_NO_FLUSH) != Z_OK ||
-        stream.avail_in != 0)
-    {
-        sLogger.failure("deflate failed.");
-        delete[] buffer;
-        return false;
-    }
-
-    // finish the deflate
-    if (deflate(&stream, Z_FINISH) != Z_STREAM_END)
-    {
-        sLogger.failure("deflate failed: did not end stream");
-        delete[] buffer;
-        return false;
-    }
-
-    // finish up
-    if (deflateEnd(&stream) != Z_OK)
-    {
-        sLogger.failure("deflateEnd failed.");
-        delete[] buffer;
-        return false;
-    }
-
-    // fill in the full size of the compressed stream
-
-    *(uint32*)&buffer[0] = size;
 
     // send it
 #if VERSION_STRING < Cata
-    m_session->OutPacket(SMSG_COMPRESSED_UPDATE_OBJECT, (uint16)stream.total_out + 4, buffer);
+    m_session->OutPacket(SMSG_COMPRESSED_UPDATE_OBJECT, static_cast<uint16_t>(compressedSize), buffer);
 #else
-    m_session->OutPacket(SMSG_UPDATE_OBJECT, (uint16)stream.total_out + 4, buffer);
+    m_session->OutPacket(SMSG_UPDATE_OBJECT, static_cast<uint16_t>(compressedSize), buffer);
 #endif
 
-    // cleanup memory
-    delete[] buffer;
-
     return true;
 }
 
@@ -8511,10 +8469,13 @@ void Player::_SavePlayerCooldowns(QueryBuffer* buf)
     uint32 mstime = Util::getMSTime();
 
     // clear them (this should be replaced with an update queue later)
+    PreparedStatement* deleteStatement = CharacterDatabase.getPreparedStatement(CHARACTER_DEL_PLAYERCOOLDOWNS);
+    deleteStatement->setUInt32(0, getGuidLow());
+
     if (buf != nullptr)
-        buf->AddQuery("DELETE FROM playercooldowns WHERE player_guid = %u", getGuidLow());        // 0 is guid always
+        buf->addPreparedStatement(deleteStatement);
     else
-        CharacterDatabase.Execute("DELETE FROM playercooldowns WHERE player_guid = %u", getGuidLow());        // 0 is guid always
+        CharacterDatabase.executePreparedAsync(deleteStatement);
 
     for (uint32 i = 0; i < NUM_COOLDOWN_TYPES; ++i)
     {
@@ -8541,16 +8502,18 @@ void Player::_SavePlayerCooldowns(QueryBuffer* buf)
             uint32 seconds = (itr2->second.ExpireTime - mstime) / 1000;
             // this shouldn't ever be nonzero because of our check before, so no check needed
 
+            PreparedStatement* insertStatement = CharacterDatabase.getPreparedStatement(CHARACTER_INS_PLAYERCOOLDOWN);
+            insertStatement->setUInt32(0, getGuidLow());
+            insertStatement->setUInt32(1, i);
+            insertStatement->setUInt32(2, itr2->first);
+            insertStatement->setUInt32(3, seconds + (uint32)UNIXTIME);
+            insertStatement->setUInt32(4, itr2->second.SpellId);
+            insertStatement->setUInt32(5, itr2->second.ItemId);
+
             if (buf != nullptr)
-            {
-                buf->AddQuery("INSERT INTO playercooldowns VALUES(%u, %u, %u, %u, %u, %u)", getGuidLow(),
-                              i, itr2->first, seconds + (uint32)UNIXTIME, itr2->second.SpellId, itr2->second.ItemId);
-            }
+                buf->addPreparedStatement(insertStatement);
             else
-            {
-                CharacterDatabase.Execute("INSERT INTO playercooldowns VALUES(%u, %u, %u, %u, %u, %u)", getGuidLow(),
-                                          i, itr2->first, seconds + (uint32)UNIXTIME, itr2->second.SpellId, itr2->second.ItemId);
-            }
+                CharacterDatabase.executePreparedAsync(insertStatement);
         }
     }
 }
@@ -9516,33 +9479,29 @@ bool Player::SaveReputations(bool NewCharacter, QueryBuffer *buf)
     if (!NewCharacter && (buf == nullptr))
         return false;
 
-    std::stringstream ds;
     uint32 guid = getGuidLow();
 
-    ds << "DELETE FROM playerreputations WHERE guid = '";
-    ds << guid;
-    ds << "';";
+    PreparedStatement* deleteStatement = CharacterDatabase.getPreparedStatement(CHARACTER_DEL_PLAYERREPUTATIONS);
+    deleteStatement->setUInt32(0, guid);
 
     if (!NewCharacter)
-        buf->AddQueryStr(ds.str());
+        buf->addPreparedStatement(deleteStatement);
     else
-        CharacterDatabase.ExecuteNA(ds.str().c_str());
+        CharacterDatabase.executePreparedAsync(deleteStatement);
 
     for (ReputationMap::iterator itr = m_reputation.begin(); itr != m_reputation.end(); ++itr)
     {
-        std::stringstream ss;
-
-        ss << "INSERT INTO playerreputations VALUES('";
-        ss << getGuidLow() << "','";
-        ss << itr->first << "','";
-        ss << uint32(itr->second->flag) << "','";
-        ss << itr->second->baseStanding << "','";
-        ss << itr->second->standing << "');";
+        PreparedStatement* insertStatement = CharacterDatabase.getPreparedStatement(CHARACTER_INS_PLAYERREPUTATION);
+        insertStatement->setUInt32(0, guid);
+        insertStatement->setUInt32(1, itr->first);
+        insertStatement->setUInt32(2, uint32(itr->second->flag));
+        insertStatement->setInt32(3, itr->second->baseStanding);
+        insertStatement->setInt32(4, itr->second->standing);
 
         if (!NewCharacter)
-            buf->AddQueryStr(ss.str());
+            buf->addPreparedStatement(insertStatement);
         else
-            CharacterDatabase.ExecuteNA(ss.str().c_str());
+            CharacterDatabase.executePreparedAsync(insertStatement);
     }
 
     return true;
@@ -9553,32 +9512,26 @@ bool Player::SaveSpells(bool NewCharacter, QueryBuffer* buf)
     if (!NewCharacter && buf == nullptr)
         return false;
 
-    std::stringstream ds;
     uint32 guid = getGuidLow();
 
-    ds << "DELETE FROM playerspells WHERE GUID = '";
-    ds << guid;
-    ds << "';";
+    PreparedStatement* deleteStatement = CharacterDatabase.getPreparedStatement(CHARACTER_DEL_PLAYERSPELLS);
+    deleteStatement->setUInt32(0, guid);
 
     if (!NewCharacter)
-        buf->AddQueryStr(ds.str());
+        buf->addPreparedStatement(deleteStatement);
     else
-        CharacterDatabase.ExecuteNA(ds.str().c_str());
+        CharacterDatabase.executePreparedAsync(deleteStatement);
 
     for (SpellSet::iterator itr = mSpells.begin(); itr != mSpells.end(); ++itr)
     {
-        uint32 spellid = *itr;
-
-        std::stringstream ss;
-
-        ss << "INSERT INTO playerspells VALUES('";
-        ss << guid << "','";
-        ss << spellid << "');";
+        PreparedStatement* insertStatement = CharacterDatabase.getPreparedStatement(CHARACTER_INS_PLAYERSPELL);
+        insertStatement->setUInt32(0, guid);
+        insertStatement->setUInt32(1, *itr);
 
         if (!NewCharacter)
-            buf->AddQueryStr(ss.str());
+            buf->addPreparedStatement(insertStatement);
         else
-            CharacterDatabase.ExecuteNA(ss.str().c_str());
+            CharacterDatabase.executePreparedAsync(insertStatement);
     }
 
     return true;
@@ -9609,32 +9562,26 @@ bool Player::SaveDeletedSpells(bool NewCharacter, QueryBuffer* buf)
     if (!NewCharacter && buf == nullptr)
         return false;
 
-    std::stringstream ds;
     uint32 guid = getGuidLow();
 
-    ds << "DELETE FROM playerdeletedspells WHERE GUID = '";
-    ds << guid;
-    ds << "';";
+    PreparedStatement* deleteStatement = CharacterDatabase.getPreparedStatement(CHARACTER_DEL_PLAYERDELETEDSPELLS);
+    deleteStatement->setUInt32(0, guid);
 
     if (!NewCharacter)
-        buf->AddQueryStr(ds.str());
+        buf->addPreparedStatement(deleteStatement);
     else
-        CharacterDatabase.ExecuteNA(ds.str().c_str());
+        CharacterDatabase.executePreparedAsync(deleteStatement);
 
     for (SpellSet::iterator itr = mDeletedSpells.begin(); itr != mDeletedSpells.end(); ++itr)
     {
-        uint32 spellid = *itr;
-
-        std::stringstream ss;
-
-        ss << "INSERT INTO playerdeletedspells VALUES('";
-        ss << guid << "','";
-        ss << spellid << "');";
+        PreparedStatement* insertStatement = CharacterDatabase.getPreparedStatement(CHARACTER_INS_PLAYERDELETEDSPELL);
+        insertStatement->setUInt32(0, guid);
+        insertStatement->setUInt32(1, *itr);
 
         if (!NewCharacter)
-            buf->AddQueryStr(ss.str());
+            buf->addPreparedStatement(insertStatement);
         else
-            CharacterDatabase.ExecuteNA(ss.str().c_str());
+            CharacterDatabase.executePreparedAsync(insertStatement);
     }
 
     return true;
@@ -9674,17 +9621,15 @@ bool Player::SaveSkills(bool NewCharacter, QueryBuffer* buf)
     if (!NewCharacter && buf == nullptr)
         return false;
 
-    std::stringstream ds;
     uint32 guid = getGuidLow();
 
-    ds << "DELETE FROM playerskills WHERE GUID = '";
-    ds << guid;
-    ds << "';";
+    PreparedStatement* deleteStatement = CharacterDatabase.getPreparedStatement(CHARACTER_DEL_PLAYERSKILLS);
+    deleteStatement->setUInt32(0, guid);
 
     if (!NewCharacter)
-        buf->AddQueryStr(ds.str());
+        buf->addPreparedStatement(deleteStatement);
     else
-        CharacterDatabase.ExecuteNA(ds.str().c_str());
+        CharacterDatabase.executePreparedAsync(deleteStatement);
 
     for (SkillMap::iterator itr = m_skills.begin(); itr != m_skills.end(); ++itr)
     {
@@ -9700,18 +9645,16 @@ bool Player::SaveSkills(bool NewCharacter, QueryBuffer* buf)
         if (currval == 0)
             continue;
 
-        std::stringstream ss;
-
-        ss << "INSERT INTO playerskills VALUES('";
-        ss << guid << "','";
-        ss << skillid << "','";
-        ss << currval << "','";
-        ss << maxval << "');";
+        PreparedStatement* insertStatement = CharacterDatabase.getPreparedStatement(CHARACTER_INS_PLAYERSKILL);
+        insertStatement->setUInt32(0, guid);
+        insertStatement->setUInt32(1, skillid);
+        insertStatement->setUInt32(2, currval);
+        insertStatement->setUInt32(3, maxval);
 
         if (!NewCharacter)
-            buf->AddQueryStr(ss.str());
+            buf->addPreparedStatement(insertStatement);
         else
-            CharacterDatabase.ExecuteNA(ss.str().c_str());
+            CharacterDatabase.executePreparedAsync(insertStatement);
     }
 
     return true;
@@ -10963,7 +10906,7 @@ void Player::UpdateInrangeSetsBasedOnReputation()
         if (rep_value && !enemy_current)   // We are now enemies.
             addInRangeOppositeFaction(pUnit);
         else if (!rep_value && enemy_current)
-            addInRangeOppositeFaction(pUnit);
+            removeObjectFromInRangeOppositeFactionSet(pUnit);
     }
 }
 
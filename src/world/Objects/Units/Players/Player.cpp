@@ -57,6 +57,7 @@ This file is released under the MIT license. See README-MIT for more information
 #include "Server/Packets/SmsgClearCooldown.h"
 #include "Server/Packets/SmsgLootReleaseResponse.h"
 #include "Server/Packets/SmsgLootRemoved.h"
+#include "Server/CharacterDatabaseStatements.hpp"
 #include "Server/World.h"
 #include "Server/WorldSocket.h"
 #include "Server/Packets/SmsgContactList.h"
@@ -2789,11 +2790,16 @@ void Player::setTutorialValueForId(uint8_t id, uint32_t value)
 
 void Player::loadTutorials()
 {
-    if (auto result = CharacterDatabase.Query("SELECT * FROM tutorials WHERE playerId = %u", getGuidLow()))
+    PreparedStatement* statement = CharacterDatabase.getPreparedStatement(CHARACTER_SEL_TUTORIALS);
+    statement->setUInt32(0, getGuidLow());
+
+    if (auto result = CharacterDatabase.queryPrepared(statement))
     {
         auto* const fields = result->Fetch();
         for (uint8_t id = 0; id < 8; ++id)
-            m_Tutorials[id] = fields[id + 1].GetUInt32();
+            m_Tutorials[id] = fields[id].GetUInt32();
+
+        delete result;
     }
     tutorialsDirty = false;
 }
@@ -2802,8 +2808,16 @@ void Player::saveTutorials()
 {
     if (tutorialsDirty)
     {
-        CharacterDatabase.Execute("DELETE FROM tutorials WHERE playerid = %u;", getGuidLow());
-        CharacterDatabase.Execute("INSERT INTO tutorials VALUES('%u','%u','%u','%u','%u','%u','%u','%u','%u');", getGuidLow(), m_Tutorials[0], m_Tutorials[1], m_Tutorials[2], m_Tutorials[3], m_Tutorials[4], m_Tutorials[5], m_Tutorials[6], m_Tutorials[7]);
+        PreparedStatement* deleteStatement = CharacterDatabase.getPreparedStatement(CHARACTER_DEL_TUTORIALS);
+        deleteStatement->setUInt32(0, getGuidLow());
+        CharacterDatabase.executePreparedAsync(deleteStatement);
+
+        PreparedStatement* insertStatement = CharacterDatabase.getPreparedStatement(CHARACTER_INS_TUTORIALS);
+        insertStatement->setUInt32(0, getGuidLow());
+        for (uint8_t id = 0; id < 8; ++id)
+            insertStatement->setUInt32(id + 1, m_Tutorials[id]);
+
+        CharacterDatabase.executePreparedAsync(insertStatement);
 
         tutorialsDirty = false;
     }
@@ -8241,7 +8241,7 @@ void Unit::RemoveFromWorld(bool free_guid)
     RemoveAllAreaAuraByOther();
 
     // Attempt to prevent memory corruption
-    for (auto& obj : getInRangeObjectsSet())
+    for (auto obj : getInRangeObjectsSet())
     {
         if (!obj->isCreatureOrPlayer())
             continue;
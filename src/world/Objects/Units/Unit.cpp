@@ -1346,7 +1346,7 @@ void Unit::combatResetPvPTimeout()
         {
             if (!itr->second->deleted)
             {
-                itr->second->currTime = 5000;
+                event_SetTimeLeft(itr->second, 5000);
                 m_lock.Release();
                 return;
             }
@@ -6480,9 +6480,6 @@ void Unit::addToInRangeObjects(Object* pObj)
 
 void Unit::onRemoveInRangeObject(Object* pObj)
 {
-    removeObjectFromInRangeOppositeFactionSet(pObj);
-    removeObjectFromInRangeSameFactionSet(pObj);
-
     if (pObj->isCreatureOrPlayer())
     {
         if (getCharmGuid() == pObj->getGuid())
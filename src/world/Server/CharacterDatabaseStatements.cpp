@@ -0,0 +1,33 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#include "CharacterDatabaseStatements.hpp"
+
+#include "Database/Database.h"
+
+void registerCharacterDatabaseStatements(Database& database)
+{
+    database.registerPreparedStatement(CHARACTER_DEL_PLAYERITEM, "DELETE FROM playeritems WHERE guid = ?");
+    database.registerPreparedStatement(CHARACTER_INS_PLAYERITEM, "INSERT INTO playeritems VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+
+    database.registerPreparedStatement(CHARACTER_REP_QUESTLOG, "REPLACE INTO questlog VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    database.registerPreparedStatement(CHARACTER_DEL_QUESTLOG, "DELETE FROM questlog WHERE player_guid = ? AND quest_id = ?");
+
+    database.registerPreparedStatement(CHARACTER_DEL_PLAYERCOOLDOWNS, "DELETE FROM playercooldowns WHERE player_guid = ?");
+    database.registerPreparedStatement(CHARACTER_INS_PLAYERCOOLDOWN, "INSERT INTO playercooldowns VALUES(?, ?, ?, ?, ?, ?)");
+
+    database.registerPreparedStatement(CHARACTER_DEL_PLAYERSKILLS, "DELETE FROM playerskills WHERE GUID = ?");
+    database.registerPreparedStatement(CHARACTER_INS_PLAYERSKILL, "INSERT INTO playerskills VALUES(?, ?, ?, ?)");
+    database.registerPreparedStatement(CHARACTER_DEL_PLAYERSPELLS, "DELETE FROM playerspells WHERE GUID = ?");
+    database.registerPreparedStatement(CHARACTER_INS_PLAYERSPELL, "INSERT INTO playerspells VALUES(?, ?)");
+    database.registerPreparedStatement(CHARACTER_DEL_PLAYERDELETEDSPELLS, "DELETE FROM playerdeletedspells WHERE GUID = ?");
+    database.registerPreparedStatement(CHARACTER_INS_PLAYERDELETEDSPELL, "INSERT INTO playerdeletedspells VALUES(?, ?)");
+    database.registerPreparedStatement(CHARACTER_DEL_PLAYERREPUTATIONS, "DELETE FROM playerreputations WHERE guid = ?");
+    database.registerPreparedStatement(CHARACTER_INS_PLAYERREPUTATION, "INSERT INTO playerreputations VALUES(?, ?, ?, ?, ?)");
+
+    database.registerPreparedStatement(CHARACTER_SEL_TUTORIALS, "SELECT tut0, tut1, tut2, tut3, tut4, tut5, tut6, tut7 FROM tutorials WHERE playerId = ?");
+    database.registerPreparedStatement(CHARACTER_DEL_TUTORIALS, "DELETE FROM tutorials WHERE playerId = ?");
+    database.registerPreparedStatement(CHARACTER_INS_TUTORIALS, "INSERT INTO tutorials VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?)");
+}
@@ -0,0 +1,40 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+class Database;
+
+// Prepared statements of the character database, used by the character save and load
+enum CharacterDatabaseStatements : uint32_t
+{
+    CHARACTER_DEL_PLAYERITEM,
+    CHARACTER_INS_PLAYERITEM,
+
+    CHARACTER_REP_QUESTLOG,
+    CHARACTER_DEL_QUESTLOG,
+
+    CHARACTER_DEL_PLAYERCOOLDOWNS,
+    CHARACTER_INS_PLAYERCOOLDOWN,
+
+    CHARACTER_DEL_PLAYERSKILLS,
+    CHARACTER_INS_PLAYERSKILL,
+    CHARACTER_DEL_PLAYERSPELLS,
+    CHARACTER_INS_PLAYERSPELL,
+    CHARACTER_DEL_PLAYERDELETEDSPELLS,
+    CHARACTER_INS_PLAYERDELETEDSPELL,
+    CHARACTER_DEL_PLAYERREPUTATIONS,
+    CHARACTER_INS_PLAYERREPUTATION,
+
+    CHARACTER_SEL_TUTORIALS,
+    CHARACTER_DEL_TUTORIALS,
+    CHARACTER_INS_TUTORIALS,
+
+    MAX_CHARACTER_DATABASE_STATEMENTS
+};
+
+void registerCharacterDatabaseStatements(Database& database);
@@ -12,8 +12,17 @@ This file is released under the MIT license. See README-MIT for more information
 #include "Server/MainServerDefines.h"
 #include "Server/Master.h"
 #include "crc32.h"
+#include "Logging/AsyncLogWriter.hpp"
 #include "Server/World.h"
 #include "Management/ObjectMgr.h"
+#include "Management/ObjectUpdates/UpdateCompressor.hpp"
+#include "Map/MapTickProfiler.hpp"
+#include "Map/MapUpdateScheduler.hpp"
+#include "Map/TerrainMgr.h"
+#include "Movement/PathCache.hpp"
+#include "Movement/PathfindingService.hpp"
+#include "Server/OpcodeTable.hpp"
+#include "Server/PacketCapture.hpp"
 #include "Server/Script/ScriptMgr.h"
 
 
@@ -152,6 +161,55 @@ bool handleServerInfoCommand(BaseConsole* baseConsole, int /*argumentCount*/, st
         baseConsole->Write("RAM Usage: %4.2f MB\r\n", sWorld.getRAMUsage());
         baseConsole->Write("SQL Query Cache Size (World): %u queries delayed\r\n", WorldDatabase.GetQueueSize());
         baseConsole->Write("SQL Query Cache Size (Character): %u queries delayed\r\n", CharacterDatabase.GetQueueSize());
+
+        if (sLogger.isAsyncModeEnabled())
+        {
+            const AscEmu::Logging::AsyncLogStats logStats = sLogger.getAsyncStats();
+            baseConsole->Write("Async Logger: %llu messages written, %llu dropped, %llu waited for a full buffer, %u logging threads\r\n",
+                static_cast<unsigned long long>(logStats.written), static_cast<unsigned long long>(logStats.dropped),
+                static_cast<unsigned long long>(logStats.blocked), logStats.producerCount);
+        }
+
+        if (sMapUpdateScheduler.isEnabled())
+        {
+            baseConsole->Write("Map Update Workers: %u (%u maps scheduled, %u of them idle or hibernating)\r\n", sMapUpdateScheduler.getWorkerCount(),
+                sMapUpdateScheduler.getScheduledMapCount(), sMapUpdateScheduler.getSleepingMapCount());
+            baseConsole->Write("Map Ticks: %llu (%llu late, max %u ms late)\r\n", static_cast<unsigned long long>(sMapUpdateScheduler.getTickCount()),
+                static_cast<unsigned long long>(sMapUpdateScheduler.getLateTickCount()), sMapUpdateScheduler.getMaxTickLateness());
+        }
+
+        baseConsole->Write("Terrain Tiles: %u mapped (%u unused), %llu KB, %llu maps, %llu shared\r\n", sTerrainTileCache.getTileCount(),
+            sTerrainTileCache.getUnusedTileCount(), static_cast<unsigned long long>(sTerrainTileCache.getMappedBytes() / 1024),
+            static_cast<unsigned long long>(sTerrainTileCache.getMapCount()), static_cast<unsigned long long>(sTerrainTileCache.getShareCount()));
+
+        if (sPathfindingService.isEnabled())
+        {
+            baseConsole->Write("Pathfinding Workers: %u (%u paths queued, %llu calculated, %llu cancelled, %llu us average, %u us max)\r\n",
+                sPathfindingService.getWorkerCount(), sPathfindingService.getQueuedPathCount(),
+                static_cast<unsigned long long>(sPathfindingService.getCalculatedPathCount()), static_cast<unsigned long long>(sPathfindingService.getCancelledPathCount()),
+                static_cast<unsigned long long>(sPathfindingService.getAveragePathTime()), sPathfindingService.getMaxPathTime());
+        }
+
+        if (sPathCache.isEnabled())
+        {
+            const uint64_t pathCacheHits = sPathCache.getHitCount();
+            const uint64_t pathCacheQueries = pathCacheHits + sPathCache.getMissCount();
+            baseConsole->Write("Path Cache: %u paths, %llu hits of %llu queries (%.1f %%), %llu invalidated\r\n", sPathCache.getPathCount(),
+                static_cast<unsigned long long>(pathCacheHits), static_cast<unsigned long long>(pathCacheQueries),
+                pathCacheQueries ? 100.0f * static_cast<float>(pathCacheHits) / static_cast<float>(pathCacheQueries) : 0.0f,
+                static_cast<unsigned long long>(sPathCache.getInvalidatedCount()));
+        }
+
+        if (const auto compressedPackets = sUpdateCompressor.getPacketCount())
+        {
+            const auto bytesIn = sUpdateCompressor.getBytesIn();
+            const auto bytesOut = sUpdateCompressor.getBytesOut();
+            baseConsole->Write("Compressed Updates: %llu packets on %u streams, %llu KB -> %llu KB (%3.2f %%)\r\n", static_cast<unsigned long long>(compressedPackets),
+                sUpdateCompressor.getStreamCount(), static_cast<unsigned long long>(bytesIn / 1024), static_cast<unsigned long long>(bytesOut / 1024),
+                bytesIn ? 100.0f * static_cast<float>(bytesOut) / static_cast<float>(bytesIn) : 0.0f);
+            baseConsole->Write("Compression Time: %llu ms (%.3f ms per packet)\r\n", static_cast<unsigned long long>(sUpdateCompressor.getCompressionTime() / 1000),
+                static_cast<float>(sUpdateCompressor.getCompressionTime()) / 1000.0f / static_cast<float>(compressedPackets));
+        }
     }
 
     sSocketMgr.ShowStatus();
@@ -436,11 +494,207 @@ bool handlePrintTimeDateCommand(BaseConsole* baseConsole, int /*argumentCount*/,
 
 bool handleGetAccountsCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string /*consoleInput*/, bool /*isWebClient*/)
 {
-    sLogonCommHandler.requestAccountData();
+    // kept up to date by the account sync with the logonserver, started by the first call
+    if (sLogonCommHandler.startAccountSync())
+    {
+        baseConsole->Write("Started the account sync with the logonserver, run the command again once the accounts are received.\r\n");
+        return true;
+    }
+
+    const std::string accountData = sLogonCommHandler.getAccountData();
+
+    std::cout << "Command result is: " << accountData << "\n";
+
+    baseConsole->Write("%s\r\n", accountData.c_str());
+
+    return true;
+}
+
+bool handleMapProfileCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string consoleInput, bool /*isWebClient*/)
+{
+    std::stringstream profileStream;
+    std::stringstream argumentStream(consoleInput);
+
+    uint32_t mapId = 0;
+    uint32_t instanceId = 0;
+    if (!(argumentStream >> mapId))
+    {
+        // no map given, or not a number
+        if (!argumentStream.eof())
+            return false;
+
+        sMapTickProfilerRegistry.writeSummary(profileStream);
+    }
+    else
+    {
+        argumentStream >> instanceId;
+
+        const auto profiler = sMapTickProfilerRegistry.getProfiler(mapId, instanceId);
+        if (profiler == nullptr)
+        {
+            baseConsole->Write("No map %u with instance %u found.\r\n", mapId, instanceId);
+            return true;
+        }
+
+        profiler->writeReport(profileStream);
+    }
+
+    std::string line;
+    while (std::getline(profileStream, line))
+        baseConsole->Write("%s\r\n", line.c_str());
+
+    return true;
+}
+
+bool handleMapProfileDumpCommand(BaseConsole* baseConsole, int argumentCount, std::string consoleInput, bool /*isWebClient*/)
+{
+    std::string fileName;
+    std::stringstream(consoleInput) >> fileName;
+
+    if (argumentCount > 0 && fileName.empty())
+        return false;
+
+    // the remote console must not be able to write anywhere else
+    const std::string filePath = Util::getPathInDirectory(worldConfig.logger.extendedLogsDir, fileName);
+    if (filePath.empty())
+    {
+        baseConsole->Write("'%s' is not a plain file name, the profile is written to ExtendedLogDir.\r\n", fileName.c_str());
+        return true;
+    }
+
+    if (sMapTickProfilerRegistry.writeReportToFile(filePath))
+        baseConsole->Write("Map tick profile written to '%s'.\r\n", filePath.c_str());
+    else
+        baseConsole->Write("Could not write map tick profile to '%s'.\r\n", filePath.c_str());
+
+    return true;
+}
+
+bool handleMapProfileResetCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string /*consoleInput*/, bool /*isWebClient*/)
+{
+    sMapTickProfilerRegistry.resetAll();
+    baseConsole->Write("Map tick profiles reset.\r\n");
+
+    return true;
+}
+
+bool handleLuaProfileCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string consoleInput, bool /*isWebClient*/)
+{
+    std::stringstream profileStream;
+
+    uint32_t count = 20;
+    std::stringstream argumentStream(consoleInput);
+    if (!(argumentStream >> count))
+    {
+        // no count given, or not a number
+        if (!argumentStream.eof())
+            return false;
+
+        count = 20;
+    }
+
+    if (!sScriptMgr.WriteScriptEngineProfiles(profileStream, count))
+    {
+        baseConsole->Write("No scripting engine with call profiles is loaded.\r\n");
+        return true;
+    }
+
+    std::string line;
+    while (std::getline(profileStream, line))
+        baseConsole->Write("%s\r\n", line.c_str());
+
+    return true;
+}
+
+bool handleLuaProfileResetCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string /*consoleInput*/, bool /*isWebClient*/)
+{
+    sScriptMgr.ResetScriptEngineProfiles();
+    baseConsole->Write("Lua call profiles reset.\r\n");
+
+    return true;
+}
+
+bool handleCaptureStartCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string consoleInput, bool /*isWebClient*/)
+{
+    std::string fileName;
+    std::stringstream(consoleInput) >> fileName;
+
+    if (fileName.empty())
+    {
+        fileName = worldConfig.logger.packetCaptureFile;
+    }
+    else
+    {
+        // the remote console must not be able to write anywhere else
+        const std::string filePath = Util::getPathInDirectory(worldConfig.logger.extendedLogsDir, fileName);
+        if (filePath.empty())
+        {
+            baseConsole->Write("'%s' is not a plain file name, the capture is written to ExtendedLogDir.\r\n", fileName.c_str());
+            return true;
+        }
+
+        fileName = filePath;
+    }
+
+    if (sPacketCapture.start(fileName))
+        baseConsole->Write("Capturing packets to '%s'.\r\n", fileName.c_str());
+    else
+        baseConsole->Write("Could not open '%s'.\r\n", fileName.c_str());
+
+    return true;
+}
+
+bool handleCaptureStopCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string /*consoleInput*/, bool /*isWebClient*/)
+{
+    if (!sPacketCapture.isCapturing())
+    {
+        baseConsole->Write("No packet capture is running.\r\n");
+        return true;
+    }
+
+    const auto stats = sPacketCapture.getStats();
+    sPacketCapture.stop();
+
+    baseConsole->Write("Packet capture '%s' stopped, %llu packets captured, %llu dropped.\r\n", sPacketCapture.getFileName().c_str(),
+        static_cast<unsigned long long>(stats.captured), static_cast<unsigned long long>(stats.dropped));
+
+    return true;
+}
+
+bool handleCaptureStatusCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string /*consoleInput*/, bool /*isWebClient*/)
+{
+    if (!sPacketCapture.isCapturing())
+    {
+        baseConsole->Write("No packet capture is running.\r\n");
+        return true;
+    }
+
+    const auto stats = sPacketCapture.getStats();
+    baseConsole->Write("Capturing to '%s'\r\n", sPacketCapture.getFileName().c_str());
+    baseConsole->Write("Packets: %llu captured, %llu dropped, %llu sampled out\r\n", static_cast<unsigned long long>(stats.captured),
+        static_cast<unsigned long long>(stats.dropped), static_cast<unsigned long long>(stats.sampledOut));
+    baseConsole->Write("Written: %llu KB, buffer: %u / %u KB\r\n", static_cast<unsigned long long>(stats.writtenBytes / 1024),
+        static_cast<uint32_t>(stats.bufferedBytes / 1024), static_cast<uint32_t>(stats.bufferSize / 1024));
 
-    std::cout << "Command result is: " << sLogonCommHandler.accountResult << "\n";
+    return true;
+}
+
+bool handleCaptureSampleCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string consoleInput, bool /*isWebClient*/)
+{
+    std::string opcodeName;
+    uint32_t rate;
+    if (!(std::stringstream(consoleInput) >> opcodeName >> rate))
+        return false;
+
+    const uint32_t opcode = sOpcodeTables.getInternalIdForName(opcodeName);
+    if (opcode == NUM_OPCODES)
+    {
+        baseConsole->Write("Unknown opcode '%s'.\r\n", opcodeName.c_str());
+        return true;
+    }
 
-    baseConsole->Write("%s\r\n", sLogonCommHandler.accountResult.c_str());
+    sPacketCapture.setSampleRate(static_cast<uint16_t>(opcode), rate);
+    baseConsole->Write("Sample rate of %s set to %u.\r\n", opcodeName.c_str(), rate);
 
     return true;
 }
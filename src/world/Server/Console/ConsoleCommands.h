@@ -30,3 +30,12 @@ bool handleClearConsoleCommand(BaseConsole* baseConsole, int /*argumentCount*/,
 bool handleReloadScriptEngineCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string /*consoleInput*/, bool isWebClient);
 bool handlePrintTimeDateCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string /*consoleInput*/, bool isWebClient);
 bool handleGetAccountsCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string /*consoleInput*/, bool isWebClient);
+bool handleMapProfileCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string consoleInput, bool isWebClient);
+bool handleMapProfileDumpCommand(BaseConsole* baseConsole, int argumentCount, std::string consoleInput, bool isWebClient);
+bool handleMapProfileResetCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string /*consoleInput*/, bool isWebClient);
+bool handleLuaProfileCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string consoleInput, bool isWebClient);
+bool handleLuaProfileResetCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string /*consoleInput*/, bool isWebClient);
+bool handleCaptureStartCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string consoleInput, bool isWebClient);
+bool handleCaptureStopCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string /*consoleInput*/, bool isWebClient);
+bool handleCaptureStatusCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string /*consoleInput*/, bool isWebClient);
+bool handleCaptureSampleCommand(BaseConsole* baseConsole, int /*argumentCount*/, std::string consoleInput, bool isWebClient);
@@ -158,6 +158,15 @@ static ConsoleCommand Commands[] =
     { &handleReloadScriptEngineCommand, "reloadscripts",    0,  "None",                                 "Reloads all scripting engines currently loaded." },
     { &handlePrintTimeDateCommand,      "datetime",         0,  "None",                                 "Shows time and date according to localtime()" },
     { &handleGetAccountsCommand,        "getaccountdata",   0,  "None",                                 "Prints out all account data" },
+    { &handleMapProfileCommand,         "mapprofile",       0,  "[mapid] [instanceid]",                 "Shows map tick times, or the phase breakdown of one map." },
+    { &handleMapProfileDumpCommand,     "mapprofiledump",   1,  "<file>",                               "Writes the full map tick profile to <file> in ExtendedLogDir." },
+    { &handleMapProfileResetCommand,    "mapprofilereset",  0,  "None",                                 "Resets the map tick profiles." },
+    { &handleLuaProfileCommand,         "luaprofile",       0,  "[count]",                              "Shows the Lua functions with the most call time." },
+    { &handleLuaProfileResetCommand,    "luaprofilereset",  0,  "None",                                 "Resets the Lua call profiles." },
+    { &handleCaptureStartCommand,       "capturestart",     0,  "[file]",                               "Starts capturing world packets to [file] in ExtendedLogDir (PacketCaptureFile)." },
+    { &handleCaptureStopCommand,        "capturestop",      0,  "None",                                 "Stops the packet capture." },
+    { &handleCaptureStatusCommand,      "capturestatus",    0,  "None",                                 "Shows packet capture counters." },
+    { &handleCaptureSampleCommand,      "capturesample",    2,  "<opcode name> <rate>",                 "Captures every <rate>th packet of an opcode, 0 = none." },
     { nullptr,                          "",                 0,  "",                                     "" },
 };
 
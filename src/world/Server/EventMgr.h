@@ -22,6 +22,7 @@
 #define EVENTMGR_H
 
 #include "CallBack.h"
+#include <atomic>
 #include <map>
 
 enum EventTypes : uint16_t
@@ -251,10 +252,13 @@ enum EventFlags : uint8_t
     EVENT_FLAG_DELETES_OBJECT = 0x2,
 };
 
+class EventableObjectHolder;
+
 struct SERVER_DECL TimedEvent
 {
     TimedEvent(void* object, CallbackBase* callback, uint32 type, time_t time, uint32 repeat, uint32 flags) :
-        obj(object), cb(callback), eventType(type), eventFlag(static_cast<uint16>(flags)), msTime(time), currTime(time), repeats(static_cast<uint16>(repeat)), deleted(false), ref(0), instanceId(0) {}
+        obj(object), cb(callback), eventType(type), eventFlag(static_cast<uint16>(flags)), msTime(time), currTime(time), repeats(static_cast<uint16>(repeat)), deleted(false), ref(0), instanceId(0),
+        wheelGeneration(0), wheelHolder(nullptr), wheelExpireTime(0) {}
 
     void* obj;
     CallbackBase* cb;
@@ -267,6 +271,12 @@ struct SERVER_DECL TimedEvent
     int instanceId;
     std::atomic<unsigned long> ref;
 
+    // Timer wheel bookkeeping of EventableObjectHolder. Every (re)schedule gets a new
+    // generation, wheel entries with an older generation are dropped when they expire.
+    std::atomic<uint32> wheelGeneration;
+    EventableObjectHolder* wheelHolder;
+    uint64 wheelExpireTime;
+
     static TimedEvent* Allocate(void* object, CallbackBase* callback, uint32 flags, time_t time, uint32 repeat);
 
 
@@ -283,7 +293,6 @@ struct SERVER_DECL TimedEvent
 };
 
 class EventMgr;
-class EventableObjectHolder;
 typedef std::map<int32, EventableObjectHolder*> HolderMap;
 
 class SERVER_DECL EventMgr
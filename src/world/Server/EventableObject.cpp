@@ -179,8 +179,9 @@ void EventableObject::event_ModifyTimeLeft(uint32 EventType, time_t TimeLeft, bo
         do
         {
             if (unconditioned)
-                itr->second->currTime = TimeLeft;
-            else itr->second->currTime = (TimeLeft > itr->second->msTime) ? itr->second->msTime : TimeLeft;
+                event_SetTimeLeft(itr->second, TimeLeft);
+            else
+                event_SetTimeLeft(itr->second, (TimeLeft > itr->second->msTime) ? itr->second->msTime : TimeLeft);
             ++itr;
         }
         while (itr != m_events.upper_bound(EventType));
@@ -209,7 +210,7 @@ bool EventableObject::event_GetTimeLeft(uint32 EventType, time_t* Time)
                 continue;
             }
 
-            *Time = (uint32)itr->second->currTime;
+            *Time = (uint32)EventableObjectHolder::GetTimeLeft(itr->second);
             m_lock.Release();
             return true;
 
@@ -221,6 +222,15 @@ bool EventableObject::event_GetTimeLeft(uint32 EventType, time_t* Time)
     return false;
 }
 
+void EventableObject::event_SetTimeLeft(TimedEvent* ev, time_t TimeLeft)
+{
+    ev->currTime = TimeLeft;
+
+    // schedule it again, the old wheel entry is dropped
+    if (m_holder != nullptr && !ev->deleted)
+        m_holder->AddEvent(ev);
+}
+
 void EventableObject::event_ModifyTime(uint32 EventType, time_t Time)
 {
     m_lock.Acquire();
@@ -258,7 +268,8 @@ void EventableObject::event_ModifyTimeAndTimeLeft(uint32 EventType, time_t Time)
     {
         do
         {
-            itr->second->currTime = itr->second->msTime = Time;
+            itr->second->msTime = Time;
+            event_SetTimeLeft(itr->second, Time);
             ++itr;
         }
         while (itr != m_events.upper_bound(EventType));
@@ -298,9 +309,8 @@ bool EventableObject::event_HasEvent(uint32 EventType)
     return ret;
 }
 
-EventableObjectHolder::EventableObjectHolder(int32 instance_id) : mInstanceId(instance_id)
+EventableObjectHolder::EventableObjectHolder(int32 instance_id) : mInstanceId(instance_id), m_time(0)
 {
-    m_insertPool.clear();
     sEventMgr.AddEventHolder(this, instance_id);
 }
 
@@ -309,16 +319,14 @@ EventableObjectHolder::~EventableObjectHolder()
     sEventMgr.RemoveEventHolder(this);
 
     m_insertPoolLock.Acquire();
-    EventList::iterator insertPoolItr = m_insertPool.begin();
-    for (; insertPoolItr != m_insertPool.end(); ++insertPoolItr)
-        (*insertPoolItr)->DecRef();
+    for (const auto& scheduledEvent : m_insertPool)
+        releaseEvent(scheduledEvent);
+    m_insertPool.clear();
     m_insertPoolLock.Release();
 
     /* decrement events reference count */
     m_lock.Acquire();
-    EventList::iterator itr = m_events.begin();
-    for (; itr != m_events.end(); ++itr)
-        (*itr)->DecRef();
+    m_timerWheel.clear([this](ScheduledEvent scheduledEvent) { releaseEvent(scheduledEvent); });
     m_lock.Release();
 }
 
@@ -328,92 +336,136 @@ void EventableObjectHolder::Update(time_t time_difference)
 
     /* Insert any pending objects in the insert pool. */
     m_insertPoolLock.Acquire();
-    InsertableQueue::iterator iqi;
-    InsertableQueue::iterator iq2 = m_insertPool.begin();
-    while (iq2 != m_insertPool.end())
+    for (const auto& scheduledEvent : m_insertPool)
     {
-        iqi = iq2++;
-        if ((*iqi)->deleted || (*iqi)->instanceId != mInstanceId)
-            (*iqi)->DecRef();
+        if (isOutdated(scheduledEvent))
+            scheduledEvent.event->DecRef();
         else
-            m_events.push_back((*iqi));
-
-        m_insertPool.erase(iqi);
+            scheduleEvent(scheduledEvent);
     }
+    m_insertPool.clear();
     m_insertPoolLock.Release();
 
     /* Now we can proceed normally. */
-    EventList::iterator itr = m_events.begin();
-    EventList::iterator it2;
-    TimedEvent* ev;
+    if (time_difference > 0)
+        m_time += time_difference;
+
+    m_timerWheel.advance(m_time, [this](ScheduledEvent scheduledEvent) { executeEvent(scheduledEvent); });
+
+    m_lock.Release();
+}
+
+time_t EventableObjectHolder::GetTimeLeft(TimedEvent* ev)
+{
+    EventableObjectHolder* holder = ev->wheelHolder;
+    if (holder == nullptr)
+        return ev->currTime;
+
+    const uint64 time = holder->m_time;
+    return ev->wheelExpireTime > time ? static_cast<time_t>(ev->wheelExpireTime - time) : 0;
+}
+
+void EventableObjectHolder::queueEvent(TimedEvent* ev)
+{
+    // m_lock NEEDS TO BE A RECURSIVE MUTEX
+    ev->IncRef();
+
+    // a new generation outdates the entries of earlier AddEvent calls
+    const ScheduledEvent scheduledEvent = { ev, ++ev->wheelGeneration };
 
-    while (itr != m_events.end())
+    if (!m_lock.AttemptAcquire())
     {
-        it2 = itr++;
+        ev->wheelHolder = nullptr;
 
-        if ((*it2)->instanceId != mInstanceId || (*it2)->deleted)
-        {
+        m_insertPoolLock.Acquire();
+        m_insertPool.push_back(scheduledEvent);
+        m_insertPoolLock.Release();
+    }
+    else
+    {
+        scheduleEvent(scheduledEvent);
+        m_lock.Release();
+    }
 
-            (*it2)->DecRef();
+    if (m_eventAddedHandler)
+        m_eventAddedHandler();
+}
 
-            // remove from this list.
-            m_events.erase(it2);
+void EventableObjectHolder::scheduleEvent(ScheduledEvent scheduledEvent)
+{
+    TimedEvent* ev = scheduledEvent.event;
 
-            continue;
-        }
+    // like the old countdown, an event expires in the first update that ends at least currTime after
+    // the last one, at most once per update
+    const uint64 expireTime = m_time + (ev->currTime > 0 ? static_cast<uint64>(ev->currTime) : 1);
 
-        // Event Update Procedure
-        ev = *it2;
+    ev->wheelExpireTime = expireTime;
+    ev->wheelHolder = this;
 
-        if (ev->currTime <= time_difference)
-        {
-            // execute the callback
-            if (ev->eventFlag & EVENT_FLAG_DELETES_OBJECT)
-            {
-                m_events.erase(it2);
-                ev->deleted = true;
-                ev->cb->execute();
-                ev->DecRef();
-                continue;
-            }
-            else
-                ev->cb->execute();
+    m_timerWheel.schedule(scheduledEvent, expireTime);
+}
 
-            // check if the event is expired now.
-            if (ev->repeats && --ev->repeats == 0)
-            {
-                // Event expired :>
+void EventableObjectHolder::executeEvent(ScheduledEvent scheduledEvent)
+{
+    if (isOutdated(scheduledEvent))
+    {
+        scheduledEvent.event->DecRef();
+        return;
+    }
 
-                /* remove the event from the object */
-                /*obj = (EventableObject*)ev->obj;
-                obj->event_RemoveByPointer(ev);*/
+    // Event Update Procedure
+    TimedEvent* ev = scheduledEvent.event;
 
-                /* remove the event from here */
-                ev->deleted = true;
-                ev->DecRef();
-                m_events.erase(it2);
+    // execute the callback
+    if (ev->eventFlag & EVENT_FLAG_DELETES_OBJECT)
+    {
+        ev->deleted = true;
+        ev->cb->execute();
+        ev->DecRef();
+        return;
+    }
 
-                continue;
-            }
-            else if (ev->deleted)
-            {
-                // event is now deleted
-                ev->DecRef(); //this was added on "addevent"
-                m_events.erase(it2);
-                continue;
-            }
+    ev->cb->execute();
 
-            // event has to repeat again, reset the timer
-            ev->currTime = ev->msTime;
-        }
-        else
-        {
-            // event is still "waiting", subtract time difference
-            ev->currTime -= time_difference;
-        }
+    // check if the event is expired now.
+    if (ev->repeats && --ev->repeats == 0)
+    {
+        // Event expired :>
+        ev->deleted = true;
+        ev->DecRef();
+        return;
     }
 
-    m_lock.Release();
+    // event is now deleted, moved or was scheduled again from its callback
+    if (isOutdated(scheduledEvent))
+    {
+        ev->DecRef(); //this was added on "addevent"
+        return;
+    }
+
+    // event has to repeat again, reset the timer. The entry keeps its reference.
+    ev->currTime = ev->msTime;
+    scheduleEvent(scheduledEvent);
+}
+
+bool EventableObjectHolder::isOutdated(ScheduledEvent scheduledEvent) const
+{
+    const TimedEvent* ev = scheduledEvent.event;
+    return ev->deleted || ev->instanceId != mInstanceId || ev->wheelGeneration != scheduledEvent.generation;
+}
+
+void EventableObjectHolder::releaseEvent(ScheduledEvent scheduledEvent)
+{
+    TimedEvent* ev = scheduledEvent.event;
+
+    // keep the time left of events which are still owned by an object
+    if (ev->wheelHolder == this)
+    {
+        ev->currTime = GetTimeLeft(ev);
+        ev->wheelHolder = nullptr;
+    }
+
+    ev->DecRef();
 }
 
 void EventableObject::event_Relocate()
@@ -427,10 +479,17 @@ void EventableObject::event_Relocate()
         // whee, we changed event holder :>
         // doing this will change the instanceid on all the events, as well as add to the new holder.
 
+        // the time left is taken from the old holder, the new one continues from there
+        for (EventMap::iterator itr = m_events.begin(); itr != m_events.end(); ++itr)
+        {
+            itr->second->currTime = EventableObjectHolder::GetTimeLeft(itr->second);
+            itr->second->wheelHolder = nullptr;
+        }
+
         //If nh is NULL then we were removed from world. There's no reason to be added to WORLD_INSTANCE EventMgr, let's just wait till something will add us again to world.
         if (nh == NULL)
         {
-            //set instaceId to 0 to each event of this EventableObject, so EventableObjectHolder::Update() will remove them from its EventList.
+            //set instaceId to 0 to each event of this EventableObject, so EventableObjectHolder::Update() will drop them from its timer wheel.
             for (EventMap::iterator itr = m_events.begin(); itr != m_events.end(); ++itr)
             {
                 itr->second->instanceId = 0;
@@ -464,67 +523,33 @@ uint32 EventableObject::event_GetEventPeriod(uint32 EventType)
     return ret;
 }
 
+size_t EventableObjectHolder::GetEventCount()
+{
+    m_lock.Acquire();
+    m_insertPoolLock.Acquire();
+    const size_t count = m_timerWheel.size() + m_insertPool.size();
+    m_insertPoolLock.Release();
+    m_lock.Release();
+
+    return count;
+}
+
 void EventableObjectHolder::AddEvent(TimedEvent* ev)
 {
-    // m_lock NEEDS TO BE A RECURSIVE MUTEX
-    ev->IncRef();
-    if (!m_lock.AttemptAcquire())
-    {
-        m_insertPoolLock.Acquire();
-        m_insertPool.push_back(ev);
-        m_insertPoolLock.Release();
-    }
-    else
-    {
-        m_events.push_back(ev);
-        m_lock.Release();
-    }
+    queueEvent(ev);
 }
 
 void EventableObjectHolder::AddObject(EventableObject* obj)
 {
     // transfer all of this objects events into our holder
-    if (!m_lock.AttemptAcquire())
+    // if our thread is occupied they go to the insert pool, so 2 threads relocating at once can't deadlock
+    for (EventMap::iterator itr = obj->m_events.begin(); itr != obj->m_events.end(); ++itr)
     {
-        // The other thread is obviously occupied. We have to use an insert pool here, otherwise
-        // if 2 threads relocate at once we'll hit a deadlock situation.
-        m_insertPoolLock.Acquire();
-        EventMap::iterator it2;
-
-        for (EventMap::iterator itr = obj->m_events.begin(); itr != obj->m_events.end(); ++itr)
-        {
-            // ignore deleted events (shouldn't be any in here, actually)
-            if (itr->second->deleted)
-            {
-                /*it2 = itr++;
-                itr->second->DecRef();
-                obj->m_events.erase(it2);*/
-                continue;
-            }
-
-            itr->second->IncRef();
-            itr->second->instanceId = mInstanceId;
-            m_insertPool.push_back(itr->second);
-        }
-
-        // Release the insert pool.
-        m_insertPoolLock.Release();
-
-        // Ignore the rest of this stuff
-        return;
-    }
-    else
-    {
-        for (EventMap::iterator itr = obj->m_events.begin(); itr != obj->m_events.end(); ++itr)
-        {
-            // ignore deleted events
-            if (itr->second->deleted)
-                continue;
+        // ignore deleted events
+        if (itr->second->deleted)
+            continue;
 
-            itr->second->IncRef();
-            itr->second->instanceId = mInstanceId;
-            m_events.push_back(itr->second);
-        }
-        m_lock.Release();
+        itr->second->instanceId = mInstanceId;
+        queueEvent(itr->second);
     }
 }
@@ -22,13 +22,15 @@
 #define EVENTABLEOBJECT_H
 
 #include "EventMgr.h"
+#include "TimerWheel.hpp"
 #include <Util.hpp>
+#include <functional>
 #include <list>
 #include <set>
+#include <vector>
 
 class EventableObjectHolder;
 
-typedef std::list<TimedEvent*> EventList;
 typedef std::multimap<uint32, TimedEvent*> EventMap;
 
 #define EVENT_REMOVAL_FLAG_ALL 0xFFFFFFFF
@@ -55,6 +57,7 @@ class SERVER_DECL EventableObject
         void event_RemoveByPointer(TimedEvent* ev);
         int32 event_GetCurrentInstanceId() { return m_event_Instanceid; }
         bool event_GetTimeLeft(uint32 EventType, time_t* Time);
+        void event_SetTimeLeft(TimedEvent* ev, time_t TimeLeft);
 
     public:
 
@@ -91,6 +94,8 @@ typedef std::set<EventableObject*> EventableObjectSet;
 /// from one holder to another (changing maps / instances).
 /// EventableObjectHolder also updates all the timed events in all of its objects when its
 /// update function is called.
+/// The events are kept in a timer wheel, so an update only touches the events that expire.
+/// Removed or rescheduled events stay in the wheel and are dropped once they come up.
 //////////////////////////////////////////////////////////////////////////////////////////
 class EventableObjectHolder
 {
@@ -101,20 +106,46 @@ class EventableObjectHolder
 
         void Update(time_t time_difference);
 
+        /// adds the event, or schedules it again with its currTime when it is already added
         void AddEvent(TimedEvent* ev);
         void AddObject(EventableObject* obj);
 
         uint32 GetInstanceID() { return mInstanceId; }
 
+        /// events in the timer wheel (including removed ones which did not come up yet) and in the insert pool
+        size_t GetEventCount();
+
+        /// called after an event was added, used by maps to wake up from an idle sleep
+        void SetEventAddedHandler(std::function<void()> handler) { m_eventAddedHandler = std::move(handler); }
+
+        /// time until the event expires, currTime for events which are not in a timer wheel yet
+        static time_t GetTimeLeft(TimedEvent* ev);
+
     protected:
 
+        struct ScheduledEvent
+        {
+            TimedEvent* event;
+            uint32 generation;
+        };
+
+        void queueEvent(TimedEvent* ev);
+        void scheduleEvent(ScheduledEvent scheduledEvent);
+        void executeEvent(ScheduledEvent scheduledEvent);
+        bool isOutdated(ScheduledEvent scheduledEvent) const;
+        void releaseEvent(ScheduledEvent scheduledEvent);
+
         int32 mInstanceId;
         Mutex m_lock;
-        EventList m_events;
+        TimerWheel<ScheduledEvent> m_timerWheel;
+
+        /// time at the end of the last update, events are scheduled relative to it
+        uint64 m_time;
 
         Mutex m_insertPoolLock;
-        typedef std::list<TimedEvent*> InsertableQueue;
-        InsertableQueue m_insertPool;
+        std::vector<ScheduledEvent> m_insertPool;
+
+        std::function<void()> m_eventAddedHandler;
 };
 
 #endif // EVENTABLEOBJECT_H
@@ -123,7 +123,11 @@ void LogonCommClientSocket::HandlePacket(WorldPacket& recvData)
         NULL,                                                   // LRCMSG_ACCOUNT_REQUEST
         &LogonCommClientSocket::HandleResultCheckAccount,       // LRSMSG_ACCOUNT_RESULT
         NULL,                                                   // LRCMSG_ALL_ACCOUNT_REQUEST
-        &LogonCommClientSocket::HandleResultAllAccount,         // LRSMSG_ALL_ACCOUNT_RESULT
+        NULL,                                                   // LRSMSG_ALL_ACCOUNT_RESULT
+        NULL,                                                   // LRCMSG_ACCOUNT_SYNC_REQUEST
+        &LogonCommClientSocket::HandleAccountSyncSnapshot,      // LRSMSG_ACCOUNT_SYNC_SNAPSHOT
+        NULL,                                                   // LRCMSG_ACCOUNT_SYNC_SNAPSHOT_ACK
+        &LogonCommClientSocket::HandleAccountSyncDelta,         // LRSMSG_ACCOUNT_SYNC_DELTA
     };
 
     if (recvData.GetOpcode() >= LRMSG_MAX_OPCODES || Handlers[recvData.GetOpcode()] == 0)
@@ -630,10 +634,53 @@ void LogonCommClientSocket::HandleResultCheckAccount(WorldPacket& recvData)
     }
 }
 
-void LogonCommClientSocket::HandleResultAllAccount(WorldPacket& recvData)
+// Reads the uncompressed size and the compressed accounts following it
+static bool uncompressAccounts(WorldPacket& recvData, ByteBuffer& accounts)
 {
-    std::string accountResult;
-    recvData >> accountResult;
+    uint32 realSize;
+    recvData >> realSize;
+    uLongf rsize = realSize;
 
-    sLogonCommHandler.accountResult = accountResult;
+    accounts.resize(realSize);
+
+    if (recvData.size() < recvData.rpos() || uncompress(accounts.contents(), &rsize, recvData.contents() + recvData.rpos(), (uLong)(recvData.size() - recvData.rpos())) != Z_OK)
+    {
+        sLogger.failure("Uncompress of account sync packet failed.");
+        return false;
+    }
+
+    return true;
+}
+
+void LogonCommClientSocket::HandleAccountSyncSnapshot(WorldPacket& recvData)
+{
+    uint32 epoch;
+    uint64 version;
+    uint32 part;
+    uint32 partCount;
+    recvData >> epoch >> version >> part >> partCount;
+
+    ByteBuffer accounts;
+    if (!uncompressAccounts(recvData, accounts))
+        return;
+
+    const uint32 nextPart = sLogonCommHandler.handleAccountSnapshot(epoch, version, part, partCount, accounts);
+
+    WorldPacket data(LRCMSG_ACCOUNT_SYNC_SNAPSHOT_ACK, 16);
+    data << epoch;
+    data << version;
+    data << nextPart;
+    SendPacket(&data, false);
+}
+
+void LogonCommClientSocket::HandleAccountSyncDelta(WorldPacket& recvData)
+{
+    uint32 epoch;
+    uint64 fromVersion;
+    uint64 toVersion;
+    recvData >> epoch >> fromVersion >> toVersion;
+
+    ByteBuffer changes;
+    if (!uncompressAccounts(recvData, changes) || !sLogonCommHandler.handleAccountDelta(epoch, fromVersion, toVersion, changes))
+        sLogonCommHandler.requestAccountSync(this);
 }
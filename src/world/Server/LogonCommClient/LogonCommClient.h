@@ -57,7 +57,8 @@ class LogonCommClientSocket : public Socket
         void HandlePopulationRequest(WorldPacket& recvData);
         void HandleModifyDatabaseResult(WorldPacket& recvData);
         void HandleResultCheckAccount(WorldPacket& recvData);
-        void HandleResultAllAccount(WorldPacket& recvData);
+        void HandleAccountSyncSnapshot(WorldPacket& recvData);
+        void HandleAccountSyncDelta(WorldPacket& recvData);
 
         void OnDisconnect();
         void CompressAndSend(ByteBuffer& uncompressed);
@@ -204,6 +204,10 @@ void LogonCommHandler::tryLogonServerConnection(LogonServerStructure* server)
     // Wait for all realms to register
     Arcemu::Sleep(200);
 
+    // resume the account sync after a reconnect, it is only started by the first getaccounts
+    if (isAccountSyncStarted())
+        requestAccountSync(logonCommSocket);
+
     sLogger.info("LogonCommClient : Logonserver latency is %ums.", logonCommSocket->latency);
 }
 
@@ -668,13 +672,123 @@ void LogonCommHandler::checkIfAccountExist(const char* account, const char* requ
     }
 }
 
-void LogonCommHandler::requestAccountData()
+bool LogonCommHandler::startAccountSync()
 {
+    {
+        std::lock_guard<std::mutex> guard(accountSyncLock);
+
+        if (accountSyncStarted)
+            return false;
+
+        accountSyncStarted = true;
+    }
+
     if (LogonCommClientSocket* logonCommSocket = getLogonServerSocket())
+        requestAccountSync(logonCommSocket);
+
+    return true;
+}
+
+bool LogonCommHandler::isAccountSyncStarted()
+{
+    std::lock_guard<std::mutex> guard(accountSyncLock);
+    return accountSyncStarted;
+}
+
+void LogonCommHandler::requestAccountSync(LogonCommClientSocket* Socket)
+{
+    std::lock_guard<std::mutex> guard(accountSyncLock);
+
+    pendingLogonAccounts.clear();
+
+    WorldPacket data(LRCMSG_ACCOUNT_SYNC_REQUEST, 16);
+    data << uint32_t(ACCOUNT_SYNC_PROTOCOL_VERSION);
+    data << accountSyncEpoch;
+    data << accountSyncVersion;
+    Socket->SendPacket(&data, false);
+}
+
+uint32_t LogonCommHandler::handleAccountSnapshot(uint32_t epoch, uint64_t version, uint32_t part, uint32_t partCount, ByteBuffer& accounts)
+{
+    std::lock_guard<std::mutex> guard(accountSyncLock);
+
+    if (part == 0)
+        pendingLogonAccounts.clear();
+
+    uint32_t count;
+    accounts >> count;
+
+    for (uint32_t i = 0; i < count; ++i)
     {
-        WorldPacket data(LRCMSG_ALL_ACCOUNT_REQUEST, 100);
-        logonCommSocket->SendPacket(&data, false);
+        uint8_t type;
+        uint32_t accountId;
+        LogonAccount account;
+        accounts >> type >> accountId >> account.name >> account.gmFlags;
+
+        pendingLogonAccounts[accountId] = std::move(account);
     }
+
+    if (part + 1 >= partCount)
+    {
+        logonAccounts.swap(pendingLogonAccounts);
+        pendingLogonAccounts.clear();
+
+        accountSyncEpoch = epoch;
+        accountSyncVersion = version;
+
+        sLogger.info("LogonCommClient : Received %u accounts from logonserver.", static_cast<uint32_t>(logonAccounts.size()));
+    }
+
+    return part + 1;
+}
+
+bool LogonCommHandler::handleAccountDelta(uint32_t epoch, uint64_t fromVersion, uint64_t toVersion, ByteBuffer& changes)
+{
+    std::lock_guard<std::mutex> guard(accountSyncLock);
+
+    if (epoch != accountSyncEpoch || fromVersion != accountSyncVersion)
+    {
+        sLogger.failure("LogonCommClient : Account changes %llu - %llu do not follow version %llu, requesting all accounts.",
+            static_cast<unsigned long long>(fromVersion), static_cast<unsigned long long>(toVersion), static_cast<unsigned long long>(accountSyncVersion));
+
+        accountSyncEpoch = 0;
+        accountSyncVersion = 0;
+        return false;
+    }
+
+    uint32_t count;
+    changes >> count;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint8_t type;
+        uint32_t accountId;
+        LogonAccount account;
+        changes >> type >> accountId >> account.name >> account.gmFlags;
+
+        if (type == AccountSync_Removed)
+            logonAccounts.erase(accountId);
+        else
+            logonAccounts[accountId] = std::move(account);
+    }
+
+    accountSyncVersion = toVersion;
+    return true;
+}
+
+std::string LogonCommHandler::getAccountData()
+{
+    std::lock_guard<std::mutex> guard(accountSyncLock);
+
+    std::string accountData;
+    for (const auto& account : logonAccounts)
+        accountData += std::to_string(account.first) + "," + account.second.name + "," + (account.second.gmFlags.empty() ? "0" : account.second.gmFlags) + ";";
+
+    // remove last ; from string
+    if (!accountData.empty())
+        accountData.pop_back();
+
+    return accountData;
 }
 
 LogonCommClientSocket* LogonCommHandler::getLogonServerSocket()
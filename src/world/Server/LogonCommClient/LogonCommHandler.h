@@ -11,6 +11,7 @@ This file is released under the MIT license. See README-MIT for more information
 
 #include <string>
 #include <map>
+#include <mutex>
 #include <set>
 
 struct LogonServerStructure
@@ -46,6 +47,13 @@ enum RealmType
 };
 
 
+// An account of the logonserver, see LogonCommHandler::requestAccountSync
+struct LogonAccount
+{
+    std::string name;
+    std::string gmFlags;
+};
+
 class LogonCommHandler
 {
     typedef std::unordered_map<uint32_t, std::string> AccountPermissionMap;
@@ -75,6 +83,14 @@ class LogonCommHandler
 
     float server_population;
 
+    // account sync, guarded by accountSyncLock
+    std::mutex accountSyncLock;
+    bool accountSyncStarted = false;
+    std::map<uint32_t, LogonAccount> logonAccounts;
+    std::map<uint32_t, LogonAccount> pendingLogonAccounts;  // snapshot parts received so far
+    uint32_t accountSyncEpoch = 0;
+    uint64_t accountSyncVersion = 0;
+
     private:
 
         LogonCommHandler() = default;
@@ -118,7 +134,21 @@ class LogonCommHandler
         void dropLogonServerConnection(uint32_t ID);
 
         void checkIfAccountExist(const char* account, const char* request_name, const char* additional, uint32_t method = 1);
-        void requestAccountData();
+
+        // Account sync
+        // The logonserver sends all accounts once, then it pushes the changes. After a reconnect only the
+        // changes since the last known version are sent, unless the logonserver no longer has them.
+        // Nothing is synced until the accounts are needed the first time (getaccounts console command).
+        // returns true when this call started the sync
+        bool startAccountSync();
+        bool isAccountSyncStarted();
+        void requestAccountSync(LogonCommClientSocket* Socket);
+        // returns the next part to request
+        uint32_t handleAccountSnapshot(uint32_t epoch, uint64_t version, uint32_t part, uint32_t partCount, ByteBuffer& accounts);
+        // returns false when changes are missing, the accounts have to be requested again
+        bool handleAccountDelta(uint32_t epoch, uint64_t fromVersion, uint64_t toVersion, ByteBuffer& changes);
+        // id,name,gmflags; of all accounts
+        std::string getAccountData();
         
         LogonCommClientSocket* getLogonServerSocket();
         
@@ -145,7 +175,6 @@ class LogonCommHandler
         Mutex & getPendingLock() { return pendingLock; }
  
         void testConsoleLogon(std::string & username, std::string & password, uint32_t requestnum);
-        std::string accountResult;
 };
 
 #define sLogonCommHandler LogonCommHandler::getInstance()
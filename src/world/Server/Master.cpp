@@ -25,6 +25,7 @@
 #include "WorldRunnable.h"
 #include "Server/Console/ConsoleThread.h"
 #include "Server/MainServerDefines.h"
+#include "Server/CharacterDatabaseStatements.hpp"
 #include "Server/Master.h"
 #include "Server/BroadcastMgr.h"
 #include "Storage/DayWatcherThread.h"
@@ -33,6 +34,7 @@
 #include "Management/AddonMgr.h"
 #include "Management/AuctionMgr.h"
 #include "Util.hpp"
+#include "Database/DatabaseSnapshot.hpp"
 #include "Database/DatabaseUpdater.hpp"
 #include "Packets/SmsgServerMessage.h"
 #include "OpcodeTable.hpp"
@@ -282,6 +284,9 @@ bool Master::Run(int /*argc*/, char** /*argv*/)
     sLogger.setMinimumMessageType(static_cast<AscEmu::Logging::MessageType>(worldConfig.logger.minimumMessageType));
     sLogger.setDebugFlags(static_cast<AscEmu::Logging::DebugFlags>(worldConfig.logger.debugFlags));
 
+    if (worldConfig.logger.enableAsyncMode)
+        sLogger.enableAsyncMode(worldConfig.logger.asyncFlushInterval, worldConfig.logger.asyncBufferSize, worldConfig.logger.asyncDropWhenFull);
+
     OpenCheatLogFiles();
 
     if (!_StartDB())
@@ -308,7 +313,8 @@ bool Master::Run(int /*argc*/, char** /*argv*/)
 
     const std::string worldDbName = worldConfig.worldDb.dbName;
     DatabaseUpdater::initBaseIfNeeded(worldDbName, "world", WorldDatabase);
-    DatabaseUpdater::checkAndApplyDBUpdatesIfNeeded("world", WorldDatabase);
+    if (DatabaseUpdater::checkAndApplyDBUpdatesIfNeeded("world", WorldDatabase))
+        DatabaseSnapshot::remove(worldConfig.server.databaseSnapshotFile);
 
     if (!_CheckDBVersion())
     {
@@ -611,6 +617,8 @@ bool Master::_StartDB()
         return false;
     }
 
+    registerCharacterDatabaseStatements(CharacterDatabase);
+
     return true;
 }
 
@@ -890,6 +898,9 @@ void Master::ShutdownThreadPools(bool listnersockcreate)
 void Master::StartNetworkSubsystem()
 {
     sLogger.info("Network : Starting subsystem...");
+#ifdef CONFIG_USE_EPOLL
+    sSocketMgr.setWorkerThreadCount(worldConfig.listen.networkThreads);
+#endif
     sSocketMgr.initialize();
 }
 
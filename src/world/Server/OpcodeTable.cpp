@@ -10,6 +10,10 @@ This file is released under the MIT license. See README-MIT for more information
 
 #include "OpcodeTable.hpp"
 
+#include <limits>
+
+static_assert(NUM_OPCODES <= std::numeric_limits<uint16_t>::max(), "internal opcode ids are stored as uint16_t");
+
 OpcodeTables& OpcodeTables::getInstance()
 {
     static OpcodeTables mInstance;
@@ -20,16 +24,39 @@ void OpcodeTables::initialize()
 {
     std::cout << "OpcodeTables preparing version specific tables." << "\n";
 
-    // fill vector
-    for (const auto opcodeStore : multiversionOpcodeStore)
-    {   
-        for (auto hexIndex = 0; hexIndex < MAX_VERSION_INDEX; ++hexIndex)
-            _versionHexTable[hexIndex].emplace_back(opcodeStore.second.hexValues[hexIndex], opcodeStore.first);
+    const uint32_t internalIdCount = multiversionOpcodeStore.empty() ? 0 : multiversionOpcodeStore.rbegin()->first + 1;
+
+    for (auto hexIndex = 0; hexIndex < MAX_VERSION_INDEX; ++hexIndex)
+    {
+        _hexToInternalIdTable[hexIndex].assign(std::numeric_limits<uint16_t>::max() + 1, 0);
+        _internalIdToHexTable[hexIndex].assign(internalIdCount, 0);
+
+        // several opcodes can share a hex value (0 for opcodes a version does not have),
+        // filled backwards so the lowest internal id wins like with the old linear search
+        for (auto opcodeStore = multiversionOpcodeStore.rbegin(); opcodeStore != multiversionOpcodeStore.rend(); ++opcodeStore)
+        {
+            const uint16_t hexValue = opcodeStore->second.hexValues[hexIndex];
+
+            _hexToInternalIdTable[hexIndex][hexValue] = static_cast<uint16_t>(opcodeStore->first);
+            _internalIdToHexTable[hexIndex][opcodeStore->first] = hexValue;
+        }
     }
 }
 
+uint32_t OpcodeTables::getInternalIdForName(std::string const& name)
+{
+    for (const auto& opcodeStore : multiversionOpcodeStore)
+        if (opcodeStore.second.name == name)
+            return opcodeStore.first;
+
+    return NUM_OPCODES;
+}
+
 void OpcodeTables::finalize()
 {
     for (auto hexIndex = 0; hexIndex < MAX_VERSION_INDEX; ++hexIndex)
-        _versionHexTable[hexIndex].clear();
+    {
+        _hexToInternalIdTable[hexIndex].clear();
+        _internalIdToHexTable[hexIndex].clear();
+    }
 }
@@ -95,11 +95,8 @@ class SERVER_DECL OpcodeTables
             if (versionId == -1 || versionId >= MAX_VERSION_INDEX)
                 versionId = getVersionIdForAEVersion();
 
-            for (const auto table : _versionHexTable[versionId])
-                if (table.hexValue == hex)
-                    return table.internalId;
-
-            return 0;
+            const auto& hexTable = _hexToInternalIdTable[versionId];
+            return hex < hexTable.size() ? hexTable[hex] : 0;
         }
 
         std::string getNameForOpcode(uint16_t hex, int versionId = -1)
@@ -122,28 +119,27 @@ class SERVER_DECL OpcodeTables
             return "Unknown internal id!";
         }
 
+        // NUM_OPCODES for unknown names
+        uint32_t getInternalIdForName(std::string const& name);
+
         uint16_t getHexValueForVersionId(int versionId, uint32_t internalId)
         {
             if (versionId >= 0 && versionId < MAX_VERSION_INDEX)
             {
-                auto multiversionTable = multiversionOpcodeStore.find(internalId);
-                if (multiversionTable != multiversionOpcodeStore.end())
-                    return multiversionTable->second.hexValues[versionId];
+                const auto& internalIdTable = _internalIdToHexTable[versionId];
+                if (internalId < internalIdTable.size())
+                    return internalIdTable[internalId];
             }
 
             return 0;
         }
 
-        struct HexToId
-        {
-            HexToId(uint16_t hex, uint32_t intId) :
-                hexValue(hex), internalId(intId){}
-
-            uint16_t hexValue;
-            uint32_t internalId;
-        };
+    private:
 
-        std::vector<HexToId> _versionHexTable[MAX_VERSION_INDEX];
+        // Dense lookup tables for every version, filled in initialize().
+        // Both directions are a single indexed load, hex 0 and unknown ids map to 0.
+        std::vector<uint16_t> _hexToInternalIdTable[MAX_VERSION_INDEX];
+        std::vector<uint16_t> _internalIdToHexTable[MAX_VERSION_INDEX];
 };
 
 #define sOpcodeTables OpcodeTables::getInstance()
@@ -0,0 +1,330 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#include "PacketCapture.hpp"
+
+#include "Logging/Logger.hpp"
+#include "OpcodeTable.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <sstream>
+
+namespace
+{
+    // the writer wakes up earlier when the ring is half full
+    constexpr uint32_t PACKET_CAPTURE_WRITE_INTERVAL = 250;
+}
+
+PacketCapture& PacketCapture::getInstance()
+{
+    static PacketCapture mInstance;
+    return mInstance;
+}
+
+PacketCapture::PacketCapture() :
+    m_sampleRates(new std::atomic<uint32_t>[NUM_OPCODES]()),
+    m_sampleCounters(new std::atomic<uint32_t>[NUM_OPCODES]())
+{
+    setSampleRate(1);
+}
+
+PacketCapture::~PacketCapture()
+{
+    stop();
+}
+
+void PacketCapture::configure(size_t bufferSize, uint32_t maxPacketSize)
+{
+    std::lock_guard<std::mutex> guard(m_bufferMutex);
+    m_bufferSize = std::max<size_t>(bufferSize, 64 * 1024);
+    m_maxPacketSize = maxPacketSize;
+}
+
+bool PacketCapture::start(std::string const& fileName)
+{
+    stop();
+
+    m_file = fopen(fileName.c_str(), "wb");
+    if (m_file == nullptr)
+    {
+        sLogger.failure("PacketCapture : Could not open capture file %s", fileName.c_str());
+        return false;
+    }
+
+    m_fileName = fileName;
+    writeFileHeader();
+
+    size_t bufferSize;
+    {
+        std::lock_guard<std::mutex> guard(m_bufferMutex);
+        m_startTime = std::chrono::steady_clock::now();
+        bufferSize = m_bufferSize;
+        m_buffer.assign(m_bufferSize, 0);
+        m_readPosition = 0;
+        m_writePosition = 0;
+    }
+
+    m_capturedCount = 0;
+    m_droppedCount = 0;
+    m_sampledOutCount = 0;
+    m_writtenBytes = 0;
+
+    m_wakeUpRequested = false;
+    m_isRunning = true;
+    m_thread = std::thread(&PacketCapture::run, this);
+
+    m_isCapturing = true;
+
+    sLogger.info("PacketCapture : Capturing packets to %s (%u KB buffer)", fileName.c_str(), static_cast<uint32_t>(bufferSize / 1024));
+    return true;
+}
+
+void PacketCapture::stop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    {
+        // packets that are copied right now finish before the capture ends
+        std::lock_guard<std::mutex> guard(m_bufferMutex);
+        m_isCapturing = false;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_wakeUpMutex);
+        m_isRunning = false;
+    }
+    m_wakeUpCondition.notify_one();
+    m_thread.join();
+
+    fclose(m_file);
+    m_file = nullptr;
+
+    sLogger.info("PacketCapture : Stopped capture to %s, %llu packets captured, %llu dropped, %llu sampled out", m_fileName.c_str(),
+        static_cast<unsigned long long>(m_capturedCount.load()), static_cast<unsigned long long>(m_droppedCount.load()),
+        static_cast<unsigned long long>(m_sampledOutCount.load()));
+
+    std::vector<uint8_t>().swap(m_buffer);
+}
+
+void PacketCapture::capturePacket(uint16_t opcode, uint32_t length, const uint8_t* data, uint8_t direction, uint32_t accountId)
+{
+    if (!isCapturing())
+        return;
+
+    if (!isSampled(opcode))
+    {
+        ++m_sampledOutCount;
+        return;
+    }
+
+    PacketCaptureRecordHeader header;
+    header.accountId = accountId;
+    header.length = length;
+    header.opcode = sOpcodeTables.getHexValueForVersionId(sOpcodeTables.getVersionIdForAEVersion(), opcode);
+    header.direction = direction;
+    header.reserved = 0;
+
+    size_t recordSize;
+    size_t bufferedBytes;
+    size_t bufferSize;
+    {
+        std::lock_guard<std::mutex> guard(m_bufferMutex);
+        if (!m_isCapturing)
+            return;
+
+        // start time and packet size limit are set by start and configure under the same lock
+        header.time = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_startTime).count());
+        header.capturedLength = data == nullptr ? 0 : (m_maxPacketSize != 0 ? std::min(length, m_maxPacketSize) : length);
+        recordSize = sizeof(header) + header.capturedLength;
+
+        bufferSize = m_buffer.size();
+        bufferedBytes = static_cast<size_t>(m_writePosition - m_readPosition);
+        if (bufferSize - bufferedBytes < recordSize)
+        {
+            ++m_droppedCount;
+            return;
+        }
+
+        copyToBuffer(m_writePosition, &header, sizeof(header));
+        copyToBuffer(m_writePosition + sizeof(header), data, header.capturedLength);
+        m_writePosition += recordSize;
+    }
+
+    ++m_capturedCount;
+
+    // only the packet that fills the first half wakes the writer
+    if (bufferedBytes * 2 < bufferSize && (bufferedBytes + recordSize) * 2 >= bufferSize)
+        wakeUp();
+}
+
+void PacketCapture::setSampleRate(uint32_t rate)
+{
+    for (uint32_t opcode = 0; opcode < NUM_OPCODES; ++opcode)
+        m_sampleRates[opcode] = rate;
+}
+
+void PacketCapture::setSampleRate(uint16_t opcode, uint32_t rate)
+{
+    if (opcode < NUM_OPCODES)
+        m_sampleRates[opcode] = rate;
+}
+
+uint32_t PacketCapture::getSampleRate(uint16_t opcode) const
+{
+    return opcode < NUM_OPCODES ? m_sampleRates[opcode].load() : 1;
+}
+
+bool PacketCapture::loadSampleRates(std::string const& sampleRates)
+{
+    bool isValid = true;
+
+    std::stringstream stream(sampleRates);
+    std::string entry;
+    while (stream >> entry)
+    {
+        const auto separator = entry.find(':');
+        const uint32_t opcode = sOpcodeTables.getInternalIdForName(entry.substr(0, separator));
+        if (separator == std::string::npos || opcode == NUM_OPCODES)
+        {
+            sLogger.failure("PacketCapture : Invalid sample rate '%s', expected <opcode name>:<rate>", entry.c_str());
+            isValid = false;
+            continue;
+        }
+
+        setSampleRate(static_cast<uint16_t>(opcode), static_cast<uint32_t>(std::strtoul(entry.c_str() + separator + 1, nullptr, 10)));
+    }
+
+    return isValid;
+}
+
+PacketCaptureStats PacketCapture::getStats()
+{
+    std::lock_guard<std::mutex> guard(m_bufferMutex);
+    return { m_capturedCount.load(), m_droppedCount.load(), m_sampledOutCount.load(), m_writtenBytes.load(),
+        static_cast<size_t>(m_writePosition - m_readPosition), m_buffer.size() };
+}
+
+bool PacketCapture::isSampled(uint16_t opcode)
+{
+    if (opcode >= NUM_OPCODES)
+        return true;
+
+    const uint32_t rate = m_sampleRates[opcode].load(std::memory_order_relaxed);
+    if (rate <= 1)
+        return rate == 1;
+
+    return m_sampleCounters[opcode].fetch_add(1, std::memory_order_relaxed) % rate == 0;
+}
+
+void PacketCapture::writeFileHeader()
+{
+    const int versionId = sOpcodeTables.getVersionIdForAEVersion();
+
+    // opcode names of this version, so the dump tool does not depend on the server version
+    std::vector<char> opcodeNames;
+    uint32_t opcodeNameCount = 0;
+    for (const auto& opcodeStore : multiversionOpcodeStore)
+    {
+        const uint16_t hexValue = opcodeStore.second.hexValues[versionId];
+        if (hexValue == 0)
+            continue;
+
+        const uint8_t nameLength = static_cast<uint8_t>(std::min<size_t>(opcodeStore.second.name.size(), 255));
+        opcodeNames.insert(opcodeNames.end(), reinterpret_cast<const char*>(&hexValue), reinterpret_cast<const char*>(&hexValue) + sizeof(hexValue));
+        opcodeNames.push_back(static_cast<char>(nameLength));
+        opcodeNames.insert(opcodeNames.end(), opcodeStore.second.name.begin(), opcodeStore.second.name.begin() + nameLength);
+        ++opcodeNameCount;
+    }
+
+    PacketCaptureFileHeader header;
+    memcpy(header.magic, PACKET_CAPTURE_MAGIC, sizeof(header.magic));
+    header.formatVersion = PACKET_CAPTURE_FORMAT_VERSION;
+    header.versionId = static_cast<uint8_t>(versionId);
+    header.reserved = 0;
+    header.startTime = static_cast<uint64_t>(time(nullptr));
+    header.opcodeNameCount = opcodeNameCount;
+
+    fwrite(&header, sizeof(header), 1, m_file);
+    fwrite(opcodeNames.data(), 1, opcodeNames.size(), m_file);
+    fflush(m_file);
+}
+
+void PacketCapture::copyToBuffer(uint64_t position, const void* data, size_t size)
+{
+    if (size == 0)
+        return;
+
+    const size_t start = static_cast<size_t>(position % m_buffer.size());
+    const size_t firstPart = std::min(size, m_buffer.size() - start);
+
+    memcpy(&m_buffer[start], data, firstPart);
+    if (firstPart < size)
+        memcpy(&m_buffer[0], static_cast<const uint8_t*>(data) + firstPart, size - firstPart);
+}
+
+void PacketCapture::run()
+{
+    while (true)
+    {
+        bool isRunning;
+        {
+            std::unique_lock<std::mutex> lock(m_wakeUpMutex);
+            m_wakeUpCondition.wait_for(lock, std::chrono::milliseconds(PACKET_CAPTURE_WRITE_INTERVAL), [this] { return m_wakeUpRequested || !m_isRunning; });
+
+            m_wakeUpRequested = false;
+            isRunning = m_isRunning;
+        }
+
+        writeBuffered();
+
+        if (!isRunning)
+            break;
+    }
+}
+
+size_t PacketCapture::writeBuffered()
+{
+    uint64_t readPosition;
+    uint64_t writePosition;
+    {
+        std::lock_guard<std::mutex> guard(m_bufferMutex);
+        readPosition = m_readPosition;
+        writePosition = m_writePosition;
+    }
+
+    if (readPosition == writePosition)
+        return 0;
+
+    // the range between read and write position is only touched by this thread until the read position moves
+    const size_t count = static_cast<size_t>(writePosition - readPosition);
+    const size_t start = static_cast<size_t>(readPosition % m_buffer.size());
+    const size_t firstPart = std::min(count, m_buffer.size() - start);
+
+    fwrite(&m_buffer[start], 1, firstPart, m_file);
+    if (firstPart < count)
+        fwrite(&m_buffer[0], 1, count - firstPart, m_file);
+
+    fflush(m_file);
+
+    {
+        std::lock_guard<std::mutex> guard(m_bufferMutex);
+        m_readPosition = writePosition;
+    }
+
+    m_writtenBytes += count;
+    return count;
+}
+
+void PacketCapture::wakeUp()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_wakeUpMutex);
+        m_wakeUpRequested = true;
+    }
+    m_wakeUpCondition.notify_one();
+}
@@ -0,0 +1,112 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CommonTypes.hpp"
+#include "PacketCaptureFormat.hpp"
+
+struct PacketCaptureStats
+{
+    uint64_t captured;
+    uint64_t dropped;               // ring buffer was full
+    uint64_t sampledOut;
+    uint64_t writtenBytes;
+    size_t bufferedBytes;
+    size_t bufferSize;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Captures world packets into a binary file (see PacketCaptureFormat.hpp).
+// The socket threads only copy the packet into a preallocated ring buffer, a writer thread
+// writes the buffer to disk. Packets are dropped and counted when the ring is full, the
+// send and receive path never waits for the disk.
+// Every opcode has a sample rate: 1 keeps every packet, n keeps every nth, 0 keeps none.
+class SERVER_DECL PacketCapture
+{
+private:
+    PacketCapture();
+    ~PacketCapture();
+
+public:
+    static PacketCapture& getInstance();
+
+    PacketCapture(PacketCapture&&) = delete;
+    PacketCapture(PacketCapture const&) = delete;
+    PacketCapture& operator=(PacketCapture&&) = delete;
+    PacketCapture& operator=(PacketCapture const&) = delete;
+
+    // bufferSize in bytes, maxPacketSize 0 stores whole packets
+    void configure(size_t bufferSize, uint32_t maxPacketSize);
+
+    bool start(std::string const& fileName);
+    void stop();
+    bool isCapturing() const { return m_isCapturing.load(std::memory_order_acquire); }
+
+    // opcode is the internal id
+    void capturePacket(uint16_t opcode, uint32_t length, const uint8_t* data, uint8_t direction, uint32_t accountId);
+
+    // rate for all opcodes
+    void setSampleRate(uint32_t rate);
+    void setSampleRate(uint16_t opcode, uint32_t rate);
+    uint32_t getSampleRate(uint16_t opcode) const;
+
+    // space separated list of <opcode name>:<rate>, returns false if an opcode is unknown
+    bool loadSampleRates(std::string const& sampleRates);
+
+    PacketCaptureStats getStats();
+    std::string const& getFileName() const { return m_fileName; }
+
+private:
+    bool isSampled(uint16_t opcode);
+
+    void writeFileHeader();
+    void copyToBuffer(uint64_t position, const void* data, size_t size);
+
+    void run();
+    size_t writeBuffered();
+    void wakeUp();
+
+    size_t m_bufferSize = 16 * 1024 * 1024;
+    uint32_t m_maxPacketSize = 0;
+
+    std::unique_ptr<std::atomic<uint32_t>[]> m_sampleRates;
+    std::unique_ptr<std::atomic<uint32_t>[]> m_sampleCounters;
+
+    std::atomic<bool> m_isCapturing = false;
+    std::string m_fileName;
+    FILE* m_file = nullptr;
+    std::chrono::steady_clock::time_point m_startTime;
+
+    // producers copy under the mutex, the writer reads the committed range without it
+    std::mutex m_bufferMutex;
+    std::vector<uint8_t> m_buffer;
+    uint64_t m_readPosition = 0;
+    uint64_t m_writePosition = 0;
+
+    std::mutex m_wakeUpMutex;
+    std::condition_variable m_wakeUpCondition;
+    bool m_wakeUpRequested = false;
+    bool m_isRunning = false;
+    std::thread m_thread;
+
+    std::atomic<uint64_t> m_capturedCount = 0;
+    std::atomic<uint64_t> m_droppedCount = 0;
+    std::atomic<uint64_t> m_sampledOutCount = 0;
+    std::atomic<uint64_t> m_writtenBytes = 0;
+};
+
+#define sPacketCapture PacketCapture::getInstance()
@@ -1524,6 +1524,37 @@ void ScriptMgr::ReloadScriptEngines()
     }
 }
 
+bool ScriptMgr::WriteScriptEngineProfiles(std::ostream& out, uint32 count)
+{
+    bool hasProfiles = false;
+
+    for (DynamicLibraryMap::iterator itr = dynamiclibs.begin(); itr != dynamiclibs.end(); ++itr)
+    {
+        Arcemu::DynLib* dl = *itr;
+
+        exp_engine_profile engine_profilefunc = reinterpret_cast<exp_engine_profile>(dl->GetAddressForSymbol("_export_engine_profile"));
+        if (engine_profilefunc == nullptr)
+            continue;
+
+        engine_profilefunc(out, count);
+        hasProfiles = true;
+    }
+
+    return hasProfiles;
+}
+
+void ScriptMgr::ResetScriptEngineProfiles()
+{
+    for (DynamicLibraryMap::iterator itr = dynamiclibs.begin(); itr != dynamiclibs.end(); ++itr)
+    {
+        Arcemu::DynLib* dl = *itr;
+
+        exp_engine_profile_reset engine_profileresetfunc = reinterpret_cast<exp_engine_profile_reset>(dl->GetAddressForSymbol("_export_engine_profile_reset"));
+        if (engine_profileresetfunc != nullptr)
+            engine_profileresetfunc();
+    }
+}
+
 void ScriptMgr::UnloadScriptEngines()
 {
     //for all scripting engines that allow unloading, assuming there will be new scripting engines.
@@ -31,6 +31,8 @@
 #include "Spell/SpellScript.hpp"
 #include "ScriptEvent.hpp"
 
+#include <ostream>
+
 class Channel;
 class Guild;
 struct QuestProperties;
@@ -140,6 +142,8 @@ typedef bool(*exp_handle_dummy_aura)(uint8_t effectIndex, Aura* pAura, bool appl
 typedef void(*exp_script_register)(ScriptMgr* mgr);
 typedef void(*exp_engine_reload)();
 typedef void(*exp_engine_unload)();
+typedef void(*exp_engine_profile)(std::ostream& out, uint32 count);
+typedef void(*exp_engine_profile_reset)();
 typedef uint32(*exp_get_script_type)();
 typedef const char*(*exp_get_version)();
 typedef void(*exp_set_serverstate_singleton)(ServerState* state);
@@ -265,6 +269,10 @@ class SERVER_DECL ScriptMgr
         void ReloadScriptEngines();
         void UnloadScriptEngines();
 
+        // writes the call profiles of the scripting engines, false when none of them records calls
+        bool WriteScriptEngineProfiles(std::ostream& out, uint32 count);
+        void ResetScriptEngineProfiles();
+
         //////////////////////////////////////////////////////////////////////////////////////////
         // Purpose: Returns true if ScriptMgr has already registered the specified creature id.
         // Parameter: uint32 - the id of the creature to search for.
@@ -0,0 +1,143 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Hierarchical timer wheel with a resolution of one time unit (ms for events).
+// Four levels of 256 slots cover 2^32 units, later timers wait in an overflow list.
+// Scheduling is O(1) and advancing only touches the passing slots, the timers that
+// expire and the timers that move down one level when a higher level slot comes up.
+// Timers are not removed from the wheel, the owner drops cancelled ones on expiry.
+template <typename T>
+class TimerWheel
+{
+    static constexpr uint32_t SLOT_BITS = 8;
+    static constexpr uint64_t SLOT_COUNT = 1 << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOT_COUNT - 1;
+    static constexpr uint32_t LEVEL_COUNT = 4;
+
+    struct Timer
+    {
+        T value;
+        uint64_t expireTime;
+    };
+
+public:
+    uint64_t getTime() const { return m_time; }
+    size_t size() const { return m_count; }
+
+    // expireTime has to be later than the current wheel time
+    void schedule(T value, uint64_t expireTime)
+    {
+        insert({ value, expireTime });
+        ++m_count;
+    }
+
+    // Moves the wheel forward to time and calls onExpire(value) for every expired timer in expire order.
+    // onExpire may schedule new timers.
+    template <typename Func>
+    void advance(uint64_t time, Func onExpire)
+    {
+        while (m_time < time)
+        {
+            if (m_count == 0)
+            {
+                m_time = time;
+                return;
+            }
+
+            ++m_time;
+
+            if ((m_time & SLOT_MASK) == 0)
+                cascade();
+
+            auto& slot = m_slots[0][m_time & SLOT_MASK];
+            if (slot.empty())
+                continue;
+
+            // new timers never end up in the current slot, so it can be processed without copying
+            m_expired.swap(slot);
+            m_count -= m_expired.size();
+
+            for (const auto& timer : m_expired)
+                onExpire(timer.value);
+
+            m_expired.clear();
+        }
+    }
+
+    // Calls func(value) for every scheduled timer and removes all of them
+    template <typename Func>
+    void clear(Func func)
+    {
+        for (auto& level : m_slots)
+        {
+            for (auto& slot : level)
+            {
+                for (const auto& timer : slot)
+                    func(timer.value);
+
+                slot.clear();
+            }
+        }
+
+        for (const auto& timer : m_overflow)
+            func(timer.value);
+
+        m_overflow.clear();
+        m_count = 0;
+    }
+
+private:
+    void insert(Timer timer)
+    {
+        const uint64_t delta = timer.expireTime > m_time ? timer.expireTime - m_time : 0;
+
+        for (uint32_t level = 0; level < LEVEL_COUNT; ++level)
+        {
+            if (delta < (uint64_t(1) << (SLOT_BITS * (level + 1))))
+            {
+                m_slots[level][(timer.expireTime >> (SLOT_BITS * level)) & SLOT_MASK].push_back(timer);
+                return;
+            }
+        }
+
+        m_overflow.push_back(timer);
+    }
+
+    // The lowest level wrapped around, move the now current slot of every wrapped level one level down.
+    // Higher levels go first so their timers can be moved down again by the next level.
+    void cascade()
+    {
+        uint32_t wrappedLevel = 1;
+        while (wrappedLevel < LEVEL_COUNT && (m_time & ((uint64_t(1) << (SLOT_BITS * (wrappedLevel + 1))) - 1)) == 0)
+            ++wrappedLevel;
+
+        for (uint32_t level = wrappedLevel; level >= 1; --level)
+        {
+            std::vector<Timer> timers;
+            if (level == LEVEL_COUNT)
+                timers.swap(m_overflow);
+            else
+                timers.swap(m_slots[level][(m_time >> (SLOT_BITS * level)) & SLOT_MASK]);
+
+            for (const auto& timer : timers)
+                insert(timer);
+        }
+    }
+
+    std::array<std::array<std::vector<Timer>, SLOT_COUNT>, LEVEL_COUNT> m_slots;
+    std::vector<Timer> m_overflow;
+    std::vector<Timer> m_expired;
+
+    uint64_t m_time = 0;
+    size_t m_count = 0;
+};
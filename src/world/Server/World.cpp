@@ -18,12 +18,18 @@ This file is released under the MIT license. See README-MIT for more information
 #include "Chat/Channel.hpp"
 #include "Chat/ChannelMgr.hpp"
 #include "WorldSocket.h"
+#include "Database/DatabaseSnapshot.hpp"
 #include "Storage/MySQLDataStore.hpp"
+#include "Storage/StartupLoader.hpp"
 #include <CrashHandler.h>
 #include "Server/MainServerDefines.h"
 //#include "Config/Config.h"
 //#include "Map/MapCell.h"
 #include "Map/WorldCreator.h"
+#include "Map/MapUpdateScheduler.hpp"
+#include "Map/TerrainMgr.h"
+#include "Movement/PathCache.hpp"
+#include "Movement/PathfindingService.hpp"
 #include "Storage/DayWatcherThread.h"
 #include "BroadcastMgr.h"
 #include "Spell/SpellMgr.hpp"
@@ -32,6 +38,7 @@ This file is released under the MIT license. See README-MIT for more information
 #include "Packets/SmsgAreaTriggerMessage.h"
 #include "Packets/SmsgZoneUnderAttack.h"
 #include "OpcodeTable.hpp"
+#include "PacketCapture.hpp"
 #include "Chat/ChatHandler.hpp"
 #include "Management/GameEventMgr.h"
 #include "Objects/Units/Creatures/CreatureGroups.h"
@@ -96,6 +103,7 @@ void World::finalize()
 {
     sLogger.info("WorldLog : ~WorldLog()");
     sWorldPacketLog.finalize();
+    sPacketCapture.stop();
 
     sLogger.info("ObjectMgr : ~ObjectMgr()");
     sObjectMgr.finalize();
@@ -127,6 +135,18 @@ void World::finalize()
     sLogger.info("InstanceMgr : ~InstanceMgr()");
     sInstanceMgr.Shutdown();
 
+    sLogger.info("MapUpdateScheduler : finalize()");
+    sMapUpdateScheduler.finalize();
+
+    sLogger.info("PathfindingService : finalize()");
+    sPathfindingService.finalize();
+
+    sLogger.info("PathCache : finalize()");
+    sPathCache.finalize();
+
+    sLogger.info("TerrainTileCache : finalize()");
+    sTerrainTileCache.finalize();
+
     sLogger.info("WordFilter : ~WordFilter()");
     delete g_chatFilter;
 
@@ -698,6 +718,11 @@ bool World::setInitialWorldSettings()
     sWorldPacketLog.initialize();
     sWorldPacketLog.initWorldPacketLog(worldConfig.logger.enableWorldPacketLog);
 
+    sPacketCapture.configure(static_cast<size_t>(worldConfig.logger.packetCaptureBufferSize) * 1024, worldConfig.logger.packetCaptureMaxPacketSize);
+    sPacketCapture.loadSampleRates(worldConfig.logger.packetCaptureSampleRates);
+    if (worldConfig.logger.enablePacketCapture)
+        sPacketCapture.start(worldConfig.logger.packetCaptureFile);
+
     sLogger.info("World : Loading SpellInfo data...");
     sSpellMgr.startSpellMgr();
 
@@ -708,6 +733,9 @@ bool World::setInitialWorldSettings()
         LoadGameObjectModelList(vmapPath);
     }
 
+    DatabaseSnapshot databaseSnapshot;
+    openWorldDatabaseSnapshot(databaseSnapshot);
+
     loadMySQLStores();
 
     sLogger.info("World : Loading loot data...");
@@ -715,6 +743,8 @@ bool World::setInitialWorldSettings()
     sLootMgr.loadLoot();
 
     loadMySQLTablesByTask();
+
+    closeWorldDatabaseSnapshot(databaseSnapshot);
     logEntitySize();
 
     sSpellMgr.loadSpellDataFromDatabase();
@@ -789,83 +819,173 @@ bool World::loadDbcDb2Stores()
     return true;
 }
 
+std::string World::getWorldDatabaseSnapshotKey() const
+{
+    std::string key;
+
+    if (QueryResult* result = WorldDatabase.Query("SELECT LastUpdate FROM world_db_version ORDER BY LastUpdate DESC LIMIT 1"))
+    {
+        key = result->Fetch()[0].GetString();
+        delete result;
+    }
+
+    if (!worldConfig.server.databaseSnapshotChecksum)
+        return key;
+
+    QueryResult* tableResult = WorldDatabase.Query("SHOW TABLES");
+    if (tableResult == nullptr)
+        return key;
+
+    std::string checksumQuery = "CHECKSUM TABLE ";
+    do
+    {
+        if (checksumQuery.back() == '`')
+            checksumQuery += ", ";
+
+        checksumQuery += "`";
+        checksumQuery += tableResult->Fetch()[0].GetString();
+        checksumQuery += "`";
+    } while (tableResult->NextRow());
+
+    delete tableResult;
+
+    // the server does the full table scans, only the checksums are sent
+    if (QueryResult* checksumResult = WorldDatabase.QueryNA(checksumQuery.c_str()))
+    {
+        do
+        {
+            Field* fields = checksumResult->Fetch();
+            key += " ";
+            key += fields[0].GetString();
+            key += ":";
+            key += fields[1].isSet() ? fields[1].GetString() : "NULL";
+        } while (checksumResult->NextRow());
+
+        delete checksumResult;
+    }
+
+    return key;
+}
+
+void World::openWorldDatabaseSnapshot(DatabaseSnapshot& snapshot)
+{
+    if (!worldConfig.server.enableDatabaseSnapshot)
+        return;
+
+    auto startTime = Util::TimeNow();
+
+    const std::string key = getWorldDatabaseSnapshotKey();
+    if (snapshot.open(worldConfig.server.databaseSnapshotFile, key))
+        sLogger.info("DatabaseSnapshot : Using %s, checked in %u ms", worldConfig.server.databaseSnapshotFile.c_str(), static_cast<uint32_t>(Util::GetTimeDifferenceToNow(startTime)));
+    else
+        sLogger.info("DatabaseSnapshot : No valid snapshot, world tables are loaded from the database and saved to %s", worldConfig.server.databaseSnapshotFile.c_str());
+
+    WorldDatabase.setSnapshot(&snapshot);
+}
+
+void World::closeWorldDatabaseSnapshot(DatabaseSnapshot& snapshot)
+{
+    if (!snapshot.isOpen())
+        return;
+
+    // queries after the startup always go to the database
+    WorldDatabase.setSnapshot(nullptr);
+
+    sLogger.info("DatabaseSnapshot : %u queries answered by the snapshot, %u sent to the database", snapshot.getHitCount(), snapshot.getMissCount());
+    snapshot.close();
+}
+
+uint32_t World::getDatabaseLoadThreads() const
+{
+    // every thread holds one connection while a table is loaded
+    if (worldConfig.server.databaseLoadThreads == 0)
+        return static_cast<uint32_t>(std::max(worldConfig.worldDb.connections, 1));
+
+    return worldConfig.server.databaseLoadThreads;
+}
+
 void World::loadMySQLStores()
 {
     auto startTime = Util::TimeNow();
 
     sMySQLStore.loadAdditionalTableConfig();
 
-    sMySQLStore.loadItemPagesTable();
-    sMySQLStore.loadItemPropertiesTable();
-    sMySQLStore.loadCreaturePropertiesMovementTable();
-    sMySQLStore.loadCreaturePropertiesTable();
-    sMySQLStore.loadGameObjectPropertiesTable();
-    sMySQLStore.loadQuestPropertiesTable();
-    sMySQLStore.loadGameObjectQuestItemBindingTable();
-    sMySQLStore.loadGameObjectQuestPickupBindingTable();
-
-    sMySQLStore.loadCreatureDifficultyTable();
-    sMySQLStore.loadDisplayBoundingBoxesTable();
-    sMySQLStore.loadVendorRestrictionsTable();
-
-    sMySQLStore.loadNpcTextTable();
-    sMySQLStore.loadNpcScriptTextTable();
-    sMySQLStore.loadGossipMenuOptionTable();
-    sMySQLStore.loadGraveyardsTable();
-    sMySQLStore.loadTeleportCoordsTable();
-    sMySQLStore.loadFishingTable();
-    sMySQLStore.loadWorldMapInfoTable();
-    sMySQLStore.loadZoneGuardsTable();
-    sMySQLStore.loadBattleMastersTable();
-    sMySQLStore.loadTotemDisplayIdsTable();
-    sMySQLStore.loadSpellClickSpellsTable();
-
-    sMySQLStore.loadWorldStringsTable();
-    sMySQLStore.loadPointsOfInterestTable();
-    sMySQLStore.loadItemSetLinkedSetBonusTable();
-    sMySQLStore.loadCreatureInitialEquipmentTable();
-
-    sMySQLStore.loadPlayerCreateInfoTable();
-    sMySQLStore.loadPlayerCreateInfoBars();
-    sMySQLStore.loadPlayerCreateInfoItems();
-    sMySQLStore.loadPlayerCreateInfoSkills();
-    sMySQLStore.loadPlayerCreateInfoSpellLearn();
-    sMySQLStore.loadPlayerCreateInfoSpellCast();
-    sMySQLStore.loadPlayerCreateInfoLevelstats();
-    sMySQLStore.loadPlayerCreateInfoClassLevelstats();
-    sMySQLStore.loadPlayerXpToLevelTable();
-
-    sMySQLStore.loadSpellOverrideTable();
-
-    sMySQLStore.loadNpcGossipTextIdTable();
-    sMySQLStore.loadPetLevelAbilitiesTable();
-    sMySQLStore.loadBroadcastTable();
-
-    sMySQLStore.loadAreaTriggerTable();
-    sMySQLStore.loadWordFilterCharacterNames();
-    sMySQLStore.loadWordFilterChat();
-
-    sMySQLStore.loadLocalesCreature();
-    sMySQLStore.loadLocalesGameobject();
-    sMySQLStore.loadLocalesGossipMenuOption();
-    sMySQLStore.loadLocalesItem();
-    sMySQLStore.loadLocalesItemPages();
-    sMySQLStore.loadLocalesNpcScriptText();
-    sMySQLStore.loadLocalesNpcText();
-    sMySQLStore.loadLocalesQuest();
-    sMySQLStore.loadLocalesWorldbroadcast();
-    sMySQLStore.loadLocalesWorldmapInfo();
-    sMySQLStore.loadLocalesWorldStringTable();
+    StartupLoader loader("MySQLStore");
+
+    loader.addTask("ItemPages", {}, [] { sMySQLStore.loadItemPagesTable(); });
+    loader.addTask("ItemProperties", { "ItemPages" }, [] { sMySQLStore.loadItemPropertiesTable(); });
+    loader.addTask("CreaturePropertiesMovement", {}, [] { sMySQLStore.loadCreaturePropertiesMovementTable(); });
+    loader.addTask("CreatureProperties", { "CreaturePropertiesMovement" }, [] { sMySQLStore.loadCreaturePropertiesTable(); });
+    loader.addTask("GameObjectProperties", { "ItemProperties" }, [] { sMySQLStore.loadGameObjectPropertiesTable(); });
+    loader.addTask("QuestProperties", { "CreatureProperties", "GameObjectProperties" }, [] { sMySQLStore.loadQuestPropertiesTable(); });
+    loader.addTask("GameObjectQuestItemBinding", { "QuestProperties" }, [] { sMySQLStore.loadGameObjectQuestItemBindingTable(); });
+    loader.addTask("GameObjectQuestPickupBinding", { "GameObjectQuestItemBinding" }, [] { sMySQLStore.loadGameObjectQuestPickupBindingTable(); });
+
+    loader.addTask("CreatureDifficulty", {}, [] { sMySQLStore.loadCreatureDifficultyTable(); });
+    loader.addTask("DisplayBoundingBoxes", {}, [] { sMySQLStore.loadDisplayBoundingBoxesTable(); });
+    loader.addTask("VendorRestrictions", {}, [] { sMySQLStore.loadVendorRestrictionsTable(); });
+
+    loader.addTask("NpcText", {}, [] { sMySQLStore.loadNpcTextTable(); });
+    loader.addTask("NpcScriptText", {}, [] { sMySQLStore.loadNpcScriptTextTable(); });
+    loader.addTask("GossipMenuOption", {}, [] { sMySQLStore.loadGossipMenuOptionTable(); });
+    loader.addTask("Graveyards", {}, [] { sMySQLStore.loadGraveyardsTable(); });
+    loader.addTask("TeleportCoords", {}, [] { sMySQLStore.loadTeleportCoordsTable(); });
+    loader.addTask("Fishing", {}, [] { sMySQLStore.loadFishingTable(); });
+    loader.addTask("WorldMapInfo", {}, [] { sMySQLStore.loadWorldMapInfoTable(); });
+    loader.addTask("ZoneGuards", {}, [] { sMySQLStore.loadZoneGuardsTable(); });
+    loader.addTask("BattleMasters", {}, [] { sMySQLStore.loadBattleMastersTable(); });
+    loader.addTask("TotemDisplayIds", {}, [] { sMySQLStore.loadTotemDisplayIdsTable(); });
+    loader.addTask("SpellClickSpells", {}, [] { sMySQLStore.loadSpellClickSpellsTable(); });
+
+    loader.addTask("WorldStrings", {}, [] { sMySQLStore.loadWorldStringsTable(); });
+    loader.addTask("PointsOfInterest", {}, [] { sMySQLStore.loadPointsOfInterestTable(); });
+    loader.addTask("ItemSetLinkedSetBonus", {}, [] { sMySQLStore.loadItemSetLinkedSetBonusTable(); });
+    loader.addTask("CreatureInitialEquipment", { "CreatureProperties", "ItemProperties" }, [] { sMySQLStore.loadCreatureInitialEquipmentTable(); });
+
+    // all player create info loaders fill the same store
+    loader.addTask("PlayerCreateInfo", {}, [] { sMySQLStore.loadPlayerCreateInfoTable(); });
+    loader.addTask("PlayerCreateInfoBars", { "PlayerCreateInfo" }, [] { sMySQLStore.loadPlayerCreateInfoBars(); });
+    loader.addTask("PlayerCreateInfoItems", { "PlayerCreateInfoBars", "ItemProperties" }, [] { sMySQLStore.loadPlayerCreateInfoItems(); });
+    loader.addTask("PlayerCreateInfoSkills", { "PlayerCreateInfoItems" }, [] { sMySQLStore.loadPlayerCreateInfoSkills(); });
+    loader.addTask("PlayerCreateInfoSpellLearn", { "PlayerCreateInfoSkills" }, [] { sMySQLStore.loadPlayerCreateInfoSpellLearn(); });
+    loader.addTask("PlayerCreateInfoSpellCast", { "PlayerCreateInfoSpellLearn" }, [] { sMySQLStore.loadPlayerCreateInfoSpellCast(); });
+    loader.addTask("PlayerCreateInfoLevelstats", { "PlayerCreateInfoSpellCast" }, [] { sMySQLStore.loadPlayerCreateInfoLevelstats(); });
+    loader.addTask("PlayerCreateInfoClassLevelstats", { "PlayerCreateInfoLevelstats" }, [] { sMySQLStore.loadPlayerCreateInfoClassLevelstats(); });
+    loader.addTask("PlayerXpToLevel", {}, [] { sMySQLStore.loadPlayerXpToLevelTable(); });
+
+    loader.addTask("SpellOverride", {}, [] { sMySQLStore.loadSpellOverrideTable(); });
+
+    loader.addTask("NpcGossipTextId", { "CreatureProperties" }, [] { sMySQLStore.loadNpcGossipTextIdTable(); });
+    loader.addTask("PetLevelAbilities", {}, [] { sMySQLStore.loadPetLevelAbilitiesTable(); });
+    loader.addTask("Broadcast", {}, [] { sMySQLStore.loadBroadcastTable(); });
+
+    loader.addTask("AreaTrigger", {}, [] { sMySQLStore.loadAreaTriggerTable(); });
+    loader.addTask("WordFilterCharacterNames", {}, [] { sMySQLStore.loadWordFilterCharacterNames(); });
+    loader.addTask("WordFilterChat", {}, [] { sMySQLStore.loadWordFilterChat(); });
+
+    loader.addTask("LocalesCreature", {}, [] { sMySQLStore.loadLocalesCreature(); });
+    loader.addTask("LocalesGameobject", {}, [] { sMySQLStore.loadLocalesGameobject(); });
+    loader.addTask("LocalesGossipMenuOption", {}, [] { sMySQLStore.loadLocalesGossipMenuOption(); });
+    loader.addTask("LocalesItem", {}, [] { sMySQLStore.loadLocalesItem(); });
+    loader.addTask("LocalesItemPages", {}, [] { sMySQLStore.loadLocalesItemPages(); });
+    loader.addTask("LocalesNpcScriptText", {}, [] { sMySQLStore.loadLocalesNpcScriptText(); });
+    loader.addTask("LocalesNpcText", {}, [] { sMySQLStore.loadLocalesNpcText(); });
+    loader.addTask("LocalesQuest", {}, [] { sMySQLStore.loadLocalesQuest(); });
+    loader.addTask("LocalesWorldbroadcast", {}, [] { sMySQLStore.loadLocalesWorldbroadcast(); });
+    loader.addTask("LocalesWorldmapInfo", {}, [] { sMySQLStore.loadLocalesWorldmapInfo(); });
+    loader.addTask("LocalesWorldStringTable", {}, [] { sMySQLStore.loadLocalesWorldStringTable(); });
 
     //sMySQLStore.loadDefaultPetSpellsTable();      Zyres 2017/07/16 not used
-    sMySQLStore.loadProfessionDiscoveriesTable();
+    loader.addTask("ProfessionDiscoveries", {}, [] { sMySQLStore.loadProfessionDiscoveriesTable(); });
+
+    loader.addTask("TransportData", { "GameObjectProperties" }, [] { sMySQLStore.loadTransportDataTable(); });
+    loader.addTask("TransportEntrys", {}, [] { sMySQLStore.loadTransportEntrys(); });
+    loader.addTask("GossipMenuItems", {}, [] { sMySQLStore.loadGossipMenuItemsTable(); });
+    loader.addTask("Recall", {}, [] { sMySQLStore.loadRecallTable(); });
+    loader.addTask("CreatureAIScripts", { "CreatureProperties", "NpcScriptText" }, [] { sMySQLStore.loadCreatureAIScriptsTable(); });
+    loader.addTask("SpawnGroupIds", {}, [] { sMySQLStore.loadSpawnGroupIds(); });
 
-    sMySQLStore.loadTransportDataTable();
-    sMySQLStore.loadTransportEntrys();
-    sMySQLStore.loadGossipMenuItemsTable();
-    sMySQLStore.loadRecallTable();
-    sMySQLStore.loadCreatureAIScriptsTable();
-    sMySQLStore.loadSpawnGroupIds();
+    loader.run(getDatabaseLoadThreads());
 
     sLogger.info("Done. MySQLStore loaded in %u ms.", static_cast<uint32_t>(Util::GetTimeDifferenceToNow(startTime)));
 
@@ -884,58 +1004,70 @@ void World::loadMySQLTablesByTask()
     sTicketMgr.initialize();
     sGameEventMgr.initialize();
 
+    StartupLoader loader("ObjectMgr");
 
-    sObjectMgr.GenerateLevelUpInfo();
-    sObjectMgr.LoadPlayersInfo();
-
-    sMySQLStore.loadCreatureSpawns();
-    sMySQLStore.loadGameobjectSpawns();
-
-    sMySQLStore.loadCreatureGroupSpawns();
-
-    sObjectMgr.LoadInstanceEncounters();
-    sObjectMgr.LoadCreatureTimedEmotes();
-    sObjectMgr.loadTrainers();
-    sObjectMgr.LoadSpellSkills();
-    sObjectMgr.LoadVendors();
-    sObjectMgr.LoadSpellTargetConstraints();
-    sObjectMgr.LoadSpellRequired();
-    sObjectMgr.LoadSkillLineAbilityMap();
-    sObjectMgr.LoadPetSpellCooldowns();
-    sObjectMgr.LoadGuildCharters();
-    sTicketMgr.loadGMTickets();
-    sObjectMgr.SetHighestGuids();
-    sObjectMgr.LoadReputationModifiers();
-    sObjectMgr.LoadGroups();
-    sObjectMgr.LoadArenaTeams();
-    sObjectMgr.LoadVehicleAccessories();
-    sObjectMgr.LoadWorldStateTemplates();
+    loader.addTask("LevelUpInfo", {}, [] { sObjectMgr.GenerateLevelUpInfo(); });
+    loader.addTask("PlayersInfo", {}, [] { sObjectMgr.LoadPlayersInfo(); });
+
+    loader.addTask("CreatureSpawns", {}, [] { sMySQLStore.loadCreatureSpawns(); });
+    loader.addTask("GameobjectSpawns", {}, [] { sMySQLStore.loadGameobjectSpawns(); });
+
+    loader.addTask("CreatureGroupSpawns", { "CreatureSpawns" }, [] { sMySQLStore.loadCreatureGroupSpawns(); });
+
+    loader.addTask("InstanceEncounters", {}, [] { sObjectMgr.LoadInstanceEncounters(); });
+    loader.addTask("CreatureTimedEmotes", {}, [] { sObjectMgr.LoadCreatureTimedEmotes(); });
+    loader.addTask("Trainers", {}, [] { sObjectMgr.loadTrainers(); });
+    loader.addTask("SpellSkills", {}, [] { sObjectMgr.LoadSpellSkills(); });
+    loader.addTask("Vendors", {}, [] { sObjectMgr.LoadVendors(); });
+    loader.addTask("SpellTargetConstraints", {}, [] { sObjectMgr.LoadSpellTargetConstraints(); });
+    loader.addTask("SpellRequired", {}, [] { sObjectMgr.LoadSpellRequired(); });
+    loader.addTask("SkillLineAbilityMap", {}, [] { sObjectMgr.LoadSkillLineAbilityMap(); });
+    loader.addTask("PetSpellCooldowns", {}, [] { sObjectMgr.LoadPetSpellCooldowns(); });
+
+    // character database, the highest guids have to be known before groups and arena teams are created
+    loader.addTask("GuildCharters", { "PlayersInfo" }, [] { sObjectMgr.LoadGuildCharters(); });
+    loader.addTask("GMTickets", { "GuildCharters" }, [] { sTicketMgr.loadGMTickets(); });
+    loader.addTask("HighestGuids", { "GMTickets" }, [] { sObjectMgr.SetHighestGuids(); });
+    loader.addTask("ReputationModifiers", {}, [] { sObjectMgr.LoadReputationModifiers(); });
+    loader.addTask("Groups", { "HighestGuids" }, [] { sObjectMgr.LoadGroups(); });
+    loader.addTask("ArenaTeams", { "Groups" }, [] { sObjectMgr.LoadArenaTeams(); });
+    loader.addTask("VehicleAccessories", {}, [] { sObjectMgr.LoadVehicleAccessories(); });
+    loader.addTask("WorldStateTemplates", {}, [] { sObjectMgr.LoadWorldStateTemplates(); });
 
 #if VERSION_STRING > TBC
-    sObjectMgr.LoadAchievementRewards();
+    loader.addTask("AchievementRewards", {}, [] { sObjectMgr.LoadAchievementRewards(); });
 #endif
 
-    sLootMgr.loadAndGenerateLoot(0);
-    sLootMgr.loadAndGenerateLoot(1);
-    sLootMgr.loadAndGenerateLoot(2);
-    sLootMgr.loadAndGenerateLoot(3);
-    sLootMgr.loadAndGenerateLoot(4);
-    sLootMgr.loadAndGenerateLoot(5);
-
-    sQuestMgr.LoadExtraQuestStuff();
-    sObjectMgr.LoadEventScripts();
-    sWeatherMgr.LoadFromDB();
-    sAddonMgr.LoadFromDB();
-    sGameEventMgr.LoadFromDB();
-    sCalendarMgr.LoadFromDB();
-
-    sCommandTableStorage.Load();
+    // every loot type has its own store
+    loader.addTask("LootCreatures", {}, [] { sLootMgr.loadAndGenerateLoot(0); });
+    loader.addTask("LootGameobjects", {}, [] { sLootMgr.loadAndGenerateLoot(1); });
+    loader.addTask("LootSkinning", {}, [] { sLootMgr.loadAndGenerateLoot(2); });
+    loader.addTask("LootFishing", {}, [] { sLootMgr.loadAndGenerateLoot(3); });
+    loader.addTask("LootItems", {}, [] { sLootMgr.loadAndGenerateLoot(4); });
+    loader.addTask("LootPickpocketing", {}, [] { sLootMgr.loadAndGenerateLoot(5); });
+
+    // these managers work on data of many stores, they keep their old order after everything else
+    loader.addTaskAfterAll("ExtraQuestStuff", [] { sQuestMgr.LoadExtraQuestStuff(); });
+    loader.addTask("EventScripts", { "ExtraQuestStuff" }, [] { sObjectMgr.LoadEventScripts(); });
+    loader.addTask("Weather", { "EventScripts" }, [] { sWeatherMgr.LoadFromDB(); });
+    loader.addTask("Addons", { "Weather" }, [] { sAddonMgr.LoadFromDB(); });
+    loader.addTask("GameEvents", { "Addons" }, [] { sGameEventMgr.LoadFromDB(); });
+    loader.addTask("Calendar", { "GameEvents" }, [] { sCalendarMgr.LoadFromDB(); });
+    loader.addTask("CommandTable", { "Calendar" }, [] { sCommandTableStorage.Load(); });
+
+    loader.run(getDatabaseLoadThreads());
+
     sLogger.info("WordFilter : Loading...");
 
     g_chatFilter = new WordFilter();
 
     sLogger.info("Done. Database loaded in %u ms.", static_cast<uint32_t>(Util::GetTimeDifferenceToNow(startTime)));
 
+    sMapUpdateScheduler.initialize(worldConfig.server.mapUpdateThreads);
+    sTerrainTileCache.initialize(worldConfig.server.terrainCachedTiles);
+    sPathfindingService.initialize(worldConfig.terrainCollision.isPathfindingEnabled ? worldConfig.terrainCollision.pathfindingThreads : 0);
+    sPathCache.initialize(worldConfig.terrainCollision.isPathfindingEnabled ? worldConfig.terrainCollision.pathCacheSize : 0);
+
     // calling this puts all maps into our task list.
     sInstanceMgr.Load();
 }
@@ -41,6 +41,7 @@ enum ServerMessageType
 
 class SpellInfo;
 class Object;
+class DatabaseSnapshot;
 
 typedef std::set<WorldSession*> SessionSet;
 
@@ -217,6 +218,11 @@ class SERVER_DECL World : public EventableObject
         void resetCharacterLoginBannState();
         bool loadDbcDb2Stores();
 
+        std::string getWorldDatabaseSnapshotKey() const;
+        void openWorldDatabaseSnapshot(DatabaseSnapshot& snapshot);
+        void closeWorldDatabaseSnapshot(DatabaseSnapshot& snapshot);
+
+        uint32_t getDatabaseLoadThreads() const;
         void loadMySQLStores();
         void loadMySQLTablesByTask();
         void logEntitySize();
@@ -11,6 +11,7 @@ This file is released under the MIT license. See README-MIT for more information
 #include "Server/MainServerDefines.h"
 #include "Config/Config.h"
 #include "Map/MapCell.h"
+#include "Map/MapMgrDefines.hpp"
 //#include "Server/WorldSocket.h"
 #include "Logging/Logger.hpp"
 #include "Macros/PlayerMacros.hpp"
@@ -34,6 +35,7 @@ WorldConfig::WorldConfig(): mFloatRates{}, mIntRates{}
 
     // world.conf - Listen Config
     listen.listenPort = 8129;
+    listen.networkThreads = 1;
 
     // world.conf - Logger Settings
     logger.extendedLogsDir = "./";
@@ -44,6 +46,15 @@ WorldConfig::WorldConfig(): mFloatRates{}, mIntRates{}
     logger.enablePlayerLog = false;
     logger.enableTimeStamp = false;
     logger.enableSqlBanLog = false;
+    logger.enableAsyncMode = false;
+    logger.asyncFlushInterval = 100;
+    logger.asyncBufferSize = 4096;
+    logger.asyncDropWhenFull = false;
+    logger.enablePacketCapture = false;
+    logger.packetCaptureFile = "world-packets.aepc";
+    logger.packetCaptureBufferSize = 16384;
+    logger.packetCaptureMaxPacketSize = 0;
+    logger.packetCaptureSampleRates = "";
 
     // world.conf - Server Settings
     server.playerLimit = 100;
@@ -54,6 +65,16 @@ WorldConfig::WorldConfig(): mFloatRates{}, mIntRates{}
     server.enableAdjustPriority = false;
     server.mapUnloadTime = MAP_CELL_DEFAULT_UNLOAD_TIME;
     server.mapCellNumber = 1;
+    server.mapUpdateThreads = 0;
+    server.mapBusyPlayerCount = 0;
+    server.mapBusyTickPeriod = MAPMGR_UPDATE_PERIOD;
+    server.mapIdleTickPeriod = 0;
+    server.mapHibernateDelay = 0;
+    server.terrainCachedTiles = 256;
+    server.databaseLoadThreads = 0;
+    server.enableDatabaseSnapshot = false;
+    server.databaseSnapshotFile = "world_snapshot.aesn";
+    server.databaseSnapshotChecksum = true;
     server.secondsBeforeKickAFKPlayers = 0;
     server.queueUpdateInterval = 5000;
     server.enableBreathing = true;
@@ -141,6 +162,8 @@ WorldConfig::WorldConfig(): mFloatRates{}, mIntRates{}
     // world.conf - Terrain & Collision Settings
     terrainCollision.isCollisionEnabled = false;
     terrainCollision.isPathfindingEnabled = false;
+    terrainCollision.pathfindingThreads = 2;
+    terrainCollision.pathCacheSize = 512;
 
     // world.conf - Mail Settings
     mail.isCostsForGmDisabled = false;
@@ -153,6 +176,11 @@ WorldConfig::WorldConfig(): mFloatRates{}, mIntRates{}
     startup.enableMultithreadedLoading = false;
     startup.enableSpellIdDump = false;
 
+    // world.conf - LuaEngine Settings
+    luaEngine.mapStates = 0;
+    luaEngine.profileCalls = false;
+    luaEngine.instructionBudget = 0;
+
     // world.conf - AntiHack Setup
     antiHack.isTeleportHackCheckEnabled = false;
     antiHack.isSpeedHackCkeckEnabled = false;
@@ -267,6 +295,7 @@ void WorldConfig::loadWorldConfigValues(bool reload /*false*/)
     // world.conf - Listen Config
     Config.MainConfig.tryGetString("Listen", "Host", &listen.listenHost);
     Config.MainConfig.tryGetInt("Listen", "WorldServerPort", &listen.listenPort);
+    Config.MainConfig.tryGetInt("Listen", "NetworkThreads", &listen.networkThreads);
 
     // world.conf - Logger Settings
     Config.MainConfig.tryGetInt("Logger", "MinimumMessageType", &logger.minimumMessageType);
@@ -282,6 +311,15 @@ void WorldConfig::loadWorldConfigValues(bool reload /*false*/)
     Config.MainConfig.tryGetBool("Logger", "EnablePlayerLog", &logger.enablePlayerLog);
     Config.MainConfig.tryGetBool("Logger", "EnableTimeStamp", &logger.enableTimeStamp);
     Config.MainConfig.tryGetBool("Logger", "EnableSqlBanLog", &logger.enableSqlBanLog);
+    Config.MainConfig.tryGetBool("Logger", "AsyncMode", &logger.enableAsyncMode);
+    Config.MainConfig.tryGetInt("Logger", "AsyncFlushInterval", &logger.asyncFlushInterval);
+    Config.MainConfig.tryGetInt("Logger", "AsyncBufferSize", &logger.asyncBufferSize);
+    Config.MainConfig.tryGetBool("Logger", "AsyncDropWhenFull", &logger.asyncDropWhenFull);
+    Config.MainConfig.tryGetBool("Logger", "EnablePacketCapture", &logger.enablePacketCapture);
+    Config.MainConfig.tryGetString("Logger", "PacketCaptureFile", &logger.packetCaptureFile);
+    Config.MainConfig.tryGetInt("Logger", "PacketCaptureBufferSize", &logger.packetCaptureBufferSize);
+    Config.MainConfig.tryGetInt("Logger", "PacketCaptureMaxPacketSize", &logger.packetCaptureMaxPacketSize);
+    Config.MainConfig.tryGetString("Logger", "PacketCaptureSampleRates", &logger.packetCaptureSampleRates);
 
     // world.conf - Server Settings
     Config.MainConfig.tryGetInt("Server", "PlayerLimit", &server.playerLimit);
@@ -317,6 +355,21 @@ void WorldConfig::loadWorldConfigValues(bool reload /*false*/)
         sLogger.failure("MapCellNumber is set to 0. Congrats, no MapCells will be loaded. Overriding it to default value of 1");
         server.mapCellNumber = 1;
     }
+    Config.MainConfig.tryGetInt("Server", "MapUpdateThreads", &server.mapUpdateThreads);
+    Config.MainConfig.tryGetInt("Server", "MapBusyPlayerCount", &server.mapBusyPlayerCount);
+    Config.MainConfig.tryGetInt("Server", "MapBusyTickPeriod", &server.mapBusyTickPeriod);
+    if (server.mapBusyTickPeriod == 0)
+    {
+        sLogger.failure("MapBusyTickPeriod is set to 0. Overriding it to default value of %u", MAPMGR_UPDATE_PERIOD);
+        server.mapBusyTickPeriod = MAPMGR_UPDATE_PERIOD;
+    }
+    Config.MainConfig.tryGetInt("Server", "MapIdleTickPeriod", &server.mapIdleTickPeriod);
+    Config.MainConfig.tryGetInt("Server", "MapHibernateDelay", &server.mapHibernateDelay);
+    Config.MainConfig.tryGetInt("Server", "TerrainCachedTiles", &server.terrainCachedTiles);
+    Config.MainConfig.tryGetInt("Server", "DatabaseLoadThreads", &server.databaseLoadThreads);
+    Config.MainConfig.tryGetBool("Server", "DatabaseSnapshot", &server.enableDatabaseSnapshot);
+    Config.MainConfig.tryGetString("Server", "SnapshotFile", &server.databaseSnapshotFile);
+    Config.MainConfig.tryGetBool("Server", "SnapshotChecksum", &server.databaseSnapshotChecksum);
     Config.MainConfig.tryGetInt("Server", "KickAFKPlayers", &server.secondsBeforeKickAFKPlayers);
     server.secondsBeforeKickAFKPlayers *= 1000;
     Config.MainConfig.tryGetInt("Server", "QueueUpdateInterval", &server.queueUpdateInterval);
@@ -458,6 +511,8 @@ void WorldConfig::loadWorldConfigValues(bool reload /*false*/)
     // world.conf - Terrain & Collision Settings
     Config.MainConfig.tryGetBool("Terrain", "Collision", &terrainCollision.isCollisionEnabled);
     Config.MainConfig.tryGetBool("Terrain", "Pathfinding", &terrainCollision.isPathfindingEnabled);
+    Config.MainConfig.tryGetInt("Terrain", "PathfindingThreads", &terrainCollision.pathfindingThreads);
+    Config.MainConfig.tryGetInt("Terrain", "PathCacheSize", &terrainCollision.pathCacheSize);
 
     // world.conf - Mail Settings
     Config.MainConfig.tryGetBool("Mail", "DisablePostageCostsForGM", &mail.isCostsForGmDisabled);
@@ -471,6 +526,11 @@ void WorldConfig::loadWorldConfigValues(bool reload /*false*/)
     Config.MainConfig.tryGetBool("Startup", "EnableSpellIDDump", &startup.enableSpellIdDump);
     Config.MainConfig.tryGetString("Startup", "LoadAdditionalTables", &startup.additionalTableLoads);
 
+    // world.conf - LuaEngine Settings
+    Config.MainConfig.tryGetInt("LuaEngine", "MapStates", &luaEngine.mapStates);
+    Config.MainConfig.tryGetBool("LuaEngine", "ProfileCalls", &luaEngine.profileCalls);
+    Config.MainConfig.tryGetInt("LuaEngine", "InstructionBudget", &luaEngine.instructionBudget);
+
     // world.conf - AntiHack Setup
     Config.MainConfig.tryGetBool("AntiHack", "Teleport", &antiHack.isTeleportHackCheckEnabled);
     Config.MainConfig.tryGetBool("AntiHack", "Speed", &antiHack.isSpeedHackCkeckEnabled);
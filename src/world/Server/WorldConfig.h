@@ -98,6 +98,7 @@ class SERVER_DECL WorldConfig
         {
             std::string listenHost;
             int listenPort;
+            uint32_t networkThreads;
         } listen;
 
         // world.conf - Logger Settings
@@ -112,6 +113,15 @@ class SERVER_DECL WorldConfig
             bool enablePlayerLog;
             bool enableTimeStamp;
             bool enableSqlBanLog;
+            bool enableAsyncMode;
+            uint32_t asyncFlushInterval;
+            uint32_t asyncBufferSize;
+            bool asyncDropWhenFull;
+            bool enablePacketCapture;
+            std::string packetCaptureFile;
+            uint32_t packetCaptureBufferSize;
+            uint32_t packetCaptureMaxPacketSize;
+            std::string packetCaptureSampleRates;
         } logger;
 
         // world.conf - Server Settings
@@ -125,6 +135,16 @@ class SERVER_DECL WorldConfig
             bool enableAdjustPriority;
             uint32_t mapUnloadTime;
             uint8_t mapCellNumber;
+            uint32_t mapUpdateThreads;
+            uint32_t mapBusyPlayerCount;
+            uint32_t mapBusyTickPeriod;
+            uint32_t mapIdleTickPeriod;
+            uint32_t mapHibernateDelay;
+            uint32_t terrainCachedTiles;
+            uint32_t databaseLoadThreads;
+            bool enableDatabaseSnapshot;
+            std::string databaseSnapshotFile;
+            bool databaseSnapshotChecksum;
             uint32_t secondsBeforeKickAFKPlayers;
             uint32_t queueUpdateInterval;
             bool enableBreathing;
@@ -257,6 +277,8 @@ class SERVER_DECL WorldConfig
         {
             bool isCollisionEnabled;
             bool isPathfindingEnabled;
+            uint32_t pathfindingThreads;
+            uint32_t pathCacheSize;
         } terrainCollision;
 
         // world.conf - Mail Settings
@@ -277,6 +299,14 @@ class SERVER_DECL WorldConfig
             std::string additionalTableLoads;
         } startup;
 
+        // world.conf - LuaEngine Settings
+        struct LuaEngineSettings
+        {
+            uint32_t mapStates;
+            bool profileCalls;
+            uint32_t instructionBudget;
+        } luaEngine;
+
         // world.conf - AntiHack Setup
         struct AntiHackSettings
         {
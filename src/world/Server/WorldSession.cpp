@@ -157,13 +157,14 @@ uint8 WorldSession::Update(uint32 InstanceID)
     {
         if (packet != nullptr)
         {
-            if (sOpcodeTables.getInternalIdForHex(packet->GetOpcode()) >= NUM_OPCODES)
+            const uint32_t internalId = sOpcodeTables.getInternalIdForHex(packet->GetOpcode());
+            if (internalId >= NUM_OPCODES)
             {
                 sLogger.debugFlag(AscEmu::Logging::LF_OPCODE, "[Session] Received out of range packet with opcode 0x%.4X", packet->GetOpcode());
             }
             else
             {
-                OpcodeHandler* handler = &WorldPacketHandlers[sOpcodeTables.getInternalIdForHex(packet->GetOpcode())];
+                OpcodeHandler* handler = &WorldPacketHandlers[internalId];
                 if (handler->status == STATUS_LOGGEDIN && !_player && handler->handler != 0)
                 {
                     sLogger.debugFlag(AscEmu::Logging::LF_OPCODE, "[Session] Received unexpected/wrong state packet with opcode %s (0x%.4X)",
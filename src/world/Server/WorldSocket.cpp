@@ -30,6 +30,7 @@
 #include "Packets/SmsgAuthChallenge.h"
 #include "Packets/SmsgAuthResponse.h"
 #include "OpcodeTable.hpp"
+#include "PacketCapture.hpp"
 
 using namespace AscEmu::Packets;
 
@@ -1034,6 +1035,9 @@ void WorldSocket::HandleWoWConnection(WorldPacket* recvPacket)
 
 void WorldPacketLog::logPacket(uint32_t len, uint16_t opcode, const uint8_t* data, uint8_t direction, uint32_t accountid)
 {
+    // only copies the packet, the capture file is written by its own thread
+    sPacketCapture.capturePacket(opcode, len, data, direction, accountid);
+
     switch (opcode)
     {
         //stop spaming opcodes here
@@ -0,0 +1,188 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#include "StartupLoader.hpp"
+
+#include "Logging/Logger.hpp"
+
+#include <algorithm>
+#include <thread>
+
+StartupLoader::StartupLoader(std::string name) : m_name(std::move(name))
+{
+}
+
+void StartupLoader::addTask(std::string const& name, std::vector<std::string> const& dependencies, std::function<void()> function)
+{
+    if (m_taskIndices.find(name) != m_taskIndices.end())
+    {
+        sLogger.failure("StartupLoader : Task %s is added twice to %s, the second one is skipped", name.c_str(), m_name.c_str());
+        return;
+    }
+
+    const size_t index = m_tasks.size();
+
+    Task task;
+    task.name = name;
+    task.function = std::move(function);
+
+    for (const auto& dependency : dependencies)
+    {
+        const auto itr = m_taskIndices.find(dependency);
+        if (itr == m_taskIndices.end())
+        {
+            sLogger.failure("StartupLoader : Task %s depends on %s which is not added before it", name.c_str(), dependency.c_str());
+            continue;
+        }
+
+        task.dependencies.push_back(itr->second);
+        m_tasks[itr->second].dependents.push_back(index);
+    }
+
+    task.pendingDependencies = task.dependencies.size();
+
+    m_taskIndices.emplace(name, index);
+    m_tasks.push_back(std::move(task));
+}
+
+void StartupLoader::addTaskAfterAll(std::string const& name, std::function<void()> function)
+{
+    std::vector<std::string> dependencies;
+    dependencies.reserve(m_tasks.size());
+
+    for (const auto& task : m_tasks)
+        dependencies.push_back(task.name);
+
+    addTask(name, dependencies, std::move(function));
+}
+
+void StartupLoader::run(uint32_t threadCount)
+{
+    threadCount = std::max<uint32_t>(1, std::min<uint32_t>(threadCount, static_cast<uint32_t>(m_tasks.size())));
+
+    m_startTime = std::chrono::steady_clock::now();
+
+    if (threadCount == 1)
+    {
+        for (auto& task : m_tasks)
+            runTask(task);
+    }
+    else
+    {
+        m_finishedCount = 0;
+        for (size_t i = 0; i < m_tasks.size(); ++i)
+        {
+            if (m_tasks[i].pendingDependencies == 0)
+                m_readyTasks.insert(i);
+        }
+
+        std::vector<std::thread> workers;
+        workers.reserve(threadCount - 1);
+        for (uint32_t i = 1; i < threadCount; ++i)
+            workers.emplace_back(&StartupLoader::runWorker, this);
+
+        runWorker();
+
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    const auto wallTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_startTime).count();
+    logReport(wallTime, threadCount);
+}
+
+void StartupLoader::runWorker()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+    {
+        m_condition.wait(lock, [this] { return !m_readyTasks.empty() || m_finishedCount == m_tasks.size(); });
+        if (m_readyTasks.empty())
+            return;
+
+        const size_t index = *m_readyTasks.begin();
+        m_readyTasks.erase(m_readyTasks.begin());
+
+        lock.unlock();
+        runTask(m_tasks[index]);
+        lock.lock();
+
+        ++m_finishedCount;
+        for (const size_t dependent : m_tasks[index].dependents)
+        {
+            if (--m_tasks[dependent].pendingDependencies == 0)
+                m_readyTasks.insert(dependent);
+        }
+
+        m_condition.notify_all();
+    }
+}
+
+void StartupLoader::runTask(Task& task)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    task.function();
+    const auto endTime = std::chrono::steady_clock::now();
+
+    task.startTime = std::chrono::duration_cast<std::chrono::microseconds>(startTime - m_startTime).count();
+    task.duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+}
+
+void StartupLoader::logReport(long long wallTime, uint32_t threadCount) const
+{
+    if (m_tasks.empty())
+        return;
+
+    // tasks are stored in a valid serial order, so every dependency is calculated before its dependents
+    std::vector<long long> pathTimes(m_tasks.size(), 0);
+    std::vector<size_t> pathPredecessors(m_tasks.size(), m_tasks.size());
+    long long taskTime = 0;
+    size_t pathEnd = 0;
+
+    for (size_t i = 0; i < m_tasks.size(); ++i)
+    {
+        for (const size_t dependency : m_tasks[i].dependencies)
+        {
+            if (pathTimes[dependency] > pathTimes[i])
+            {
+                pathTimes[i] = pathTimes[dependency];
+                pathPredecessors[i] = dependency;
+            }
+        }
+
+        pathTimes[i] += m_tasks[i].duration;
+        taskTime += m_tasks[i].duration;
+
+        if (pathTimes[i] > pathTimes[pathEnd])
+            pathEnd = i;
+    }
+
+    std::vector<size_t> criticalPath;
+    for (size_t i = pathEnd; i != m_tasks.size(); i = pathPredecessors[i])
+        criticalPath.push_back(i);
+
+    std::reverse(criticalPath.begin(), criticalPath.end());
+
+    sLogger.info("StartupLoader : %s loaded %u tasks in %u ms on %u threads, %u ms spent in tasks", m_name.c_str(), static_cast<uint32_t>(m_tasks.size()),
+        static_cast<uint32_t>(wallTime / 1000), threadCount, static_cast<uint32_t>(taskTime / 1000));
+
+    sLogger.info("StartupLoader : Critical path of %s takes %u ms:", m_name.c_str(), static_cast<uint32_t>(pathTimes[pathEnd] / 1000));
+    for (const size_t index : criticalPath)
+        sLogger.info("StartupLoader :     %-40s %6u ms", m_tasks[index].name.c_str(), static_cast<uint32_t>(m_tasks[index].duration / 1000));
+
+    std::vector<size_t> sortedTasks(m_tasks.size());
+    for (size_t i = 0; i < sortedTasks.size(); ++i)
+        sortedTasks[i] = i;
+
+    std::sort(sortedTasks.begin(), sortedTasks.end(), [this](size_t a, size_t b) { return m_tasks[a].duration > m_tasks[b].duration; });
+
+    sLogger.info("StartupLoader : Tasks of %s by load time:", m_name.c_str());
+    for (const size_t index : sortedTasks)
+    {
+        sLogger.info("StartupLoader :     %-40s %6u ms (started at %u ms)", m_tasks[index].name.c_str(), static_cast<uint32_t>(m_tasks[index].duration / 1000),
+            static_cast<uint32_t>(m_tasks[index].startTime / 1000));
+    }
+}
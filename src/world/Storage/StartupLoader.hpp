@@ -0,0 +1,75 @@
+/*
+Copyright (c) 2014-2021 AscEmu Team <http://www.ascemu.org>
+This file is released under the MIT license. See README-MIT for more information.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Runs the database loaders of the server startup as a dependency graph.
+// A task starts as soon as all tasks it depends on are finished, independent tasks run
+// at the same time on a fixed number of threads (each one uses its own database connection).
+// Dependencies have to be added before the task that needs them, so the order of addTask
+// is always a valid serial order.
+// After run() the time of every task and the critical path (the longest chain of dependent
+// tasks, the lower limit of the wall time) is written to the log.
+class StartupLoader
+{
+public:
+    explicit StartupLoader(std::string name);
+
+    StartupLoader(StartupLoader&&) = delete;
+    StartupLoader(StartupLoader const&) = delete;
+    StartupLoader& operator=(StartupLoader&&) = delete;
+    StartupLoader& operator=(StartupLoader const&) = delete;
+
+    void addTask(std::string const& name, std::vector<std::string> const& dependencies, std::function<void()> function);
+
+    // depends on every task added before, for loaders whose dependencies are not known
+    void addTaskAfterAll(std::string const& name, std::function<void()> function);
+
+    // threadCount includes the calling thread, 1 runs all tasks in the order they were added
+    void run(uint32_t threadCount);
+
+private:
+    struct Task
+    {
+        std::string name;
+        std::function<void()> function;
+
+        std::vector<size_t> dependencies;
+        std::vector<size_t> dependents;
+        size_t pendingDependencies = 0;
+
+        // microseconds since the start of run()
+        long long startTime = 0;
+        long long duration = 0;
+    };
+
+    void runWorker();
+    void runTask(Task& task);
+
+    void logReport(long long wallTime, uint32_t threadCount) const;
+
+    std::string m_name;
+    std::vector<Task> m_tasks;
+    std::map<std::string, size_t> m_taskIndices;
+
+    std::chrono::steady_clock::time_point m_startTime;
+
+    // lowest index first, which keeps the order of addTask for tasks that are ready at the same time
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::set<size_t> m_readyTasks;
+    size_t m_finishedCount = 0;
+};